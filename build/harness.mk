@@ -1,6 +1,7 @@
 HARNESS_SOURCES = \
 	$(SRC)/NMEA/MoreData.cpp \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/TrafficTable.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -15,7 +15,8 @@ LIBNMEA_SOURCES = \
 	$(SRC)/NMEA/SwitchState.cpp \
 	$(SRC)/NMEA/InputLine.cpp \
 	$(SRC)/NMEA/Checksum.cpp \
-	$(SRC)/NMEA/Aircraft.cpp
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/FLARM/TrafficTable.cpp
 
 LIBNMEA_DEPENDS = GEO TIME UNITS
 
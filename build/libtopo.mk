@@ -7,6 +7,7 @@ TOPO_SOURCES = \
 	$(SRC)/Topography/Thread.cpp \
 	$(SRC)/Topography/TopographyGlue.cpp \
 	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/TopographyPack.cpp \
 	$(SRC)/Topography/Index.cpp \
 	$(SRC)/Topography/CachedTopographyRenderer.cpp
 
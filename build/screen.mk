@@ -179,6 +179,7 @@ SCREEN_SOURCES += \
 	$(CANVAS_SRC_DIR)/custom/Files.cpp \
 	$(CANVAS_SRC_DIR)/custom/Bitmap.cpp \
 	$(CANVAS_SRC_DIR)/custom/ResourceBitmap.cpp \
+	$(CANVAS_SRC_DIR)/memory/Damage.cpp \
 	$(CANVAS_SRC_DIR)/fb/TopCanvas.cpp \
 	$(WINDOW_SRC_DIR)/poll/TopWindow.cpp \
 	$(WINDOW_SRC_DIR)/fb/Window.cpp \
@@ -192,6 +193,7 @@ SCREEN_SOURCES += \
 	$(CANVAS_SRC_DIR)/custom/Bitmap.cpp \
 	$(CANVAS_SRC_DIR)/custom/ResourceBitmap.cpp \
 	$(CANVAS_SRC_DIR)/memory/Export.cpp \
+	$(CANVAS_SRC_DIR)/memory/Damage.cpp \
 	$(WINDOW_SRC_DIR)/poll/TopWindow.cpp \
 	$(WINDOW_SRC_DIR)/fb/TopWindow.cpp \
 	$(CANVAS_SRC_DIR)/fb/TopCanvas.cpp \
@@ -239,6 +241,7 @@ SCREEN_SOURCES += \
 	$(CANVAS_SRC_DIR)/memory/RawBitmap.cpp \
 	$(CANVAS_SRC_DIR)/memory/VirtualCanvas.cpp \
 	$(CANVAS_SRC_DIR)/memory/SubCanvas.cpp \
+	$(CANVAS_SRC_DIR)/memory/TiledRasteriser.cpp \
 	$(CANVAS_SRC_DIR)/memory/Canvas.cpp
 MEMORY_CANVAS_CPPFLAGS = -DUSE_MEMORY_CANVAS
 endif
@@ -267,6 +270,11 @@ ifeq ($(LIBPNG),y)
 SCREEN_DEPENDS += IO
 endif
 
+ifeq ($(USE_MEMORY_CANVAS),y)
+# TiledRasteriser.cpp uses class StandbyThread
+SCREEN_DEPENDS += THREAD
+endif
+
 $(eval $(call link-library,screen,SCREEN))
 
 ifeq ($(USE_FB)$(VFB),yy)
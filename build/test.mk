@@ -76,6 +76,13 @@ TEST_NAMES = \
 	test_pressure \
 	test_task \
 	TestOverwritingRingBuffer \
+	TestTripleBuffer TestDeviceBlackboard \
+	TestTrafficTable \
+	TestFlarmConflict \
+	TestMapRenderStats \
+	TestImageDamage TestTiledRasteriser TestRasterShader \
+	TestVarioSynthesiser TestAudioAlgorithms \
+	TestFlightLogbook \
 	TestDateTime TestRoughTime TestWrapClock \
 	TestPolylineDecoder \
 	TestTransponderCode \
@@ -87,6 +94,8 @@ TEST_NAMES = \
 	TestValidity TestUTM \
 	TestAllocatedGrid \
 	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRasterLineWalker \
+	TestTopographyPack \
 	TestLogger TestGRecord TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet \
@@ -99,6 +108,7 @@ TEST_NAMES = \
 	TestTaskWaypoint \
 	TestTeamCode \
 	TestZeroFinder \
+	TestTraceColumns TestContestParallel \
 	TestAirspaceParser \
 	TestMETARParser \
 	TestIGCParser \
@@ -163,6 +173,102 @@ TEST_OVERWRITING_RING_BUFFER_SOURCES = \
 TEST_OVERWRITING_RING_BUFFER_DEPENDS = MATH
 $(eval $(call link-program,TestOverwritingRingBuffer,TEST_OVERWRITING_RING_BUFFER))
 
+TEST_TRIPLE_BUFFER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTripleBuffer.cpp
+$(eval $(call link-program,TestTripleBuffer,TEST_TRIPLE_BUFFER))
+
+TEST_DEVICE_BLACKBOARD_SOURCES = \
+	$(SRC)/Blackboard/DeviceBlackboard.cpp \
+	$(SRC)/Device/Simulator.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalSlice.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterCollection.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Atmosphere/AirDensity.cpp \
+	$(SRC)/Engine/GlideSolvers/GlidePolar.cpp \
+	$(SRC)/Engine/Task/Stats/TaskStats.cpp \
+	$(SRC)/Engine/Task/Stats/CommonStats.cpp \
+	$(SRC)/Engine/Task/Stats/ElementStat.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestDeviceBlackboard.cpp
+TEST_DEVICE_BLACKBOARD_DEPENDS = LIBNMEA GEO MATH UTIL TIME UNITS
+$(eval $(call link-program,TestDeviceBlackboard,TEST_DEVICE_BLACKBOARD))
+
+TEST_TRAFFIC_TABLE_SOURCES = \
+	$(SRC)/FLARM/Id.cpp \
+	$(SRC)/FLARM/TrafficTable.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTrafficTable.cpp
+TEST_TRAFFIC_TABLE_DEPENDS = FMT
+$(eval $(call link-program,TestTrafficTable,TEST_TRAFFIC_TABLE))
+
+TEST_FLARM_CONFLICT_SOURCES = \
+	$(SRC)/FLARM/Id.cpp \
+	$(SRC)/FLARM/TrafficTable.cpp \
+	$(SRC)/FLARM/ConflictPredictor.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFlarmConflict.cpp
+TEST_FLARM_CONFLICT_DEPENDS = MATH FMT
+$(eval $(call link-program,TestFlarmConflict,TEST_FLARM_CONFLICT))
+
+TEST_MAP_RENDER_STATS_SOURCES = \
+	$(SRC)/MapWindow/MapRenderStats.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestMapRenderStats.cpp
+TEST_MAP_RENDER_STATS_DEPENDS = IO FMT UTIL
+$(eval $(call link-program,TestMapRenderStats,TEST_MAP_RENDER_STATS))
+
+TEST_IMAGE_DAMAGE_SOURCES = \
+	$(SRC)/ui/canvas/memory/Damage.cpp \
+	$(SRC)/ui/canvas/memory/Dither.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestImageDamage.cpp
+$(eval $(call link-program,TestImageDamage,TEST_IMAGE_DAMAGE))
+
+TEST_TILED_RASTERISER_SOURCES = \
+	$(SRC)/ui/canvas/memory/TiledRasteriser.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTiledRasteriser.cpp
+TEST_TILED_RASTERISER_CPPFLAGS = -DUSE_MEMORY_CANVAS
+TEST_TILED_RASTERISER_DEPENDS = THREAD UTIL
+$(eval $(call link-program,TestTiledRasteriser,TEST_TILED_RASTERISER))
+
+TEST_RASTER_SHADER_SOURCES = \
+	$(SRC)/Terrain/RasterShader.cpp \
+	$(SRC)/ui/canvas/Ramp.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRasterShader.cpp
+TEST_RASTER_SHADER_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_RASTER_SHADER_DEPENDS = MATH THREAD UTIL
+$(eval $(call link-program,TestRasterShader,TEST_RASTER_SHADER))
+
+TEST_VARIO_SYNTHESISER_SOURCES = \
+	$(SRC)/Audio/ToneSynthesiser.cpp \
+	$(SRC)/Audio/VarioSynthesiser.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestVarioSynthesiser.cpp
+TEST_VARIO_SYNTHESISER_DEPENDS = MATH UTIL
+$(eval $(call link-program,TestVarioSynthesiser,TEST_VARIO_SYNTHESISER))
+
+TEST_AUDIO_ALGORITHMS_SOURCES = \
+	$(SRC)/Audio/PCMMixerDataSource.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAudioAlgorithms.cpp
+TEST_AUDIO_ALGORITHMS_DEPENDS = UTIL
+$(eval $(call link-program,TestAudioAlgorithms,TEST_AUDIO_ALGORITHMS))
+
+TEST_FLIGHT_LOGBOOK_SOURCES = \
+	$(SRC)/FlightInfo.cpp \
+	$(SRC)/Logger/FlightParser.cpp \
+	$(SRC)/Logger/FlightLogbook.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFlightLogbook.cpp
+TEST_FLIGHT_LOGBOOK_DEPENDS = IO OS TIME UTIL
+$(eval $(call link-program,TestFlightLogbook,TEST_FLIGHT_LOGBOOK))
+
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -180,11 +286,13 @@ $(eval $(call link-program,TestMETARParser,TEST_METAR_PARSER))
 
 TEST_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(SRC)/RadioFrequency.cpp \
 	$(TEST_SRC_DIR)/FakeDialogs.cpp \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
 	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAirspaceParser.cpp
 TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
@@ -560,6 +668,27 @@ TEST_FLAT_GEO_POINT_SOURCES = \
 TEST_FLAT_GEO_POINT_DEPENDS = GEO MATH
 $(eval $(call link-program,TestFlatGeoPoint,TEST_FLAT_GEO_POINT))
 
+TEST_RASTER_LINE_WALKER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRasterLineWalker.cpp
+TEST_RASTER_LINE_WALKER_DEPENDS = MATH
+$(eval $(call link-program,TestRasterLineWalker,TEST_RASTER_LINE_WALKER))
+
+TEST_TOPOGRAPHY_PACK_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/system/Path.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTopographyPack.cpp
+ifeq ($(OPENGL),y)
+TEST_TOPOGRAPHY_PACK_SOURCES += \
+	$(CANVAS_SRC_DIR)/opengl/Triangulate.cpp
+endif
+TEST_TOPOGRAPHY_PACK_DEPENDS = TOPO GEO MATH THREAD IO SYSTEM UTIL ZZIP
+TEST_TOPOGRAPHY_PACK_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,TestTopographyPack,TEST_TOPOGRAPHY_PACK))
+
 TEST_FLAT_LINE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestFlatLine.cpp
@@ -672,6 +801,7 @@ $(eval $(call link-program,TestDriver,TEST_DRIVER))
 
 TEST_WAY_POINT_FILE_SOURCES = \
 	$(SRC)/Waypoint/CupWriter.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/Factory.cpp \
 	$(SRC)/RadioFrequency.cpp \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
@@ -680,6 +810,14 @@ TEST_WAY_POINT_FILE_SOURCES = \
 TEST_WAY_POINT_FILE_DEPENDS = WAYPOINTFILE OPERATION GEO MATH IO ZZIP OS THREAD UTIL
 $(eval $(call link-program,TestWaypointReader,TEST_WAY_POINT_FILE))
 
+TEST_TRACE_COLUMNS_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/TestTraceColumns.cpp
+TEST_TRACE_COLUMNS_DEPENDS = GEO MATH UTIL
+$(eval $(call link-program,TestTraceColumns,TEST_TRACE_COLUMNS))
+
 TEST_TRACE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(SRC)/Engine/Trace/Point.cpp \
@@ -750,6 +888,7 @@ DEBUG_PROGRAM_NAMES += \
 	RunDeviceDriver RunDeclare RunFlightList RunDownloadFlight \
 	RunEnableNMEA \
 	CAI302Tool \
+	BenchmarkGlideComputer \
 	RunIGCWriter \
 	RunFlightLogger RunFlyingComputer \
 	RunCirclingWind RunWindEKF RunWindComputer \
@@ -799,7 +938,8 @@ DEBUG_PROGRAM_NAMES += DownloadFile \
 	UploadFile \
 	RunWeGlideClient \
 	RunTimClient \
-	RunNOAADownloader RunSkyLinesTracking RunLiveTrack24
+	RunNOAADownloader RunSkyLinesTracking RunLiveTrack24 \
+	RunCloudLoad
 endif
 
 ifeq ($(TARGET_IS_LINUX),y)
@@ -986,6 +1126,13 @@ RUN_SL_TRACKING_SOURCES = \
 RUN_SL_TRACKING_DEPENDS = $(DEBUG_REPLAY_DEPENDS)
 $(eval $(call link-program,RunSkyLinesTracking,RUN_SL_TRACKING))
 
+RUN_CLOUD_LOAD_SOURCES = \
+	$(SRC)/net/SocketError.cxx \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(TEST_SRC_DIR)/RunCloudLoad.cpp
+RUN_CLOUD_LOAD_DEPENDS = ASYNC LIBNET OS GEO MATH UTIL
+$(eval $(call link-program,RunCloudLoad,RUN_CLOUD_LOAD))
+
 RUN_LIVETRACK24_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/net/SocketError.cxx \
@@ -1541,6 +1688,19 @@ RUN_CONTEST_SOURCES = \
 RUN_CONTEST_DEPENDS = $(DEBUG_REPLAY_DEPENDS) CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,RunContestAnalysis,RUN_CONTEST))
 
+TEST_CONTEST_PARALLEL_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/TransponderCode.cpp \
+	$(SRC)/Formatter/NMEAFormatter.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestContestParallel.cpp
+TEST_CONTEST_PARALLEL_DEPENDS = $(DEBUG_REPLAY_DEPENDS) CONTEST UTIL GEO MATH TIME
+$(eval $(call link-program,TestContestParallel,TEST_CONTEST_PARALLEL))
+
 RUN_WAVE_COMPUTER_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Computer/WaveComputer.cpp \
@@ -1554,6 +1714,51 @@ RUN_WAVE_COMPUTER_SOURCES = \
 RUN_WAVE_COMPUTER_DEPENDS = $(DEBUG_REPLAY_DEPENDS) UTIL GEO MATH TIME
 $(eval $(call link-program,RunWaveComputer,RUN_WAVE_COMPUTER))
 
+BENCHMARK_GLIDE_COMPUTER_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/TransponderCode.cpp \
+	$(SRC)/Formatter/NMEAFormatter.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Vector.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
+	$(ENGINE_SRC_DIR)/Util/Gradient.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/TeamCode/TeamCode.cpp \
+	$(SRC)/TeamCode/Settings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(ENGINE_SRC_DIR)/GlideSolvers/GlideSettings.cpp \
+	$(TEST_SRC_DIR)/FakeProfile.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/BenchmarkGlideComputer.cpp
+BENCHMARK_GLIDE_COMPUTER_DEPENDS = \
+	LIBCOMPUTER TERRAIN \
+	CONTEST TASK ROUTE GLIDE AIRSPACE WAYPOINT \
+	$(DEBUG_REPLAY_DEPENDS) \
+	LIBNMEA ZZIP UTIL GEO MATH TIME
+$(eval $(call link-program,BenchmarkGlideComputer,BENCHMARK_GLIDE_COMPUTER))
+
+# Replay the IGC files in BENCH_IGC_FILES through the GlideComputer
+# and write per-subsystem timings to $(OUT)/bench.json
+BENCH_IGC_FILES ?= $(wildcard $(topdir)/test/data/*.igc)
+
+bench: $(call name-to-bin,BenchmarkGlideComputer) | $(OUT)/test/dirstamp
+	@$(NQ)echo "  BENCH   $(OUT)/bench.json"
+	$(Q)$< --json $(BENCH_IGC_FILES) >$(OUT)/bench.json.tmp
+	$(Q)mv $(OUT)/bench.json.tmp $(OUT)/bench.json
+
 ANALYSE_FLIGHT_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/NMEA/Aircraft.cpp \
@@ -1720,6 +1925,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Waypoint/HomeGlue.cpp \
 	$(SRC)/Waypoint/LastUsed.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/Factory.cpp \
 	$(SRC)/Compatibility/fmode.c \
 	$(SRC)/RadioFrequency.cpp \
@@ -2128,6 +2334,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Renderer/AirspaceRendererSettings.cpp \
@@ -2272,6 +2479,7 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Formatter/Units.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/Factory.cpp \
 	$(TEST_SRC_DIR)/FakeAsset.cpp \
 	$(TEST_SRC_DIR)/FakeDialogs.cpp \
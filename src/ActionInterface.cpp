@@ -54,7 +54,7 @@ XCSoarInterface::ReceiveCalculated() noexcept
     auto &device_blackboard = *backend_components->device_blackboard;
     const std::lock_guard lock{device_blackboard.mutex};
 
-    ReadBlackboardCalculated(device_blackboard.Calculated());
+    ReadBlackboardCalculated(device_blackboard.GetCalculatedSnapshot());
     device_blackboard.ReadComputerSettings(GetComputerSettings());
   }
 
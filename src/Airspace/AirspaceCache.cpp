@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/Reader.hxx"
+#include "system/Path.hpp"
+#include "LogFile.hpp"
+#include "util/StringAPI.hxx"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CacheHeader {
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  /**
+   * The length of the source path (in characters) which follows
+   * this header.
+   */
+  uint32_t source_length;
+
+  uint32_t n_airspaces;
+};
+
+/**
+ * Describes one airspace.  It is followed by the name and a list of
+ * points: the border of a polygon, or the center of a circle.
+ */
+struct CacheAirspace {
+  AirspaceAltitude base, top;
+
+  /**
+   * The radius of a circle [m]; unused for polygons.
+   */
+  double radius;
+
+  uint32_t name_length;
+  uint32_t n_points;
+
+  AbstractAirspace::Shape shape;
+  AirspaceClass asclass, astype;
+  AirspaceActivity days;
+  RadioFrequency radio_frequency;
+};
+
+static_assert(std::is_trivially_copyable_v<CacheAirspace>);
+
+/* limits to reject corrupt files before allocating memory */
+static constexpr uint32_t MAX_NAME_LENGTH = 4096;
+static constexpr uint32_t MAX_POINTS = 1024 * 1024;
+
+} // anonymous namespace
+
+static void
+WriteString(BufferedOutputStream &os, const TCHAR *s)
+{
+  const std::basic_string_view<TCHAR> sv{s};
+  os.Write(std::as_bytes(std::span{sv}));
+}
+
+static std::basic_string<TCHAR>
+ReadString(BufferedReader &r, std::size_t length)
+{
+  std::basic_string<TCHAR> s(length, TCHAR{});
+  r.ReadFull(std::as_writable_bytes(std::span{s}));
+  return s;
+}
+
+static void
+SaveAirspace(BufferedOutputStream &os, const AbstractAirspace &airspace)
+{
+  CacheAirspace header;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(static_cast<void *>(&header), 0, sizeof(header));
+
+  header.base = airspace.GetBase();
+  header.top = airspace.GetTop();
+  header.name_length = StringLength(airspace.GetName());
+  header.shape = airspace.GetShape();
+  header.asclass = airspace.GetClass();
+  header.astype = airspace.GetType();
+  header.days = airspace.GetDays();
+  header.radio_frequency = airspace.GetRadioFrequency();
+
+  switch (airspace.GetShape()) {
+  case AbstractAirspace::Shape::CIRCLE:
+    header.radius = static_cast<const AirspaceCircle &>(airspace).GetRadius();
+    header.n_points = 1;
+    break;
+
+  case AbstractAirspace::Shape::POLYGON:
+    header.radius = 0;
+    header.n_points = airspace.GetPoints().size();
+    break;
+  }
+
+  os.Write(ReferenceAsBytes(header));
+  WriteString(os, airspace.GetName());
+
+  switch (airspace.GetShape()) {
+  case AbstractAirspace::Shape::CIRCLE:
+    os.WriteT(airspace.GetReferenceLocation());
+    break;
+
+  case AbstractAirspace::Shape::POLYGON:
+    for (const auto &i : airspace.GetPoints())
+      os.WriteT(i.GetLocation());
+    break;
+  }
+}
+
+static AirspacePtr
+LoadAirspace(BufferedReader &r)
+{
+  const auto header = r.ReadFullT<CacheAirspace>();
+  if (header.name_length > MAX_NAME_LENGTH ||
+      header.n_points > MAX_POINTS ||
+      header.asclass >= AIRSPACECLASSCOUNT ||
+      header.astype >= AIRSPACECLASSCOUNT)
+    throw std::runtime_error("Malformed airspace cache");
+
+  auto name = ReadString(r, header.name_length);
+
+  AirspacePtr airspace;
+  switch (header.shape) {
+  case AbstractAirspace::Shape::CIRCLE:
+    if (header.n_points != 1)
+      throw std::runtime_error("Malformed airspace cache");
+
+    airspace = std::make_shared<AirspaceCircle>(r.ReadFullT<GeoPoint>(),
+                                                header.radius);
+    break;
+
+  case AbstractAirspace::Shape::POLYGON:
+    {
+      if (header.n_points < 3)
+        throw std::runtime_error("Malformed airspace cache");
+
+      std::vector<GeoPoint> points(header.n_points);
+      r.ReadFull(std::as_writable_bytes(std::span{points}));
+      airspace = std::make_shared<AirspacePolygon>(points);
+    }
+    break;
+
+  default:
+    throw std::runtime_error("Malformed airspace cache");
+  }
+
+  airspace->SetProperties(std::move(name), header.asclass, header.astype,
+                          header.base, header.top);
+  airspace->SetRadioFrequency(header.radio_frequency);
+  airspace->SetDays(header.days);
+  return airspace;
+}
+
+void
+SaveAirspaceCache(BufferedOutputStream &os, Path source,
+                  const Airspaces &airspaces)
+{
+  const auto &pending = airspaces.GetPending();
+
+  CacheHeader header;
+  header.version = CacheHeader::VERSION;
+  header.source_length = StringLength(source.c_str());
+  header.n_airspaces = pending.size();
+
+  os.Write(ReferenceAsBytes(header));
+  WriteString(os, source.c_str());
+
+  for (const auto &i : pending)
+    SaveAirspace(os, *i);
+}
+
+bool
+LoadAirspaceCache(BufferedReader &r, Path source, Airspaces &airspaces)
+{
+  const auto header = r.ReadFullT<CacheHeader>();
+  if (header.version != CacheHeader::VERSION ||
+      header.source_length > MAX_NAME_LENGTH)
+    throw std::runtime_error("Malformed airspace cache header");
+
+  if (ReadString(r, header.source_length) != source.c_str())
+    return false;
+
+  for (uint32_t i = 0; i < header.n_airspaces; ++i)
+    airspaces.Add(LoadAirspace(r));
+
+  return true;
+}
+
+bool
+LoadAirspaceCache(FileCache &cache, const TCHAR *cache_name, Path path,
+                  Airspaces &airspaces) noexcept
+try {
+  auto r = cache.Load(cache_name, path);
+  if (!r)
+    return false;
+
+  /* load into a temporary container, because a failure in the
+     middle would leave a partial set */
+  Airspaces loaded;
+  BufferedReader buffered_reader{*r};
+  if (!LoadAirspaceCache(buffered_reader, path, loaded))
+    return false;
+
+  for (const auto &i : loaded.GetPending())
+    airspaces.Add(i);
+
+  return true;
+} catch (...) {
+  LogError(std::current_exception(), "Failed to load airspace cache");
+  return false;
+}
+
+void
+SaveAirspaceCache(FileCache &cache, const TCHAR *cache_name, Path path,
+                  const Airspaces &airspaces) noexcept
+try {
+  auto os = cache.Save(cache_name, path);
+  BufferedOutputStream bos(*os);
+  SaveAirspaceCache(bos, path, airspaces);
+  bos.Flush();
+  os->Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save airspace cache");
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Airspace/Airspaces.hpp"
+#include "system/Path.hpp"
+
+#include <tchar.h>
+
+class BufferedOutputStream;
+class BufferedReader;
+class FileCache;
+
+/**
+ * Write a snapshot of the airspaces which were added to the
+ * #Airspaces object, but not yet inserted by Airspaces::Optimise()
+ * (see Airspaces::GetPending()).  The snapshot contains the final
+ * geometry, so loading it does not need to evaluate arcs again.
+ *
+ * Throws on error.
+ *
+ * @param source the path of the file these airspaces were parsed
+ * from; it is stored to detect configuration changes
+ */
+void
+SaveAirspaceCache(BufferedOutputStream &os, Path source,
+                  const Airspaces &airspaces);
+
+/**
+ * Load a snapshot written by SaveAirspaceCache() and add its
+ * airspaces to the given #Airspaces object.  On error, the
+ * #Airspaces object may contain a part of the snapshot.
+ *
+ * Throws on error.
+ *
+ * @return false if the snapshot was created from a different file
+ */
+bool
+LoadAirspaceCache(BufferedReader &r, Path source, Airspaces &airspaces);
+
+/**
+ * Load the snapshot with the given name from the #FileCache, unless
+ * it is older than #path.  Errors are logged.
+ *
+ * @return true if the airspaces were added, false if there is no
+ * valid snapshot (nothing was added)
+ */
+bool
+LoadAirspaceCache(FileCache &cache, const TCHAR *cache_name, Path path,
+                  Airspaces &airspaces) noexcept;
+
+/**
+ * Save a snapshot to the #FileCache.  Errors are logged.
+ */
+void
+SaveAirspaceCache(FileCache &cache, const TCHAR *cache_name, Path path,
+                  const Airspaces &airspaces) noexcept;
+
+/**
+ * Parse an airspace file with the given function, unless there is a
+ * cached copy which is not older than #path.
+ *
+ * Throws on error.  Like without a cache, the airspaces which were
+ * parsed before the error are kept, but they are not cached.
+ *
+ * @param path the file which contains the airspaces (or the ZIP
+ * archive containing it); its modification time and size are used
+ * to validate the cache
+ */
+template<typename F>
+void
+ParseCachedAirspaceFile(Airspaces &airspaces,
+                        FileCache *cache, const TCHAR *cache_name, Path path,
+                        F &&parse)
+{
+  if (cache == nullptr) {
+    parse(airspaces);
+    return;
+  }
+
+  if (LoadAirspaceCache(*cache, cache_name, path, airspaces))
+    return;
+
+  Airspaces parsed;
+  try {
+    parse(parsed);
+  } catch (...) {
+    for (const auto &i : parsed.GetPending())
+      airspaces.Add(i);
+    throw;
+  }
+
+  SaveAirspaceCache(*cache, cache_name, path, parsed);
+
+  for (const auto &i : parsed.GetPending())
+    airspaces.Add(i);
+}
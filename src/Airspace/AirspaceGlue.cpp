@@ -3,6 +3,7 @@
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Atmosphere/Pressure.hpp"
 #include "Profile/Keys.hpp"
@@ -12,6 +13,7 @@
 #include "lib/fmt/PathFormatter.hpp"
 #include "lib/fmt/RuntimeError.hxx"
 #include "system/Path.hpp"
+#include "io/FileCache.hpp"
 #include "io/FileReader.hxx"
 #include "io/ProgressReader.hpp"
 #include "io/BufferedReader.hxx"
@@ -24,18 +26,22 @@
 
 static bool
 ParseAirspaceFile(Airspaces &airspaces, Path path,
+                  FileCache *cache, const TCHAR *cache_name,
                   OperationEnvironment &operation) noexcept
 try {
-  FileReader file_reader{path};
-  ProgressReader progress_reader{file_reader, file_reader.GetSize(), operation};
-  BufferedReader buffered_reader{progress_reader};
+  ParseCachedAirspaceFile(airspaces, cache, cache_name, path,
+                          [&](Airspaces &dest){
+    FileReader file_reader{path};
+    ProgressReader progress_reader{file_reader, file_reader.GetSize(), operation};
+    BufferedReader buffered_reader{progress_reader};
 
-  try {
-    ParseAirspaceFile(airspaces, buffered_reader);
-  } catch (...) {
-    // TODO translate this?
-    std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
-  }
+    try {
+      ParseAirspaceFile(dest, buffered_reader);
+    } catch (...) {
+      // TODO translate this?
+      std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
+    }
+  });
 
   return true;
 } catch (...) {
@@ -47,18 +53,22 @@ try {
 static bool
 ParseAirspaceFile(Airspaces &airspaces,
                   struct zzip_dir *dir, const char *path,
+                  Path archive_path, FileCache *cache,
                   OperationEnvironment &operation)
 try {
-  ZipReader zip_reader{dir, path};
-  ProgressReader progress_reader{zip_reader, zip_reader.GetSize(), operation};
-  BufferedReader buffered_reader{progress_reader};
+  ParseCachedAirspaceFile(airspaces, cache, _T("airspace-map"), archive_path,
+                          [&](Airspaces &dest){
+    ZipReader zip_reader{dir, path};
+    ProgressReader progress_reader{zip_reader, zip_reader.GetSize(), operation};
+    BufferedReader buffered_reader{progress_reader};
 
-  try {
-    ParseAirspaceFile(airspaces, buffered_reader);
-  } catch (...) {
-    // TODO translate this?
-    std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
-  }
+    try {
+      ParseAirspaceFile(dest, buffered_reader);
+    } catch (...) {
+      // TODO translate this?
+      std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
+    }
+  });
 
   return true;
 } catch (...) {
@@ -70,6 +80,7 @@ try {
 void
 ReadAirspace(Airspaces &airspaces,
              AtmosphericPressure press,
+             FileCache *cache,
              OperationEnvironment &operation)
 {
   LogString("ReadAirspace");
@@ -80,17 +91,22 @@ ReadAirspace(Airspaces &airspaces,
   // Read the airspace filenames from the registry
   if (const auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
       path != nullptr)
-    airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
+    airspace_ok |= ParseAirspaceFile(airspaces, path, cache, _T("airspace"),
+                                     operation);
 
   if (const auto path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
       path != nullptr)
-    airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
+    airspace_ok |= ParseAirspaceFile(airspaces, path,
+                                     cache, _T("airspace-additional"),
+                                     operation);
 
   try {
     if (auto archive = OpenMapFile();
         archive && archive->Exists("airspace.txt"))
       airspace_ok |= ParseAirspaceFile(airspaces, archive->get(),
-                                       "airspace.txt", operation);
+                                       "airspace.txt",
+                                       Profile::GetPath(ProfileKeys::MapFile),
+                                       cache, operation);
   } catch (...) {
     LogError(std::current_exception(),
              "Failed to load airspaces from map file");
@@ -8,12 +8,14 @@
 
 #include <algorithm>
 #include <limits>
-#include <type_traits>
-#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
 /* Algorithms for processing audio data */
 
 /**
@@ -48,23 +50,139 @@ constexpr int16_t Clip(int32_t value) noexcept {
 }
 
 /**
- * Mix PCM data from a data source (which is read using the provided source
- * reader function) to a destination buffer (which already contains PCM data).
+ * Convert a volume level below 100 percent to a Q15 fixed-point gain
+ * factor.  Multiplying with it avoids a division per sample, and it
+ * maps directly to the saturating multiply instructions of SIMD
+ * units.  Q15 cannot represent 1.0, therefore the callers copy the
+ * samples as-is at full volume.
+ */
+constexpr int16_t VolumeToGain(unsigned vol_percent) noexcept {
+  assert(vol_percent < 100);
+
+  return static_cast<int16_t>(vol_percent * 0x8000 / 100);
+}
+
+/**
+ * Multiply a sample with a Q15 gain factor (see VolumeToGain()).
+ */
+constexpr int16_t ApplyGain(int16_t sample, int16_t gain) noexcept {
+  return static_cast<int16_t>((static_cast<int32_t>(sample) * gain) >> 15);
+}
+
+constexpr int16_t ByteSwapSample(int16_t sample) noexcept {
+  return static_cast<int16_t>(
+      GenericByteSwap16(static_cast<uint16_t>(sample)));
+}
+
+#ifdef __ARM_NEON__
+
+/**
+ * NEON implementation of ScalePCMKernel() for a multiple of 8
+ * samples.  vqdmulh calculates (2*a*b)>>16, which is exactly
+ * ApplyGain(); the scalar and NEON results are bit-identical.
  *
- * The audio volume is lowered to the given percentage value.
+ * @return the number of processed samples
+ */
+template<bool byte_swap>
+inline size_t NEONScalePCM(int16_t *buffer, size_t n, int16_t gain) noexcept {
+  const size_t n8 = n & ~size_t(7);
+
+  for (size_t i = 0; i < n8; i += 8) {
+    int16x8_t v = vld1q_s16(buffer + i);
+    if constexpr (byte_swap)
+      v = vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_s16(v)));
+    vst1q_s16(buffer + i, vqdmulhq_n_s16(v, gain));
+  }
+
+  return n8;
+}
+
+/**
+ * NEON implementation of MixPCMKernel() for a multiple of 8 samples.
  *
- * Performs cipping, if necessary.
+ * @return the number of processed samples
  */
-template<typename SrcReadFuncT>
-inline void MixPCM(int16_t *dest, size_t num_frames,
-                   unsigned vol_percent, SrcReadFuncT src_reader) {
-  if (0 == vol_percent) {
-    std::fill(dest, dest + num_frames, 0);
-    return;
+template<bool byte_swap>
+inline size_t NEONMixPCM(int16_t *gcc_restrict dest,
+                         const int16_t *gcc_restrict src,
+                         size_t n, int16_t gain) noexcept {
+  const size_t n8 = n & ~size_t(7);
+
+  for (size_t i = 0; i < n8; i += 8) {
+    int16x8_t v = vld1q_s16(src + i);
+    if constexpr (byte_swap)
+      v = vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_s16(v)));
+    vst1q_s16(dest + i, vqaddq_s16(vld1q_s16(dest + i),
+                                   vqdmulhq_n_s16(v, gain)));
   }
 
-  for (size_t i = 0; i < num_frames; ++i) {
-    dest[i] += Clip(src_reader(i) * static_cast<int32_t>(vol_percent) / 100);
+  return n8;
+}
+
+#endif
+
+/**
+ * Multiply all samples with a Q15 gain factor, optionally
+ * byte-swapping them first.
+ */
+template<bool byte_swap>
+inline void ScalePCMKernel(int16_t *buffer, size_t n, int16_t gain) noexcept {
+  size_t i = 0;
+#ifdef __ARM_NEON__
+  i = NEONScalePCM<byte_swap>(buffer, n, gain);
+#endif
+
+  for (; i < n; ++i) {
+    int16_t sample = buffer[i];
+    if constexpr (byte_swap)
+      sample = ByteSwapSample(sample);
+    buffer[i] = ApplyGain(sample, gain);
+  }
+}
+
+/**
+ * Multiply all source samples with a Q15 gain factor and add them to
+ * the destination with saturation, optionally byte-swapping the
+ * source samples first.
+ */
+template<bool byte_swap>
+inline void MixPCMKernel(int16_t *gcc_restrict dest,
+                         const int16_t *gcc_restrict src,
+                         size_t n, int16_t gain) noexcept {
+  size_t i = 0;
+#ifdef __ARM_NEON__
+  i = NEONMixPCM<byte_swap>(dest, src, n, gain);
+#endif
+
+  for (; i < n; ++i) {
+    int16_t sample = src[i];
+    if constexpr (byte_swap)
+      sample = ByteSwapSample(sample);
+    dest[i] = Clip(static_cast<int32_t>(dest[i]) + ApplyGain(sample, gain));
+  }
+}
+
+/**
+ * Byte-swap all samples.
+ */
+inline void ByteSwapPCM(int16_t *buffer, size_t n) noexcept {
+  for (size_t i = 0; i < n; ++i)
+    buffer[i] = ByteSwapSample(buffer[i]);
+}
+
+/**
+ * Add all source samples to the destination with saturation,
+ * optionally byte-swapping the source samples first.
+ */
+template<bool byte_swap>
+inline void AddPCMKernel(int16_t *gcc_restrict dest,
+                         const int16_t *gcc_restrict src,
+                         size_t n) noexcept {
+  for (size_t i = 0; i < n; ++i) {
+    int16_t sample = src[i];
+    if constexpr (byte_swap)
+      sample = ByteSwapSample(sample);
+    dest[i] = Clip(static_cast<int32_t>(dest[i]) + sample);
   }
 }
 
@@ -72,29 +190,39 @@ inline void MixPCM(int16_t *dest, size_t num_frames,
  * Mix PCM data from a given data source to a destination buffer
  * (which already contains PCM data).
  *
- * Performs cipping, if necessary.
+ * The audio volume of the source is lowered to the given percentage
+ * value.
+ *
+ * Performs clipping, if necessary.
  */
 inline void MixPCM(int16_t *dest, const int16_t *src, size_t num_frames,
                    unsigned vol_percent) {
-  MixPCM(dest, num_frames, vol_percent, [&src](size_t i) { return src[i]; });
+  if (vol_percent >= 100) {
+    AddPCMKernel<false>(dest, src, num_frames);
+    return;
+  }
+
+  MixPCMKernel<false>(dest, src, num_frames, VolumeToGain(vol_percent));
 }
 
 /**
  * Mix PCM data from a given data source to a destination buffer
  * (which already contains PCM data). The data which is read from the source
- * buffer is and byte-swapped.
+ * buffer is byte-swapped.
  *
  * Use this function, if the source is big endian and the destination
  * is little endian, or vice versa.
  *
- * Performs cipping, if necessary.
+ * Performs clipping, if necessary.
  */
 inline void ByteSwapAndMixPCM(int16_t *dest, const int16_t *src,
                               size_t num_frames, unsigned vol_percent) {
-  MixPCM(dest, num_frames, vol_percent,
-         [&src](size_t i) {
-           return static_cast<int32_t>(GenericByteSwap16(src[i]));
-         });
+  if (vol_percent >= 100) {
+    AddPCMKernel<true>(dest, src, num_frames);
+    return;
+  }
+
+  MixPCMKernel<true>(dest, src, num_frames, VolumeToGain(vol_percent));
 }
 
 /**
@@ -102,16 +230,10 @@ inline void ByteSwapAndMixPCM(int16_t *dest, const int16_t *src,
  */
 inline void LowerVolume(int16_t *buffer, size_t num_frames,
                         unsigned vol_percent) {
-  if (0 == vol_percent) {
-    std::fill(buffer, buffer + num_frames, 0);
+  if (vol_percent >= 100)
     return;
-  }
 
-  for (size_t i = 0; i < num_frames; ++i) {
-    buffer[i] =
-        static_cast<int16_t>(
-            (static_cast<int32_t>(vol_percent) * buffer[i]) / 100);
-  }
+  ScalePCMKernel<false>(buffer, num_frames, VolumeToGain(vol_percent));
 }
 
 /**
@@ -120,16 +242,10 @@ inline void LowerVolume(int16_t *buffer, size_t num_frames,
  */
 inline void ByteSwapAndLowerVolume(int16_t *buffer, size_t num_frames,
                                    unsigned vol_percent) {
-  if (0 == vol_percent) {
-    std::fill(buffer, buffer + num_frames, 0);
+  if (vol_percent >= 100) {
+    ByteSwapPCM(buffer, num_frames);
     return;
   }
 
-  for (size_t i = 0; i < num_frames; ++i) {
-    buffer[i] =
-        static_cast<int16_t>(
-            static_cast<int32_t>(vol_percent) *
-                static_cast<int32_t>(GenericByteSwap16(buffer[i])) /
-                100);
-  }
+  ScalePCMKernel<true>(buffer, num_frames, VolumeToGain(vol_percent));
 }
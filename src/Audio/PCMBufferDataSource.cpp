@@ -25,6 +25,13 @@ PCMBufferDataSource::Clear()
   queued_data.clear();
 }
 
+bool
+PCMBufferDataSource::IsEmpty()
+{
+  const std::lock_guard protect{lock};
+  return queued_data.empty();
+}
+
 size_t
 PCMBufferDataSource::GetData(int16_t *buffer, size_t n)
 {
@@ -39,6 +39,11 @@ public:
    */
   void Clear();
 
+  /**
+   * Has all queued data been played?
+   */
+  bool IsEmpty();
+
   /* virtual methods from class PCMDataSource */
   bool IsBigEndian() const override {
     return false; // Our PCM resources are always little endian
@@ -15,11 +15,22 @@
  * must always be the same, because resampling is not supported yet.
  */
 class PCMMixerDataSource : public PCMDataSource {
-  static constexpr unsigned MAX_MIXER_SOURCES_COUNT = 2;
+  /**
+   * The vario tone plus up to three sounds (see #PCMResourcePlayer).
+   */
+  static constexpr unsigned MAX_MIXER_SOURCES_COUNT = 4;
+
+  /**
+   * The number of sources which usually play at the same time: the
+   * vario tone and one sound.  The mixer saturates, so more
+   * sources at high volume levels are clipped, but they do not wrap
+   * around.
+   */
+  static constexpr unsigned SAFE_MIXER_SOURCES_COUNT = 2;
 
   const unsigned sample_rate;
 
-  unsigned vol_percent = 100 / MAX_MIXER_SOURCES_COUNT;
+  unsigned vol_percent = 100 / SAFE_MIXER_SOURCES_COUNT;
 
   PCMDataSource *sources[MAX_MIXER_SOURCES_COUNT] = {};
 
@@ -56,10 +67,11 @@ public:
 
   /**
    * Get max volume value which is "safe". No clipping artifacts
-   * can occur up to this volume level.
+   * can occur up to this volume level while no more than
+   * #SAFE_MIXER_SOURCES_COUNT sources are being played.
    */
   static constexpr unsigned GetMaxSafeVolume() {
-    return 100 / MAX_MIXER_SOURCES_COUNT;
+    return 100 / SAFE_MIXER_SOURCES_COUNT;
   }
 
   /* virtual methods from class PCMDataSource */
@@ -11,9 +11,10 @@
 
 #include <utility>
 
-PCMResourcePlayer::PCMResourcePlayer() :
-    player(PCMPlayerFactory::CreateInstance())
+PCMResourcePlayer::PCMResourcePlayer()
 {
+  for (auto &voice : voices)
+    voice.player.reset(PCMPlayerFactory::CreateInstance());
 }
 
 bool
@@ -29,9 +30,19 @@ PCMResourcePlayer::PlayResource(const TCHAR *resource_name)
 
   const std::lock_guard protect{lock};
 
-  if (1 == buffer_data_source.Add(std::move(pcm_data))) {
-    if (!player->Start(buffer_data_source)) {
-      buffer_data_source.Clear();
+  /* use the first idle voice; if all are busy, queue the sound
+     after the one playing on the first voice */
+  Voice *voice = &voices.front();
+  for (auto &i : voices) {
+    if (i.buffer_data_source.IsEmpty()) {
+      voice = &i;
+      break;
+    }
+  }
+
+  if (1 == voice->buffer_data_source.Add(std::move(pcm_data))) {
+    if (!voice->player->Start(voice->buffer_data_source)) {
+      voice->buffer_data_source.Clear();
       return false;
     }
   }
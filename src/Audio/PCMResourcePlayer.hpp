@@ -9,17 +9,28 @@
 #include "thread/Mutex.hxx"
 
 #include <tchar.h>
+#include <array>
 #include <memory>
 
 /**
  * Can play sounds, stored as raw PCM in an embedded resource, using #PCMPlayer
+ *
+ * Up to #MAX_VOICES sounds (e.g. a FLARM alert and an airspace
+ * warning) are played at the same time, each by its own #PCMPlayer.
+ * More sounds are queued.
  */
 class PCMResourcePlayer {
-  Mutex lock;
+  static constexpr unsigned MAX_VOICES = 3;
+
+  struct Voice {
+    std::unique_ptr<PCMPlayer> player;
 
-  std::unique_ptr<PCMPlayer> player;
+    PCMBufferDataSource buffer_data_source;
+  };
+
+  Mutex lock;
 
-  PCMBufferDataSource buffer_data_source;
+  std::array<Voice, MAX_VOICES> voices;
 
 public:
   PCMResourcePlayer();
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "ToneSynthesiser.hpp"
+#include "AudioAlgorithms.hpp"
 #include "Math/FastTrig.hpp"
 
 #include <cassert>
@@ -17,10 +18,19 @@ ToneSynthesiser::Synthesise(int16_t *buffer, size_t n)
 {
   assert(angle < ISINETABLE.size());
 
-  for (int16_t *end = buffer + n; buffer != end; ++buffer) {
-    *buffer = ISINETABLE[angle] * (32767 / 1024) * (int)volume / 100;
-    angle = (angle + increment) & (ISINETABLE.size() - 1);
+  /* the table lookup cannot be vectorised (there is no NEON
+     "gather" instruction), so this loop does only that, and the
+     volume is applied by a separate SIMD pass */
+  const unsigned mask = ISINETABLE.size() - 1;
+  unsigned a = angle;
+  for (size_t i = 0; i < n; ++i) {
+    buffer[i] = ISINETABLE[a] * (32767 / 1024);
+    a = (a + increment) & mask;
   }
+
+  angle = a;
+
+  LowerVolume(buffer, n, volume);
 }
 
 unsigned
@@ -6,6 +6,8 @@
 #include "PCMPlayerFactory.hpp"
 #include "VarioSynthesiser.hpp"
 #include "VarioSettings.hpp"
+#include "LogFile.hpp"
+#include "thread/Mutex.hxx"
 
 #ifdef ANDROID
 #include "SLES/Init.hpp"
@@ -15,6 +17,31 @@
 
 static constexpr unsigned sample_rate = 44100;
 
+/**
+ * After this duration without SetDeviceValue(), SetValue() takes
+ * over again.
+ */
+static constexpr std::chrono::seconds device_value_timeout{2};
+
+static constexpr unsigned NO_DEVICE = ~0u;
+
+/**
+ * Arbitrates between SetValue() and SetDeviceValue(), which are
+ * called by different threads.  This is never locked by the audio
+ * thread.
+ */
+static Mutex device_mutex;
+
+static bool allow_device_values = true;
+
+/**
+ * The device which delivered the most recent SetDeviceValue() call,
+ * or #NO_DEVICE.
+ */
+static unsigned value_device = NO_DEVICE;
+
+static VarioSynthesiser::Clock::time_point value_device_time;
+
 #ifdef ANDROID
 static bool have_sles;
 #endif
@@ -51,6 +78,14 @@ AudioVarioGlue::Initialise()
 void
 AudioVarioGlue::Deinitialise()
 {
+  if (synthesiser != nullptr) {
+    const auto latency = synthesiser->GetLatencyStatistics();
+    if (latency.count > 0)
+      LogFormat("Vario sound latency: %u tone changes, average %u us, max %u us",
+                latency.count, (unsigned)latency.GetAverage().count(),
+                (unsigned)latency.max.count());
+  }
+
   delete player;
   player = nullptr;
   delete synthesiser;
@@ -91,9 +126,54 @@ AudioVarioGlue::SetValue(double vario)
   assert(player != nullptr);
   assert(synthesiser != nullptr);
 
+  {
+    const std::lock_guard lock{device_mutex};
+    if (value_device != NO_DEVICE &&
+        VarioSynthesiser::Clock::now() - value_device_time < device_value_timeout)
+      /* a device delivers values directly */
+      return;
+  }
+
   synthesiser->SetVario(vario);
 }
 
+void
+AudioVarioGlue::SetDeviceValue(unsigned device, double vario)
+{
+  assert(device != NO_DEVICE);
+
+  if (synthesiser == nullptr)
+    /* not initialised or no audio on this platform */
+    return;
+
+  const auto now = VarioSynthesiser::Clock::now();
+
+  {
+    const std::lock_guard lock{device_mutex};
+    if (!allow_device_values)
+      return;
+
+    if (device > value_device &&
+        now - value_device_time < device_value_timeout)
+      /* a device with higher priority delivers values */
+      return;
+
+    value_device = device;
+    value_device_time = now;
+  }
+
+  synthesiser->SetVario(vario, now);
+}
+
+void
+AudioVarioGlue::AllowDeviceValues(bool allow)
+{
+  const std::lock_guard lock{device_mutex};
+  allow_device_values = allow;
+  if (!allow)
+    value_device = NO_DEVICE;
+}
+
 void
 AudioVarioGlue::NoValue()
 {
@@ -105,5 +185,10 @@ AudioVarioGlue::NoValue()
   assert(player != nullptr);
   assert(synthesiser != nullptr);
 
+  {
+    const std::lock_guard lock{device_mutex};
+    value_device = NO_DEVICE;
+  }
+
   synthesiser->SetSilence();
 }
@@ -27,12 +27,32 @@ namespace AudioVarioGlue {
   void Configure(const VarioSoundSettings &settings);
 
   /**
-   * Update the vario value.
+   * Update the vario value from the merged sensor data.  This is
+   * ignored while a device delivers values to SetDeviceValue().
    *
    * @param vario the current vario value [m/s]
    */
   void SetValue(double vario);
 
+  /**
+   * Update the vario value directly from a device's parser, without
+   * waiting for the MergeThread.  If several devices deliver vario
+   * values, the one with the lowest index wins (like
+   * NMEAInfo::Complement() does in DeviceBlackboard::Merge()).
+   *
+   * This method is thread-safe.
+   *
+   * @param device the device index
+   * @param vario the total energy vario value [m/s]
+   */
+  void SetDeviceValue(unsigned device, double vario);
+
+  /**
+   * Shall SetDeviceValue() be accepted?  The MergeThread disables
+   * it while the merged data comes from a replay or the simulator.
+   */
+  void AllowDeviceValues(bool allow);
+
   /**
    * Declare that no vario value is known (e.g. when connection to all
    * devices is lost).  Vario sound will be shut off until vario
@@ -51,6 +71,9 @@ namespace AudioVarioGlue {
   static inline void Deinitialise() {}
   static inline void Configure([[maybe_unused]] const VarioSoundSettings &settings) {}
   static inline void SetValue([[maybe_unused]] double vario) {}
+  static inline void SetDeviceValue([[maybe_unused]] unsigned device,
+                                    [[maybe_unused]] double vario) {}
+  static inline void AllowDeviceValues([[maybe_unused]] bool allow) {}
   static inline void NoValue() {}
   static inline bool HaveAudioVario() { return false; }
 #endif
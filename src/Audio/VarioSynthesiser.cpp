@@ -22,7 +22,7 @@ VarioSynthesiser::VarioToFrequency(int ivario)
 }
 
 void
-VarioSynthesiser::SetVario(double vario)
+VarioSynthesiser::SetVario(double vario, Clock::time_point time)
 {
   const std::lock_guard lock{mutex};
 
@@ -34,8 +34,9 @@ VarioSynthesiser::SetVario(double vario)
     return;
   }
 
-  /* update the ToneSynthesiser base class */
-  SetTone(VarioToFrequency(ivario));
+  Parameters &p = parameters.GetBack();
+  p.frequency = VarioToFrequency(ivario);
+  p.time = time;
 
   if (ivario > 0) {
     /* while climbing, the vario sound gets interrupted by silence
@@ -46,22 +47,15 @@ VarioSynthesiser::SetVario(double vario)
          * (max_period_ms - min_period_ms) / max_vario)
       / 1000;
 
-    silence_count = period_ms / 3;
-    audible_count = period_ms - silence_count;
-
-    /* preserve the old "_remaining" values as much as possible, to
-       avoid chopping off the previous tone */
-
-    if (audible_remaining > audible_count)
-      audible_remaining = audible_count;
-
-    if (silence_remaining > silence_count)
-      silence_remaining = silence_count;
+    p.silence_count = period_ms / 3;
+    p.audible_count = period_ms - p.silence_count;
   } else {
     /* continuous tone while sinking */
-    audible_count = 1;
-    silence_count = 0;
+    p.audible_count = 1;
+    p.silence_count = 0;
   }
+
+  parameters.Publish();
 }
 
 void
@@ -74,23 +68,80 @@ VarioSynthesiser::SetSilence()
 void
 VarioSynthesiser::UnsafeSetSilence()
 {
-  audible_count = 0;
-  silence_count = 1;
+  Parameters &p = parameters.GetBack();
+  p.audible_count = 0;
+  p.silence_count = 1;
+  p.time = Clock::now();
+  parameters.Publish();
+}
+
+void
+VarioSynthesiser::Apply(const Parameters &p) noexcept
+{
+  audible_count = p.audible_count;
+  silence_count = p.silence_count;
+
+  if (audible_count == 0) {
+    /* silence */
+
+    if (audible_remaining > 0)
+      /* quit the current period as early as possible; the method
+         Synthesise() will take care for finishing the current sine
+         wave to avoid clicking noise */
+      audible_remaining = 1;
+
+    silence_remaining = 0;
+    return;
+  }
+
+  /* update the ToneSynthesiser base class */
+  SetTone(p.frequency);
+
+  if (silence_count > 0) {
+    /* preserve the old "_remaining" values as much as possible, to
+       avoid chopping off the previous tone */
 
-  if (audible_remaining > 0)
-    /* quit the current period as early as possible; the method
-       Synthesise() will take care for finishing the current sine
-       wave to avoid clicking noise */
-    audible_remaining = 1;
+    if (audible_remaining > audible_count)
+      audible_remaining = audible_count;
 
-  silence_remaining = 0;
+    if (silence_remaining > silence_count)
+      silence_remaining = silence_count;
+  }
+
+  AddLatency(Clock::now() - p.time);
 }
 
+void
+VarioSynthesiser::AddLatency(Clock::duration latency) noexcept
+{
+  const uint_least32_t us =
+    std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+
+  latency_last_us.store(us, std::memory_order_relaxed);
+  if (us > latency_max_us.load(std::memory_order_relaxed))
+    latency_max_us.store(us, std::memory_order_relaxed);
+  latency_total_us.fetch_add(us, std::memory_order_relaxed);
+  latency_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+VarioSynthesiser::LatencyStatistics
+VarioSynthesiser::GetLatencyStatistics() const noexcept
+{
+  using std::chrono::microseconds;
+
+  LatencyStatistics s;
+  s.count = latency_count.load(std::memory_order_relaxed);
+  s.last = microseconds(latency_last_us.load(std::memory_order_relaxed));
+  s.max = microseconds(latency_max_us.load(std::memory_order_relaxed));
+  s.total = microseconds(latency_total_us.load(std::memory_order_relaxed));
+  return s;
+}
 
 void
 VarioSynthesiser::Synthesise(int16_t *buffer, size_t n)
 {
-  const std::lock_guard lock{mutex};
+  if (parameters.Consume())
+    Apply(parameters.GetFront());
 
   assert(audible_count > 0 || silence_count > 0);
 
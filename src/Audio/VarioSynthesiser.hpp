@@ -5,17 +5,73 @@
 
 #include "ToneSynthesiser.hpp"
 #include "thread/Mutex.hxx"
+#include "thread/TripleBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
 
 /**
  * This class generates vario sound.
+ *
+ * The audio thread never waits for a lock: SetVario() and
+ * SetSilence() calculate new #Parameters and pass them through a
+ * #TripleBuffer, and Synthesise() picks up the most recent version
+ * at the beginning of each buffer.
  */
 class VarioSynthesiser final : public ToneSynthesiser {
+public:
+  using Clock = std::chrono::steady_clock;
+
   /**
-   * This mutex protects all atttributes below.  It is locked
-   * automatically by all public methods.
+   * Statistics about the time from a SetVario() call until the
+   * first Synthesise() call which plays the new tone.  The time the
+   * synthesised samples spend in the audio output buffer comes on
+   * top of this.
+   */
+  struct LatencyStatistics {
+    unsigned count;
+
+    std::chrono::microseconds last, max, total;
+
+    std::chrono::microseconds GetAverage() const noexcept {
+      return count > 0 ? total / count : std::chrono::microseconds{};
+    }
+  };
+
+private:
+  /**
+   * The tone parameters calculated by SetVario() or SetSilence().
+   */
+  struct Parameters {
+    /**
+     * The tone frequency; ignored if #audible_count is zero.
+     */
+    unsigned frequency;
+
+    /**
+     * The new values for VarioSynthesiser::audible_count and
+     * VarioSynthesiser::silence_count.  If #audible_count is zero,
+     * then this is a SetSilence() call.
+     */
+    size_t audible_count, silence_count;
+
+    /**
+     * The time of the vario sample, for #LatencyStatistics.
+     */
+    Clock::time_point time;
+  };
+
+  /**
+   * Serialises the producers, i.e. SetVario(), SetSilence() and the
+   * configuration setters, and protects the configuration attributes
+   * below.  Synthesise() does not lock it.
    */
   Mutex mutex;
 
+  TripleBuffer<Parameters> parameters;
+
+  /* the following attributes are only used by the audio thread */
+
   /**
    * The number of audible samples in each period.
    */
@@ -34,6 +90,13 @@ class VarioSynthesiser final : public ToneSynthesiser {
    */
   size_t audible_remaining, silence_remaining;
 
+  std::atomic<uint_least32_t> latency_count{0};
+  std::atomic<uint_least32_t> latency_last_us{0}, latency_max_us{0};
+  std::atomic<uint_least64_t> latency_total_us{0};
+
+  /* the following configuration attributes are protected by
+     #mutex */
+
   bool dead_band_enabled;
 
   /**
@@ -82,8 +145,10 @@ public:
    * a new "silence" rate (for positive vario values).
    *
    * @param vario the current vario value [m/s]
+   * @param time the time the value was received, for
+   * GetLatencyStatistics()
    */
-  void SetVario(double vario);
+  void SetVario(double vario, Clock::time_point time=Clock::now());
 
   /**
    * Produce silence from now on.
@@ -94,6 +159,7 @@ public:
    * Enable/disable the dead band silence
    */
   void SetDeadBand(bool enabled) {
+    const std::lock_guard lock{mutex};
     dead_band_enabled = enabled;
   }
 
@@ -101,6 +167,7 @@ public:
    * Set the base frequencies for minimum, zero and maximum lift
    */
   void SetFrequencies(unsigned min, unsigned zero, unsigned max) {
+    const std::lock_guard lock{mutex};
     min_frequency = min;
     zero_frequency = zero;
     max_frequency = max;
@@ -110,6 +177,7 @@ public:
    * Set the time periods for minimum and maximum lift
    */
   void SetPeriods(unsigned min, unsigned max) {
+    const std::lock_guard lock{mutex};
     min_period_ms = min;
     max_period_ms = max;
   }
@@ -118,19 +186,33 @@ public:
    * Set the vario range of the "dead band" during which no sound is emitted
    */
   void SetDeadBandRange(double min, double max) {
+    const std::lock_guard lock{mutex};
     min_dead = (int)(min * 100);
     max_dead = (int)(max * 100);
   }
 
+  /**
+   * This method is thread-safe.
+   */
+  LatencyStatistics GetLatencyStatistics() const noexcept;
+
   /* methods from class PCMSynthesiser */
   virtual void Synthesise(int16_t *buffer, size_t n);
 
 private:
   /**
-   * Same as SetSilence(), but doesn't lock the mutex.
+   * Publish new #Parameters which request silence.  Caller must
+   * lock the mutex.
    */
   void UnsafeSetSilence();
 
+  /**
+   * Apply new #Parameters in the audio thread.
+   */
+  void Apply(const Parameters &p) noexcept;
+
+  void AddLatency(Clock::duration latency) noexcept;
+
   /**
    * Convert a vario value to a tone frequency.
    *
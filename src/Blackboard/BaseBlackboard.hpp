@@ -6,14 +6,24 @@
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 
+#include <memory>
+
 /**
  * Base class for blackboards, providing read access to NMEA_INFO and DERIVED_INFO
+ *
+ * The #DerivedInfo is an immutable snapshot: the #CalculationThread
+ * publishes a new one after each iteration, and all blackboards which
+ * read it share the same object instead of copying it.
  */
 class BaseBlackboard
 {
 protected:
   MoreData gps_info;
-  DerivedInfo calculated_info;
+
+  /**
+   * The current #DerivedInfo snapshot; never nullptr.
+   */
+  std::shared_ptr<const DerivedInfo> calculated_info = MakeCalculated();
 
 public:
   // all blackboards can be read as const
@@ -21,7 +31,25 @@ public:
     return gps_info;
   }
 
-  constexpr const DerivedInfo& Calculated() const noexcept {
+  const DerivedInfo& Calculated() const noexcept {
+    return *calculated_info;
+  }
+
+  /**
+   * Returns the snapshot behind Calculated(), to be passed to
+   * another blackboard.
+   */
+  const std::shared_ptr<const DerivedInfo> &GetCalculatedSnapshot() const noexcept {
     return calculated_info;
   }
+
+  /**
+   * Create a new snapshot which is initialised with
+   * DerivedInfo::Reset().
+   */
+  static std::shared_ptr<const DerivedInfo> MakeCalculated() {
+    auto calculated = std::make_shared<DerivedInfo>();
+    calculated->Reset();
+    return calculated;
+  }
 };
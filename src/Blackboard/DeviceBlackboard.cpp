@@ -13,9 +13,8 @@
  */
 DeviceBlackboard::DeviceBlackboard() noexcept
 {
-  // Clear the gps_info and calculated_info
+  // Clear the gps_info (calculated_info is initialised by BaseBlackboard)
   gps_info.Reset();
-  calculated_info.Reset();
 
   // Set GPS assumed time to system time
   gps_info.UpdateClock();
@@ -23,6 +22,8 @@ DeviceBlackboard::DeviceBlackboard() noexcept
   gps_info.time = TimeStamp{gps_info.date_time_utc.DurationSinceMidnight()};
 
   std::fill(per_device_data.begin(), per_device_data.end(), gps_info);
+  for (auto &i : staging)
+    i.working = gps_info;
 
   real_data = simulator_data = replay_data = gps_info;
 
@@ -48,9 +49,13 @@ DeviceBlackboard::SetStartupLocation(const GeoPoint &loc,
   if (Calculated().flight.flying)
     return;
 
-  for (auto &i : per_device_data)
-    if (!i.location_available)
-      i.SetFakeLocation(loc, alt);
+  for (auto &i : staging) {
+    const std::lock_guard device_lock{i.mutex};
+    if (!i.working.location_available) {
+      i.working.SetFakeLocation(loc, alt);
+      i.Publish();
+    }
+  }
 
   if (!real_data.location_available)
     real_data.SetFakeLocation(loc, alt);
@@ -156,18 +161,26 @@ DeviceBlackboard::SetAltitude(double val) noexcept
 void
 DeviceBlackboard::ExpireWallClock() noexcept
 {
-  const std::lock_guard lock{mutex};
-  if (!Basic().alive)
-    return;
+  {
+    const std::lock_guard lock{mutex};
+    if (!Basic().alive)
+      return;
+  }
 
+  /* expire the working copies: the NMEA parser continues with them,
+     and the next Merge() would copy stale data back to
+     #per_device_data */
   bool modified = false;
-  for (auto &basic : per_device_data) {
-    if (!basic.alive)
+  for (auto &i : staging) {
+    const std::lock_guard device_lock{i.mutex};
+    if (!i.working.alive)
       continue;
 
-    basic.ExpireWallClock();
-    if (!basic.alive)
+    i.working.ExpireWallClock();
+    if (!i.working.alive) {
+      i.Publish();
       modified = true;
+    }
   }
 
   if (modified)
@@ -180,11 +193,27 @@ DeviceBlackboard::ScheduleMerge() noexcept
   TriggerMergeThread();
 }
 
+void
+DeviceBlackboard::DeviceStaging::Publish() noexcept
+{
+  /* expire old data (e.g. FLARM traffic) here as well, because the
+     working copy is never touched by Merge() */
+  working.UpdateClock();
+  working.Expire();
+
+  buffer.GetBack() = working;
+  buffer.Publish();
+}
+
 void
 DeviceBlackboard::Merge() noexcept
 {
   NMEAInfo &basic = SetBasic();
 
+  for (std::size_t i = 0; i < NUMDEV; ++i)
+    if (staging[i].buffer.Consume())
+      per_device_data[i] = staging[i].buffer.GetFront();
+
   real_data.Reset();
   for (auto &basic : per_device_data) {
     if (!basic.alive)
@@ -8,6 +8,7 @@
 #include "Device/Simulator.hpp"
 #include "Device/Features.hpp"
 #include "thread/Mutex.hxx"
+#include "thread/TripleBuffer.hpp"
 #include "time/WrapClock.hpp"
 
 #include <array>
@@ -28,10 +29,43 @@ class DeviceBlackboard
 {
   friend class MergeThread;
 
+public:
+  /**
+   * The data of one physical device while it is being edited by the
+   * device's thread (see #DeviceDataEditor).  Editing does not need
+   * the blackboard #mutex; the result is passed to Merge() through a
+   * lock-free #TripleBuffer.
+   */
+  struct DeviceStaging {
+    /**
+     * Protects #working and the producer side of #buffer.  It is
+     * usually only locked by the device's I/O thread; other threads
+     * lock it only for rare events (e.g. opening the device).
+     */
+    Mutex mutex;
+
+    /**
+     * The device's current state, which is updated by each NMEA
+     * sentence.  Protected by #mutex.
+     */
+    NMEAInfo working;
+
+    TripleBuffer<NMEAInfo> buffer;
+
+    /**
+     * Pass a copy of #working to Merge().  Caller must lock #mutex.
+     */
+    void Publish() noexcept;
+  };
+
+private:
   Simulator simulator;
 
+  std::array<DeviceStaging, NUMDEV> staging;
+
   /**
-   * Data from each physical device.
+   * Data from each physical device, as picked up from #staging by
+   * the last Merge() call.
    */
   std::array<NMEAInfo, NUMDEV> per_device_data;
 
@@ -62,13 +96,12 @@ public:
   DeviceBlackboard() noexcept;
 
   /**
-   * Reads the given derived_info usually provided by the
-   * GlideComputerBlackboard and saves it to the own Blackboard
-   * @param derived_info Calculated information usually provided
-   * by the GlideComputerBlackboard
+   * Publishes a new snapshot of the calculated information, usually
+   * a copy of the GlideComputerBlackboard's #DerivedInfo.  Readers
+   * which still use the previous snapshot keep it alive.
    */
-  void ReadBlackboard(const DerivedInfo &derived_info) noexcept {
-    calculated_info = derived_info;
+  void ReadBlackboard(std::shared_ptr<const DerivedInfo> &&derived_info) noexcept {
+    calculated_info = std::move(derived_info);
   }
 
   /**
@@ -90,29 +123,31 @@ public:
     return per_device_data[i];
   }
 
-  NMEAInfo &SetRealState(unsigned i) noexcept {
-    return per_device_data[i];
+  DeviceStaging &GetStaging(unsigned i) noexcept {
+    return staging[i];
   }
 
   /**
    * Return a copy of a device's data after updating its clock via
    * NMEAInfo::UpdateClock().  The method takes care for locking and
-   * unlocking the mutex.
+   * unlocking the device's staging mutex.
    */
   NMEAInfo LockGetDeviceDataUpdateClock(unsigned i) noexcept {
-    const std::lock_guard lock{mutex};
-    per_device_data[i].UpdateClock();
-    return per_device_data[i];
+    const std::lock_guard lock{staging[i].mutex};
+    staging[i].working.UpdateClock();
+    return staging[i].working;
   }
 
   /**
    * Overwrites a device's data and schedule the MergeThread.  The
-   * method takes care for locking and unlocking the mutex.
+   * method takes care for locking and unlocking the device's staging
+   * mutex.
    */
   void LockSetDeviceDataScheduleMerge(unsigned i, const NMEAInfo &src) noexcept {
     {
-      const std::lock_guard lock{mutex};
-      per_device_data[i] = src;
+      const std::lock_guard lock{staging[i].mutex};
+      staging[i].working = src;
+      staging[i].Publish();
     }
 
     ScheduleMerge();
@@ -124,6 +159,15 @@ public:
 public:
   const NMEAInfo &RealState() const noexcept { return real_data; }
 
+  /**
+   * Is the merged data taken from the devices, i.e. neither replay
+   * nor simulator is running?  Caller must lock the blackboard.
+   */
+  [[gnu::pure]]
+  bool IsRealDataActive() const noexcept {
+    return !replay_data.alive && !simulator_data.alive;
+  }
+
   /**
    * Is the specified device a FLARM?
    *
@@ -162,7 +206,8 @@ public:
   void ScheduleMerge() noexcept;
 
   /**
-   * Copy real_data or simulator_data or replay_data to gps_info.
+   * Pick up the data published by each device's staging area, and
+   * copy real_data or simulator_data or replay_data to gps_info.
    * Caller must lock the blackboard.
    */
   void Merge() noexcept;
@@ -4,9 +4,17 @@
 #include "InterfaceBlackboard.hpp"
 
 void
-InterfaceBlackboard::ReadBlackboardCalculated(const DerivedInfo &derived_info) noexcept
+InterfaceBlackboard::ReadBlackboardCalculated(std::shared_ptr<const DerivedInfo> derived_info) noexcept
 {
-  calculated_info = derived_info;
+  calculated_info = std::move(derived_info);
+}
+
+void
+InterfaceBlackboard::ReadCommonStats(const CommonStats &common_stats) noexcept
+{
+  auto copy = std::make_shared<DerivedInfo>(*calculated_info);
+  copy->common_stats = common_stats;
+  calculated_info = std::move(copy);
 }
 
 void
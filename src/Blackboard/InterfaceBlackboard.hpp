@@ -9,7 +9,7 @@ class InterfaceBlackboard : public LiveBlackboard
 {
 public:
   void ReadBlackboardBasic(const MoreData &nmea_info) noexcept;
-  void ReadBlackboardCalculated(const DerivedInfo &derived_info) noexcept;
+  void ReadBlackboardCalculated(std::shared_ptr<const DerivedInfo> derived_info) noexcept;
 
   [[gnu::const]]
   SystemSettings &SetSystemSettings() noexcept {
@@ -26,9 +26,11 @@ public:
     return ui_settings;
   }
 
-  inline void ReadCommonStats(const CommonStats &common_stats) noexcept {
-    calculated_info.common_stats = common_stats;
-  }
+  /**
+   * Replace the #CommonStats of the current snapshot; this copies
+   * the snapshot, because it is shared with other blackboards.
+   */
+  void ReadCommonStats(const CommonStats &common_stats) noexcept;
 
   void ReadComputerSettings(const ComputerSettings &settings) noexcept;
 };
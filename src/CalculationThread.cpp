@@ -94,10 +94,13 @@ CalculationThread::Tick() noexcept
 
   // values changed, so copy them back now: ONLY CALCULATED INFO
   // should be changed in DoCalculations, so we only need to write
-  // that one back (otherwise we may write over new data)
+  // that one back (otherwise we may write over new data); this is
+  // the only copy, all readers share this snapshot
+  auto calculated = std::make_shared<const DerivedInfo>(glide_computer.Calculated());
+
   {
     const std::lock_guard lock{device_blackboard.mutex};
-    device_blackboard.ReadBlackboard(glide_computer.Calculated());
+    device_blackboard.ReadBlackboard(std::move(calculated));
   }
 
   // if (new GPS data)
@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright The XCSoar Project
 
-#include "Data.hpp"
+#include "Shard.hpp"
 #include "Dump.hpp"
 #include "Sender.hpp"
 #include "Serialiser.hpp"
@@ -11,6 +11,8 @@
 #include "event/Loop.hxx"
 #include "event/CoarseTimerEvent.hxx"
 #include "event/SignalMonitor.hxx"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
 #include "net/IPv4Address.hxx"
 #include "io/FileOutputStream.hxx"
 #include "io/FileReader.hxx"
@@ -18,10 +20,15 @@
 #include "util/Exception.hxx"
 #include "util/Compiler.h"
 #include "util/ScopeExit.hxx"
+#include "util/NumberParser.hpp"
+#include "util/StaticArray.hxx"
 
+#include <algorithm>
 #include <array>
+#include <forward_list>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 #include <signal.h>
 
@@ -38,54 +45,57 @@ using std::cout;
 using std::cerr;
 using std::endl;
 
+/**
+ * Serialises the log lines written by the #CloudServer instances.
+ */
+static Mutex log_mutex;
+
+/**
+ * Handles requests arriving on one socket.  There may be several
+ * instances running in different threads, sharing one
+ * #CloudShardedData.
+ */
 class CloudServer final
-  : public SkyLinesTracking::Server, CloudData
+  : public SkyLinesTracking::Server
 {
-  const AllocatedPath db_path;
+  CloudShardedData &data;
 
-  CoarseTimerEvent save_timer, expire_timer;
+  /**
+   * The main thread's #EventLoop, which is stopped on fatal errors.
+   */
+  EventLoop &main_loop;
 
 public:
-  CloudServer(AllocatedPath &&_db_path, EventLoop &event_loop,
-              SocketAddress bind_address)
-    :SkyLinesTracking::Server(event_loop, bind_address),
-     db_path(std::move(_db_path)),
-     save_timer(event_loop, BIND_THIS_METHOD(OnSaveTimer)),
-     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer))
-  {
-#ifndef _WIN32
-    SignalMonitorRegister(SIGINT, BIND_THIS_METHOD(OnQuitSignal));
-    SignalMonitorRegister(SIGTERM, BIND_THIS_METHOD(OnQuitSignal));
-    SignalMonitorRegister(SIGQUIT, BIND_THIS_METHOD(OnQuitSignal));
-
-    SignalMonitorRegister(SIGHUP, BIND_THIS_METHOD(OnReloadSignal));
-    SignalMonitorRegister(SIGUSR1, BIND_THIS_METHOD(OnDumpSignal));
-#endif
-
-    ScheduleSave();
-  }
-
-  void Load();
-  void Save();
+  CloudServer(CloudShardedData &_data, EventLoop &event_loop,
+              EventLoop &_main_loop,
+              SocketAddress bind_address, bool reuse_port)
+    :SkyLinesTracking::Server(event_loop, bind_address, reuse_port),
+     data(_data), main_loop(_main_loop) {}
 
 private:
-  void OnSaveTimer() noexcept {
-    Save();
-    ScheduleSave();
-  }
-
-  void ScheduleSave() {
-    save_timer.Schedule(std::chrono::minutes(1));
-  }
-
-  void OnExpireTimer() noexcept {
-    clients.Expire(GetEventLoop().SteadyNow() - std::chrono::minutes(10));
-    if (!clients.empty())
-      ScheduleExpire();
-  }
-
-  void ScheduleExpire() {
-    expire_timer.Schedule(std::chrono::minutes(5));
+  /**
+   * A client which shall receive a packet.
+   */
+  struct Recipient {
+    StaticSocketAddress address;
+    uint64_t key;
+  };
+
+  /**
+   * Collect the clients within the given range (except the one with
+   * the given key) which match the predicate.  The packets can then
+   * be sent after the shards have been unlocked.
+   */
+  template<typename P>
+  std::vector<Recipient> FindRecipients(::GeoPoint location, double range,
+                                        uint64_t except_key, P &&p) const {
+    std::vector<Recipient> recipients;
+    data.VisitClientsWithinRange(location, range, [&](const CloudClient &i){
+      if (i.key != except_key && p(i))
+        recipients.push_back({StaticSocketAddress{i.address}, i.key});
+      return true;
+    });
+    return recipients;
   }
 
 protected:
@@ -116,14 +126,120 @@ protected:
 
   void OnSendError(SocketAddress address,
                    std::exception_ptr e) noexcept override {
+    const std::scoped_lock lock{log_mutex};
     cerr << "Failed to send to " << address
          << ": " << GetFullMessage(e)
          << endl;
   }
 
   void OnError(std::exception_ptr e) override {
-    cerr << GetFullMessage(e) << endl;
-    GetEventLoop().Break();
+    {
+      const std::scoped_lock lock{log_mutex};
+      cerr << GetFullMessage(e) << endl;
+    }
+
+    main_loop.InjectBreak();
+  }
+};
+
+/**
+ * A thread running a #CloudServer with its own #EventLoop.
+ */
+class CloudWorker final : Thread {
+  EventLoop event_loop{ThreadId::Null()};
+
+  CloudServer server;
+
+public:
+  CloudWorker(CloudShardedData &data, EventLoop &main_loop,
+              SocketAddress bind_address)
+    :Thread("worker"),
+     server(data, event_loop, main_loop, bind_address, true) {}
+
+  ~CloudWorker() noexcept {
+    /* allow the server to unregister its socket from this thread */
+    event_loop.SetAlive(false);
+  }
+
+  /**
+   * Throws on error.
+   */
+  void Start() {
+    event_loop.SetAlive(true);
+    Thread::Start();
+  }
+
+  void Stop() noexcept {
+    if (!IsDefined())
+      /* Start() has failed */
+      return;
+
+    event_loop.InjectBreak();
+    Join();
+  }
+
+private:
+  /* virtual methods from class Thread */
+  void Run() noexcept override {
+    event_loop.Run();
+  }
+};
+
+/**
+ * Owns the data and everything that runs in the main thread:
+ * persistence, expiry and signal handling.
+ */
+class CloudMain final {
+  const AllocatedPath db_path;
+
+  CloudShardedData &data;
+
+  CoarseTimerEvent save_timer, expire_timer;
+
+public:
+  CloudMain(AllocatedPath &&_db_path, CloudShardedData &_data,
+            EventLoop &event_loop)
+    :db_path(std::move(_db_path)), data(_data),
+     save_timer(event_loop, BIND_THIS_METHOD(OnSaveTimer)),
+     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer))
+  {
+#ifndef _WIN32
+    SignalMonitorRegister(SIGINT, BIND_THIS_METHOD(OnQuitSignal));
+    SignalMonitorRegister(SIGTERM, BIND_THIS_METHOD(OnQuitSignal));
+    SignalMonitorRegister(SIGQUIT, BIND_THIS_METHOD(OnQuitSignal));
+
+    SignalMonitorRegister(SIGHUP, BIND_THIS_METHOD(OnReloadSignal));
+    SignalMonitorRegister(SIGUSR1, BIND_THIS_METHOD(OnDumpSignal));
+#endif
+
+    ScheduleSave();
+    ScheduleExpire();
+  }
+
+  auto &GetEventLoop() const noexcept {
+    return save_timer.GetEventLoop();
+  }
+
+  void Load();
+  void Save();
+
+private:
+  void OnSaveTimer() noexcept {
+    Save();
+    ScheduleSave();
+  }
+
+  void ScheduleSave() {
+    save_timer.Schedule(std::chrono::minutes(1));
+  }
+
+  void OnExpireTimer() noexcept {
+    data.Expire(std::chrono::steady_clock::now() - std::chrono::minutes(10));
+    ScheduleExpire();
+  }
+
+  void ScheduleExpire() {
+    expire_timer.Schedule(std::chrono::minutes(5));
   }
 
 #ifndef _WIN32
@@ -136,7 +252,9 @@ protected:
   }
 
   void OnDumpSignal() noexcept {
-    DumpClients();
+    const std::scoped_lock lock{log_mutex};
+    data.DumpClients();
+    data.DumpStatistics();
   }
 #endif
 };
@@ -148,44 +266,36 @@ CloudServer::OnFix(const Client &c,
 {
   (void)time_of_day; // TODO: use this parameter
 
-  CloudClient *client;
-  if (location.IsValid()) {
-    bool was_empty = clients.empty();
+  if (!location.IsValid()) {
+    data.Refresh(c.key, c.address);
+    return;
+  }
 
-    client = &clients.Make(c.address, c.key, location, altitude);
+  const auto client = data.Make(c.address, c.key, location, altitude);
 
+  {
+    const std::scoped_lock lock{log_mutex};
     cout << "FIX\t"
-         << client->address << '\t'
-         << std::hex << client->key << std::dec << '\t'
-         << client->id << '\t'
-         << client->location << '\t'
-         << client->altitude << 'm'
+         << SocketAddress(c.address) << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << client.id << '\t'
+         << client.location << '\t'
+         << client.altitude << 'm'
          << endl;
-
-    if (was_empty)
-      ScheduleExpire();
-  } else {
-    client = clients.Find(c.key);
-    if (client != nullptr)
-      clients.Refresh(*client, c.address);
   }
 
   /* send this new traffic location to all interested clients
      immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(location, TRAFFIC_RANGE)) {
-    if (i->key == c.key)
-      /* ignore this client's own submissions - he knows them
-         already */
-      continue;
-
-    if (now > i->wants_traffic)
-      /* not interested (anymore) */
-      continue;
-
-    TrafficResponseSender s(*this, i->address, i->key);
-    s.Add(client->id, 0, //TODO: time?
-          client->location, client->altitude);
+  const auto recipients = FindRecipients(location, TRAFFIC_RANGE, c.key,
+                                         [now](const CloudClient &i){
+    return now <= i.wants_traffic;
+  });
+
+  for (const auto &i : recipients) {
+    TrafficResponseSender s(*this, i.address, i.key);
+    s.Add(client.id, 0, //TODO: time?
+          client.location, client.altitude);
     s.Flush();
   }
 }
@@ -197,37 +307,39 @@ CloudServer::OnTrafficRequest(const Client &c, bool near)
     /* "near" is the only selection flag we know */
     return;
 
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  GeoPoint location;
+  if (!data.VisitClient(c.key, [&](CloudClient &client){
+    client.wants_traffic = now + REQUEST_EXPIRY;
+    location = client.location;
+  }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_traffic = now + REQUEST_EXPIRY;
-
   const auto min_stamp = now - MAX_TRAFFIC_AGE;
 
-  TrafficResponseSender s(*this, c.address, c.key);
-
-  unsigned n = 0;
-  for (const auto &traffic : clients.QueryWithinRange(client->location,
-                                                      TRAFFIC_RANGE)) {
-    if (traffic.get() == client)
-      continue;
+  /* copy the traffic, so nothing is sent while its shard is
+     locked */
+  StaticArray<CloudShardedData::ClientInfo, 64> traffic_list;
+  data.VisitClientsWithinRange(location, TRAFFIC_RANGE,
+                               [&](const CloudClient &traffic){
+    if (traffic.key == c.key)
+      return true;
 
-    if (traffic->stamp < min_stamp)
+    if (traffic.stamp < min_stamp)
       /* don't send stale traffic, it's probably not there anymore */
-      continue;
+      return true;
 
-    s.Add(traffic->id, 0, //TODO: time?
-          traffic->location, traffic->altitude);
-
-    if (++n > 64)
-      break;
-  }
+    traffic_list.push_back({traffic.id, traffic.location, traffic.altitude});
+    return !traffic_list.full();
+  });
 
+  TrafficResponseSender s(*this, c.address, c.key);
+  for (const auto &traffic : traffic_list)
+    s.Add(traffic.id, 0, //TODO: time?
+          traffic.location, traffic.altitude);
   s.Flush();
 }
 
@@ -239,16 +351,19 @@ CloudServer::OnWaveSubmit(const Client &c,
                           int top_altitude,
                           double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!data.VisitClient(c.key, [&](const CloudClient &client){
+    id = client.id;
+  }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
+  const std::scoped_lock lock{log_mutex};
   cout << "WAVE\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
+       << SocketAddress(c.address) << '\t'
+       << std::hex << c.key << std::dec << '\t'
+       << id << '\t'
        << a << '\t'
        << b << '\t'
        << bottom_altitude << '-' << top_altitude << "m\t"
@@ -265,42 +380,43 @@ CloudServer::OnThermalSubmit(const Client &c,
                              int top_altitude,
                              double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!data.VisitClient(c.key, [&](const CloudClient &client){
+    id = client.id;
+  }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
-  cout << "THERMAL\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
-       << top_location << '\t'
-       << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
+  {
+    const std::scoped_lock lock{log_mutex};
+    cout << "THERMAL\t"
+         << SocketAddress(c.address) << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << id << '\t'
+         << top_location << '\t'
+         << bottom_altitude << '-' << top_altitude << "m\t"
+         << lift << "m/s"
+         << endl;
+  }
 
-  const auto &thermal =
-    thermals.Make(c.key,
-                  AGeoPoint(bottom_location, bottom_altitude),
-                  AGeoPoint(top_location, top_altitude),
-                  lift);
+  const auto thermal =
+    data.MakeThermal(c.key,
+                     AGeoPoint(bottom_location, bottom_altitude),
+                     AGeoPoint(top_location, top_altitude),
+                     lift);
 
   /* send this new thermal to all interested clients immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(bottom_location,
-                                                THERMAL_RANGE)) {
-    if (i->key == c.key)
-      /* ignore this client's own submissions - he knows them
-         already */
-      continue;
-
-    if (now > i->wants_thermals)
-      /* not interested (anymore) */
-      continue;
-
-    ThermalResponseSender s(*this, i->address, i->key);
-    s.Add(thermal.Pack());
+  const auto recipients = FindRecipients(bottom_location, THERMAL_RANGE,
+                                         c.key,
+                                         [now](const CloudClient &i){
+    return now <= i.wants_thermals;
+  });
+
+  for (const auto &i : recipients) {
+    ThermalResponseSender s(*this, i.address, i.key);
+    s.Add(thermal);
     s.Flush();
   }
 }
@@ -308,92 +424,136 @@ CloudServer::OnThermalSubmit(const Client &c,
 void
 CloudServer::OnThermalRequest(const Client &c)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  GeoPoint location;
+  if (!data.VisitClient(c.key, [&](CloudClient &client){
+    client.wants_thermals = now + REQUEST_EXPIRY;
+    location = client.location;
+  }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_thermals = now + REQUEST_EXPIRY;
-
   const auto min_time = now - MAX_THERMAL_AGE;
 
-  ThermalResponseSender s(*this, c.address, c.key);
-
-  unsigned n = 0;
-  for (const auto &thermal : thermals.QueryWithinRange(client->location,
-                                                       THERMAL_RANGE)) {
-    if (thermal->client_key == c.key)
+  /* copy the thermals, so nothing is sent while their shard is
+     locked */
+  StaticArray<SkyLinesTracking::Thermal, 256> thermals;
+  data.VisitThermalsWithinRange(location, THERMAL_RANGE,
+                                [&](const CloudThermal &thermal){
+    if (thermal.client_key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return true;
 
-    if (thermal->time < min_time)
+    if (thermal.time < min_time)
       /* don't send old thermals, they're useless */
-      continue;
+      return true;
 
-    s.Add(thermal->Pack());
-
-    if (++n > 256)
-      break;
-  }
+    thermals.push_back(thermal.Pack());
+    return !thermals.full();
+  });
 
+  ThermalResponseSender s(*this, c.address, c.key);
+  for (const auto &thermal : thermals)
+    s.Add(thermal);
   s.Flush();
 }
 
 void
-CloudServer::Load()
+CloudMain::Load()
 {
   FileReader fr(db_path);
   Deserialiser s(fr);
-  CloudData::Load(s);
+  data.Load(s);
 }
 
 void
-CloudServer::Save()
+CloudMain::Save()
 {
-  cout << "Saving data to " << db_path.c_str() << endl;
+  {
+    const std::scoped_lock lock{log_mutex};
+    cout << "Saving data to " << db_path.c_str() << endl;
+  }
 
   FileOutputStream fos(db_path);
 
   {
     Serialiser s(fos);
-    CloudData::Save(s);
+    data.Save(s);
     s.Flush();
   }
 
   fos.Commit();
 }
 
+/**
+ * The number of shards per thread.  More shards than threads reduce
+ * lock contention, at the cost of more shards per range query.
+ */
+static constexpr unsigned SHARDS_PER_THREAD = 4;
+
 int
 main(int argc, char **argv)
 try {
-  if (argc != 2) {
-    cerr << "Usage: " << argv[0] << " DBPATH" << endl;
+  if (argc < 2 || argc > 3) {
+    cerr << "Usage: " << argv[0] << " DBPATH [THREADS]" << endl;
     return EXIT_FAILURE;
   }
 
   const Path db_path(argv[1]);
 
+  unsigned n_threads = 1;
+  if (argc > 2) {
+    char *endptr;
+    n_threads = ParseUnsigned(argv[2], &endptr);
+    if (*endptr != 0 || n_threads < 1 ||
+        n_threads * SHARDS_PER_THREAD > CloudShardedData::MAX_SHARDS) {
+      cerr << "Invalid number of threads" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* a single thread doesn't need more than one shard */
+  CloudShardedData data(n_threads > 1 ? n_threads * SHARDS_PER_THREAD : 1,
+                        std::max(TRAFFIC_RANGE, THERMAL_RANGE));
+
   EventLoop event_loop;
   SignalMonitorInit(event_loop);
   AtScopeExit() { SignalMonitorFinish(); };
 
-  CloudServer server(db_path, event_loop,
-                     IPv4Address(CloudServer::GetDefaultPort()));
+  CloudMain main(db_path, data, event_loop);
 
   try {
-    server.Load();
+    main.Load();
   } catch (const std::runtime_error &e) {
     cerr << "Failed to load database" << endl;
     PrintException(e);
   }
 
-  event_loop.Run();
+  /* the main thread handles one socket; with more than one thread,
+     all sockets share the port with SO_REUSEPORT and the kernel
+     distributes the clients among them */
+  const IPv4Address bind_address(CloudServer::GetDefaultPort());
+  CloudServer server(data, event_loop, event_loop,
+                     bind_address, n_threads > 1);
+
+  {
+    std::forward_list<CloudWorker> workers;
+    AtScopeExit(&workers) {
+      for (auto &worker : workers)
+        worker.Stop();
+    };
+
+    for (unsigned i = 1; i < n_threads; ++i)
+      workers.emplace_front(data, event_loop, bind_address).Start();
+
+    event_loop.Run();
+  }
 
-  server.Save();
+  main.Save();
+  data.DumpStatistics();
 
   return EXIT_SUCCESS;
 } catch (const std::exception &exception) {
@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Shard.hpp"
+#include "Data.hpp"
+#include "Dump.hpp"
+#include "Serialiser.hpp"
+#include "Geo/Boost/RangeBox.hpp"
+#include "Geo/FAISphere.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "net/ToString.hxx"
+
+#include <cassert>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+CloudShardedData::CloudShardedData(unsigned _n_shards, double max_range)
+  :n_shards(_n_shards),
+   cell_size(CalcCellSize(max_range)),
+   shards(new Shard[n_shards])
+{
+  assert(n_shards > 0);
+  assert(n_shards <= MAX_SHARDS);
+}
+
+CloudShardedData::~CloudShardedData() noexcept = default;
+
+double
+CloudShardedData::CalcCellSize(double max_range) noexcept
+{
+  /* the box spans twice the range, divided by cos(60 degrees) in
+     longitude (see BoostRangeBox()) */
+  return 4 * FAISphere::EarthDistanceToAngle(max_range).Degrees();
+}
+
+inline unsigned
+CloudShardedData::GetShardIndex(GeoPoint location) const noexcept
+{
+  /* scramble the cell coordinates, so neighbouring cells (i.e. a
+     busy area) are spread over different shards */
+  uint32_t h = uint32_t(ToCell(location.latitude)) * 0x9e3779b1U
+    ^ uint32_t(ToCell(location.longitude)) * 0x85ebca6bU;
+  h ^= h >> 16;
+  return h % n_shards;
+}
+
+std::bitset<CloudShardedData::MAX_SHARDS>
+CloudShardedData::GetShardsWithinRange(GeoPoint location,
+                                       double range) const noexcept
+{
+  std::bitset<MAX_SHARDS> mask;
+
+  if (n_shards == 1) {
+    mask.set(0);
+    return mask;
+  }
+
+  const auto box = BoostRangeBox(location, range);
+  const int south = ToCell(box.min_corner().latitude);
+  const int north = ToCell(box.max_corner().latitude);
+  const int west = ToCell(box.min_corner().longitude);
+  const int east = ToCell(box.max_corner().longitude);
+
+  if (west > east ||
+      unsigned(north - south + 1) * unsigned(east - west + 1) > n_shards) {
+    /* crossing the date line or very close to a pole: don't bother
+       to enumerate the cells, just visit all shards */
+    for (unsigned i = 0; i < n_shards; ++i)
+      mask.set(i);
+    return mask;
+  }
+
+  for (int y = south; y <= north; ++y)
+    for (int x = west; x <= east; ++x)
+      mask.set(GetShardIndex(GeoPoint(Angle::Degrees((x + 0.5) * cell_size),
+                                      Angle::Degrees((y + 0.5) * cell_size))));
+
+  return mask;
+}
+
+inline void
+CloudShardedData::InsertClient(unsigned shard_index, CloudClient &client)
+{
+  auto &stripe = GetStripe(client.key);
+  const std::scoped_lock stripe_lock{stripe.mutex};
+
+  auto &shard = shards[shard_index];
+  const std::scoped_lock shard_lock{shard.mutex};
+
+  shard.clients.Insert(client);
+  stripe.shards[client.key] = shard_index;
+}
+
+inline CloudShardedData::ClientInfo
+CloudShardedData::MakeLocked(Shard &shard, SocketAddress address,
+                             uint64_t key,
+                             const GeoPoint &location, int altitude)
+{
+  CloudClient *client = shard.clients.Find(key);
+  if (client == nullptr) {
+    auto new_client = std::make_shared<CloudClient>(address, key, next_id++,
+                                                    location, altitude);
+    shard.clients.Insert(*new_client);
+    client = new_client.get();
+  } else
+    shard.clients.Refresh(*client, address, location, altitude);
+
+  return {client->id, client->location, client->altitude};
+}
+
+CloudShardedData::ClientInfo
+CloudShardedData::Make(SocketAddress address, uint64_t key,
+                       const GeoPoint &location, int altitude)
+{
+  assert(location.IsValid());
+
+  const unsigned shard_index = GetShardIndex(location);
+  auto &shard = shards[shard_index];
+
+  auto &stripe = GetStripe(key);
+  const std::scoped_lock stripe_lock{stripe.mutex};
+
+  if (const auto i = stripe.shards.find(key);
+      i != stripe.shards.end() && i->second != shard_index) {
+    /* the client has left the cells owned by its old shard; move
+       it, locking both shards at the same time so Save() sees it in
+       exactly one of them */
+    auto &old_shard = shards[i->second];
+    const std::scoped_lock shard_lock{old_shard.mutex, shard.mutex};
+
+    if (auto *client = old_shard.clients.Find(key)) {
+      const auto ptr = client->shared_from_this();
+      old_shard.clients.Remove(*client);
+      client->location = location;
+      shard.clients.Insert(*client);
+    }
+
+    i->second = shard_index;
+    return MakeLocked(shard, address, key, location, altitude);
+  }
+
+  const std::scoped_lock shard_lock{shard.mutex};
+  stripe.shards[key] = shard_index;
+  return MakeLocked(shard, address, key, location, altitude);
+}
+
+bool
+CloudShardedData::Refresh(uint64_t key, SocketAddress address)
+{
+  auto &stripe = GetStripe(key);
+  const std::scoped_lock stripe_lock{stripe.mutex};
+
+  const auto i = stripe.shards.find(key);
+  if (i == stripe.shards.end())
+    return false;
+
+  auto &shard = shards[i->second];
+  const std::scoped_lock shard_lock{shard.mutex};
+
+  auto *client = shard.clients.Find(key);
+  if (client == nullptr)
+    return false;
+
+  shard.clients.Refresh(*client, address);
+  return true;
+}
+
+SkyLinesTracking::Thermal
+CloudShardedData::MakeThermal(uint64_t client_key,
+                              const AGeoPoint &bottom_location,
+                              const AGeoPoint &top_location,
+                              double lift)
+{
+  /* thermals are indexed by their top location (see
+     CloudThermalIndexable) */
+  auto &shard = shards[GetShardIndex(top_location)];
+  const std::scoped_lock lock{shard.mutex};
+  return shard.thermals.Make(client_key, bottom_location, top_location,
+                             lift).Pack();
+}
+
+void
+CloudShardedData::Expire(std::chrono::steady_clock::time_point before)
+{
+  std::vector<uint64_t> expired;
+
+  for (unsigned i = 0; i < n_shards; ++i) {
+    auto &shard = shards[i];
+
+    expired.clear();
+
+    {
+      const std::scoped_lock lock{shard.mutex};
+
+      /* the list is sorted by time stamp, oldest at the back */
+      while (!shard.clients.empty()) {
+        const auto &oldest = *std::prev(shard.clients.end());
+        if (oldest.stamp >= before)
+          break;
+
+        expired.push_back(oldest.key);
+        shard.clients.Remove(*shard.clients.Find(oldest.key));
+      }
+    }
+
+    /* now that the shard is unlocked, the directory entries can be
+       removed (observing the locking order); skip those which have
+       reappeared in the meantime */
+    for (const uint64_t key : expired) {
+      auto &stripe = GetStripe(key);
+      const std::scoped_lock stripe_lock{stripe.mutex};
+
+      const auto j = stripe.shards.find(key);
+      if (j == stripe.shards.end() || j->second != i)
+        continue;
+
+      const std::shared_lock shard_lock{shard.mutex};
+      if (shard.clients.Find(key) == nullptr)
+        stripe.shards.erase(j);
+    }
+  }
+}
+
+void
+CloudShardedData::DumpClients()
+{
+  for (unsigned i = 0; i < n_shards; ++i) {
+    const std::shared_lock lock{shards[i].mutex};
+
+    for (const auto &client : shards[i].clients) {
+      cout << ToString(client.address) << '\t'
+           << std::hex << client.key << std::dec << '\t'
+           << client.id << '\t'
+           << client.location << '\t'
+           << client.altitude << "m\n";
+    }
+  }
+
+  cout.flush();
+}
+
+void
+CloudShardedData::DumpStatistics() const
+{
+  const unsigned long queries = statistics.queries;
+  if (queries == 0)
+    return;
+
+  const unsigned long shard_locks = statistics.shard_locks;
+  const std::chrono::steady_clock::duration hold_time{statistics.hold_time};
+
+  cout << "Queries: " << queries << ", "
+       << double(shard_locks) / queries << " shards/query, "
+       << statistics.contended << " contended, "
+       << std::chrono::duration<double, std::micro>(hold_time).count() / queries
+       << "us locked/query" << endl;
+}
+
+void
+CloudShardedData::Save(Serialiser &s) const
+{
+  /* lock all shards to get a consistent snapshot */
+  std::vector<std::shared_lock<SharedMutex>> locks;
+  locks.reserve(n_shards);
+  for (unsigned i = 0; i < n_shards; ++i)
+    locks.emplace_back(shards[i].mutex);
+
+  /* this is the format of CloudData::Save() and its containers */
+  s.Write32(CloudData::MAGIC);
+  s.Write32(CloudData::VERSION);
+
+  s.Write32(next_id);
+
+  for (unsigned i = 0; i < n_shards; ++i) {
+    for (const auto &client : shards[i].clients) {
+      s.Write8(1);
+      client.Save(s);
+    }
+  }
+
+  s.Write8(0);
+  s.Write8(0);
+
+  s.Write8(1);
+  s.Write8(1);
+
+  for (unsigned i = 0; i < n_shards; ++i) {
+    for (const auto &thermal : shards[i].thermals) {
+      s.Write8(1);
+      thermal.Save(s);
+    }
+  }
+
+  s.Write8(0);
+  s.Write8(0);
+
+  s.Write8(0);
+}
+
+void
+CloudShardedData::Load(Deserialiser &s)
+{
+  if (s.Read32() != CloudData::MAGIC)
+    throw std::runtime_error("Bad magic");
+
+  if (s.Read32() != CloudData::VERSION)
+    throw std::runtime_error("Bad version");
+
+  next_id = s.Read32();
+
+  while (s.Read8() != 0) {
+    auto client = std::make_shared<CloudClient>(CloudClient::Load(s));
+    InsertClient(GetShardIndex(client->location), *client);
+  }
+
+  s.Read8();
+
+  if (s.Read8() != 0) {
+    s.Read8();
+
+    while (s.Read8() != 0) {
+      auto thermal = std::make_shared<CloudThermal>(CloudThermal::Load(s));
+      auto &shard = shards[GetShardIndex(thermal->top_location)];
+      const std::scoped_lock lock{shard.mutex};
+      shard.thermals.Insert(*thermal);
+    }
+
+    s.Read8();
+  }
+}
@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Client.hpp"
+#include "Thermal.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/SharedMutex.hpp"
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+class Serialiser;
+class Deserialiser;
+
+/**
+ * The contents of #CloudData, partitioned by geographic cell into
+ * several shards, each with its own lock.  This allows several
+ * threads to handle requests concurrently; requests which query a
+ * range only lock the (up to four) shards owning the cells within
+ * that range.
+ *
+ * Clients move between shards as they fly across cell boundaries;
+ * a directory maps each client key to the shard which currently
+ * owns it.
+ *
+ * Locking order: a directory stripe may be locked before a shard,
+ * but never the other way round.  Moving a client locks two shards
+ * with std::scoped_lock's deadlock avoidance; Save() locks all
+ * shards.
+ */
+class CloudShardedData {
+public:
+  static constexpr unsigned MAX_SHARDS = 64;
+
+  struct Shard {
+    /**
+     * Protects #clients and #thermals.  Writers (new fixes,
+     * requests updating a client's "wants" flags, expiry) lock
+     * exclusively; range queries lock shared.
+     */
+    mutable SharedMutex mutex;
+
+    CloudClientContainer clients;
+    CloudThermalContainer thermals;
+  };
+
+  /**
+   * A copy of the attributes of a #CloudClient, for use after the
+   * shard has been unlocked.
+   */
+  struct ClientInfo {
+    unsigned id;
+    GeoPoint location;
+    int altitude;
+  };
+
+private:
+  static constexpr unsigned N_STRIPES = 64;
+
+  /**
+   * One stripe of the key directory.
+   */
+  struct Stripe {
+    Mutex mutex;
+
+    /**
+     * Map client key to shard index.
+     */
+    std::unordered_map<uint64_t, unsigned> shards;
+  };
+
+  const unsigned n_shards;
+
+  /**
+   * The size of a geographic cell [degrees], see CalcCellSize().
+   */
+  const double cell_size;
+
+  const std::unique_ptr<Shard[]> shards;
+
+  std::array<Stripe, N_STRIPES> directory;
+
+  /**
+   * The public id assigned to the next new #CloudClient.
+   */
+  std::atomic_uint next_id{1};
+
+  /**
+   * Lock statistics of the range queries, see DumpStatistics().
+   */
+  struct QueryStatistics {
+    std::atomic_ulong queries{0}, shard_locks{0}, contended{0};
+
+    /**
+     * The total time shards were locked by range queries.
+     */
+    std::atomic<std::chrono::steady_clock::rep> hold_time{0};
+  };
+
+  mutable QueryStatistics statistics;
+
+public:
+  /**
+   * @param max_range the largest range passed to
+   * VisitClientsWithinRange() and VisitThermalsWithinRange() [m]
+   */
+  CloudShardedData(unsigned _n_shards, double max_range);
+  ~CloudShardedData() noexcept;
+
+  CloudShardedData(const CloudShardedData &) = delete;
+  CloudShardedData &operator=(const CloudShardedData &) = delete;
+
+  unsigned GetShardCount() const noexcept {
+    return n_shards;
+  }
+
+  /**
+   * Create a new #CloudClient, or refresh the existing one (and
+   * move it to another shard if it has left its cell).
+   */
+  ClientInfo Make(SocketAddress address, uint64_t key,
+                  const GeoPoint &location, int altitude);
+
+  /**
+   * Refresh the address and time stamp of an existing client.
+   *
+   * @return false if no such client exists
+   */
+  bool Refresh(uint64_t key, SocketAddress address);
+
+  /**
+   * Look up a client by its secret key and invoke the given function
+   * with a mutable reference while its shard is locked.
+   *
+   * @return false if no such client exists
+   */
+  template<typename F>
+  bool VisitClient(uint64_t key, F &&f) {
+    auto &stripe = GetStripe(key);
+    const std::scoped_lock stripe_lock{stripe.mutex};
+
+    const auto i = stripe.shards.find(key);
+    if (i == stripe.shards.end())
+      return false;
+
+    auto &shard = shards[i->second];
+    const std::scoped_lock shard_lock{shard.mutex};
+
+    auto *client = shard.clients.Find(key);
+    if (client == nullptr)
+      return false;
+
+    f(*client);
+    return true;
+  }
+
+  /**
+   * Invoke the given function for each client within the given
+   * range.  The function is called while the client's shard is
+   * locked (shared), and must not call back into this object.  It
+   * may return false to stop the iteration.
+   */
+  template<typename F>
+  void VisitClientsWithinRange(GeoPoint location, double range, F &&f) const {
+    VisitShards(location, range, [&](const Shard &shard){
+      for (const auto &i : shard.clients.QueryWithinRange(location, range))
+        if (!f(*i))
+          return false;
+      return true;
+    });
+  }
+
+  /**
+   * Like VisitClientsWithinRange(), but for thermals.
+   */
+  template<typename F>
+  void VisitThermalsWithinRange(GeoPoint location, double range, F &&f) const {
+    VisitShards(location, range, [&](const Shard &shard){
+      for (const auto &i : shard.thermals.QueryWithinRange(location, range))
+        if (!f(*i))
+          return false;
+      return true;
+    });
+  }
+
+  /**
+   * Create a new #CloudThermal.
+   *
+   * @return the new thermal in wire format
+   */
+  SkyLinesTracking::Thermal MakeThermal(uint64_t client_key,
+                   const AGeoPoint &bottom_location,
+                   const AGeoPoint &top_location,
+                   double lift);
+
+  void Expire(std::chrono::steady_clock::time_point before);
+
+  void DumpClients();
+
+  /**
+   * Print the lock statistics of the range queries.
+   */
+  void DumpStatistics() const;
+
+  /**
+   * Save all shards in the #CloudData file format.
+   */
+  void Save(Serialiser &s) const;
+
+  /**
+   * Load a #CloudData file and distribute its contents among the
+   * shards.  Must be called before the other threads are started.
+   */
+  void Load(Deserialiser &s);
+
+private:
+  /**
+   * Calculate the cell size for queries up to the given range: up to
+   * 60 degrees latitude, the bounding box of such a query is not
+   * larger than one cell, and therefore overlaps no more than 2x2
+   * cells.
+   */
+  [[gnu::const]]
+  static double CalcCellSize(double max_range) noexcept;
+
+  [[gnu::pure]]
+  int ToCell(Angle angle) const noexcept {
+    return (int)std::floor(angle.Degrees() / cell_size);
+  }
+
+  Stripe &GetStripe(uint64_t key) noexcept {
+    return directory[key % N_STRIPES];
+  }
+
+  [[gnu::pure]]
+  unsigned GetShardIndex(GeoPoint location) const noexcept;
+
+  /**
+   * Determine the shards owning cells which intersect with the
+   * given range.
+   */
+  [[gnu::pure]]
+  std::bitset<MAX_SHARDS> GetShardsWithinRange(GeoPoint location,
+                                               double range) const noexcept;
+
+  template<typename F>
+  void VisitShards(GeoPoint location, double range, F &&f) const {
+    ++statistics.queries;
+
+    const auto mask = GetShardsWithinRange(location, range);
+    for (unsigned i = 0; i < n_shards; ++i) {
+      if (!mask[i])
+        continue;
+
+      std::shared_lock lock{shards[i].mutex, std::try_to_lock};
+      if (!lock.owns_lock()) {
+        ++statistics.contended;
+        lock.lock();
+      }
+
+      ++statistics.shard_locks;
+
+      const auto start = std::chrono::steady_clock::now();
+      const bool result = f(shards[i]);
+      lock.unlock();
+      statistics.hold_time += (std::chrono::steady_clock::now() - start).count();
+
+      if (!result)
+        break;
+    }
+  }
+
+  ClientInfo MakeLocked(Shard &shard, SocketAddress address, uint64_t key,
+                        const GeoPoint &location, int altitude);
+
+  void InsertClient(unsigned shard_index, CloudClient &client);
+};
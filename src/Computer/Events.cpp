@@ -15,6 +15,8 @@ GlideComputerEvents::Reset()
   last_final_glide = false;
   last_traffic = 0;
   last_new_traffic.Clear();
+  last_conflict_id.Clear();
+  last_conflict_level = FlarmTraffic::AlarmType::NONE;
   last_teammate_in_sector = false;
 }
 
@@ -62,6 +64,21 @@ GlideComputerEvents::OnCalculatedUpdate(const MoreData &basic,
   } else
     last_traffic = 0;
 
+  /* check for predicted conflicts; report each target again when its
+     alarm level rises */
+
+  if (const auto *conflict = flarm.conflicts.GetMostUrgent()) {
+    if (conflict->id != last_conflict_id ||
+        (unsigned)conflict->level > (unsigned)last_conflict_level)
+      InputEvents::processGlideComputer(GCE_FLARM_CONFLICT);
+
+    last_conflict_id = conflict->id;
+    last_conflict_level = conflict->level;
+  } else {
+    last_conflict_id.Clear();
+    last_conflict_level = FlarmTraffic::AlarmType::NONE;
+  }
+
   /* check team mate */
 
   if (enable_team) {
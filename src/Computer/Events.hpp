@@ -5,6 +5,7 @@
 
 #include "Blackboard/BlackboardListener.hpp"
 #include "NMEA/Validity.hpp"
+#include "FLARM/Traffic.hpp"
 
 /**
  * This class listens for #LiveBlackboard changes and emits glide
@@ -22,6 +23,12 @@ class GlideComputerEvents final : public NullBlackboardListener {
   unsigned last_traffic;
   Validity last_new_traffic;
 
+  /**
+   * The most urgent predicted conflict which was reported last.
+   */
+  FlarmId last_conflict_id;
+  FlarmTraffic::AlarmType last_conflict_level;
+
 public:
   GlideComputerEvents():enable_team(false) {}
 
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "GlideComputer.hpp"
+#include "Profiler.hpp"
 #include "Computer/Settings.hpp"
 #include "NMEA/Derived.hpp"
 #include "GlideComputerInterface.hpp"
@@ -54,6 +55,8 @@ GlideComputer::Initialise()
 bool
 GlideComputer::ProcessGPS(bool force)
 {
+  const ScopeComputerProfile profile(profiler, ComputerSubsystem::GPS);
+
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
   const ComputerSettings &settings = GetComputerSettings();
@@ -141,6 +144,8 @@ GlideComputer::ProcessGPS(bool force)
 void
 GlideComputer::ProcessIdle(bool exhaustive)
 {
+  const ScopeComputerProfile profile(profiler, ComputerSubsystem::IDLE);
+
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
 
@@ -152,8 +157,11 @@ GlideComputer::ProcessIdle(bool exhaustive)
   task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
                             exhaustive);
 
-  warning_computer.Update(GetComputerSettings(), basic,
-                          calculated, calculated.airspace_warnings);
+  {
+    const ScopeComputerProfile airspace_profile(profiler, ComputerSubsystem::AIRSPACE);
+    warning_computer.Update(GetComputerSettings(), basic,
+                            calculated, calculated.airspace_warnings);
+  }
 
   idle_condition_monitors.Update(basic, calculated, GetComputerSettings());
 
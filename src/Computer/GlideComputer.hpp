@@ -20,6 +20,7 @@ class Waypoints;
 class ProtectedTaskManager;
 class GlideComputerTaskEvents;
 class RasterTerrain;
+class ComputerProfiler;
 
 // TODO: replace copy constructors so copies of these structures
 // do not replicate the large items or items that should be singletons
@@ -52,6 +53,8 @@ class GlideComputer : public GlideComputerBlackboard
    */
   DeltaTime trace_history_time;
 
+  ComputerProfiler *profiler = nullptr;
+
 public:
   GlideComputer(const ComputerSettings &_settings,
                 const Waypoints &_way_points,
@@ -65,6 +68,16 @@ public:
     log_computer.SetLogger(logger);
   }
 
+  /**
+   * Install a #ComputerProfiler which receives the time spent in
+   * each subsystem.  Pass nullptr to disable profiling.
+   */
+  void SetProfiler(ComputerProfiler *_profiler) noexcept {
+    profiler = _profiler;
+    air_data_computer.SetProfiler(_profiler);
+    task_computer.SetProfiler(_profiler);
+  }
+
   /**
    * Resets the GlideComputer data
    * @param full Reset all data?
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "GlideComputerAirData.hpp"
+#include "Profiler.hpp"
 #include "Settings.hpp"
 #include "Math/LowPassFilter.hpp"
 #include "Terrain/RasterTerrain.hpp"
@@ -86,10 +87,13 @@ GlideComputerAirData::ProcessVertical(const MoreData &basic,
   wave_computer.Compute(basic, calculated.flight,
                         calculated.wave, settings.wave);
 
-  wind_computer.Compute(settings.wind, settings.polar.glide_polar_task,
-                        basic, calculated);
-  wind_computer.Select(settings.wind, basic, calculated);
-  wind_computer.ComputeHeadWind(basic, calculated);
+  {
+    const ScopeComputerProfile profile(profiler, ComputerSubsystem::WIND);
+    wind_computer.Compute(settings.wind, settings.polar.glide_polar_task,
+                          basic, calculated);
+    wind_computer.Select(settings.wind, basic, calculated);
+    wind_computer.ComputeHeadWind(basic, calculated);
+  }
 
   if (basic.location_available)
     thermallocator.Process(calculated.circling && calculated.turning,
@@ -21,6 +21,7 @@ struct ThermalLocatorInfo;
 class Waypoints;
 class RasterTerrain;
 class GlidePolar;
+class ComputerProfiler;
 
 // TODO: replace copy constructors so copies of these structures
 // do not replicate the large items or items that should be singletons
@@ -30,6 +31,8 @@ class GlideComputerAirData {
   const Waypoints &waypoints;
   const RasterTerrain *terrain;
 
+  ComputerProfiler *profiler = nullptr;
+
   AutoQNH auto_qnh;
 
   GlideRatioComputer gr_computer;
@@ -57,6 +60,10 @@ public:
     terrain = _terrain;
   }
 
+  void SetProfiler(ComputerProfiler *_profiler) noexcept {
+    profiler = _profiler;
+  }
+
   const WindStore &GetWindStore() const {
     return wind_computer.GetWindStore();
   }
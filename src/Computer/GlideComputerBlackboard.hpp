@@ -3,20 +3,35 @@
 
 #pragma once
 
-#include "Blackboard/BaseBlackboard.hpp"
 #include "Blackboard/ComputerSettingsBlackboard.hpp"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
 
 /**
  * Blackboard class used by glide computer (calculation) thread.
  * Can only write DERIVED_INFO
+ *
+ * Unlike #BaseBlackboard, this owns a writable #DerivedInfo; a copy
+ * of it is published to the #DeviceBlackboard after each iteration.
  */
 class GlideComputerBlackboard:
-  public BaseBlackboard,
   public ComputerSettingsBlackboard
 {
   DerivedInfo Finish_Derived_Info;
 
+protected:
+  MoreData gps_info;
+  DerivedInfo calculated_info;
+
 public:
+  const MoreData &Basic() const noexcept {
+    return gps_info;
+  }
+
+  const DerivedInfo &Calculated() const noexcept {
+    return calculated_info;
+  }
+
   void ReadBlackboard(const MoreData &nmea_info);
   void ReadComputerSettings(const ComputerSettings &settings);
 
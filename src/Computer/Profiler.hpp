@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * The subsystems of the #GlideComputer which are measured by
+ * #ComputerProfiler.
+ */
+enum class ComputerSubsystem : uint8_t {
+  TRACE,
+  TASK,
+
+  /**
+   * ProtectedRoutePlanner::SolveRoute() and the terrain warning
+   * intersection; only measured when the route is solved again.
+   */
+  ROUTE,
+
+  /**
+   * ProtectedRoutePlanner::SolveReach(); only measured when the
+   * reach is solved again.
+   */
+  REACH,
+
+  WIND,
+  CONTEST,
+  AIRSPACE,
+
+  /**
+   * All of GlideComputer::ProcessGPS().
+   */
+  GPS,
+
+  /**
+   * All of GlideComputer::ProcessIdle().
+   */
+  IDLE,
+
+  COUNT
+};
+
+/**
+ * Receives the time spent in each subsystem of the #GlideComputer.
+ * This is used by benchmarks; XCSoar itself does not install a
+ * profiler, and the overhead is a pointer check per subsystem call.
+ */
+class ComputerProfiler {
+public:
+  using Duration = std::chrono::steady_clock::duration;
+
+  virtual void Add(ComputerSubsystem subsystem, Duration duration) noexcept = 0;
+};
+
+/**
+ * Measures the lifetime of this object and reports it to a
+ * #ComputerProfiler (if there is one).
+ */
+class ScopeComputerProfile {
+  ComputerProfiler *const profiler;
+  const ComputerSubsystem subsystem;
+  std::chrono::steady_clock::time_point start;
+
+public:
+  ScopeComputerProfile(ComputerProfiler *_profiler,
+                       ComputerSubsystem _subsystem) noexcept
+    :profiler(_profiler), subsystem(_subsystem)
+  {
+    if (profiler != nullptr)
+      start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopeComputerProfile() noexcept {
+    if (profiler != nullptr)
+      profiler->Add(subsystem, std::chrono::steady_clock::now() - start);
+  }
+
+  ScopeComputerProfile(const ScopeComputerProfile &) = delete;
+  ScopeComputerProfile &operator=(const ScopeComputerProfile &) = delete;
+};
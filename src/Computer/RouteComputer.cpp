@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "RouteComputer.hpp"
+#include "Profiler.hpp"
 #include "Task/ProtectedRoutePlanner.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
@@ -89,6 +90,8 @@ RouteComputer::TerrainWarning(const MoreData &basic,
       last_active_tp = calculated.task_stats.active_index;
 
       if (dirty) {
+        const ScopeComputerProfile profile(profiler, ComputerSubsystem::ROUTE);
+
         protected_route_planner.SolveRoute(dest, start, config, h_ceiling);
         calculated.planned_route = route_planner.GetSolution();
 
@@ -97,6 +100,7 @@ RouteComputer::TerrainWarning(const MoreData &basic,
       }
       return;
     } else {
+      const ScopeComputerProfile profile(profiler, ComputerSubsystem::ROUTE);
       protected_route_planner.SolveRoute(start, start, config, h_ceiling);
       calculated.planned_route = route_planner.GetSolution();
     }
@@ -124,6 +128,7 @@ RouteComputer::Reach(const MoreData &basic, DerivedInfo &calculated,
                                (int)calculated.common_stats.height_max_working));
 
   if (reach_clock.CheckAdvance(basic.time, PERIOD)) {
+    const ScopeComputerProfile profile(profiler, ComputerSubsystem::REACH);
     protected_route_planner.SolveReach(start, config, h_ceiling, do_solve);
 
     if (do_solve) {
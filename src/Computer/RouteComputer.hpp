@@ -14,6 +14,7 @@ struct GlideSettings;
 struct RoutePlannerConfig;
 class ProtectedAirspaceWarningManager;
 class RasterTerrain;
+class ComputerProfiler;
 class GlidePolar;
 
 class RouteComputer {
@@ -27,6 +28,8 @@ class RouteComputer {
 
   const RasterTerrain *terrain;
 
+  ComputerProfiler *profiler = nullptr;
+
   TaskType last_task_type;
   unsigned last_active_tp;
 
@@ -55,6 +58,10 @@ public:
 
   void set_terrain(const RasterTerrain* _terrain);
 
+  void SetProfiler(ComputerProfiler *_profiler) noexcept {
+    profiler = _profiler;
+  }
+
 private:
   void TerrainWarning(const MoreData &basic,
                       DerivedInfo &calculated,
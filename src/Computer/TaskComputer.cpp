@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "TaskComputer.hpp"
+#include "Profiler.hpp"
 #include "Task/ProtectedTaskManager.hpp"
 #include "Engine/Task/TaskManager.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
@@ -48,7 +49,12 @@ TaskComputer::ProcessBasicTask(const MoreData &basic,
                                const ComputerSettings &settings_computer,
                                bool force)
 {
-  trace.Update(settings_computer, basic, calculated);
+  {
+    const ScopeComputerProfile profile(profiler, ComputerSubsystem::TRACE);
+    trace.Update(settings_computer, basic, calculated);
+  }
+
+  const ScopeComputerProfile profile(profiler, ComputerSubsystem::TASK);
 
   ProtectedTaskManager::ExclusiveLease _task(task);
 
@@ -130,14 +136,20 @@ TaskComputer::ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
                           const ComputerSettings &settings_computer,
                           bool exhaustive)
 {
-  contest.SetPredicted(Predicted(settings_computer.contest, basic,
-                                 calculated.task_stats.current_leg));
+  {
+    const ScopeComputerProfile profile(profiler, ComputerSubsystem::CONTEST);
 
-  if (exhaustive)
-    contest.SolveExhaustive(settings_computer.contest,
-                            calculated.contest_stats);
-  else
-    contest.Solve(settings_computer.contest, calculated.contest_stats);
+    contest.SetPredicted(Predicted(settings_computer.contest, basic,
+                                   calculated.task_stats.current_leg));
+
+    if (exhaustive)
+      contest.SolveExhaustive(settings_computer.contest,
+                              calculated.contest_stats);
+    else
+      contest.Solve(settings_computer.contest, calculated.contest_stats);
+  }
+
+  const ScopeComputerProfile profile(profiler, ComputerSubsystem::TASK);
 
   const AircraftState as = ToAircraftState(basic, calculated);
 
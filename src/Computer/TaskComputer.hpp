@@ -12,6 +12,7 @@
 struct NMEAInfo;
 class ProtectedTaskManager;
 class ProtectedAirspaceWarningManager;
+class ComputerProfiler;
 
 class TaskComputer
 {
@@ -30,6 +31,8 @@ class TaskComputer
 
   Validity last_location_available;
 
+  ComputerProfiler *profiler = nullptr;
+
 public:
   TaskComputer(ProtectedTaskManager &_task,
                const Airspaces &airspace_database,
@@ -72,6 +75,11 @@ public:
 
   void SetTerrain(const RasterTerrain* _terrain);
 
+  void SetProfiler(ComputerProfiler *_profiler) noexcept {
+    profiler = _profiler;
+    route.SetProfiler(_profiler);
+  }
+
   void SetContestIncremental(bool incremental) {
     contest.SetIncremental(incremental);
   }
@@ -74,7 +74,7 @@ CrossSectionRenderer::Paint(Canvas &canvas, const PixelRect rc) const
   UpdateTerrain(elevations);
 
   if (airspace_database != nullptr) {
-    const AircraftState aircraft = ToAircraftState(Basic(), Calculated());
+    const AircraftState aircraft = ToAircraftState(gps_info, calculated_info);
     airspace_renderer.Draw(canvas, chart, *airspace_database, start, vec,
                            aircraft);
   }
@@ -3,14 +3,14 @@
 
 #pragma once
 
-#include "Blackboard/BaseBlackboard.hpp"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
 #include "TerrainXSRenderer.hpp"
 #include "AirspaceXSRenderer.hpp"
 #include "Engine/GlideSolvers/GlideSettings.hpp"
 #include "Engine/GlideSolvers/GlidePolar.hpp"
 
 struct PixelRect;
-struct MoreData;
 struct CrossSectionLook;
 struct AirspaceLook;
 struct ChartLook;
@@ -23,8 +23,7 @@ class Canvas;
 /**
  * A Window which renders a terrain and airspace cross-section
  */
-class CrossSectionRenderer :
-  public BaseBlackboard
+class CrossSectionRenderer
 {
 public:
   static constexpr unsigned NUM_SLICES = 64;
@@ -34,6 +33,9 @@ protected:
   const CrossSectionLook &look;
   const ChartLook &chart_look;
 
+  MoreData gps_info;
+  DerivedInfo calculated_info;
+
   GlideSettings glide_settings;
   GlidePolar glide_polar;
 
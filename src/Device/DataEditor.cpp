@@ -3,14 +3,22 @@
 
 #include "DataEditor.hpp"
 #include "Blackboard/DeviceBlackboard.hpp"
+#include "Audio/VarioGlue.hpp"
 
 DeviceDataEditor::DeviceDataEditor(DeviceBlackboard &_blackboard,
-                                   std::size_t idx) noexcept
-  :blackboard(_blackboard), lock(blackboard.mutex),
-   basic(blackboard.SetRealState(idx)) {}
+                                   std::size_t _idx) noexcept
+  :blackboard(_blackboard), staging(blackboard.GetStaging(_idx)),
+   lock(staging.mutex),
+   basic(staging.working),
+   idx(_idx),
+   total_energy_vario_before(basic.total_energy_vario_available) {}
 
 void
 DeviceDataEditor::Commit() const noexcept
 {
+  staging.Publish();
   blackboard.ScheduleMerge();
+
+  if (basic.total_energy_vario_available.Modified(total_energy_vario_before))
+    AudioVarioGlue::SetDeviceValue(idx, basic.total_energy_vario);
 }
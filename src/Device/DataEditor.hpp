@@ -3,22 +3,44 @@
 
 #pragma once
 
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "NMEA/Validity.hpp"
 #include "thread/Mutex.hxx"
 
 class DeviceBlackboard;
 struct NMEAInfo;
 
+/**
+ * Edits the data of one device.  This locks only the device's
+ * staging area (see DeviceBlackboard::DeviceStaging), not the whole
+ * #DeviceBlackboard.
+ */
 class DeviceDataEditor {
   DeviceBlackboard &blackboard;
 
+  DeviceBlackboard::DeviceStaging &staging;
+
   const std::lock_guard<Mutex> lock;
 
   NMEAInfo &basic;
 
+  const std::size_t idx;
+
+  /**
+   * The total energy vario timestamp before editing; Commit()
+   * compares it to find out whether a new value was received.
+   */
+  const Validity total_energy_vario_before;
+
 public:
   DeviceDataEditor(DeviceBlackboard &blackboard,
                    std::size_t idx) noexcept;
 
+  /**
+   * Pass the modified data to the MergeThread.  A new vario value
+   * is also passed directly to the vario sound, which would
+   * otherwise have to wait for the merge.
+   */
   void Commit() const noexcept;
 
   NMEAInfo *operator->() const noexcept {
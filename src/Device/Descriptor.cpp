@@ -1316,8 +1316,9 @@ DeviceDescriptor::DataReceived(std::span<const std::byte> s) noexcept
 
     const ExternalSettings old_settings = basic.settings;
 
-    /* call Device::DataReceived() without holding
-       DeviceBlackboard::mutex to avoid blocking all other threads */
+    /* call Device::DataReceived() without holding the staging
+       mutex to avoid blocking threads which edit this device's
+       data */
     if (device->DataReceived(s, basic)) {
       if (!config.sync_from_device)
         basic.settings = old_settings;
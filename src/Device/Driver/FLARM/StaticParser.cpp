@@ -70,6 +70,7 @@ ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, TimeStamp clock) noexcept
 
   // PFLAA,<AlarmLevel>,<RelativeNorth>,<RelativeEast>,<RelativeVertical>,
   //   <IDType>,<ID>,<Track>,<TurnRate>,<GroundSpeed>,<ClimbRate>,<AcftType>
+  //   [,<NoTrack>,<Source>,<RSSI>]
   FlarmTraffic traffic;
   traffic.alarm_level = (FlarmTraffic::AlarmType)
     line.Read((int)FlarmTraffic::AlarmType::NONE);
@@ -139,15 +140,19 @@ ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, TimeStamp clock) noexcept
   else
     traffic.type = (FlarmTraffic::AircraftType)type;
 
+  line.Skip(); /* no-track */
+
+  traffic.source = (FlarmTraffic::SourceType)
+    line.Read((int)FlarmTraffic::SourceType::FLARM);
+
   FlarmTraffic *flarm_slot = flarm.FindTraffic(traffic.id);
   if (flarm_slot == nullptr) {
-    flarm_slot = flarm.AllocateTraffic();
+    flarm_slot = flarm.AllocateTraffic(traffic.id);
     if (flarm_slot == nullptr)
       // no more slots available
       return;
 
     flarm_slot->Clear();
-    flarm_slot->id = traffic.id;
 
     flarm.new_traffic.Update(clock);
   }
@@ -226,6 +226,10 @@ public:
     days_of_operation = mask;
   }
 
+  AirspaceActivity GetDays() const noexcept {
+    return days_of_operation;
+  }
+
   /**
    * Get asclass of airspace
    *
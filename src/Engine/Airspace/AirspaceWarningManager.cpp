@@ -8,9 +8,18 @@
 #include "AirspaceIntersectionVisitor.hpp"
 #include "AirspaceAircraftPerformance.hpp"
 #include "Task/Stats/TaskStats.hpp"
+#include "util/StaticArray.hxx"
+
+#include <algorithm>
 
 static constexpr double CRUISE_FILTER_FACT = 0.5;
 
+/**
+ * The minimum distance [m] between the aircraft (and its
+ * predictions) and the border of the candidate envelope.
+ */
+static constexpr double MIN_ENVELOPE_MARGIN = 2000;
+
 AirspaceWarningManager::AirspaceWarningManager(const AirspaceWarningConfig &_config,
                                                const Airspaces &_airspaces)
   :airspaces(_airspaces)
@@ -118,11 +127,22 @@ AirspaceWarningManager::Update(const AircraftState& state,
   for (auto &w : warnings)
     w.SaveState();
 
+  const auto glide = PredictGlide(state, glide_polar);
+  const auto filter = PredictFilter(state, circling);
+  const auto task = PredictTask(state, glide_polar, task_stats);
+
+  StaticArray<const Prediction *, 3> predictions;
+  for (const auto *i : {glide ? &*glide : nullptr, &filter,
+                        task ? &*task : nullptr})
+    if (i != nullptr)
+      predictions.push_back(i);
+
+  CollectCandidates(state.location, predictions);
+
   // check from strongest to weakest alerts
   UpdateInside(state, glide_polar);
-  UpdateGlide(state, glide_polar);
-  UpdateFilter(state, circling);
-  UpdateTask(state, glide_polar, task_stats);
+  for (const auto *i : predictions)
+    UpdatePredicted(state, *i);
 
   // action changes
   for (auto it = warnings.begin(), end = warnings.end(); it != end;) {
@@ -254,19 +274,51 @@ private:
 };
 
 
-bool 
-AirspaceWarningManager::UpdatePredicted(const AircraftState& state, 
-                                        const GeoPoint &location_predicted,
-                                        const AirspaceAircraftPerformance &perf,
-                                        const AirspaceWarning::State warning_state,
-                                        const FloatDuration max_time) noexcept
+void
+AirspaceWarningManager::CollectCandidates(const GeoPoint &location,
+                                          std::span<const Prediction *const> predictions) noexcept
+{
+  const FlatProjection &projection = airspaces.GetProjection();
+
+  FlatBoundingBox box(projection.ProjectInteger(location));
+  for (const auto *i : predictions)
+    box.Expand(projection.ProjectInteger(i->location));
+
+  if (!envelope_valid || envelope_serial != airspaces.GetSerial() ||
+      !envelope.Contains(box)) {
+    /* the aircraft is about to leave the envelope (or the airspaces
+       have been modified): query the tree with a new one, which has
+       enough margin to be reused for a while */
+    const unsigned margin =
+      std::max({box.GetWidth() / 2, box.GetHeight() / 2,
+                projection.ProjectRangeInteger(location,
+                                               MIN_ENVELOPE_MARGIN)});
+    envelope = box;
+    envelope.Grow(margin);
+    envelope_serial = airspaces.GetSerial();
+    envelope_valid = true;
+
+    candidates.clear();
+    for (const auto &i : airspaces.QueryIntersecting(envelope))
+      candidates.push_back(&i);
+  }
+
+  inside.clear();
+  for (const Airspace *i : candidates)
+    if (airspaces.IsBoxInside(*i, location) && i->IsInside(location))
+      inside.push_back(i);
+}
+
+bool
+AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
+                                        const Prediction &prediction) noexcept
 {
   // this is the time limit of intrusions, beyond which we are not interested.
   // it can be the minimum of the user set warning time, or the time of the 
   // task segment
 
   const auto max_time_limit = std::min(FloatDuration{config.warning_time},
-                                       max_time);
+                                       prediction.max_time);
 
   // the ceiling is the max height for predicted intrusions, given
   // that you may be climbing.  the ceiling is nominally set at 1000m
@@ -279,40 +331,41 @@ AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
   const auto ceiling = state.altitude
     + std::max((unsigned)1000, config.altitude_warning_margin);
 
-  AirspaceIntersectionWarningVisitor visitor(state, perf, 
-                                             *this, 
-                                             warning_state, max_time_limit,
+  AirspaceIntersectionWarningVisitor visitor(state, prediction.perf,
+                                             *this,
+                                             prediction.warning_state,
+                                             max_time_limit,
                                              ceiling);
 
-  airspaces.VisitIntersecting(state.location, location_predicted, visitor);
+  airspaces.VisitIntersecting(candidates, state.location,
+                              prediction.location, visitor);
 
   visitor.SetMode(true);
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
-    visitor.Visit(i.GetAirspacePtr());
-  }
+  for (const Airspace *i : inside)
+    visitor.Visit(i->GetAirspacePtr());
 
   return visitor.Found();
 }
 
 
-bool 
-AirspaceWarningManager::UpdateTask(const AircraftState &state,
-                                   const GlidePolar &glide_polar,
-                                   const TaskStats &task_stats)
+std::optional<AirspaceWarningManager::Prediction>
+AirspaceWarningManager::PredictTask(const AircraftState &state,
+                                    const GlidePolar &glide_polar,
+                                    const TaskStats &task_stats) const noexcept
 {
   if (!glide_polar.IsValid())
-    return false;
+    return std::nullopt;
 
   const ElementStat &current_leg = task_stats.current_leg;
 
   if (!task_stats.task_valid || !current_leg.location_remaining.IsValid())
-    return false;
+    return std::nullopt;
 
   const GlideResult &solution = current_leg.solution_remaining;
   if (!solution.IsOk() || !solution.IsAchievable())
     /* glide solver failed, cannot continue */
-    return false;
+    return std::nullopt;
 
   const AirspaceAircraftPerformance perf_task(glide_polar,
                                               current_leg.solution_remaining);
@@ -326,13 +379,14 @@ AirspaceWarningManager::UpdateTask(const AircraftState &state,
        the configured warning time */
     location_tp = state.location.IntermediatePoint(location_tp, max_distance);
 
-  return UpdatePredicted(state, location_tp, perf_task,
-                          AirspaceWarning::WARNING_TASK, time_remaining);
+  return Prediction{location_tp, perf_task,
+                    AirspaceWarning::WARNING_TASK, time_remaining};
 }
 
 
-bool 
-AirspaceWarningManager::UpdateFilter(const AircraftState& state, const bool circling)
+AirspaceWarningManager::Prediction
+AirspaceWarningManager::PredictFilter(const AircraftState& state,
+                                      const bool circling) noexcept
 {
   // update both filters even though we are using only one
   cruise_filter.Update(state);
@@ -343,30 +397,29 @@ AirspaceWarningManager::UpdateFilter(const AircraftState& state, const bool circ
     cruise_filter.GetPredictedState(prediction_time_filter).location;
 
   if (circling) 
-    return UpdatePredicted(state, location_predicted,
-                           AirspaceAircraftPerformance(circling_filter),
-                            AirspaceWarning::WARNING_FILTER, prediction_time_filter);
+    return Prediction{location_predicted,
+                      AirspaceAircraftPerformance(circling_filter),
+                      AirspaceWarning::WARNING_FILTER, prediction_time_filter};
   else
-    return UpdatePredicted(state, location_predicted,
-                           AirspaceAircraftPerformance(cruise_filter),
-                            AirspaceWarning::WARNING_FILTER, prediction_time_filter);
+    return Prediction{location_predicted,
+                      AirspaceAircraftPerformance(cruise_filter),
+                      AirspaceWarning::WARNING_FILTER, prediction_time_filter};
 }
 
 
-bool 
-AirspaceWarningManager::UpdateGlide(const AircraftState &state,
-                                    const GlidePolar &glide_polar)
+std::optional<AirspaceWarningManager::Prediction>
+AirspaceWarningManager::PredictGlide(const AircraftState &state,
+                                     const GlidePolar &glide_polar) const noexcept
 {
   if (!glide_polar.IsValid())
-    return false;
+    return std::nullopt;
 
   const GeoPoint location_predicted = 
     state.GetPredictedState(prediction_time_glide).location;
 
   const AirspaceAircraftPerformance perf_glide(glide_polar);
-  return UpdatePredicted(state, location_predicted,
-                          perf_glide,
-                          AirspaceWarning::WARNING_GLIDE, prediction_time_glide);
+  return Prediction{location_predicted, perf_glide,
+                    AirspaceWarning::WARNING_GLIDE, prediction_time_glide};
 }
 
 bool
@@ -378,8 +431,8 @@ AirspaceWarningManager::UpdateInside(const AircraftState& state,
 
   bool found = false;
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
-    const auto airspace = i.GetAirspacePtr();
+  for (const Airspace *i : inside) {
+    const auto airspace = i->GetAirspacePtr();
 
     const AltitudeState &altitude = state;
     if (// ignore inactive airspaces
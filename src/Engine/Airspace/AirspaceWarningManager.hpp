@@ -5,17 +5,23 @@
 
 #include "AirspaceWarning.hpp"
 #include "AirspaceWarningConfig.hpp"
+#include "AirspaceAircraftPerformance.hpp"
 #include "Util/AircraftStateFilter.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/Flat/FlatBoundingBox.hpp"
 #include "time/FloatDuration.hxx"
 #include "util/Serial.hpp"
 
 #include <list>
+#include <optional>
+#include <span>
+#include <vector>
 
 class TaskStats;
 class GlidePolar;
+class Airspace;
 class Airspaces;
 class FlatProjection;
-class AirspaceAircraftPerformance;
 
 /**
  * Class to detect and track airspace warnings
@@ -43,6 +49,46 @@ class AirspaceWarningManager {
 
   AirspaceWarningList warnings;
 
+  /**
+   * A predicted location which shall be checked for airspace
+   * intrusions.
+   */
+  struct Prediction {
+    GeoPoint location;
+    AirspaceAircraftPerformance perf;
+    AirspaceWarning::State warning_state;
+    FloatDuration max_time;
+  };
+
+  /**
+   * A box (in the #Airspaces projection) around the aircraft and
+   * its predictions, with a safety margin.  #candidates contains all
+   * airspaces whose bounding box intersects it.  As long as the
+   * aircraft and its predictions stay inside, the list can be reused
+   * without querying the airspace tree again.
+   */
+  FlatBoundingBox envelope;
+
+  /**
+   * The Airspaces::GetSerial() value #candidates was collected
+   * from.  Only valid if #envelope_valid is set.
+   */
+  Serial envelope_serial;
+
+  bool envelope_valid = false;
+
+  /**
+   * The airspaces which may be relevant for the current Update()
+   * call: all airspaces whose bounding box intersects #envelope, in
+   * tree order.
+   */
+  std::vector<const Airspace *> candidates;
+
+  /**
+   * The subset of #candidates which the aircraft is inside.
+   */
+  std::vector<const Airspace *> inside;
+
   /**
    * This number is incremented each time this object is modified.
    */
@@ -245,15 +291,25 @@ public:
   bool IsActive(const AbstractAirspace &airspace) const noexcept;
 
 private:
-  bool UpdateTask(const AircraftState &state, const GlidePolar &glide_polar,
-                  const TaskStats &task_stats);
-  bool UpdateFilter(const AircraftState& state, const bool circling);
-  bool UpdateGlide(const AircraftState& state, const GlidePolar &glide_polar);
+  std::optional<Prediction> PredictTask(const AircraftState &state,
+                                        const GlidePolar &glide_polar,
+                                        const TaskStats &task_stats) const noexcept;
+  Prediction PredictFilter(const AircraftState& state, bool circling) noexcept;
+  std::optional<Prediction> PredictGlide(const AircraftState& state,
+                                         const GlidePolar &glide_polar) const noexcept;
+
+  /**
+   * Make sure #candidates contains all airspaces whose bounding box
+   * contains the aircraft location or intersects the vector to one
+   * of the predictions (querying the tree only if they have left
+   * the #envelope), and fill #inside with those containing the
+   * aircraft.
+   */
+  void CollectCandidates(const GeoPoint &location,
+                         std::span<const Prediction *const> predictions) noexcept;
+
   bool UpdateInside(const AircraftState& state, const GlidePolar &glide_polar);
 
-  bool UpdatePredicted(const AircraftState& state, 
-                       const GeoPoint &location_predicted,
-                       const AirspaceAircraftPerformance &perf,
-                       const AirspaceWarning::State warning_state,
-                       FloatDuration max_time) noexcept;
+  bool UpdatePredicted(const AircraftState& state,
+                       const Prediction &prediction) noexcept;
 };
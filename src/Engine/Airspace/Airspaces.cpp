@@ -8,8 +8,13 @@
 
 #include <boost/geometry/algorithms/distance.hpp>
 #include <boost/geometry/algorithms/intersection.hpp>
+#include <boost/geometry/algorithms/intersects.hpp>
 #include <boost/geometry/strategies/strategies.hpp>
 #include <boost/geometry/geometries/segment.hpp>
+#include <boost/geometry/geometries/linestring.hpp>
+
+#include <cassert>
+#include <vector>
 
 namespace bgi = boost::geometry::index;
 
@@ -41,6 +46,73 @@ Airspaces::QueryIntersecting(const GeoPoint &a, const GeoPoint &b) const noexcep
   return {airspace_tree.qbegin(bgi::intersects(line)), airspace_tree.qend()};
 }
 
+Airspaces::const_iterator_range
+Airspaces::QueryIntersecting(std::span<const GeoPoint> path) const noexcept
+{
+  assert(!path.empty());
+
+  if (IsEmpty())
+    // nothing to do
+    return {airspace_tree.qend(), airspace_tree.qend()};
+
+  if (path.size() == 1) {
+    const auto flat_location = task_projection.ProjectInteger(path.front());
+    const FlatBoundingBox box(flat_location, flat_location);
+    return {airspace_tree.qbegin(bgi::intersects(box)), airspace_tree.qend()};
+  }
+
+  boost::geometry::model::linestring<FlatGeoPoint> line;
+  line.reserve(path.size());
+  for (const auto &i : path)
+    line.push_back(task_projection.ProjectInteger(i));
+
+  return {airspace_tree.qbegin(bgi::intersects(line)), airspace_tree.qend()};
+}
+
+Airspaces::const_iterator_range
+Airspaces::QueryIntersecting(const FlatBoundingBox &box) const noexcept
+{
+  if (IsEmpty())
+    // nothing to do
+    return {airspace_tree.qend(), airspace_tree.qend()};
+
+  return {airspace_tree.qbegin(bgi::intersects(box)), airspace_tree.qend()};
+}
+
+bool
+Airspaces::IsBoxIntersecting(const Airspace &airspace,
+                             const GeoPoint &a, const GeoPoint &b) const noexcept
+{
+  const boost::geometry::model::segment line{
+    task_projection.ProjectInteger(a),
+    task_projection.ProjectInteger(b),
+  };
+
+  return boost::geometry::intersects(static_cast<const FlatBoundingBox &>(airspace),
+                                     line);
+}
+
+bool
+Airspaces::IsBoxInside(const Airspace &airspace,
+                       const GeoPoint &location) const noexcept
+{
+  const auto flat_location = task_projection.ProjectInteger(location);
+  const FlatBoundingBox box(flat_location, flat_location);
+  return boost::geometry::intersects(static_cast<const FlatBoundingBox &>(airspace),
+                                     box);
+}
+
+void
+Airspaces::VisitIntersecting(std::span<const Airspace *const> candidates,
+                             const GeoPoint &loc, const GeoPoint &end,
+                             AirspaceIntersectionVisitor &visitor) const noexcept
+{
+  for (const Airspace *i : candidates)
+    if (IsBoxIntersecting(*i, loc, end) &&
+        visitor.SetIntersections(i->Intersects(loc, end, task_projection)))
+      visitor.Visit(i->GetAirspacePtr());
+}
+
 void
 Airspaces::VisitIntersecting(const GeoPoint &loc, const GeoPoint &end,
                              bool include_inside,
@@ -83,9 +155,19 @@ Airspaces::Optimise() noexcept
     airspace_tree.clear();
   }
 
-  for (auto &i : tmp_as) {
-    Airspace as(std::move(i), task_projection);
-    airspace_tree.insert(as);
+  if (airspace_tree.empty()) {
+    /* build the whole tree at once with the packing algorithm */
+    std::vector<Airspace> v;
+    v.reserve(tmp_as.size());
+    for (auto &i : tmp_as)
+      v.emplace_back(std::move(i), task_projection);
+
+    airspace_tree = AirspaceTree(v);
+  } else {
+    for (auto &i : tmp_as) {
+      Airspace as(std::move(i), task_projection);
+      airspace_tree.insert(as);
+    }
   }
 
   tmp_as.clear();
@@ -124,6 +206,8 @@ Airspaces::Clear() noexcept
 
   // then delete the tree
   airspace_tree.clear();
+
+  ++serial;
 }
 
 unsigned
@@ -215,10 +299,8 @@ Airspaces::SynchroniseInRange(const Airspaces &master,
 
   for (auto &i : QueryAll())
     i.ClearClearance();
-  airspace_tree.clear();
 
-  for (const auto &i : contents_master)
-    airspace_tree.insert(i);
+  airspace_tree = AirspaceTree(contents_master);
 
   ++serial;
 
@@ -12,6 +12,7 @@
 #include "Atmosphere/Pressure.hpp"
 
 #include <deque>
+#include <span>
 
 class RasterTerrain;
 class AirspaceIntersectionVisitor;
@@ -62,10 +63,23 @@ public:
    */
   void Add(AirspacePtr airspace) noexcept;
 
+  /**
+   * Returns the airspaces which have been added, but which have not
+   * yet been inserted into the tree by Optimise().
+   */
+  const std::deque<AirspacePtr> &GetPending() const noexcept {
+    return tmp_as;
+  }
+
   /**
    * Re-organise the internal airspace tree after inserting/deleting.
    * Should be called after inserting/deleting airspaces prior to performing
    * any searches, but can be done once after a batch insert/delete.
+   *
+   * If the tree needs to be (re)built from scratch (initial load,
+   * projection change), it is bulk-loaded with the packing
+   * algorithm, which is faster and yields a better tree than
+   * inserting one airspace at a time.
    */
   void Optimise() noexcept;
 
@@ -139,6 +153,42 @@ public:
   const_iterator_range QueryIntersecting(const GeoPoint &a,
                                          const GeoPoint &b) const noexcept;
 
+  /**
+   * Query airspaces whose bounding box intersects the given
+   * polyline, including its vertices.  This is one tree traversal,
+   * and each airspace is returned only once, even if several
+   * segments hit it; it can be used to collect the candidates for a
+   * batch of QueryIntersecting() and QueryInside() calls, which are
+   * then filtered with IsBoxIntersecting() and IsBoxInside().  The
+   * result is in no specific order.
+   *
+   * @param path a non-empty list of points
+   */
+  [[gnu::pure]]
+  const_iterator_range QueryIntersecting(std::span<const GeoPoint> path) const noexcept;
+
+  /**
+   * Query airspaces whose bounding box intersects the given box (in
+   * the projection returned by GetProjection()).
+   */
+  [[gnu::pure]]
+  const_iterator_range QueryIntersecting(const FlatBoundingBox &box) const noexcept;
+
+  /**
+   * Would QueryIntersecting(a, b) return this airspace?
+   */
+  [[gnu::pure]]
+  bool IsBoxIntersecting(const Airspace &airspace,
+                         const GeoPoint &a, const GeoPoint &b) const noexcept;
+
+  /**
+   * Is the location inside the airspace's bounding box?  This is the
+   * first check done by QueryInside().
+   */
+  [[gnu::pure]]
+  bool IsBoxInside(const Airspace &airspace,
+                   const GeoPoint &location) const noexcept;
+
   /**
    * Call visitor class on airspaces intersected by vector.
    * Note that the visitor is not instantiated separately for each match
@@ -158,6 +208,17 @@ public:
     VisitIntersecting(location, end, false, visitor);
   }
 
+  /**
+   * Like VisitIntersecting() (without "include_inside"), but check
+   * only the given candidates instead of querying the tree.  The
+   * candidates must be a superset of what QueryIntersecting() would
+   * return, e.g. obtained by a QueryIntersecting() call with a path
+   * containing this vector.
+   */
+  void VisitIntersecting(std::span<const Airspace *const> candidates,
+                         const GeoPoint &location, const GeoPoint &end,
+                         AirspaceIntersectionVisitor &visitor) const noexcept;
+
   /**
    * Query airspaces this location is inside.
    *
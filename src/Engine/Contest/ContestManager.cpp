@@ -2,6 +2,12 @@
 // Copyright The XCSoar Project
 
 #include "ContestManager.hpp"
+#include "thread/Thread.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <thread>
 
 ContestManager::ContestManager(const Contest _contest,
                                const Trace &trace_full,
@@ -9,6 +15,7 @@ ContestManager::ContestManager(const Contest _contest,
                                const Trace &trace_sprint,
                                bool predict_triangle) noexcept
   :contest(_contest),
+   max_threads(std::max(std::thread::hardware_concurrency(), 1U)),
    olc_sprint(trace_sprint),
    olc_fai(trace_triangle, predict_triangle),
    olc_classic(trace_full),
@@ -140,6 +147,100 @@ RunContest(AbstractContest &_contest,
   return true;
 }
 
+namespace {
+
+/**
+ * One invocation of RunContest() which may be executed in a separate
+ * thread.
+ */
+struct ContestJob {
+  AbstractContest &contest;
+  ContestResult &result;
+  ContestTraceVector &solution;
+
+  bool retval = false;
+
+  void Run(bool exhaustive) noexcept {
+    retval = RunContest(contest, result, solution, exhaustive);
+  }
+};
+
+/**
+ * A short-lived thread which runs one exhaustive #ContestJob.
+ */
+class ContestJobThread final : public Thread {
+  ContestJob &job;
+
+public:
+  explicit ContestJobThread(ContestJob &_job) noexcept
+    :Thread("ContestSolver"), job(_job) {}
+
+protected:
+  void Run() noexcept override {
+    job.Run(true);
+  }
+};
+
+} // anonymous namespace
+
+/**
+ * Run several independent solvers.  In exhaustive mode, up to
+ * #max_threads-1 of them (but never the first one) are moved to
+ * separate threads, and this function waits for all of them to
+ * finish.  Each solver works on its own
+ * #TracePointerVector copy, and the master #Trace is not modified
+ * while the calling thread is blocked here, so the solvers do not
+ * need any locking.
+ *
+ * Incremental searches are limited to a few iterations per call;
+ * they are not worth the thread overhead and run serially.
+ *
+ * @return true if at least one solver has found a new solution
+ */
+template<std::size_t N>
+static bool
+RunContests(std::array<ContestJob, N> &&jobs, bool exhaustive,
+            unsigned max_threads) noexcept
+{
+  static_assert(N > 1);
+
+  std::array<std::optional<ContestJobThread>, N - 1> threads;
+
+  if (exhaustive) {
+    const std::size_t n_threads = std::min<std::size_t>(max_threads, N);
+    for (std::size_t i = 1; i < n_threads; ++i) {
+      auto &thread = threads[i - 1].emplace(jobs[i]);
+
+      try {
+        thread.Start();
+      } catch (...) {
+        /* fall back to running this job in the calling thread */
+        threads[i - 1].reset();
+      }
+    }
+  }
+
+  /* run the remaining jobs in the calling thread while the others
+     are busy */
+  jobs.front().Run(exhaustive);
+  for (std::size_t i = 1; i < N; ++i)
+    if (!threads[i - 1])
+      jobs[i].Run(exhaustive);
+
+  for (auto &thread : threads) {
+    if (thread) {
+      thread->Join();
+      thread.reset();
+    }
+  }
+
+  bool retval = false;
+  for (const auto &job : jobs)
+    retval |= job.retval;
+
+  return retval;
+}
+
 bool
 ContestManager::UpdateIdle(bool exhaustive) noexcept
 {
@@ -175,11 +276,10 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::OLC_PLUS:
-    retval = RunContest(olc_classic, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(olc_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContests(std::array<ContestJob, 2>{{
+        {olc_classic, stats.result[0], stats.solution[0]},
+        {olc_fai, stats.result[1], stats.solution[1]},
+      }}, exhaustive, max_threads);
 
     if (retval) {
       olc_plus.Feed(stats.result[0], stats.solution[0],
@@ -197,17 +297,17 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::XCONTEST:
-    retval = RunContest(xcontest_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(xcontest_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContests(std::array<ContestJob, 2>{{
+        {xcontest_free, stats.result[0], stats.solution[0]},
+        {xcontest_triangle, stats.result[1], stats.solution[1]},
+      }}, exhaustive, max_threads);
     break;
 
   case Contest::DHV_XC:
-    retval = RunContest(dhv_xc_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(dhv_xc_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContests(std::array<ContestJob, 2>{{
+        {dhv_xc_free, stats.result[0], stats.solution[0]},
+        {dhv_xc_triangle, stats.result[1], stats.solution[1]},
+      }}, exhaustive, max_threads);
     break;
 
   case Contest::SIS_AT:
@@ -221,14 +321,11 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::WEGLIDE_FREE:
-    retval = RunContest(weglide_distance, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(weglide_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
-
-    retval |= RunContest(weglide_or, stats.result[2],
-                         stats.solution[2], exhaustive);
+    retval = RunContests(std::array<ContestJob, 3>{{
+        {weglide_distance, stats.result[0], stats.solution[0]},
+        {weglide_fai, stats.result[1], stats.solution[1]},
+        {weglide_or, stats.result[2], stats.solution[2]},
+      }}, exhaustive, max_threads);
 
     if (retval) {
       weglide_free.Feed(stats.result[0], stats.solution[0],
@@ -32,6 +32,13 @@ class ContestManager
 
   Contest contest;
 
+  /**
+   * The maximum number of threads (including the calling thread)
+   * which run the independent solvers of one contest during
+   * exhaustive searches.  Defaults to the number of CPU cores.
+   */
+  unsigned max_threads;
+
   ContestStatistics stats;
 
   OLCSprint olc_sprint;
@@ -76,6 +83,16 @@ public:
 
   void SetIncremental(bool incremental) noexcept;
 
+  /**
+   * Limit the number of threads which run independent solvers (e.g.
+   * OLC Classic and OLC FAI for OLC Plus) concurrently during
+   * exhaustive searches.  1 runs them serially in the calling
+   * thread.
+   */
+  void SetMaxThreads(unsigned _max_threads) noexcept {
+    max_threads = _max_threads;
+  }
+
   /**
    * @see ContestDijkstra::SetPredicted()
    */
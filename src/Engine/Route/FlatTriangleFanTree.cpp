@@ -9,6 +9,8 @@
 #include "util/GlobalSliceAllocator.hxx"
 #include "Geo/Flat/FlatProjection.hpp"
 
+#include <array>
+
 #define REACH_SWEEP (ROUTEPOLAR_Q1-BUFFER)
 
 static bool
@@ -106,8 +108,13 @@ FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin, const int index_low,
   }
 
   fan.AddOrigin(origin, index_high - index_low);
-  for (int index = index_low; index < index_high; ++index) {
-    FlatGeoPoint x = parms.ReachIntercept(index, origin, geo_origin);
+
+  std::array<FlatGeoPoint, ROUTEPOLAR_POINTS> intercepts;
+  const std::span<FlatGeoPoint> rays{intercepts.data(),
+                                     std::size_t(index_high - index_low)};
+  parms.ReachIntercepts(index_low, rays, origin, geo_origin);
+
+  for (FlatGeoPoint x : rays) {
     /* if ReachIntercept() did not find anything reasonable it returns
        a FlatGeoPoint that is almost the same as origin, but differs
        +/- 1 due to conversion errors. The resulting polygon can have
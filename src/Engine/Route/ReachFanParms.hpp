@@ -31,4 +31,11 @@ struct ReachFanParms {
     return rpolars.ReachIntercept(index, flat_origin, origin,
                                   terrain, projection);
   }
+
+  void ReachIntercepts(int index_low, std::span<FlatGeoPoint> results,
+                       const AFlatGeoPoint &flat_origin,
+                       const GeoPoint &origin) const {
+    rpolars.ReachIntercepts(index_low, results, flat_origin, origin,
+                            terrain, projection);
+  }
 };
@@ -7,6 +7,9 @@
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Terrain/RasterMap.hpp"
 
+#include <array>
+#include <cassert>
+
 static constexpr double MC_CEILING_PENALTY_FACTOR = 5.0;
 
 inline FlatGeoPoint
@@ -239,6 +242,46 @@ RoutePolars::ReachIntercept(const int index, const AFlatGeoPoint &flat_origin,
   const GeoPoint p = map->GroundIntersection(origin, altitude,
                                              altitude, dest, height_min_working);
 
+  return ClipIntercept(flat_origin, flat_dest, p, proj);
+}
+
+void
+RoutePolars::ReachIntercepts(const int index_low,
+                             std::span<FlatGeoPoint> results,
+                             const AFlatGeoPoint &flat_origin,
+                             const GeoPoint &origin,
+                             const RasterMap *map,
+                             const FlatProjection &proj) const noexcept
+{
+  assert(results.size() <= ROUTEPOLAR_POINTS);
+
+  const bool valid = map && map->IsDefined();
+  const int altitude = flat_origin.altitude - GetSafetyHeight();
+
+  for (std::size_t i = 0; i < results.size(); ++i)
+    results[i] = MSLIntercept(index_low + int(i), flat_origin, altitude, proj);
+
+  if (!valid)
+    return;
+
+  std::array<GeoPoint, ROUTEPOLAR_POINTS> dest, p;
+  for (std::size_t i = 0; i < results.size(); ++i)
+    dest[i] = proj.Unproject(results[i]);
+
+  map->GroundIntersections(origin, altitude, altitude,
+                           std::span{dest}.first(results.size()),
+                           height_min_working, p);
+
+  for (std::size_t i = 0; i < results.size(); ++i)
+    results[i] = ClipIntercept(flat_origin, results[i], p[i], proj);
+}
+
+FlatGeoPoint
+RoutePolars::ClipIntercept(const FlatGeoPoint &flat_origin,
+                           const FlatGeoPoint &flat_dest,
+                           const GeoPoint &p,
+                           const FlatProjection &proj) noexcept
+{
   if (!p.IsValid())
     return flat_dest;
 
@@ -248,8 +291,8 @@ RoutePolars::ReachIntercept(const int index, const AFlatGeoPoint &flat_origin,
      right next to our origin, the intersection may be deformed due to
      terrain raster rounding errors; the following code applies
      clipping to avoid degenerate polygons */
-  FlatGeoPoint delta1 = flat_dest - (FlatGeoPoint)flat_origin;
-  FlatGeoPoint delta2 = fp - (FlatGeoPoint)flat_origin;
+  FlatGeoPoint delta1 = flat_dest - flat_origin;
+  FlatGeoPoint delta2 = fp - flat_origin;
 
   if (delta1.x * delta2.x < 0)
     /* intersection is on the wrong horizontal side */
@@ -8,6 +8,7 @@
 #include "Point.hpp"
 
 #include <optional>
+#include <span>
 #include <limits.h>
 
 class GlidePolar;
@@ -241,7 +242,30 @@ public:
                               const RasterMap* map,
                               const FlatProjection &proj) const noexcept;
 
+  /**
+   * Calculate ReachIntercept() for the consecutive indices starting
+   * at #index_low, one for each element of #results.  This is
+   * cheaper than calling ReachIntercept() in a loop, because the
+   * terrain rays are submitted as one batch (see
+   * RasterMap::GroundIntersections()).
+   */
+  void ReachIntercepts(int index_low, std::span<FlatGeoPoint> results,
+                       const AFlatGeoPoint &flat_origin,
+                       const GeoPoint &origin,
+                       const RasterMap *map,
+                       const FlatProjection &proj) const noexcept;
+
 private:
+  /**
+   * Convert the result of RasterMap::GroundIntersection() to a
+   * #FlatGeoPoint, falling back to the MSL intercept #flat_dest.
+   */
+  [[gnu::pure]]
+  static FlatGeoPoint ClipIntercept(const FlatGeoPoint &flat_origin,
+                                    const FlatGeoPoint &flat_dest,
+                                    const GeoPoint &p,
+                                    const FlatProjection &proj) noexcept;
+
   [[gnu::pure]]
   FlatGeoPoint MSLIntercept(const int index, const FlatGeoPoint &p,
                             double altitude,
@@ -16,6 +16,13 @@ static constexpr double min_search_range = 50000;
 /** max search range in m */
 static constexpr double max_search_range = 100000;
 
+/**
+ * The number of nearest landable waypoints which are checked for
+ * reachability; more distant ones are unlikely to make it into the
+ * list of #AbortTask::max_abort items sorted by arrival time.
+ */
+static constexpr unsigned max_candidates = 128;
+
 AbortTask::AbortTask(const TaskBehaviour &_task_behaviour,
                      const Waypoints &wps) noexcept
   :UnorderedTask(TaskType::ABORT, _task_behaviour),
@@ -97,44 +104,54 @@ IsReachable(const GlideResult &result, bool final_glide) noexcept
     : result.IsAchievable();
 }
 
+void
+AbortTask::SolveCandidates(const AircraftState &state,
+                           CandidateList &candidates,
+                           const GlidePolar &polar) const noexcept
+{
+  for (auto &i : candidates) {
+    UnorderedTaskPoint t(i.waypoint, task_behaviour);
+    i.solution = TaskSolution::GlideSolutionRemaining(t, state,
+                                                      task_behaviour.glide,
+                                                      polar);
+  }
+}
+
 bool
-AbortTask::FillReachable(const AircraftState &state,
-                         AlternateList &approx_waypoints,
-                         const GlidePolar &polar, bool only_airfield,
-                         bool final_glide, [[maybe_unused]] bool safety) noexcept
+AbortTask::FillReachable(CandidateList &candidates,
+                         bool only_airfield, bool final_glide) noexcept
 {
-  if (IsTaskFull() || approx_waypoints.empty())
+  if (IsTaskFull() || candidates.empty())
     return false;
 
-  const AGeoPoint p_start(state.location, state.altitude);
-
   bool found_final_glide = false;
   AlternateList q;
   q.reserve(32);
 
-  for (auto v = approx_waypoints.begin(); v != approx_waypoints.end();) {
+  for (auto v = candidates.begin(); v != candidates.end();) {
     if (only_airfield && !v->waypoint->IsAirport()) {
       ++v;
       continue;
     }
 
-    UnorderedTaskPoint t(v->waypoint, task_behaviour);
-    GlideResult result =
-        TaskSolution::GlideSolutionRemaining(t, state,
-                                             task_behaviour.glide, polar);
+    const GlideResult &result = v->solution;
 
     if (IsReachable(result, final_glide)) {
       bool intersects = false;
       const bool is_reachable_final = IsReachable(result, true);
 
-      if (intersection_test && final_glide && is_reachable_final)
-        intersects = intersection_test->Intersects(
-            AGeoPoint(v->waypoint->location, result.min_arrival_altitude));
+      if (intersection_test && final_glide && is_reachable_final) {
+        if (!v->intersects)
+          v->intersects = intersection_test->Intersects(
+              AGeoPoint(v->waypoint->location, result.min_arrival_altitude));
+
+        intersects = *v->intersects;
+      }
 
       if (!intersects) {
         q.emplace_back(v->waypoint, result);
         // remove it since it's already in the list now      
-        v = approx_waypoints.erase(v);
+        v = candidates.erase(v);
 
         if (is_reachable_final)
           found_final_glide = true;
@@ -196,32 +213,35 @@ AbortTask::UpdateSample(const AircraftState &state,
     /* can't work without a polar */
     return false;
 
-  AlternateList approx_waypoints;
-  approx_waypoints.reserve(128);
+  CandidateList candidates;
+  candidates.reserve(max_candidates);
 
-  waypoints.VisitWithinRange(state.location,
-                             GetAbortRange(state, glide_polar), [&approx_waypoints](const auto &wp){
-                               if (wp->IsLandable())
-                                 approx_waypoints.emplace_back(wp);
-                             });
-  if (approx_waypoints.empty()) {
+  waypoints.VisitNearestLandable(state.location,
+                                 GetAbortRange(state, glide_polar),
+                                 max_candidates,
+                                 [&candidates](const auto &wp){
+                                   candidates.emplace_back(wp);
+                                 });
+  if (candidates.empty()) {
     /** @todo increase range */
     return false;
   }
 
+  /* all passes use the same polar, so each candidate needs to be
+     solved only once */
+  SolveCandidates(state, candidates, glide_polar);
+
   // sort by arrival time
 
   // first try with final glide only
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
-                                       true, true, true);
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
-                                       false, true, true);
+  reachable_landable |=  FillReachable(candidates, true, true);
+  reachable_landable |=  FillReachable(candidates, false, true);
 
   // inform clients that the landable reachable scan has been performed 
   ClientUpdate(state, true);
 
   // now try without final glide constraint and not preferring airports
-  FillReachable(state, approx_waypoints, glide_polar, false, false, false);
+  FillReachable(candidates, false, false);
 
   // inform clients that the landable unreachable scan has been performed 
   ClientUpdate(state, false);
@@ -6,12 +6,12 @@
 #include "UnorderedTask.hpp"
 #include "UnorderedTaskPoint.hpp"
 
+#include <optional>
 #include <vector>
 #include <cassert>
 
 class Waypoints;
 class AbortIntersectionTest;
-class AlternateList;
 
 /**
  * Abort task provides automatic management of a sorted list of task points
@@ -45,6 +45,28 @@ protected:
   AlternateTaskVector task_points;
 
 private:
+  /**
+   * A landable waypoint within range.  Its glide solution is
+   * calculated only once per update, and the FillReachable() passes
+   * only filter and sort these.
+   */
+  struct Candidate {
+    WaypointPtr waypoint;
+
+    GlideResult solution;
+
+    /**
+     * The cached result of AbortIntersectionTest::Intersects(); empty
+     * if it was not tested yet.
+     */
+    std::optional<bool> intersects;
+
+    explicit Candidate(const WaypointPtr &_waypoint) noexcept
+      :waypoint(_waypoint) {}
+  };
+
+  using CandidateList = std::vector<Candidate>;
+
   /** max number of items in list */
   static constexpr AlternateTaskVector::size_type max_abort = 10;
 
@@ -135,24 +157,27 @@ protected:
   double GetAbortRange(const AircraftState &state_now,
                        const GlidePolar &glide_polar) const noexcept;
 
+  /**
+   * Calculate the glide solution of all candidates.
+   */
+  void SolveCandidates(const AircraftState &state,
+                       CandidateList &candidates,
+                       const GlidePolar &polar) const noexcept;
+
   /**
    * Fill abort task list with candidate waypoints given a list of
    * waypoints satisfying approximate range queries.  Can be used
    * to add airfields only, or landpoints.
    *
-   * @param state Aircraft state
-   * @param approx_waypoints List of candidate waypoints
-   * @param polar Polar used for tests
+   * @param candidates List of candidate waypoints with their
+   * solutions (see SolveCandidates())
    * @param only_airfield If true, only add waypoints that are airfields.
    * @param final_glide Whether solution must be glide only or climb allowed
-   * @param safety Whether solution uses safety polar
    *
    * @return True if a landpoint within final glide was found
    */
-  bool FillReachable(const AircraftState &state,
-                     AlternateList &approx_waypoints,
-                     const GlidePolar &polar, bool only_airfield,
-                     bool final_glide, bool safety) noexcept;
+  bool FillReachable(CandidateList &candidates,
+                     bool only_airfield, bool final_glide) noexcept;
 
 protected:
   /**
@@ -14,11 +14,24 @@ Trace::Trace(const Time _no_thin_time, const Time max_time,
    max_time(max_time),
    no_thin_time(_no_thin_time),
    max_size(max_size),
-   opt_size((3 * max_size) / 4)
+   opt_size((3 * max_size) / 4),
+   point_column(max_size),
+   flat_column(max_size),
+   time_column(max_size)
 {
   assert(max_size >= 4);
 }
 
+void
+Trace::RebuildColumns() noexcept
+{
+  unsigned i = 0;
+  for (const auto &td : chronological_list)
+    SetColumns(i++, td.point);
+
+  assert(i == cached_size);
+}
+
 void
 Trace::clear() noexcept
 {
@@ -149,6 +162,8 @@ Trace::EraseEarlierThan(const Time p_time) noexcept
   if (!empty())
     EraseStart(GetFront());
 
+  RebuildColumns();
+
   ++modify_serial;
   ++append_serial;
   return true;
@@ -237,6 +252,7 @@ Trace::push_back(const TracePoint &point) noexcept
   delta_list.insert(*td);
   chronological_list.push_back(*td);
 
+  SetColumns(cached_size, td->point);
   ++cached_size;
 
   if (td != &chronological_list.front())
@@ -331,6 +347,8 @@ Trace::Thin() noexcept
 
   assert(size() < max_size);
 
+  RebuildColumns();
+
   average_delta_distance = CalcAverageDeltaDistance(no_thin_time);
   average_delta_time = CalcAverageDeltaTime(no_thin_time);
 
@@ -341,56 +359,18 @@ Trace::Thin() noexcept
 void
 Trace::GetPoints(TracePointVector& iov) const noexcept
 {
+  const auto points = GetPointColumn();
   iov.clear();
-  iov.reserve(size());
-  std::copy(begin(), end(), std::back_inserter(iov));
+  iov.reserve(points.size());
+  for (const TracePoint *point : points)
+    iov.push_back(*point);
 }
 
-template<typename I>
-class PointerIterator {
-  I i;
-
-public:
-  typedef typename I::iterator_category iterator_category;
-  typedef typename I::pointer value_type;
-  typedef typename I::pointer *pointer;
-  typedef value_type &reference;
-  typedef typename I::difference_type difference_type;
-
-  PointerIterator() = default;
-  explicit PointerIterator(I _i) noexcept:i(_i) {}
-
-  PointerIterator<I> &operator--() noexcept {
-    --i;
-    return *this;
-  }
-
-  PointerIterator<I> &operator++() noexcept {
-    ++i;
-    return *this;
-  }
-
-  typename I::pointer operator*() noexcept {
-    return &*i;
-  }
-
-  bool operator==(const PointerIterator<I> &other) const noexcept {
-    return i == other.i;
-  }
-
-  bool operator!=(const PointerIterator<I> &other) const noexcept {
-    return i != other.i;
-  }
-};
-
 void
 Trace::GetPoints(TracePointerVector &v) const noexcept
 {
-  v.clear();
-  v.reserve(size());
-  std::copy(PointerIterator<decltype(begin())>(begin()),
-            PointerIterator<decltype(end())>(end()),
-            std::back_inserter(v));
+  const auto points = GetPointColumn();
+  v.assign(points.begin(), points.end());
 }
 
 bool
@@ -402,11 +382,8 @@ Trace::SyncPoints(TracePointerVector &v) const noexcept
     /* no news */
     return false;
 
-  v.reserve(size());
-
-  PointerIterator<decltype(end())> e(end());
-  std::copy(std::prev(e, size() - v.size()), e,
-            std::back_inserter(v));
+  const auto points = GetPointColumn();
+  v.insert(v.end(), std::next(points.begin(), v.size()), points.end());
   assert(v.size() == size());
   return true;
 }
@@ -417,28 +394,24 @@ Trace::GetPoints(TracePointVector &v, const Time min_time,
                  double min_distance) const noexcept
 {
   /* skip the trace points that are before min_time */
-  Trace::const_iterator i = begin(), end = this->end();
-  unsigned skipped = 0;
-  while (true) {
-    if (i == end)
-      /* nothing left */
-      return;
-
-    if (i->GetTime() >= min_time)
-      /* found the first point that is within range */
-      break;
-
-    ++i;
-    ++skipped;
-  }
+  const unsigned first = FindTime(min_time);
+  if (first == size())
+    /* nothing left */
+    return;
 
-  assert(skipped < size());
+  const auto points = GetPointColumn();
+  const auto flat = GetFlatColumn();
 
-  v.reserve(size() - skipped);
+  v.reserve(size() - first);
   const unsigned range = ProjectRange(location, min_distance);
   const unsigned sq_range = range * range;
-  do {
-    v.push_back(*i);
-    i.NextSquareRange(sq_range, end);
-  } while (i != end);
+
+  unsigned previous = first;
+  v.push_back(*points[previous]);
+  for (unsigned i = first + 1; i < size(); ++i) {
+    if (flat[i].DistanceSquared(flat[previous]) >= sq_range) {
+      v.push_back(*points[i]);
+      previous = i;
+    }
+  }
 }
@@ -7,6 +7,7 @@
 #include "util/NonCopyable.hpp"
 #include "util/Sanitizer.hxx"
 #include "util/SliceAllocator.hxx"
+#include "util/AllocatedArray.hxx"
 #include "util/Serial.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 #include "time/Stamp.hpp"
@@ -15,6 +16,7 @@
 #include <boost/intrusive/set.hpp>
 #include <algorithm>
 #include <cassert>
+#include <span>
 #include <type_traits>
 #include <stdlib.h>
 
@@ -190,6 +192,23 @@ class Trace : private NonCopyable
 
   Serial append_serial, modify_serial;
 
+  /**
+   * A "structure of arrays" mirror of #chronological_list: element i
+   * of each array describes the i-th oldest point.  These are
+   * allocated with #max_size elements upon construction and are
+   * never reallocated, so the spans returned by the getters remain
+   * valid as long as the #Trace exists; their contents (up to
+   * size()) are valid until #modify_serial changes.
+   *
+   * They are updated incrementally by push_back(), and rebuilt
+   * after points have been removed from the middle or the front.
+   * GetPoints() and SyncPoints() copy from them instead of walking
+   * the list.
+   */
+  AllocatedArray<const TracePoint *> point_column;
+  AllocatedArray<FlatGeoPoint> flat_column;
+  AllocatedArray<Time> time_column;
+
   template<typename Alloc>
   struct Disposer {
     Alloc &alloc;
@@ -298,6 +317,22 @@ protected:
    */
   void EraseStart(TraceDelta &td_start) noexcept;
 
+  /**
+   * Store the given point at the specified index of the columns.
+   */
+  void SetColumns(unsigned i, const TracePoint &point) noexcept {
+    assert(i < max_size);
+
+    point_column[i] = &point;
+    flat_column[i] = point.GetFlatLocation();
+    time_column[i] = point.GetTime();
+  }
+
+  /**
+   * Refill all columns from #chronological_list.
+   */
+  void RebuildColumns() noexcept;
+
 public:
   /**
    * Add trace to internal store.  Call optimise() periodically
@@ -392,6 +427,39 @@ public:
   void GetPoints(TracePointVector &v, Time min_time,
                  const GeoPoint &location, double resolution) const noexcept;
 
+  /**
+   * Returns pointers to all points in chronological order.  See
+   * #point_column for the lifetime of the data.
+   */
+  std::span<const TracePoint *const> GetPointColumn() const noexcept {
+    return {point_column.data(), size()};
+  }
+
+  /**
+   * Returns the projected locations of all points in chronological
+   * order (see GetProjection()).
+   */
+  std::span<const FlatGeoPoint> GetFlatColumn() const noexcept {
+    return {flat_column.data(), size()};
+  }
+
+  /**
+   * Returns the time stamps of all points in ascending order.
+   */
+  std::span<const Time> GetTimeColumn() const noexcept {
+    return {time_column.data(), size()};
+  }
+
+  /**
+   * Returns the index of the first point which is not older than the
+   * given time, or size() if there is none.
+   */
+  [[gnu::pure]]
+  unsigned FindTime(Time t) const noexcept {
+    const auto times = GetTimeColumn();
+    return std::lower_bound(times.begin(), times.end(), t) - times.begin();
+  }
+
   const TracePoint &front() const noexcept {
     assert(!empty());
 
@@ -236,6 +236,38 @@ Waypoints::VisitWithinRange(const GeoPoint &loc, const double range,
   waypoint_tree.VisitWithinRange(point, mrange, visitor);
 }
 
+unsigned
+Waypoints::VisitNearestIf(const GeoPoint &loc, double range,
+                          unsigned max_results,
+                          const WaypointPredicate &predicate,
+                          WaypointVisitor visitor) const
+{
+  if (IsEmpty())
+    return 0;
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  return waypoint_tree.VisitNearestIf(point, mrange, max_results,
+                                      [&predicate](const WaypointPtr &ptr){
+                                        return predicate(*ptr);
+                                      },
+                                      [&visitor](const WaypointPtr &ptr,
+                                                 unsigned){
+                                        visitor(ptr);
+                                      });
+}
+
+unsigned
+Waypoints::VisitNearestLandable(const GeoPoint &loc, double range,
+                                unsigned max_results,
+                                WaypointVisitor visitor) const
+{
+  return VisitNearestIf(loc, range, max_results, IsLandable,
+                        std::move(visitor));
+}
+
 void
 Waypoints::VisitNamePrefix(tstring_view prefix,
                            WaypointVisitor visitor) const
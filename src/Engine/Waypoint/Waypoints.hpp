@@ -14,6 +14,7 @@
 #include <functional>
 
 using WaypointVisitor = std::function<void(const WaypointPtr &)>;
+using WaypointPredicate = std::function<bool(const Waypoint &)>;
 
 /**
  * Container for waypoints using kd-tree representation internally for
@@ -278,6 +279,36 @@ public:
   void VisitWithinRange(const GeoPoint &loc, double range,
                         WaypointVisitor visitor) const;
 
+  /**
+   * Call visitor function on the nearest waypoints within range
+   * which match the predicate, nearest first.  Unlike
+   * VisitWithinRange(), this stops searching as soon as no more
+   * distant waypoint can qualify, i.e. the cost depends on
+   * #max_results, not on the number of waypoints within range.
+   *
+   * Performs search according to flat-earth internal
+   * representation, so is approximate.
+   *
+   * @param loc Location from which to search
+   * @param range Distance in meters of search radius
+   * @param max_results the maximum number of waypoints to visit
+   * @param predicate Callback that checks whether the waypoint
+   * is suitable for the request
+   * @param visitor Visitor to be called on the matching waypoints
+   * @return the number of waypoints passed to the visitor
+   */
+  unsigned VisitNearestIf(const GeoPoint &loc, double range,
+                          unsigned max_results,
+                          const WaypointPredicate &predicate,
+                          WaypointVisitor visitor) const;
+
+  /**
+   * Like VisitNearestIf(), but only landable waypoints.
+   */
+  unsigned VisitNearestLandable(const GeoPoint &loc, double range,
+                                unsigned max_results,
+                                WaypointVisitor visitor) const;
+
   /**
    * Call visitor function on waypoints with the specified name
    * prefix.
@@ -7,6 +7,14 @@
 #include "Geo/GeoVector.hpp"
 #include "time/Cast.hxx"
 
+FlarmComputer::OwnState::OwnState(const NMEAInfo &basic) noexcept
+  :location(basic.location_available ? basic.location : GeoPoint::Invalid()),
+   altitude(basic.gps_altitude_available ? basic.gps_altitude : 0),
+   time(basic.time_available ? basic.time : TimeStamp::Undefined()),
+   location_available(basic.location_available),
+   altitude_available(basic.gps_altitude_available),
+   time_available(basic.time_available) {}
+
 void
 FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
                        const NMEAInfo &basic) noexcept
@@ -42,8 +50,24 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
     }
   }
 
+  const OwnState state(basic);
+  const bool same_state = state == last_state;
+  const TrafficTable input = flarm.traffic.list;
+
+  /* the derived fields of unchanged targets would be calculated
+     the same way as in the previous call (with a zero time
+     difference to the previous result, if last_fix has been
+     updated meanwhile), so take them from there */
+  if (same_state)
+    flarm.traffic.list.ReplaceSharedChunks(last_input, last_output);
+
   // for each item in traffic
-  for (auto &traffic : flarm.traffic.list) {
+  for (unsigned i = 0; i < flarm.traffic.list.size(); ++i) {
+    if (same_state && flarm.traffic.list.IsChunkSharedWith(last_output, i))
+      continue;
+
+    FlarmTraffic &traffic = flarm.traffic.list.Edit(i);
+
     // if we don't know the target's name yet
     if (!traffic.HasName()) {
       // lookup the name of this target's id
@@ -136,4 +160,10 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
         traffic.speed = last_traffic->speed;
     }
   }
+
+  last_state = state;
+  last_input = input;
+  last_output = flarm.traffic.list;
+
+  conflict_predictor.Predict(flarm.traffic, basic, flarm.conflicts);
 }
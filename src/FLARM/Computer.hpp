@@ -4,6 +4,10 @@
 #pragma once
 
 #include "Calculations.hpp"
+#include "ConflictPredictor.hpp"
+#include "TrafficTable.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "time/Stamp.hpp"
 
 struct FlarmData;
 struct NMEAInfo;
@@ -11,10 +15,38 @@ struct NMEAInfo;
 class FlarmComputer {
   FlarmCalculations flarm_calculations;
 
+  FlarmConflictPredictor conflict_predictor;
+
+  /**
+   * The own values which the derived target fields depend on.
+   */
+  struct OwnState {
+    GeoPoint location = GeoPoint::Invalid();
+    double altitude = 0;
+    TimeStamp time = TimeStamp::Undefined();
+    bool location_available = false, altitude_available = false;
+    bool time_available = false;
+
+    OwnState() noexcept = default;
+    explicit OwnState(const NMEAInfo &basic) noexcept;
+
+    bool operator==(const OwnState &) const noexcept = default;
+  };
+
+  /**
+   * The own state, the traffic list passed to the previous
+   * Process() call and the list it produced.  Chunks which are
+   * still shared with #last_input have not changed, and if the own
+   * state has not changed either, the results in #last_output can
+   * be reused instead of copying and recalculating the chunk.
+   */
+  OwnState last_state;
+  TrafficTable last_input, last_output;
+
 public:
   /**
    * Calculates location, altitude, average climb speed and
-   * looks up the callsign of each target
+   * looks up the callsign of each target; predicts conflicts
    */
   void Process(FlarmData &flarm, const FlarmData &last_flarm,
                const NMEAInfo &basic) noexcept;
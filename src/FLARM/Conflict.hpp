@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Traffic.hpp"
+#include "util/TrivialArray.hxx"
+
+#include <type_traits>
+#include <utility>
+
+/**
+ * A predicted conflict with a traffic target, calculated by
+ * #FlarmConflictPredictor.
+ */
+struct FlarmConflict {
+  FlarmId id;
+
+  /** Time until the closest point of approach [s] */
+  float time;
+
+  /** Horizontal distance at the closest point of approach [m] */
+  float horizontal_distance;
+
+  /** Vertical separation at the closest point of approach [m] */
+  float vertical_separation;
+
+  FlarmTraffic::AlarmType level;
+
+  /**
+   * Is this conflict more urgent than the other one?
+   */
+  [[gnu::pure]]
+  bool IsMoreUrgentThan(const FlarmConflict &other) const noexcept {
+    if (level != other.level)
+      return (unsigned)level > (unsigned)other.level;
+
+    return time < other.time;
+  }
+};
+
+/**
+ * The most urgent predicted conflicts, ordered by urgency.  This only
+ * contains targets for which the FLARM did not report an alarm
+ * itself, i.e. ADS-B, ADS-R and TIS-B targets.
+ */
+struct FlarmConflictList {
+  static constexpr std::size_t MAX_SIZE = 8;
+
+  TrivialArray<FlarmConflict, MAX_SIZE> list;
+
+  void Clear() noexcept {
+    list.clear();
+  }
+
+  bool IsEmpty() const noexcept {
+    return list.empty();
+  }
+
+  /**
+   * Returns the most urgent conflict or nullptr if there is none.
+   */
+  const FlarmConflict *GetMostUrgent() const noexcept {
+    return list.empty() ? nullptr : &list.front();
+  }
+
+  FlarmTraffic::AlarmType GetAlarmLevel() const noexcept {
+    return list.empty() ? FlarmTraffic::AlarmType::NONE : list.front().level;
+  }
+
+  [[gnu::pure]]
+  const FlarmConflict *Find(FlarmId id) const noexcept {
+    for (const auto &conflict : list)
+      if (conflict.id == id)
+        return &conflict;
+
+    return nullptr;
+  }
+
+  /**
+   * Insert a conflict at its position; if the list is full, the
+   * least urgent one is dropped.
+   */
+  void Insert(const FlarmConflict &conflict) noexcept {
+    if (list.full()) {
+      if (!conflict.IsMoreUrgentThan(list.back()))
+        return;
+
+      list.back() = conflict;
+    } else
+      list.append(conflict);
+
+    /* move the new item to its position */
+    for (std::size_t i = list.size() - 1;
+         i > 0 && list[i].IsMoreUrgentThan(list[i - 1]); --i)
+      std::swap(list[i], list[i - 1]);
+  }
+};
+
+static_assert(std::is_trivial<FlarmConflictList>::value, "type is not trivial");
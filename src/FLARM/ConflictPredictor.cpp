@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ConflictPredictor.hpp"
+#include "Conflict.hpp"
+#include "List.hpp"
+#include "NMEA/Info.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Relative velocities below this [m^2/s^2] are treated as zero, i.e.
+ * the distance does not change.
+ */
+static constexpr float MIN_VELOCITY_SQ = 0.01f;
+
+[[gnu::const]]
+static FlarmTraffic::AlarmType
+TimeToAlarmLevel(float time) noexcept
+{
+  /* the same thresholds as the FLARM (see FLARM data port
+     specification, PFLAU) */
+  if (time <= 8)
+    return FlarmTraffic::AlarmType::URGENT;
+  else if (time <= 13)
+    return FlarmTraffic::AlarmType::IMPORTANT;
+  else
+    return FlarmTraffic::AlarmType::LOW;
+}
+
+/**
+ * Shall a conflict with this target be predicted?
+ */
+[[gnu::pure]]
+static bool
+IsPredictable(const FlarmTraffic &target) noexcept
+{
+  switch (target.source) {
+  case FlarmTraffic::SourceType::FLARM:
+  case FlarmTraffic::SourceType::MODES:
+    /* the FLARM assesses FLARM targets itself (and knows more than
+       a straight-line prediction, e.g. about circling), and Mode-S
+       targets have no position */
+    return false;
+
+  case FlarmTraffic::SourceType::ADSB:
+  case FlarmTraffic::SourceType::ADSR:
+  case FlarmTraffic::SourceType::TISB:
+    break;
+
+  default:
+    return false;
+  }
+
+  /* without its velocity, the target would be treated as standing
+     still */
+  return target.track_received && target.speed_received &&
+    target.climb_rate_received;
+}
+
+std::size_t
+FlarmConflictPredictor::Load(const TrafficList &traffic,
+                             const NMEAInfo &basic) noexcept
+{
+  const auto [own_east, own_north] = basic.track.SinCos();
+  const float own_v_north = own_north * basic.ground_speed;
+  const float own_v_east = own_east * basic.ground_speed;
+  const float own_v_up = basic.noncomp_vario_available
+    ? basic.noncomp_vario
+    : 0.;
+
+  std::size_t n = 0;
+  for (unsigned i = 0; i < traffic.list.size(); ++i) {
+    const FlarmTraffic &target = traffic.list[i];
+    if (target.HasAlarm() || !IsPredictable(target))
+      /* the FLARM knows better, or we know too little */
+      continue;
+
+    const Angle track = target.track;
+    const float speed = target.speed;
+
+    north[n] = target.relative_north;
+    east[n] = target.relative_east;
+    up[n] = target.relative_altitude;
+    v_north[n] = speed * track.fastcosine() - own_v_north;
+    v_east[n] = speed * track.fastsine() - own_v_east;
+    v_up[n] = target.climb_rate - own_v_up;
+    positions[n] = i;
+    ++n;
+  }
+
+  /* pad the last block with rows which are far away */
+  for (std::size_t i = n; i % BLOCK_SIZE != 0; ++i) {
+    north[i] = east[i] = up[i] = 1e6f;
+    v_north[i] = v_east[i] = v_up[i] = 0;
+  }
+
+  return n;
+}
+
+void
+FlarmConflictPredictor::Calculate(std::size_t n) noexcept
+{
+  /* this loop has no branches and no dependencies between rows, and
+     the inner loop has a constant trip count; this allows gcc to
+     vectorise it (see HOT_SOURCES) */
+  for (std::size_t b = 0; b < n; b += BLOCK_SIZE) {
+    for (std::size_t i = b; i < b + BLOCK_SIZE; ++i) {
+      const float v_sq = v_north[i] * v_north[i] + v_east[i] * v_east[i];
+      const float dot = north[i] * v_north[i] + east[i] * v_east[i];
+
+      float t = -dot / std::max(v_sq, MIN_VELOCITY_SQ);
+      t = v_sq > MIN_VELOCITY_SQ ? t : 0.f;
+      t = std::clamp(t, 0.f, HORIZON);
+
+      const float dn = north[i] + v_north[i] * t;
+      const float de = east[i] + v_east[i] * t;
+
+      time[i] = t;
+      horizontal_sq[i] = dn * dn + de * de;
+      vertical[i] = std::fabs(up[i] + v_up[i] * t);
+    }
+  }
+}
+
+void
+FlarmConflictPredictor::Predict(const TrafficList &traffic,
+                                const NMEAInfo &basic,
+                                FlarmConflictList &conflicts) noexcept
+{
+  conflicts.Clear();
+
+  /* without our own velocity, there is nothing to predict */
+  if (!basic.track_available || !basic.ground_speed_available)
+    return;
+
+  const std::size_t n = Load(traffic, basic);
+  if (n == 0)
+    return;
+
+  Calculate(n);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    if (time[i] <= 0)
+      /* not approaching (e.g. formation flight) */
+      continue;
+
+    if (horizontal_sq[i] >= PROTECTED_RADIUS * PROTECTED_RADIUS ||
+        vertical[i] >= PROTECTED_HEIGHT)
+      continue;
+
+    FlarmConflict conflict;
+    conflict.id = traffic.list[positions[i]].id;
+    conflict.time = time[i];
+    conflict.horizontal_distance = std::sqrt(horizontal_sq[i]);
+    conflict.vertical_separation = vertical[i];
+    conflict.level = TimeToAlarmLevel(time[i]);
+    conflicts.Insert(conflict);
+  }
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "TrafficTable.hpp"
+
+#include <array>
+
+struct NMEAInfo;
+struct TrafficList;
+struct FlarmConflictList;
+
+/**
+ * Predicts conflicts with traffic targets which the FLARM does not
+ * assess itself (ADS-B, ADS-R, TIS-B): for each target, the
+ * closest point of approach is calculated from the current relative
+ * position and the velocities of both aircraft (assuming straight
+ * flight), and targets which come too close within the next
+ * #HORIZON seconds are reported.
+ *
+ * The targets are copied into a structure of arrays first, which
+ * allows the compiler to vectorise the calculation.
+ */
+class FlarmConflictPredictor {
+public:
+  /**
+   * How far to look ahead [s]; this matches the FLARM "low" alarm
+   * level.
+   */
+  static constexpr float HORIZON = 18;
+
+  /**
+   * Targets which come closer than this horizontally [m] ...
+   */
+  static constexpr float PROTECTED_RADIUS = 150;
+
+  /**
+   * ... and vertically [m] are a conflict.
+   */
+  static constexpr float PROTECTED_HEIGHT = 75;
+
+private:
+  /**
+   * The array size is rounded up to a multiple of this, so the
+   * calculation can always process full vectors.
+   */
+  static constexpr std::size_t BLOCK_SIZE = 8;
+
+  static constexpr std::size_t CAPACITY =
+    (TrafficTable::MAX_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+
+  using Column = std::array<float, CAPACITY>;
+
+  /**
+   * Relative position [m] and relative velocity [m/s] of each
+   * target.
+   */
+  alignas(32) Column north, east, up;
+  alignas(32) Column v_north, v_east, v_up;
+
+  /**
+   * Results: time until the closest point of approach [s], the
+   * squared horizontal distance [m^2] and the vertical separation
+   * [m] at that time.
+   */
+  alignas(32) Column time, horizontal_sq, vertical;
+
+  /**
+   * The position of each row within the #TrafficList.
+   */
+  std::array<uint16_t, CAPACITY> positions;
+
+public:
+  /**
+   * Calculate the conflicts with all ADS-B, ADS-R and TIS-B targets
+   * which have no FLARM alarm and whose track, speed and climb rate
+   * are known.
+   */
+  void Predict(const TrafficList &traffic, const NMEAInfo &basic,
+               FlarmConflictList &conflicts) noexcept;
+
+private:
+  /**
+   * Copy the targets into the columns.
+   *
+   * @return the number of rows
+   */
+  std::size_t Load(const TrafficList &traffic,
+                   const NMEAInfo &basic) noexcept;
+
+  void Calculate(std::size_t n) noexcept;
+};
@@ -7,8 +7,7 @@
 #include "FLARM/Version.hpp"
 #include "FLARM/Status.hpp"
 #include "FLARM/List.hpp"
-
-#include <type_traits>
+#include "FLARM/Conflict.hpp"
 
 /**
  * A container for all data received by a FLARM.
@@ -22,30 +21,35 @@ struct FlarmData {
 
   TrafficList traffic;
 
-  constexpr bool IsDetected() const noexcept {
+  /**
+   * Conflicts predicted by #FlarmConflictPredictor.  This is not
+   * received from the FLARM, but calculated by #FlarmComputer.
+   */
+  FlarmConflictList conflicts;
+
+  bool IsDetected() const noexcept {
     return status.available || !traffic.IsEmpty();
   }
 
-  constexpr void Clear() noexcept {
+  void Clear() noexcept {
     error.Clear();
     version.Clear();
     status.Clear();
     traffic.Clear();
+    conflicts.Clear();
   }
 
-  constexpr void Complement(const FlarmData &add) noexcept {
+  void Complement(const FlarmData &add) noexcept {
     error.Complement(add.error);
     version.Complement(add.version);
     status.Complement(add.status);
     traffic.Complement(add.traffic);
   }
 
-  constexpr void Expire(TimeStamp clock) noexcept {
+  void Expire(TimeStamp clock) noexcept {
     error.Expire(clock);
     version.Expire(clock);
     status.Expire(clock);
     traffic.Expire(clock);
   }
 };
-
-static_assert(std::is_trivial<FlarmData>::value, "type is not trivial");
@@ -36,6 +36,13 @@ public:
     value = UNDEFINED_VALUE;
   }
 
+  /**
+   * Returns a value for hash tables.
+   */
+  constexpr uint32_t Hash() const noexcept {
+    return value;
+  }
+
   friend constexpr auto operator<=>(const FlarmId &,
                                     const FlarmId &) noexcept = default;
 
@@ -3,6 +3,18 @@
 
 #include "List.hpp"
 
+#include <algorithm>
+
+const FlarmTraffic *
+TrafficList::FindTraffic(const TCHAR *name) const noexcept
+{
+  for (const auto &traffic : list)
+    if (traffic.name.equals(name))
+      return &traffic;
+
+  return nullptr;
+}
+
 const FlarmTraffic *
 TrafficList::FindMaximumAlert() const noexcept
 {
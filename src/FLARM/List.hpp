@@ -3,18 +3,17 @@
 
 #pragma once
 
-#include "Traffic.hpp"
+#include "TrafficTable.hpp"
 #include "NMEA/Validity.hpp"
-#include "util/TrivialArray.hxx"
 
-#include <type_traits>
+#include <tchar.h>
 
 /**
  * This class keeps track of the traffic objects received from a
  * FLARM.
  */
 struct TrafficList {
-  static constexpr size_t MAX_COUNT = 25;
+  static constexpr size_t MAX_COUNT = TrafficTable::MAX_SIZE;
 
   /**
    * Time stamp of the latest modification to this object.
@@ -27,15 +26,15 @@ struct TrafficList {
   Validity new_traffic;
 
   /** Flarm traffic information */
-  TrivialArray<FlarmTraffic, MAX_COUNT> list;
+  TrafficTable list;
 
-  constexpr void Clear() noexcept {
+  void Clear() noexcept {
     modified.Clear();
     new_traffic.Clear();
     list.clear();
   }
 
-  constexpr bool IsEmpty() const noexcept {
+  bool IsEmpty() const noexcept {
     return list.empty();
   }
 
@@ -43,7 +42,7 @@ struct TrafficList {
    * Adds data from the specified object, unless already present in
    * this one.
    */
-  constexpr void Complement(const TrafficList &add) noexcept {
+  void Complement(const TrafficList &add) noexcept {
     if (add.modified.Modified(modified))
       modified = add.modified;
 
@@ -51,16 +50,16 @@ struct TrafficList {
       new_traffic = add.new_traffic;
 
     if (list.empty() && !add.list.empty()) {
-      /* don't bother merging the two lists, we can simply memcpy()
+      /* don't bother merging the two lists, we can simply share
          it */
       list = add.list;
       return;
     }
 
     // Add unique traffic from 'add' list
-    for (auto &traffic : add.list) {
-      if (FindTraffic(traffic.id) == nullptr) {
-        FlarmTraffic * new_traffic = AllocateTraffic();
+    for (const auto &traffic : add.list) {
+      if (list.Find(traffic.id) < 0) {
+        FlarmTraffic *new_traffic = AllocateTraffic(traffic.id);
         if (new_traffic == nullptr)
           return;
         *new_traffic = traffic;
@@ -68,16 +67,17 @@ struct TrafficList {
     }
   }
 
-  constexpr void Expire(TimeStamp clock) noexcept {
+  void Expire(TimeStamp clock) noexcept {
     modified.Expire(clock, std::chrono::minutes(5));
     new_traffic.Expire(clock, std::chrono::minutes(1));
 
+    /* check before modifying, to avoid copying shared chunks */
     for (unsigned i = list.size(); i-- > 0;)
-      if (!list[i].Refresh(clock))
-        list.quick_remove(i);
+      if (list[i].valid.IsOlderThan(clock, std::chrono::seconds(2)))
+        list.QuickRemove(i);
   }
 
-  constexpr unsigned GetActiveTrafficCount() const noexcept {
+  unsigned GetActiveTrafficCount() const noexcept {
     return list.size();
   }
 
@@ -87,12 +87,9 @@ struct TrafficList {
    * @param id FLARM id
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  constexpr FlarmTraffic *FindTraffic(FlarmId id) noexcept {
-    for (auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+  FlarmTraffic *FindTraffic(FlarmId id) noexcept {
+    const int i = list.Find(id);
+    return i >= 0 ? &list.Edit(i) : nullptr;
   }
 
   /**
@@ -101,12 +98,9 @@ struct TrafficList {
    * @param id FLARM id
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  constexpr const FlarmTraffic *FindTraffic(FlarmId id) const noexcept {
-    for (const auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+  const FlarmTraffic *FindTraffic(FlarmId id) const noexcept {
+    const int i = list.Find(id);
+    return i >= 0 ? &list[i] : nullptr;
   }
 
   /**
@@ -115,69 +109,54 @@ struct TrafficList {
    * @param name the name or call sign
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  constexpr FlarmTraffic *FindTraffic(const TCHAR *name) noexcept {
-    for (auto &traffic : list)
-      if (traffic.name.equals(name))
-        return &traffic;
-
-    return NULL;
-  }
-
-  /**
-   * Looks up an item in the traffic list.
-   *
-   * @param name the name or call sign
-   * @return the FLARM_TRAFFIC pointer, NULL if not found
-   */
-  constexpr const FlarmTraffic *FindTraffic(const TCHAR *name) const noexcept {
-    for (const auto &traffic : list)
-      if (traffic.name.equals(name))
-        return &traffic;
-
-    return NULL;
-  }
+  [[gnu::pure]]
+  const FlarmTraffic *FindTraffic(const TCHAR *name) const noexcept;
 
   /**
    * Allocates a new FLARM_TRAFFIC object from the array.
    *
+   * @param id the id of the new object; it must not be in the list
+   * already
    * @return the FLARM_TRAFFIC pointer, NULL if the array is full
    */
-  constexpr FlarmTraffic *AllocateTraffic() noexcept {
+  FlarmTraffic *AllocateTraffic(FlarmId id) noexcept {
     return list.full()
-      ? NULL
-      : &list.append();
+      ? nullptr
+      : &list.Append(id);
   }
 
   /**
    * Search for the previous traffic in the ordered list.
    */
-  constexpr const FlarmTraffic *PreviousTraffic(const FlarmTraffic *t) const noexcept {
-    return t > list.begin()
-      ? t - 1
-      : NULL;
+  const FlarmTraffic *PreviousTraffic(const FlarmTraffic *t) const noexcept {
+    const unsigned i = TrafficIndex(t);
+    return i > 0
+      ? &list[i - 1]
+      : nullptr;
   }
 
   /**
    * Search for the next traffic in the ordered list.
    */
-  constexpr const FlarmTraffic *NextTraffic(const FlarmTraffic *t) const noexcept {
-    return t + 1 < list.end()
-      ? t + 1
-      : NULL;
+  const FlarmTraffic *NextTraffic(const FlarmTraffic *t) const noexcept {
+    const unsigned i = TrafficIndex(t);
+    return i + 1 < list.size()
+      ? &list[i + 1]
+      : nullptr;
   }
 
   /**
    * Search for the first traffic in the ordered list.
    */
-  constexpr const FlarmTraffic *FirstTraffic() const noexcept {
-    return list.empty() ? NULL : list.begin();
+  const FlarmTraffic *FirstTraffic() const noexcept {
+    return list.empty() ? nullptr : &list[0];
   }
 
   /**
    * Search for the last traffic in the ordered list.
    */
-  constexpr const FlarmTraffic *LastTraffic() const noexcept {
-    return list.empty() ? NULL : list.end() - 1;
+  const FlarmTraffic *LastTraffic() const noexcept {
+    return list.empty() ? nullptr : &list[list.size() - 1];
   }
 
   /**
@@ -187,8 +166,11 @@ struct TrafficList {
   [[gnu::pure]]
   const FlarmTraffic *FindMaximumAlert() const noexcept;
 
-  constexpr unsigned TrafficIndex(const FlarmTraffic *t) const noexcept {
-    return t - list.begin();
+  /**
+   * @param t an item of this list
+   */
+  unsigned TrafficIndex(const FlarmTraffic *t) const noexcept {
+    return list.Find(t->id);
   }
 
   /**
@@ -196,5 +178,3 @@ struct TrafficList {
    */
   bool InCloseRange() const noexcept;
 };
-
-static_assert(std::is_trivial<TrafficList>::value, "type is not trivial");
@@ -47,6 +47,18 @@ struct FlarmTraffic {
     STATIC_OBJECT = 15    //!< static object
   };
 
+  /**
+   * How the FLARM received the target ("Source" field of PFLAA, FLARM
+   * data port specification 7 and newer).
+   */
+  enum class SourceType: uint8_t {
+    FLARM = 0,
+    ADSB = 1,
+    ADSR = 3,
+    TISB = 4,
+    MODES = 6,
+  };
+
   /** Location of the FLARM target */
   GeoPoint location;
 
@@ -94,6 +106,8 @@ struct FlarmTraffic {
   /** Type of the aircraft */
   AircraftType type;
 
+  SourceType source;
+
   /** Is the target in stealth mode */
   bool stealth;
 
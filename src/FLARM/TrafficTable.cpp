@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TrafficTable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+/**
+ * Make sure the object is not shared with another #TrafficTable
+ * before it gets modified.
+ */
+template<typename T>
+static T &
+Unshare(std::shared_ptr<T> &p) noexcept
+{
+  if (p.use_count() > 1)
+    p = std::make_shared<T>(*p);
+  else
+    /* synchronize with the threads which have released their
+       references */
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+  return *p;
+}
+
+inline TrafficTable::Root &
+TrafficTable::EditRoot() noexcept
+{
+  if (root == nullptr)
+    root = std::make_shared<Root>();
+
+  return Unshare(root);
+}
+
+inline TrafficTable::Index &
+TrafficTable::EditIndex() noexcept
+{
+  Root &r = EditRoot();
+  if (r.index == nullptr)
+    r.index = std::make_shared<Index>();
+
+  return Unshare(r.index);
+}
+
+TrafficTable::size_type
+TrafficTable::FindSlot(FlarmId id) const noexcept
+{
+  assert(root != nullptr);
+  assert(root->index != nullptr);
+
+  const auto &slots = root->index->slots;
+  size_type s = Index::Hash(id);
+  while (slots[s] != 0 && (*this)[slots[s] - 1].id != id)
+    s = (s + 1) % Index::SIZE;
+
+  return s;
+}
+
+int
+TrafficTable::Find(FlarmId id) const noexcept
+{
+  if (empty())
+    return -1;
+
+  return int(root->index->slots[FindSlot(id)]) - 1;
+}
+
+bool
+TrafficTable::IsChunkSharedWith(const TrafficTable &other,
+                                size_type i) const noexcept
+{
+  assert(i < size());
+
+  return i < other.size() &&
+    root->chunks[i / CHUNK_SIZE] == other.root->chunks[i / CHUNK_SIZE];
+}
+
+void
+TrafficTable::ReplaceSharedChunks(const TrafficTable &before,
+                                  const TrafficTable &after) noexcept
+{
+  assert(before.size() == after.size());
+
+  const size_type n_chunks =
+    (std::min(size(), before.size()) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  Root *r = nullptr;
+  for (size_type i = 0; i < n_chunks; ++i) {
+    const auto &chunk = root->chunks[i];
+    if (chunk != before.root->chunks[i] ||
+        chunk == after.root->chunks[i])
+      continue;
+
+    /* a shared chunk cannot have been modified, and items cannot
+       have been appended to it, so the items of "after" belong
+       here */
+    if (r == nullptr)
+      r = &EditRoot();
+
+    r->chunks[i] = after.root->chunks[i];
+  }
+}
+
+FlarmTraffic &
+TrafficTable::Edit(size_type i) noexcept
+{
+  assert(i < size());
+
+  return Unshare(EditRoot().chunks[i / CHUNK_SIZE]).items[i % CHUNK_SIZE];
+}
+
+FlarmTraffic &
+TrafficTable::Append(FlarmId id) noexcept
+{
+  assert(!full());
+  assert(Find(id) < 0);
+
+  Index &index = EditIndex();
+  Root &r = *root;
+  const size_type i = r.size;
+
+  auto &chunk = r.chunks[i / CHUNK_SIZE];
+  if (chunk == nullptr)
+    chunk = std::make_shared<Chunk>();
+
+  FlarmTraffic &traffic = Unshare(chunk).items[i % CHUNK_SIZE];
+  traffic.id = id;
+
+  index.slots[FindSlot(id)] = i + 1;
+  ++r.size;
+  return traffic;
+}
+
+void
+TrafficTable::RemoveFromIndex(FlarmId id) noexcept
+{
+  Index &index = EditIndex();
+  auto &slots = index.slots;
+
+  size_type s = FindSlot(id);
+  assert(slots[s] != 0);
+  slots[s] = 0;
+
+  /* move the following items of the probe sequence up, so lookups
+     don't stop at the new gap */
+  for (size_type j = (s + 1) % Index::SIZE; slots[j] != 0;
+       j = (j + 1) % Index::SIZE) {
+    const size_type home = Index::Hash((*this)[slots[j] - 1].id);
+    const bool movable = s < j
+      ? home <= s || home > j
+      : home <= s && home > j;
+    if (movable) {
+      slots[s] = slots[j];
+      slots[j] = 0;
+      s = j;
+    }
+  }
+}
+
+void
+TrafficTable::QuickRemove(size_type i) noexcept
+{
+  assert(i < size());
+
+  const size_type last = size() - 1;
+  RemoveFromIndex((*this)[i].id);
+
+  if (i != last) {
+    const FlarmTraffic moved = (*this)[last];
+    Edit(i) = moved;
+    EditIndex().slots[FindSlot(moved.id)] = i + 1;
+  }
+
+  --root->size;
+}
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Traffic.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+/**
+ * A container for #FlarmTraffic objects with copy-on-write
+ * semantics: copying it (i.e. copying a #NMEAInfo) only copies a
+ * pointer, no matter how many targets there are.  The items are
+ * stored in fixed-size chunks, and modifying an item copies only its
+ * chunk if it is shared with another #TrafficTable.
+ *
+ * An index of all #FlarmId values allows looking up items quickly;
+ * therefore, the id of an item must not be modified after Append().
+ *
+ * Modifications invalidate all pointers obtained from this object.
+ */
+class TrafficTable {
+public:
+  using size_type = unsigned;
+
+  static constexpr size_type CHUNK_SIZE = 16;
+  static constexpr size_type N_CHUNKS = 32;
+  static constexpr size_type MAX_SIZE = CHUNK_SIZE * N_CHUNKS;
+
+private:
+  struct Chunk {
+    std::array<FlarmTraffic, CHUNK_SIZE> items;
+  };
+
+  /**
+   * A hash table with linear probing, mapping #FlarmId to the
+   * position in the table.
+   */
+  struct Index {
+    static constexpr size_type SIZE = MAX_SIZE * 2;
+
+    /**
+     * Each element is the position plus one, or zero if the slot is
+     * empty.
+     */
+    std::array<uint16_t, SIZE> slots{};
+
+    [[gnu::const]]
+    static size_type Hash(FlarmId id) noexcept {
+      return (id.Hash() * 2654435761U) % SIZE;
+    }
+  };
+
+  static_assert(MAX_SIZE < Index::SIZE);
+  static_assert(Index::SIZE <= 0x10000);
+
+  struct Root {
+    std::array<std::shared_ptr<Chunk>, N_CHUNKS> chunks;
+    std::shared_ptr<Index> index;
+    size_type size = 0;
+  };
+
+  std::shared_ptr<Root> root;
+
+public:
+  class const_iterator {
+    const Root *root;
+    size_type i;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlarmTraffic;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const FlarmTraffic *;
+    using reference = const FlarmTraffic &;
+
+    const_iterator() noexcept = default;
+
+    constexpr const_iterator(const Root *_root, size_type _i) noexcept
+      :root(_root), i(_i) {}
+
+    const FlarmTraffic &operator*() const noexcept {
+      return root->chunks[i / CHUNK_SIZE]->items[i % CHUNK_SIZE];
+    }
+
+    const FlarmTraffic *operator->() const noexcept {
+      return &**this;
+    }
+
+    const_iterator &operator++() noexcept {
+      ++i;
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+      auto old = *this;
+      ++i;
+      return old;
+    }
+
+    constexpr bool operator==(const const_iterator &other) const noexcept {
+      return i == other.i;
+    }
+  };
+
+  size_type size() const noexcept {
+    return root != nullptr ? root->size : 0;
+  }
+
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  bool full() const noexcept {
+    return size() >= MAX_SIZE;
+  }
+
+  void clear() noexcept {
+    root.reset();
+  }
+
+  const FlarmTraffic &operator[](size_type i) const noexcept {
+    return *const_iterator(root.get(), i);
+  }
+
+  const_iterator begin() const noexcept {
+    return {root.get(), 0};
+  }
+
+  const_iterator end() const noexcept {
+    return {root.get(), size()};
+  }
+
+  /**
+   * @return the position of the item with the given id or -1 if
+   * there is none
+   */
+  [[gnu::pure]]
+  int Find(FlarmId id) const noexcept;
+
+  /**
+   * Is the chunk containing the specified item shared with @p other?
+   * If yes, the item is equal in both objects.
+   */
+  [[gnu::pure]]
+  bool IsChunkSharedWith(const TrafficTable &other,
+                         size_type i) const noexcept;
+
+  /**
+   * Replace each chunk which is shared with @p before by the
+   * corresponding chunk of @p after, which must be a modified copy
+   * of @p before with the same size.  This applies the modifications
+   * of an earlier copy to the items which have not changed since,
+   * without copying any chunk.
+   */
+  void ReplaceSharedChunks(const TrafficTable &before,
+                           const TrafficTable &after) noexcept;
+
+  /**
+   * Returns a writable reference to the specified item; its chunk
+   * is copied if it is shared.
+   */
+  FlarmTraffic &Edit(size_type i) noexcept;
+
+  /**
+   * Append a new item with the given id (which must not exist
+   * already).  All other attributes are undefined.  The table must
+   * not be full.
+   */
+  FlarmTraffic &Append(FlarmId id) noexcept;
+
+  /**
+   * Remove the specified item by moving the last one into its
+   * place.
+   */
+  void QuickRemove(size_type i) noexcept;
+
+private:
+  Root &EditRoot() noexcept;
+  Index &EditIndex() noexcept;
+
+  [[gnu::pure]]
+  size_type FindSlot(FlarmId id) const noexcept;
+
+  void RemoveFromIndex(FlarmId id) noexcept;
+};
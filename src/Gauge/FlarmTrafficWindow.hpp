@@ -10,6 +10,7 @@
 #include "Math/FastRotation.hpp"
 
 #include <cstdint>
+#include <utility> // for std::as_const()
 
 class Color;
 class Brush;
@@ -71,7 +72,7 @@ public:
   }
 
   void SetTarget(const FlarmId &id) noexcept {
-    SetTarget(data.FindTraffic(id));
+    SetTarget(std::as_const(data).FindTraffic(id));
   }
 
   void NextTarget() noexcept;
@@ -148,6 +148,16 @@ struct FlatBoundingBox
   [[gnu::pure]]
   bool Overlaps(const FlatBoundingBox& other) const noexcept;
 
+  /**
+   * Is the given box completely inside this one?
+   */
+  constexpr bool Contains(const FlatBoundingBox &other) const noexcept {
+    return lower_left.x <= other.lower_left.x &&
+      lower_left.y <= other.lower_left.y &&
+      upper_right.x >= other.upper_right.x &&
+      upper_right.y >= other.upper_right.y;
+  }
+
   /**
    * Expand the bounding box to include this point
    */
@@ -1136,6 +1136,14 @@ static constexpr MetaData meta_data[] = {
     UpdateInfoBoxTaskSpeedEst,
   },
 
+  // e_MapRenderTime
+  {
+    N_("Map render time"),
+    N_("Map ms"),
+    N_("Time in milliseconds needed to draw the moving map; 90th percentile of the last 128 frames.  The comment shows the median and the 99th percentile.  Useful for diagnosing slow displays."),
+    UpdateInfoBoxMapRenderTime,
+  },
+
 };
 
 static_assert(ARRAY_SIZE(meta_data) == NUM_TYPES,
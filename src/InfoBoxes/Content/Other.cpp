@@ -10,6 +10,7 @@
 #include "Language/Language.hpp"
 #include "UIGlobals.hpp"
 #include "Look/Look.hpp"
+#include "MapWindow/GlueMapWindow.hpp"
 
 #ifdef HAVE_BATTERY
 #include "Hardware/PowerInfo.hpp"
@@ -134,6 +135,33 @@ UpdateInfoBoxFreeRAM(InfoBoxData &data) noexcept
   data.SetInvalid();
 }
 
+static constexpr double
+ToMilliseconds(MapRenderStats::Duration d) noexcept
+{
+  return d.count() / 1000.;
+}
+
+void
+UpdateInfoBoxMapRenderTime(InfoBoxData &data) noexcept
+{
+  const auto *map = UIGlobals::GetMap();
+  if (map == nullptr) {
+    data.SetInvalid();
+    return;
+  }
+
+  const auto summary = map->GetRenderStats().GetSummary();
+  if (summary.n_frames == 0) {
+    data.SetInvalid();
+    return;
+  }
+
+  data.FmtValue(_T("{:.1f}"), ToMilliseconds(summary.total.p90));
+  data.FmtComment(_T("{:.1f}/{:.1f} ms"),
+                  ToMilliseconds(summary.total.p50),
+                  ToMilliseconds(summary.total.p99));
+}
+
 void
 InfoBoxContentHorizon::OnCustomPaint(Canvas &canvas,
                                      const PixelRect &rc) noexcept
@@ -26,6 +26,9 @@ UpdateInfoBoxCPULoad(InfoBoxData &data) noexcept;
 void
 UpdateInfoBoxFreeRAM(InfoBoxData &data) noexcept;
 
+void
+UpdateInfoBoxMapRenderTime(InfoBoxData &data) noexcept;
+
 void
 UpdateInfoBoxNbrSat(InfoBoxData &data) noexcept;
 
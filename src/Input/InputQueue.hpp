@@ -26,6 +26,7 @@ enum {
   GCE_FLARM_NOTRAFFIC,
   GCE_FLARM_TRAFFIC,
   GCE_FLARM_NEWTRAFFIC,
+  GCE_FLARM_CONFLICT,
   GCE_FLIGHTMODE_CLIMB,
   GCE_FLIGHTMODE_CRUISE,
   GCE_FLIGHTMODE_FINALGLIDE,
@@ -202,11 +202,11 @@ ReadBlackboardBasic(const MoreData &nmea_info) noexcept
 }
 
 static inline void
-ReadBlackboardCalculated(const DerivedInfo &derived_info) noexcept
+ReadBlackboardCalculated(std::shared_ptr<const DerivedInfo> derived_info) noexcept
 {
   assert(InMainThread());
 
-  Private::blackboard.ReadBlackboardCalculated(derived_info);
+  Private::blackboard.ReadBlackboardCalculated(std::move(derived_info));
 }
 
 static inline void
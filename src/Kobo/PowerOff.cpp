@@ -14,8 +14,7 @@
 #include "Renderer/FlightListRenderer.hpp"
 #include "Renderer/TextRenderer.hpp"
 #include "FlightInfo.hpp"
-#include "Logger/FlightParser.hpp"
-#include "io/FileLineReader.hpp"
+#include "Logger/FlightLogbook.hpp"
 #include "io/UniqueFileDescriptor.hxx"
 #include "Resources.hpp"
 #include "Model.hpp"
@@ -133,13 +132,12 @@ DrawUserText(Canvas &canvas, PixelRect &rc) noexcept
 static void
 DrawFlights(Canvas &canvas, const PixelRect &rc)
 try {
-  FileLineReaderA file(Path("/mnt/onboard/XCSoarData/flights.log"));
+  FlightLogbook logbook(Path("/mnt/onboard/XCSoarData/flights.log"));
+  logbook.Update();
 
   FlightListRenderer renderer(normal_font, bold_font);
 
-  FlightParser parser(file);
-  FlightInfo flight;
-  while (parser.Read(flight))
+  for (const auto &flight : logbook.GetRecentFlights())
     renderer.AddFlight(flight);
 
   renderer.Draw(canvas, rc);
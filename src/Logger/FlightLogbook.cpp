@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FlightLogbook.hpp"
+#include "FlightParser.hpp"
+#include "io/FileReader.hxx"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/LineReader.hpp"
+#include "system/FileUtil.hpp"
+#include "util/SpanCast.hxx"
+#include "LogFile.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+struct IndexHeader {
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  /**
+   * sizeof(FlightInfo), to reject files written by a different
+   * build.
+   */
+  uint32_t record_size;
+
+  uint32_t n_years;
+  uint32_t n_flights;
+
+  /**
+   * The number of log bytes covered by this index.
+   */
+  uint64_t log_offset;
+
+  /**
+   * A copy of the last bytes before #log_offset; if they differ, the
+   * log was edited or replaced, and the index is discarded.
+   */
+  uint32_t tail_length;
+  char tail[60];
+};
+
+/**
+ * Followed by #IndexHeader::n_years instances, followed by
+ * #IndexHeader::n_flights #FlightInfo records.
+ */
+struct IndexYear {
+  uint32_t year;
+  uint32_t n_flights;
+  uint64_t duration_s;
+};
+
+static_assert(std::is_trivially_copyable_v<IndexHeader>);
+static_assert(std::is_trivially_copyable_v<FlightInfo>);
+
+/* limits to reject corrupt files before allocating memory */
+static constexpr uint32_t MAX_YEARS = 1000;
+
+/**
+ * An #NLineReader for a memory buffer which is modified in place.
+ * The buffer must end with a newline character.
+ */
+class MemoryLineReader final : public NLineReader {
+  char *next;
+  char *const end;
+
+public:
+  MemoryLineReader(char *begin, char *_end) noexcept
+    :next(begin), end(_end) {
+    assert(begin == end || end[-1] == '\n');
+  }
+
+  /**
+   * Returns the beginning of the next line.
+   */
+  const char *GetPosition() const noexcept {
+    return next;
+  }
+
+  /* virtual methods from class NLineReader */
+  char *ReadLine() override {
+    if (next == end)
+      return nullptr;
+
+    char *line = next;
+    char *eol = std::find(next, end, '\n');
+    next = eol + 1;
+
+    if (eol > line && eol[-1] == '\r')
+      --eol;
+    *eol = 0;
+
+    return line;
+  }
+};
+
+} // anonymous namespace
+
+static void
+ReadLogTail(FileReader &log, uint_least64_t offset,
+            IndexHeader &header)
+{
+  header.tail_length = std::min<uint_least64_t>(offset, sizeof(header.tail));
+  log.Seek(offset - header.tail_length);
+  log.ReadFull(std::as_writable_bytes(std::span{header.tail,
+                                                header.tail_length}));
+}
+
+FlightLogbook::FlightLogbook(Path _log_path) noexcept
+  :log_path(_log_path), index_path(_log_path.WithSuffix(".idx")) {}
+
+void
+FlightLogbook::Clear() noexcept
+{
+  n_flights = 0;
+  years.clear();
+  recent.clear();
+  pending = false;
+}
+
+void
+FlightLogbook::AddRecent(const FlightInfo &flight) noexcept
+{
+  if (recent.size() >= MAX_RECENT)
+    recent.erase(recent.begin());
+  recent.push_back(flight);
+}
+
+void
+FlightLogbook::Add(const FlightInfo &flight) noexcept
+{
+  ++n_flights;
+  AddRecent(flight);
+
+  if (!flight.date.IsPlausible())
+    return;
+
+  auto i = std::lower_bound(years.begin(), years.end(), flight.date.year,
+                            [](const YearStatistics &s, unsigned year){
+                              return s.year < year;
+                            });
+  if (i == years.end() || i->year != flight.date.year)
+    i = years.insert(i, {flight.date.year, 0, {}});
+
+  ++i->n_flights;
+
+  const auto duration = flight.Duration();
+  if (duration.count() >= 0)
+    i->duration +=
+      std::chrono::duration_cast<std::chrono::seconds>(duration);
+}
+
+uint_least64_t
+FlightLogbook::Load(FileReader &log)
+{
+  if (!File::Exists(index_path))
+    return 0;
+
+  FileReader file(index_path);
+
+  IndexHeader header;
+  file.ReadT(header);
+
+  if (header.version != IndexHeader::VERSION ||
+      header.record_size != sizeof(FlightInfo) ||
+      header.n_years > MAX_YEARS ||
+      header.tail_length > sizeof(header.tail) ||
+      header.log_offset > log.GetSize() ||
+      header.tail_length != std::min<uint_least64_t>(header.log_offset,
+                                                     sizeof(header.tail)))
+    return 0;
+
+  IndexHeader current;
+  ReadLogTail(log, header.log_offset, current);
+  if (memcmp(current.tail, header.tail, header.tail_length) != 0)
+    /* the log was edited or replaced */
+    return 0;
+
+  for (unsigned i = 0; i < header.n_years; ++i) {
+    IndexYear year;
+    file.ReadT(year);
+    years.push_back({year.year, year.n_flights,
+                     std::chrono::seconds(year.duration_s)});
+  }
+
+  /* read only the most recent records */
+  const unsigned n_recent = std::min(header.n_flights, MAX_RECENT);
+  file.Skip((header.n_flights - n_recent) * sizeof(FlightInfo));
+
+  recent.resize(n_recent);
+  file.ReadFull(std::as_writable_bytes(std::span{recent}));
+
+  n_flights = header.n_flights;
+  return header.log_offset;
+}
+
+void
+FlightLogbook::Save(FileReader &log, uint_least64_t log_offset,
+                    unsigned old_flights,
+                    const std::vector<FlightInfo> &added) const
+{
+  IndexHeader header{};
+  header.version = IndexHeader::VERSION;
+  header.record_size = sizeof(FlightInfo);
+  header.n_years = years.size();
+  header.n_flights = n_flights;
+  header.log_offset = log_offset;
+  ReadLogTail(log, log_offset, header);
+
+  FileOutputStream file(index_path);
+  BufferedOutputStream os(file);
+
+  os.WriteT(header);
+
+  for (const auto &i : years)
+    os.WriteT(IndexYear{i.year, i.n_flights, uint64_t(i.duration.count())});
+
+  if (old_flights > 0) {
+    /* copy the records of the old index */
+    FileReader old(index_path);
+
+    IndexHeader old_header;
+    old.ReadT(old_header);
+    old.Skip(old_header.n_years * sizeof(IndexYear));
+
+    FlightInfo buffer[256];
+    for (unsigned i = 0; i < old_flights;) {
+      const unsigned n = std::min<unsigned>(old_flights - i,
+                                            std::size(buffer));
+      const std::span<FlightInfo> chunk{buffer, n};
+      old.ReadFull(std::as_writable_bytes(chunk));
+      os.Write(std::as_bytes(chunk));
+      i += n;
+    }
+  }
+
+  os.Write(std::as_bytes(std::span{added}));
+
+  os.Flush();
+  file.Commit();
+}
+
+void
+FlightLogbook::Update()
+{
+  FileReader log(log_path);
+
+  Clear();
+
+  uint_least64_t offset;
+  try {
+    offset = Load(log);
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to load the flight log index");
+    offset = 0;
+  }
+
+  if (offset == 0)
+    Clear();
+
+  const unsigned old_flights = n_flights;
+
+  /* read the new part of the log, up to the last complete line */
+
+  std::vector<char> buffer(log.GetSize() - offset);
+  log.Seek(offset);
+  log.ReadFull(std::as_writable_bytes(std::span{buffer}));
+
+  const auto last_newline = std::find(buffer.rbegin(), buffer.rend(), '\n');
+  buffer.resize(buffer.rend() - last_newline);
+
+  MemoryLineReader reader(buffer.data(), buffer.data() + buffer.size());
+  FlightParser parser(reader);
+
+  const auto GetParserPosition = [&](){
+    const char *p = parser.GetPendingLine();
+    if (p == nullptr)
+      p = reader.GetPosition();
+    return uint_least64_t(p - buffer.data());
+  };
+
+  std::vector<FlightInfo> added;
+  uint_least64_t new_offset = offset;
+
+  FlightInfo flight;
+  while (parser.Read(flight)) {
+    if (parser.GetPendingLine() == nullptr && !flight.end_time.IsPlausible()) {
+      /* the log ends with a start: the landing may still be
+         appended, so this flight is parsed again next time */
+      AddRecent(flight);
+      pending = true;
+      break;
+    }
+
+    Add(flight);
+    added.push_back(flight);
+    new_offset = offset + GetParserPosition();
+  }
+
+  if (added.empty())
+    return;
+
+  try {
+    Save(log, new_offset, old_flights, added);
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to save the flight log index");
+  }
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "FlightInfo.hpp"
+#include "system/Path.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class FileReader;
+
+/**
+ * An index of the text log written by #FlightLogger
+ * ("flights.log").  It is stored next to the log ("flights.idx") and
+ * contains one binary record per flight plus statistics per year.
+ *
+ * Update() parses only the part of the log which was appended since
+ * the index was saved; on the first call (or if the log was replaced),
+ * the whole log is parsed once and the index is created.  The text log
+ * remains the primary data; the index can be deleted at any time.
+ */
+class FlightLogbook {
+public:
+  /**
+   * The maximum number of flights returned by GetRecentFlights().
+   */
+  static constexpr unsigned MAX_RECENT = 128;
+
+  struct YearStatistics {
+    unsigned year;
+
+    unsigned n_flights;
+
+    /**
+     * The total duration of all flights with a plausible
+     * FlightInfo::Duration().
+     */
+    std::chrono::seconds duration;
+  };
+
+private:
+  AllocatedPath log_path, index_path;
+
+  /**
+   * The number of flights in the index (not including #pending).
+   */
+  unsigned n_flights = 0;
+
+  /**
+   * Sorted by year.
+   */
+  std::vector<YearStatistics> years;
+
+  /**
+   * The most recent flights, oldest first, including #pending.
+   */
+  std::vector<FlightInfo> recent;
+
+  /**
+   * Is the last element of #recent a flight which has a start but no
+   * landing yet?  It is not in the index, because the log may still
+   * get its landing.
+   */
+  bool pending = false;
+
+public:
+  explicit FlightLogbook(Path _log_path) noexcept;
+
+  /**
+   * Load the index and add the flights which were appended to the
+   * log since it was saved.  If something was added, the index is
+   * saved; errors while saving are only logged.
+   *
+   * Throws on error (e.g. if the log does not exist).
+   */
+  void Update();
+
+  /**
+   * The total number of flights, including one which has not landed
+   * yet.
+   */
+  unsigned GetFlightCount() const noexcept {
+    return n_flights + pending;
+  }
+
+  /**
+   * Statistics for each year with at least one flight, sorted by
+   * year; flights which have not landed yet are not included.
+   */
+  const std::vector<YearStatistics> &GetYears() const noexcept {
+    return years;
+  }
+
+  /**
+   * The most recent flights (up to #MAX_RECENT), oldest first.
+   */
+  const std::vector<FlightInfo> &GetRecentFlights() const noexcept {
+    return recent;
+  }
+
+private:
+  void Clear() noexcept;
+
+  /**
+   * Load the index, but only if it matches the log.
+   *
+   * Throws on error.
+   *
+   * @return the number of log bytes covered by the index; 0 if there
+   * is no (matching) index
+   */
+  uint_least64_t Load(FileReader &log);
+
+  /**
+   * Write a new index: the records of the old one plus the given
+   * flights.
+   *
+   * Throws on error.
+   *
+   * @param old_flights the number of flights taken from the old
+   * index
+   */
+  void Save(FileReader &log, uint_least64_t log_offset,
+            unsigned old_flights,
+            const std::vector<FlightInfo> &added) const;
+
+  void Add(const FlightInfo &flight) noexcept;
+
+  void AddRecent(const FlightInfo &flight) noexcept;
+};
@@ -25,6 +25,14 @@ public:
    */
   bool Read(FlightInfo &flight);
 
+  /**
+   * Returns the line which the last Read() call has read ahead (it
+   * belongs to the next flight), or nullptr if there is none.
+   */
+  const char *GetPendingLine() const noexcept {
+    return last;
+  }
+
 private:
   char *ReadLine();
   char *ReadLine(BrokenDateTime &dt);
@@ -12,6 +12,7 @@
 #include "Terrain/Thread.hpp"
 #include "Components.hpp"
 #include "BackendComponents.hpp"
+#include "LogFile.hpp"
 
 GlueMapWindow::GlueMapWindow(const Look &look) noexcept
   :MapWindow(look.map, look.traffic),
@@ -31,6 +32,10 @@ void
 GlueMapWindow::SetTopography(TopographyStore *_topography) noexcept
 {
   if (topography_thread != nullptr) {
+    const auto &statistics = topography_thread->GetStatistics();
+    LogFormat("Topography prefetch: %u hits, %u misses",
+              statistics.hits, statistics.misses);
+
     topography_thread->LockStop();
     delete topography_thread;
     topography_thread = nullptr;
@@ -47,6 +52,10 @@ void
 GlueMapWindow::SetTerrain(RasterTerrain *_terrain) noexcept
 {
   if (terrain_thread != nullptr) {
+    const auto &statistics = terrain_thread->GetStatistics();
+    LogFormat("Terrain prefetch: %u hits, %u misses",
+              statistics.hits, statistics.misses);
+
     terrain_thread->LockStop();
     delete terrain_thread;
     terrain_thread = nullptr;
@@ -107,7 +116,7 @@ GlueMapWindow::ExchangeBlackboard() noexcept
     auto &device_blackboard = *backend_components->device_blackboard;
     const std::lock_guard lock{device_blackboard.mutex};
     ReadBlackboard(device_blackboard.Basic(),
-                   device_blackboard.Calculated());
+                   device_blackboard.GetCalculatedSnapshot());
   }
 
 #ifndef ENABLE_OPENGL
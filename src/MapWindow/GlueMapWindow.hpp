@@ -267,6 +267,18 @@ private:
    */
   void UpdateScreenBounds() noexcept;
 
+  /**
+   * Predict where the screen center will be in a few minutes (based
+   * on ground speed, track and the current task leg), to load
+   * terrain and topography in advance.
+   *
+   * @return the predicted screen center or GeoPoint::Invalid() if
+   * there is no meaningful prediction (e.g. while circling or
+   * panning)
+   */
+  [[gnu::pure]]
+  GeoPoint PredictScreenCenter() const noexcept;
+
   void UpdateScreenAngle() noexcept;
   void UpdateProjection() noexcept;
 
@@ -8,6 +8,8 @@
 #include "Interface.hpp"
 #include "Profile/Profile.hpp"
 #include "Screen/Layout.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/Math.hpp"
 
 #include <algorithm> // for std::clamp()
 
@@ -89,22 +91,74 @@ GlueMapWindow::PanTo(const GeoPoint &location) noexcept
   FullRedraw();
 }
 
+/**
+ * How far ahead (in seconds of flight) the screen center is
+ * predicted for loading terrain and topography in advance.
+ */
+static constexpr double PREFETCH_LEAD_TIME = 300;
+
+GeoPoint
+GlueMapWindow::PredictScreenCenter() const noexcept
+{
+  const MoreData &basic = CommonInterface::Basic();
+  const DerivedInfo &calculated = CommonInterface::Calculated();
+
+  if (!IsNearSelf() || calculated.circling ||
+      !basic.location_available || !basic.track_available ||
+      !basic.MovementDetected())
+    return GeoPoint::Invalid();
+
+  /* never more than half a screen width ahead; this limits the
+     amount of memory used for data which is not visible yet */
+  const double screen_width = visible_projection.GetScreenWidthMeters();
+  double distance = std::min(basic.ground_speed * PREFETCH_LEAD_TIME,
+                             screen_width / 2);
+  Angle bearing = basic.track;
+
+  const ElementStat &leg = calculated.task_stats.current_leg;
+  if (calculated.task_stats.task_valid &&
+      leg.location_remaining.IsValid()) {
+    const GeoVector vector =
+      basic.location.DistanceBearing(leg.location_remaining);
+    if (vector.distance < distance) {
+      /* the aircraft will turn at the next waypoint, and we don't
+         know where to */
+      distance = vector.distance;
+      bearing = vector.bearing;
+    } else if (basic.track.CompareRoughly(vector.bearing,
+                                          Angle::Degrees(45)))
+      /* heading for the waypoint: the leg is steadier than the
+         track */
+      bearing = vector.bearing;
+  }
+
+  if (distance < screen_width / 16)
+    /* not worth the effort */
+    return GeoPoint::Invalid();
+
+  return FindLatitudeLongitude(visible_projection.GetGeoScreenCenter(),
+                               bearing, distance);
+}
+
 void
 GlueMapWindow::UpdateScreenBounds() noexcept
 {
   visible_projection.UpdateScreenBounds();
 
+  if (!visible_projection.IsValid())
+    return;
+
+  const GeoPoint prefetch_center = PredictScreenCenter();
+
   if (topography_thread != nullptr &&
-      visible_projection.IsValid() &&
       CommonInterface::GetMapSettings().topography_enabled)
-    topography_thread->Trigger(visible_projection);
+    topography_thread->Trigger(visible_projection, prefetch_center);
 
   /* always service terrain even if it's not used by the map, because
      it's used by other calculations, therefore don't check if terrain
      display is enabled */
-  if (terrain_thread != nullptr &&
-      visible_projection.IsValid())
-    terrain_thread->Trigger(visible_projection);
+  if (terrain_thread != nullptr)
+    terrain_thread->Trigger(visible_projection, prefetch_center);
 }
 
 void
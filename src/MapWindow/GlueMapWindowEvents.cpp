@@ -443,7 +443,7 @@ GlueMapWindow::Render(Canvas &canvas, const PixelRect &rc) noexcept
   MapWindow::Render(canvas, rc);
 
   if (IsNearSelf()) {
-    draw_sw.Mark("DrawGlueMisc");
+    MarkRenderLayer(MapRenderStats::Layer::GLUE);
     if (GetMapSettings().show_thermal_profile)
       DrawThermalBand(canvas, rc);
     DrawStallRatio(canvas, rc);
@@ -201,11 +201,19 @@ GlueMapWindow::DrawFlightMode(Canvas &canvas,
     // Don't show indicator when the gauge is indicating the traffic anyway
     return;
 
-  const FlarmStatus &flarm = Basic().flarm.status;
-  if (!flarm.available)
+  const FlarmData &flarm = Basic().flarm;
+  if (!flarm.status.available && flarm.conflicts.IsEmpty())
     return;
 
-  switch (flarm.alarm_level) {
+  /* show the FLARM alarm or the most urgent predicted conflict,
+     whichever is higher */
+  auto alarm_level = flarm.status.available
+    ? flarm.status.alarm_level
+    : FlarmTraffic::AlarmType::NONE;
+  if ((unsigned)flarm.conflicts.GetAlarmLevel() > (unsigned)alarm_level)
+    alarm_level = flarm.conflicts.GetAlarmLevel();
+
+  switch (alarm_level) {
   case FlarmTraffic::AlarmType::NONE:
     bmp = &look.traffic_safe_icon;
     break;
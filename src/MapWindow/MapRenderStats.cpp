@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "MapRenderStats.hpp"
+#include "io/BufferedOutputStream.hxx"
+
+#include <algorithm>
+#include <span>
+
+using std::chrono::duration_cast;
+
+static constexpr const char *layer_names[] = {
+  "Terrain",
+  "RASP",
+  "Topography",
+  "Overlays",
+  "NOAA",
+  "FinalGlide",
+  "Airspace",
+  "Contest",
+  "Task",
+  "Waypoints",
+  "Trail",
+  "TopographyLabels",
+  "Glide",
+  "OffTrack",
+  "Misc",
+  "TrackBearing",
+  "Traffic",
+  "Glue",
+};
+
+static_assert(std::size(layer_names) == MapRenderStats::N_LAYERS);
+
+static constexpr const char *cache_names[] = {
+  "Terrain",
+  "Topography",
+  "Reach",
+};
+
+static_assert(std::size(cache_names) == MapRenderStats::N_CACHES);
+
+const char *
+MapRenderStats::GetName(Layer layer) noexcept
+{
+  return layer_names[std::size_t(layer)];
+}
+
+const char *
+MapRenderStats::GetName(Cache cache) noexcept
+{
+  return cache_names[std::size_t(cache)];
+}
+
+void
+MapRenderStats::Recorder::BeginFrame() noexcept
+{
+  frame = {};
+  current_layer = Layer::COUNT;
+  start = last_mark = Clock::now();
+}
+
+inline void
+MapRenderStats::Recorder::FinishLayer(Clock::time_point now) noexcept
+{
+  if (current_layer != Layer::COUNT)
+    frame.layers[std::size_t(current_layer)] +=
+      duration_cast<Duration>(now - last_mark);
+
+  last_mark = now;
+}
+
+void
+MapRenderStats::Recorder::Mark(Layer layer) noexcept
+{
+  FinishLayer(Clock::now());
+  current_layer = layer;
+}
+
+const MapRenderStats::Frame &
+MapRenderStats::Recorder::EndFrame() noexcept
+{
+  const auto now = Clock::now();
+  FinishLayer(now);
+  current_layer = Layer::COUNT;
+
+  frame.total = duration_cast<Duration>(now - start);
+  return frame;
+}
+
+void
+MapRenderStats::Commit(const Frame &frame) noexcept
+{
+  const std::lock_guard lock{mutex};
+
+  frames[head] = frame;
+  head = (head + 1) % HISTORY;
+  if (n_frames < HISTORY)
+    ++n_frames;
+}
+
+void
+MapRenderStats::Clear() noexcept
+{
+  const std::lock_guard lock{mutex};
+  head = n_frames = 0;
+}
+
+/**
+ * Calculate the percentiles with the "nearest rank" method.  The
+ * given buffer gets sorted.
+ */
+static MapRenderStats::Percentiles
+CalculatePercentiles(std::span<MapRenderStats::Duration> values) noexcept
+{
+  MapRenderStats::Percentiles p;
+  if (values.empty())
+    return p;
+
+  std::sort(values.begin(), values.end());
+
+  const auto rank = [&values](unsigned percent){
+    /* ceil(percent * n / 100) - 1 */
+    return values[(percent * values.size() + 99) / 100 - 1];
+  };
+
+  p.p50 = rank(50);
+  p.p90 = rank(90);
+  p.p99 = rank(99);
+  p.max = values.back();
+  return p;
+}
+
+MapRenderStats::Summary
+MapRenderStats::GetSummary() const noexcept
+{
+  Summary summary;
+
+  std::array<Duration, HISTORY> total;
+  std::array<std::array<Duration, HISTORY>, N_LAYERS> layers;
+
+  {
+    const std::lock_guard lock{mutex};
+
+    summary.n_frames = n_frames;
+
+    /* the order does not matter, the values get sorted anyway */
+    for (std::size_t i = 0; i < n_frames; ++i) {
+      const Frame &frame = frames[i];
+
+      total[i] = frame.total;
+      for (std::size_t l = 0; l < N_LAYERS; ++l)
+        layers[l][i] = frame.layers[l];
+
+      for (std::size_t c = 0; c < N_CACHES; ++c)
+        summary.caches[c] += frame.caches[c];
+    }
+  }
+
+  summary.total = CalculatePercentiles({total.data(), summary.n_frames});
+  for (std::size_t l = 0; l < N_LAYERS; ++l)
+    summary.layers[l] = CalculatePercentiles({layers[l].data(),
+                                              summary.n_frames});
+
+  return summary;
+}
+
+static void
+DumpPercentiles(BufferedOutputStream &os, const char *name,
+                const MapRenderStats::Percentiles &p)
+{
+  os.Fmt("{:<18} {:>8} {:>8} {:>8} {:>8}\n", name,
+         p.p50.count(), p.p90.count(), p.p99.count(), p.max.count());
+}
+
+void
+MapRenderStats::Dump(BufferedOutputStream &os) const
+{
+  const auto summary = GetSummary();
+
+  os.Fmt("frames: {}\n\n", summary.n_frames);
+
+  os.Fmt("{:<18} {:>8} {:>8} {:>8} {:>8}\n",
+         "layer [us]", "p50", "p90", "p99", "max");
+  DumpPercentiles(os, "total", summary.total);
+  for (std::size_t l = 0; l < N_LAYERS; ++l)
+    DumpPercentiles(os, GetName(Layer(l)), summary.layers[l]);
+
+  os.Fmt("\n{:<18} {:>8} {:>8}\n", "cache", "hits", "misses");
+  for (std::size_t c = 0; c < N_CACHES; ++c)
+    os.Fmt("{:<18} {:>8} {:>8}\n", GetName(Cache(c)),
+           summary.caches[c].hits, summary.caches[c].misses);
+}
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Renderer/CacheCounter.hpp"
+#include "thread/Mutex.hxx"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+class BufferedOutputStream;
+
+/**
+ * Collects the durations of the #MapWindow rendering stages and the
+ * hit rates of the renderer caches over the most recent frames.
+ *
+ * The draw thread measures a frame with a #Recorder and passes it to
+ * Commit(); any thread may obtain a #Summary or a textual dump at any
+ * time.
+ */
+class MapRenderStats {
+public:
+  enum class Layer : uint8_t {
+    TERRAIN,
+    RASP,
+    TOPOGRAPHY,
+    OVERLAYS,
+    NOAA,
+    FINAL_GLIDE,
+    AIRSPACE,
+    CONTEST,
+    TASK,
+    WAYPOINTS,
+    TRAIL,
+    TOPOGRAPHY_LABELS,
+    GLIDE,
+    OFF_TRACK,
+    MISC,
+    TRACK_BEARING,
+    TRAFFIC,
+    GLUE,
+    COUNT
+  };
+
+  enum class Cache : uint8_t {
+    TERRAIN,
+    TOPOGRAPHY,
+    REACH,
+    COUNT
+  };
+
+  static constexpr std::size_t N_LAYERS = std::size_t(Layer::COUNT);
+  static constexpr std::size_t N_CACHES = std::size_t(Cache::COUNT);
+
+  /**
+   * The number of frames kept in the ring buffer.
+   */
+  static constexpr std::size_t HISTORY = 128;
+
+  /**
+   * 32 bit microseconds keep the ring buffer small and are good for
+   * more than an hour per frame.
+   */
+  using Duration = std::chrono::duration<uint_least32_t, std::micro>;
+
+  struct Frame {
+    std::array<Duration, N_LAYERS> layers{};
+
+    /**
+     * The duration of the whole frame, including the code between
+     * the layers.
+     */
+    Duration total{};
+
+    std::array<CacheCounter, N_CACHES> caches{};
+  };
+
+  /**
+   * Measures one frame.  Each Mark() call ends the current layer and
+   * starts a new one, just like #ScreenStopWatch.  Not thread-safe;
+   * this object is owned by the draw thread.
+   */
+  class Recorder {
+    using Clock = std::chrono::steady_clock;
+
+    Frame frame;
+
+    Clock::time_point start, last_mark;
+
+    Layer current_layer = Layer::COUNT;
+
+  public:
+    void BeginFrame() noexcept;
+
+    void Mark(Layer layer) noexcept;
+
+    void SetCache(Cache cache, CacheCounter counter) noexcept {
+      frame.caches[std::size_t(cache)] = counter;
+    }
+
+    /**
+     * Finish the current frame and return the measurement, which
+     * remains valid until the next BeginFrame() call.
+     */
+    const Frame &EndFrame() noexcept;
+
+  private:
+    void FinishLayer(Clock::time_point now) noexcept;
+  };
+
+  struct Percentiles {
+    Duration p50{}, p90{}, p99{}, max{};
+  };
+
+  struct Summary {
+    /**
+     * The number of frames this summary was calculated from (at most
+     * #HISTORY).
+     */
+    std::size_t n_frames = 0;
+
+    Percentiles total;
+    std::array<Percentiles, N_LAYERS> layers;
+
+    /**
+     * The cache statistics, added up over all frames.
+     */
+    std::array<CacheCounter, N_CACHES> caches;
+  };
+
+private:
+  mutable Mutex mutex;
+
+  std::array<Frame, HISTORY> frames;
+
+  /**
+   * The position where the next frame will be stored.
+   */
+  std::size_t head = 0;
+
+  std::size_t n_frames = 0;
+
+public:
+  void Commit(const Frame &frame) noexcept;
+
+  void Clear() noexcept;
+
+  Summary GetSummary() const noexcept;
+
+  /**
+   * Write a human-readable table of the current summary.
+   *
+   * Throws on I/O error.
+   */
+  void Dump(BufferedOutputStream &os) const;
+
+  [[gnu::const]]
+  static const char *GetName(Layer layer) noexcept;
+
+  [[gnu::const]]
+  static const char *GetName(Cache cache) noexcept;
+};
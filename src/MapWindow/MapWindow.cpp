@@ -71,11 +71,11 @@ MapWindow::FlushCaches() noexcept
  */
 void
 MapWindow::ReadBlackboard(const MoreData &nmea_info,
-                          const DerivedInfo &derived_info,
+                          std::shared_ptr<const DerivedInfo> derived_info,
                           const ComputerSettings &settings_computer,
                           const MapSettings &settings_map) noexcept
 {
-  MapWindowBlackboard::ReadBlackboard(nmea_info, derived_info);
+  MapWindowBlackboard::ReadBlackboard(nmea_info, std::move(derived_info));
   ReadComputerSettings(settings_computer);
   ReadMapSettings(settings_map);
 }
@@ -121,7 +121,9 @@ MapWindow::OnPaintBuffer(Canvas &canvas) noexcept
 #endif
 
     // Render the moving map
+    render_recorder.BeginFrame();
     Render(canvas, GetClientRect());
+    CommitRenderStats();
     draw_sw.Finish();
   }
 
@@ -133,6 +135,21 @@ MapWindow::OnPaintBuffer(Canvas &canvas) noexcept
 #endif
 }
 
+void
+MapWindow::CommitRenderStats() noexcept
+{
+  using Cache = MapRenderStats::Cache;
+
+  render_recorder.SetCache(Cache::TERRAIN, background.TakeCacheCounter());
+  if (topography_renderer != nullptr)
+    render_recorder.SetCache(Cache::TOPOGRAPHY,
+                             topography_renderer->TakeCacheCounter());
+  render_recorder.SetCache(Cache::REACH,
+                           waypoint_renderer.TakeCacheCounter());
+
+  render_stats.Commit(render_recorder.EndFrame());
+}
+
 void
 MapWindow::SetTopography(TopographyStore *_topography) noexcept
 {
@@ -12,6 +12,7 @@
 #include "Renderer/LabelBlock.hpp"
 #include "Screen/StopWatch.hpp"
 #include "MapWindowBlackboard.hpp"
+#include "MapRenderStats.hpp"
 #include "Renderer/AirspaceLabelRenderer.hpp"
 #include "Renderer/BackgroundRenderer.hpp"
 #include "Renderer/WaypointRenderer.hpp"
@@ -166,6 +167,13 @@ protected:
    */
   ScreenStopWatch draw_sw;
 
+  /**
+   * Per-layer frame times and cache statistics of OnPaintBuffer().
+   * The #Recorder is only used by the DrawThread.
+   */
+  MapRenderStats render_stats;
+  MapRenderStats::Recorder render_recorder;
+
   friend class DrawThread;
 
 public:
@@ -244,7 +252,7 @@ public:
   using MapWindowBlackboard::ReadBlackboard;
 
   void ReadBlackboard(const MoreData &nmea_info,
-                      const DerivedInfo &derived_info,
+                      std::shared_ptr<const DerivedInfo> derived_info,
                       const ComputerSettings &settings_computer,
                       const MapSettings &settings_map) noexcept;
 
@@ -267,7 +275,24 @@ public:
     visible_projection.UpdateScreenBounds();
   }
 
+  MapRenderStats &GetRenderStats() noexcept {
+    return render_stats;
+  }
+
+  const MapRenderStats &GetRenderStats() const noexcept {
+    return render_stats;
+  }
+
 protected:
+  /**
+   * Begin a new rendering stage; the time until the next call is
+   * accounted to this layer by #draw_sw and #render_stats.
+   */
+  void MarkRenderLayer(MapRenderStats::Layer layer) noexcept {
+    draw_sw.Mark(MapRenderStats::GetName(layer));
+    render_recorder.Mark(layer);
+  }
+
   void DrawBestCruiseTrack(Canvas &canvas, PixelPoint aircraft_pos) const noexcept;
   void DrawTrackBearing(Canvas &canvas,
                         PixelPoint aircraft_pos, bool circling) const noexcept;
@@ -318,6 +343,13 @@ protected:
     UpdateTerrain();
   }
 
+private:
+  /**
+   * Finish the frame measured by #render_recorder and commit it,
+   * together with the renderer cache statistics, to #render_stats.
+   */
+  void CommitRenderStats() noexcept;
+
 protected:
   /* virtual methods from class Window */
   void OnCreate() override;
@@ -60,7 +60,7 @@ UpdateFadingTraffic(bool fade_traffic,
 
 void
 MapWindowBlackboard::ReadBlackboard(const MoreData &nmea_info,
-				    const DerivedInfo &derived_info) noexcept
+				    std::shared_ptr<const DerivedInfo> derived_info) noexcept
 {
   UpdateFadingTraffic(settings_map.fade_traffic,
                       fading_flarm_traffic, gps_info.flarm.traffic,
@@ -68,6 +68,6 @@ MapWindowBlackboard::ReadBlackboard(const MoreData &nmea_info,
                       nmea_info.clock);
 
   gps_info = nmea_info;
-  calculated_info = derived_info;
+  calculated_info = std::move(derived_info);
 }
 
@@ -77,7 +77,7 @@ protected:
   }
 
   void ReadBlackboard(const MoreData &nmea_info,
-                      const DerivedInfo &derived_info) noexcept;
+                      std::shared_ptr<const DerivedInfo> derived_info) noexcept;
   void ReadComputerSettings(const ComputerSettings &settings) noexcept;
   void ReadMapSettings(const MapSettings &settings) noexcept;
 
@@ -187,46 +187,47 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc) noexcept
   //////////////////////////////////////////////// items on ground
 
   // Render terrain, groundline and topography
-  draw_sw.Mark("RenderTerrain");
+  MarkRenderLayer(MapRenderStats::Layer::TERRAIN);
   RenderTerrain(canvas);
 
-  draw_sw.Mark("RenderRasp");
+  MarkRenderLayer(MapRenderStats::Layer::RASP);
   RenderRasp(canvas);
 
-  draw_sw.Mark("RenderTopography");
+  MarkRenderLayer(MapRenderStats::Layer::TOPOGRAPHY);
   RenderTopography(canvas);
 
-  draw_sw.Mark("RenderOverlays");
+  MarkRenderLayer(MapRenderStats::Layer::OVERLAYS);
   RenderOverlays(canvas);
 
-  draw_sw.Mark("DrawNOAAStations");
+  MarkRenderLayer(MapRenderStats::Layer::NOAA);
   RenderNOAAStations(canvas);
 
   //////////////////////////////////////////////// glide range info
 
-  draw_sw.Mark("RenderFinalGlideShading");
+  MarkRenderLayer(MapRenderStats::Layer::FINAL_GLIDE);
   RenderFinalGlideShading(canvas);
 
   //////////////////////////////////////////////// airspace
 
   // Render airspace
-  draw_sw.Mark("RenderAirspace");
+  MarkRenderLayer(MapRenderStats::Layer::AIRSPACE);
   RenderAirspace(canvas);
 
   //////////////////////////////////////////////// task
 
   // Render task, waypoints
-  draw_sw.Mark("DrawContest");
+  MarkRenderLayer(MapRenderStats::Layer::CONTEST);
   DrawContest(canvas);
 
-  draw_sw.Mark("DrawTask");
+  MarkRenderLayer(MapRenderStats::Layer::TASK);
   DrawTask(canvas);
 
-  draw_sw.Mark("DrawWaypoints");
+  MarkRenderLayer(MapRenderStats::Layer::WAYPOINTS);
   DrawWaypoints(canvas);
 
   //////////////////////////////////////////////// aircraft level items
   // Render the snail trail
+  MarkRenderLayer(MapRenderStats::Layer::TRAIL);
   RenderTrail(canvas, aircraft_pos);
 
   DrawWaves(canvas);
@@ -236,23 +237,23 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc) noexcept
 
   //////////////////////////////////////////////// text items
   // Render topography on top of airspace, to keep the text readable
-  draw_sw.Mark("RenderTopographyLabels");
+  MarkRenderLayer(MapRenderStats::Layer::TOPOGRAPHY_LABELS);
   RenderTopographyLabels(canvas);
 
   //////////////////////////////////////////////// navigation overlays
   // Render glide through terrain range
-  draw_sw.Mark("RenderGlide");
+  MarkRenderLayer(MapRenderStats::Layer::GLIDE);
   RenderGlide(canvas);
 
-  draw_sw.Mark("RenderMisc1");
+  MarkRenderLayer(MapRenderStats::Layer::OFF_TRACK);
   // Render weather/terrain max/min values
   DrawTaskOffTrackIndicator(canvas);
 
   // Render track bearing (projected track ground/air relative)
-  draw_sw.Mark("DrawTrackBearing");
+  MarkRenderLayer(MapRenderStats::Layer::TRACK_BEARING);
   RenderTrackBearing(canvas, aircraft_pos);
 
-  draw_sw.Mark("RenderMisc2");
+  MarkRenderLayer(MapRenderStats::Layer::MISC);
   DrawBestCruiseTrack(canvas, aircraft_pos);
 
   // Draw wind vector at aircraft
@@ -264,6 +265,7 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc) noexcept
 
   //////////////////////////////////////////////// traffic
   // Draw traffic
+  MarkRenderLayer(MapRenderStats::Layer::TRAFFIC);
 
 #ifdef HAVE_SKYLINES_TRACKING
   DrawSkyLinesTraffic(canvas);
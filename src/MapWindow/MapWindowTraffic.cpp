@@ -84,6 +84,7 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
 
   // Return if FLARM data is not available
   const TrafficList &flarm = Basic().flarm.traffic;
+  const FlarmConflictList &conflicts = Basic().flarm.conflicts;
 
   const WindowProjection &projection = render_projection;
 
@@ -100,6 +101,15 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
     if (!traffic.location_available)
       continue;
 
+    if (const auto *conflict = conflicts.Find(traffic.id)) {
+      /* highlight predicted conflicts like FLARM alarms */
+      FlarmTraffic copy = traffic;
+      copy.alarm_level = conflict->level;
+      DrawFlarmTraffic(canvas, projection, traffic_look, false,
+                       aircraft_pos, copy);
+      continue;
+    }
+
     DrawFlarmTraffic(canvas, projection, traffic_look, false,
                      aircraft_pos, traffic);
   }
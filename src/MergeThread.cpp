@@ -53,7 +53,7 @@ MergeThread::Tick() noexcept
   bool gps_updated, calculated_updated;
 
 #ifdef HAVE_PCM_PLAYER
-  bool vario_available;
+  bool vario_available, real_data_active;
   double vario;
 #endif
 
@@ -80,6 +80,7 @@ MergeThread::Tick() noexcept
 #ifdef HAVE_PCM_PLAYER
     vario_available = basic.brutto_vario_available;
     vario = vario_available ? basic.brutto_vario : 0;
+    real_data_active = device_blackboard.IsRealDataActive();
 #endif
 
     /* update last_any in every iteration */
@@ -93,6 +94,10 @@ MergeThread::Tick() noexcept
   }
 
 #ifdef HAVE_PCM_PLAYER
+  /* during replay and simulation, values received by the devices
+     must not be played */
+  AudioVarioGlue::AllowDeviceValues(real_data_active);
+
   if (vario_available)
     AudioVarioGlue::SetValue(vario);
   else
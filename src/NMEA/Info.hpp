@@ -24,7 +24,6 @@
 #endif
 
 #include <optional>
-#include <type_traits>
 
 /**
  * A struct that holds all the parsed data read from the connected devices
@@ -623,5 +622,3 @@ struct NMEAInfo {
    */
   void Complement(const NMEAInfo &add) noexcept;
 };
-
-static_assert(std::is_trivial<NMEAInfo>::value, "type is not trivial");
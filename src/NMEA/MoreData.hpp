@@ -5,7 +5,6 @@
 
 #include "NMEA/Info.hpp"
 
-#include <type_traits>
 
 /**
  * A wrapper for NMEA_INFO which adds a few attributes that are cheap
@@ -42,5 +41,3 @@ struct MoreData : public NMEAInfo {
     return baro_altitude_available || gps_altitude_available;
   }
 };
-
-static_assert(std::is_trivial<MoreData>::value, "type is not trivial");
@@ -18,13 +18,12 @@
 #include "ui/window/SingleWindow.hpp"
 #include "ui/event/Queue.hpp"
 #include "ui/event/Timer.hpp"
-#include "Logger/FlightParser.hpp"
+#include "Logger/FlightLogbook.hpp"
 #include "Language/Language.hpp"
 #include "lib/dbus/Connection.hxx"
 #include "lib/dbus/ScopeMatch.hxx"
 #include "lib/dbus/Systemd.hxx"
 #include "system/Process.hpp"
-#include "io/FileLineReader.hpp"
 #include "util/PrintException.hxx"
 #include "util/ScopeExit.hxx"
 #include "LocalPath.hpp"
@@ -340,11 +339,10 @@ ShowLogbook() noexcept
   FlightListRenderer renderer{look.text_font, look.bold_font};
 
   try {
-    FileLineReaderA file(LocalPath("flights.log"));
+    FlightLogbook logbook{LocalPath("flights.log")};
+    logbook.Update();
 
-    FlightParser parser{file};
-    FlightInfo flight;
-    while (parser.Read(flight))
+    for (const auto &flight : logbook.GetRecentFlights())
       renderer.AddFlight(flight);
   } catch (...) {
     ShowError(std::current_exception(), "Logbook");
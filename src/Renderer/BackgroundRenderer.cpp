@@ -24,6 +24,14 @@ BackgroundRenderer::SetTerrain(const RasterTerrain *_terrain) noexcept
   renderer.reset();
 }
 
+CacheCounter
+BackgroundRenderer::TakeCacheCounter() noexcept
+{
+  return renderer != nullptr
+    ? renderer->TakeCacheCounter()
+    : CacheCounter{};
+}
+
 void
 BackgroundRenderer::Draw(Canvas& canvas,
                          const WindowProjection& proj,
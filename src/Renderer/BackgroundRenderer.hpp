@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Math/Angle.hpp"
+#include "CacheCounter.hpp"
 
 #include <memory>
 
@@ -42,6 +43,11 @@ public:
                        const DerivedInfo &calculated) noexcept;
   void SetTerrain(const RasterTerrain *terrain) noexcept;
 
+  /**
+   * Return (and reset) the terrain image cache statistics.
+   */
+  CacheCounter TakeCacheCounter() noexcept;
+
 private:
   void SetShadingAngle(const WindowProjection& proj, Angle angle) noexcept;
 };
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <utility>
+
+/**
+ * Counts how often a renderer was able to reuse its cached output.
+ * The owner increments it while drawing; the #MapWindow collects
+ * (and resets) it once per frame for #MapRenderStats.
+ */
+struct CacheCounter {
+  unsigned hits = 0, misses = 0;
+
+  void Count(bool hit) noexcept {
+    ++(hit ? hits : misses);
+  }
+
+  CacheCounter &operator+=(const CacheCounter &other) noexcept {
+    hits += other.hits;
+    misses += other.misses;
+    return *this;
+  }
+
+  /**
+   * Return the current values and reset the counter.
+   */
+  CacheCounter Exchange() noexcept {
+    return std::exchange(*this, CacheCounter{});
+  }
+};
@@ -86,30 +86,26 @@ struct VisibleWaypoint {
       reachable = WaypointReachability::UNREACHABLE;
   }
 
-  bool CalculateRouteArrival(const ProtectedRoutePlanner &route_planner,
-                             const TaskBehaviour &task_behaviour) noexcept {
-    if (!waypoint->has_elevation)
-      return false;
-
-    const double elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const AGeoPoint p_dest (waypoint->location, elevation);
-
-    auto _reach = route_planner.FindPositiveArrival(p_dest);
-    if (!_reach)
-      return false;
+  /**
+   * The destination for ProtectedRoutePlanner::FindPositiveArrival().
+   * The waypoint must have an elevation.
+   */
+  AGeoPoint GetRouteDestination(const TaskBehaviour &task_behaviour) const noexcept {
+    assert(waypoint->has_elevation);
 
-    reach = *_reach;
-    reach.Subtract(elevation);
-    return true;
+    return AGeoPoint(waypoint->location,
+                     waypoint->elevation + task_behaviour.safety_height_arrival);
   }
 
-  void CalculateReachability(const ProtectedRoutePlanner &route_planner,
-                             const TaskBehaviour &task_behaviour) noexcept
+  void SetReachability(const std::optional<ReachResult> &_reach,
+                       const TaskBehaviour &task_behaviour) noexcept
   {
-    if (!CalculateRouteArrival(route_planner, task_behaviour))
+    if (!_reach)
       return;
 
+    reach = *_reach;
+    reach.Subtract(GetRouteDestination(task_behaviour).altitude);
+
     if (!reach.IsReachableDirect())
       reachable = WaypointReachability::UNREACHABLE;
     else if (task_behaviour.route_planner.IsReachEnabled() &&
@@ -398,12 +394,61 @@ public:
     task_valid = true;
   }
 
-  void CalculateRoute(const ProtectedRoutePlanner &route_planner) noexcept {
+  /**
+   * Look up the terrain reach of all landable (and watched)
+   * waypoints.  Results are taken from the #ReachCache if possible;
+   * the others are looked up in one batch and added to the cache.
+   */
+  void CalculateRoute(const ProtectedRoutePlanner &route_planner,
+                      WaypointRenderer::ReachCache &cache,
+                      Serial waypoints_serial) noexcept {
+    cache.Validate(route_planner.GetReachSerial(), waypoints_serial,
+                   task_behaviour.safety_height_arrival);
+
+    StaticArray<VisibleWaypoint *, 256> pending;
+    StaticArray<AGeoPoint, 256> destinations;
+
     for (VisibleWaypoint &vwp : waypoints) {
       const Waypoint &way_point = *vwp.waypoint;
 
-      if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachability(route_planner, task_behaviour);
+      if (!(way_point.IsLandable() || way_point.flags.watched) ||
+          !way_point.has_elevation)
+        continue;
+
+      const AGeoPoint destination = vwp.GetRouteDestination(task_behaviour);
+
+      if (const auto i = cache.results.find(way_point.id);
+          i != cache.results.end() &&
+          (const GeoPoint &)i->second.destination == destination &&
+          i->second.destination.altitude == destination.altitude) {
+        vwp.SetReachability(i->second.result, task_behaviour);
+        cache.counter.Count(true);
+        continue;
+      }
+
+      pending.push_back(&vwp);
+      destinations.push_back(destination);
+      cache.counter.Count(false);
+    }
+
+    if (pending.empty())
+      return;
+
+    std::optional<ReachResult> results[256];
+    const Serial reach_serial =
+      route_planner.FindPositiveArrivals(destinations,
+                                         std::span{results, pending.size()});
+
+    /* the reach may have changed after Validate() */
+    cache.Validate(reach_serial, waypoints_serial,
+                   task_behaviour.safety_height_arrival);
+
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+      VisibleWaypoint &vwp = *pending[i];
+      vwp.SetReachability(results[i], task_behaviour);
+      cache.results.insert_or_assign(vwp.waypoint->id,
+                                     WaypointRenderer::ReachCache::Item{
+                                       destinations[i], results[i]});
     }
   }
 
@@ -429,11 +474,13 @@ public:
   }
 
   void Calculate(const ProtectedRoutePlanner *route_planner,
+                 WaypointRenderer::ReachCache &reach_cache,
+                 Serial waypoints_serial,
                  const PolarSettings &polar_settings,
                  const TaskBehaviour &task_behaviour,
                  const DerivedInfo &calculated) noexcept {
     if (route_planner != nullptr && !route_planner->IsTerrainReachEmpty())
-      CalculateRoute(*route_planner);
+      CalculateRoute(*route_planner, reach_cache, waypoints_serial);
     else
       CalculateDirect(polar_settings, task_behaviour, calculated);
   }
@@ -493,7 +540,8 @@ WaypointRenderer::Render(Canvas &canvas, LabelBlock &label_block,
                                projection.GetScreenDistanceMeters(),
                                [&v](const auto &w){ v.Add(w); });
 
-  v.Calculate(route_planner, polar_settings, task_behaviour, calculated);
+  v.Calculate(route_planner, reach_cache, way_points->GetSerial(),
+              polar_settings, task_behaviour, calculated);
 
   v.Draw();
 
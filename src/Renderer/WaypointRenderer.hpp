@@ -3,7 +3,14 @@
 
 #pragma once
 
+#include "CacheCounter.hpp"
+#include "Engine/Route/ReachResult.hpp"
+#include "Geo/GeoPoint.hpp"
 #include "util/NonCopyable.hpp"
+#include "util/Serial.hpp"
+
+#include <optional>
+#include <unordered_map>
 
 struct WaypointRendererSettings;
 struct WaypointLook;
@@ -22,10 +29,59 @@ class ProtectedRoutePlanner;
  * Renders way point icons and labels into a #Canvas.
  */
 class WaypointRenderer : private NonCopyable {
+public:
+  /**
+   * Terrain reach results (see
+   * ProtectedRoutePlanner::FindPositiveArrival()) of waypoints,
+   * indexed by #Waypoint::id, so they do not need to be looked up
+   * in the reach fan on every frame.  The cache is flushed when the
+   * reach, the waypoint database or the arrival safety height
+   * changes.
+   */
+  struct ReachCache {
+    struct Item {
+      /**
+       * The destination which was looked up; a cached result is
+       * only used if it matches, because waypoints which are not in
+       * the database (e.g. in the task) may have the same id.
+       */
+      AGeoPoint destination;
+
+      std::optional<ReachResult> result;
+    };
+
+    std::unordered_map<unsigned, Item> results;
+
+    Serial reach_serial, waypoints_serial;
+
+    double safety_height = 0;
+
+    CacheCounter counter;
+
+    /**
+     * Flush the cache if it was filled with different inputs.
+     */
+    void Validate(Serial _reach_serial, Serial _waypoints_serial,
+                  double _safety_height) noexcept {
+      if (_reach_serial == reach_serial &&
+          _waypoints_serial == waypoints_serial &&
+          _safety_height == safety_height)
+        return;
+
+      results.clear();
+      reach_serial = _reach_serial;
+      waypoints_serial = _waypoints_serial;
+      safety_height = _safety_height;
+    }
+  };
+
+private:
   const Waypoints *way_points;
 
   const WaypointLook &look;
 
+  ReachCache reach_cache;
+
 public:
   WaypointRenderer(const Waypoints *_way_points,
                    const WaypointLook &_look) noexcept
@@ -37,6 +93,14 @@ public:
 
   void SetWaypoints(const Waypoints *_way_points) noexcept {
     way_points = _way_points;
+    reach_cache.results.clear();
+  }
+
+  /**
+   * Return (and reset) the statistics of the #ReachCache.
+   */
+  CacheCounter TakeCacheCounter() noexcept {
+    return reach_cache.counter.Exchange();
   }
 
   void Render(Canvas &canvas, LabelBlock &label_block,
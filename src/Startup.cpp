@@ -55,6 +55,8 @@
 #include "Replay/Replay.hpp"
 #include "LocalPath.hpp"
 #include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "io/async/AsioThread.hpp"
 #include "io/async/GlobalAsioThread.hpp"
 #include "net/http/Init.hpp"
@@ -419,7 +421,7 @@ Startup(UI::Display &display)
   {
     LogString("Loading Topography File...");
     operation.SetText(_("Loading Topography File..."));
-    LoadConfiguredTopography(*data_components->topography);
+    LoadConfiguredTopography(*data_components->topography, file_cache);
     operation.SetProgressPosition(256);
   }
 
@@ -430,7 +432,7 @@ Startup(UI::Display &display)
     sub_env.SetText(_("Loading Waypoints..."));
     WaypointGlue::LoadWaypoints(*data_components->waypoints,
                                 data_components->terrain.get(),
-                                sub_env);
+                                file_cache, sub_env);
   }
 
   // Read and parse the airfield info file
@@ -463,7 +465,7 @@ Startup(UI::Display &display)
     SubOperationEnvironment sub_env(operation, 768, 1024);
     ReadAirspace(*data_components->airspaces,
                  computer_settings.pressure,
-                 sub_env);
+                 file_cache, sub_env);
   }
 
   if (data_components->terrain)
@@ -590,6 +592,25 @@ Startup(UI::Display &display)
   return true;
 }
 
+/**
+ * Write the map rendering statistics of the most recent frames to
+ * "map-render-stats.txt" in the data directory.
+ */
+static void
+SaveMapRenderStats(const MapRenderStats &stats) noexcept
+try {
+  if (stats.GetSummary().n_frames == 0)
+    return;
+
+  FileOutputStream file(LocalPath(_T("map-render-stats.txt")));
+  BufferedOutputStream bos(file);
+  stats.Dump(bos);
+  bos.Flush();
+  file.Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save map render statistics");
+}
+
 void
 Shutdown()
 {
@@ -687,6 +708,9 @@ Shutdown()
   }
 #endif
 
+  if (const auto *map = main_window->GetMap(); map != nullptr)
+    SaveMapRenderStats(map->GetRenderStats());
+
   LogString("delete MapWindow");
   main_window->Deinitialise();
 
@@ -4,6 +4,8 @@
 #include "ProtectedRoutePlanner.hpp"
 #include "Engine/Route/ReachResult.hpp"
 
+#include <cassert>
+
 void
 ProtectedRoutePlanner::SetTerrain(const RasterTerrain *terrain) noexcept
 {
@@ -57,6 +59,7 @@ ProtectedRoutePlanner::SolveReach(const AGeoPoint &origin,
   const std::scoped_lock lock{reach_mutex};
   reach_terrain = std::move(rt);
   reach_working = std::move(rw);
+  ++reach_serial;
 }
 
 const FlatProjection
@@ -73,6 +76,20 @@ ProtectedRoutePlanner::FindPositiveArrival(const AGeoPoint &dest) const noexcept
   return reach_terrain.FindPositiveArrival(dest, rpolars_reach);
 }
 
+Serial
+ProtectedRoutePlanner::FindPositiveArrivals(std::span<const AGeoPoint> dests,
+                                            std::span<std::optional<ReachResult>> results) const noexcept
+{
+  assert(results.size() == dests.size());
+
+  const std::scoped_lock lock{reach_mutex};
+
+  for (std::size_t i = 0; i < dests.size(); ++i)
+    results[i] = reach_terrain.FindPositiveArrival(dests[i], rpolars_reach);
+
+  return reach_serial;
+}
+
 void
 ProtectedRoutePlanner::AcceptInRange(const GeoBounds &bounds,
                                      FlatTriangleFanVisitor &visitor,
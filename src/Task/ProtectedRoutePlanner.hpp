@@ -7,6 +7,10 @@
 #include "Engine/Route/ReachFan.hpp"
 #include "Engine/Route/RoutePolars.hpp"
 #include "thread/Mutex.hxx"
+#include "util/Serial.hpp"
+
+#include <optional>
+#include <span>
 
 struct GlideSettings;
 struct RoutePlannerConfig;
@@ -37,6 +41,12 @@ class ProtectedRoutePlanner
   ReachFan reach_terrain;
   ReachFan reach_working;
 
+  /**
+   * Incremented whenever the "reach" fields change.  It can be used
+   * to invalidate cached FindPositiveArrival() results.
+   */
+  Serial reach_serial;
+
 public:
   ProtectedRoutePlanner(RoutePlannerGlue &route, const Airspaces &_airspaces,
                         const ProtectedAirspaceWarningManager *_warnings) noexcept
@@ -54,6 +64,13 @@ public:
     const std::scoped_lock lock{reach_mutex};
     reach_terrain.Reset();
     reach_working.Reset();
+    ++reach_serial;
+  }
+
+  [[gnu::pure]]
+  Serial GetReachSerial() const noexcept {
+    const std::scoped_lock lock{reach_mutex};
+    return reach_serial;
   }
 
   [[gnu::pure]]
@@ -83,6 +100,17 @@ public:
   [[gnu::pure]]
   std::optional<ReachResult> FindPositiveArrival(const AGeoPoint &dest) const noexcept;
 
+  /**
+   * Like FindPositiveArrival(), but look up several destinations
+   * while locking the reach only once.
+   *
+   * @param results receives one result for each destination
+   * @return the reach serial (see GetReachSerial()) these results
+   * belong to
+   */
+  Serial FindPositiveArrivals(std::span<const AGeoPoint> dests,
+                              std::span<std::optional<ReachResult>> results) const noexcept;
+
   void AcceptInRange(const GeoBounds &bounds,
                      FlatTriangleFanVisitor &visitor,
                      bool working) const noexcept;
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "RasterTileCache.hpp"
+#include "RasterLineWalker.hpp"
 #include "Terrain/RasterLocation.hpp"
 
 #include <stdlib.h>
@@ -36,15 +37,10 @@ RasterTileCache::FirstIntersection(const SignedRasterLocation origin,
 
   h_dest = std::max(h_dest, h_origin);
 
-  // line algorithm parameters
-  const int dx = abs(destination.x - origin.x);
-  const int dy = abs(destination.y - origin.y);
-  int err = dx-dy;
-  const int sx = origin.x < destination.x ? 1 : -1;
-  const int sy = origin.y < destination.y ? 1 : -1;
+  RasterLineWalker line(origin, destination);
 
   // max number of steps to walk
-  const int max_steps = (dx+dy);
+  const int max_steps = line.GetMaxSteps();
   // calculate number of fine steps to produce a step on the overview field
   const int step_fine = std::max(1, max_steps >> INTERSECT_BITS);
   // number of steps for update to the overview map
@@ -54,11 +50,6 @@ RasterTileCache::FirstIntersection(const SignedRasterLocation origin,
   // number of steps to be cleared after climbing over obstruction
   const int intersect_steps = 32;
 
-  // counter for steps to reach next position to be checked on the field.
-  unsigned step_counter = 0;
-  // total counter of fine steps
-  int total_steps = 0;
-
   // number of steps since intersection
   int intersect_counter = 0;
 
@@ -85,9 +76,9 @@ RasterTileCache::FirstIntersection(const SignedRasterLocation origin,
   int last_clear_h = h_origin;
 
   while (true) {
+    location = line.GetLocation();
 
-    if (!step_counter) {
-
+    {
       if (!IsInside(location))
         break; // outside bounds
 
@@ -96,10 +87,10 @@ RasterTileCache::FirstIntersection(const SignedRasterLocation origin,
         break;
 
       const int h_terrain = field_direct.first.GetValueOr0() + h_safety;
-      step_counter = field_direct.second ? step_fine : step_coarse;
+      const int step_counter = field_direct.second ? step_fine : step_coarse;
 
       // calculate height of glide so far
-      const int dh = (total_steps * slope_fact) >> RASTER_SLOPE_FACT;
+      const int dh = (line.GetTotalSteps() * slope_fact) >> RASTER_SLOPE_FACT;
 
       // current aircraft height
       int h_int = dh + h_origin;
@@ -159,29 +150,19 @@ RasterTileCache::FirstIntersection(const SignedRasterLocation origin,
           last_clear_h = h_int;
         }
       }
-    }
 
-    if (!intersect_counter && (total_steps == max_steps)) {
+      // skip to the next position to be checked
+      const int iteration = line.GetIteration();
+      line.Advance(step_counter);
+
+      // did we pass the destination on the way?
+      if (!intersect_counter && iteration <= line.GetEndIteration() &&
+          line.GetEndIteration() < line.GetIteration()) {
 #ifdef DEBUG_TILE
-      printf("# fint cleared\n");
+        printf("# fint cleared\n");
 #endif
-      return std::nullopt;
-    }
-
-    const int e2 = 2*err;
-    if (e2 > -dy) {
-      err -= dy;
-      location.x += sx;
-      if (step_counter)
-        step_counter--;
-      total_steps++;
-    }
-    if (e2 < dx) {
-      err += dx;
-      location.y += sy;
-      if (step_counter)
-        step_counter--;
-      total_steps++;
+        return std::nullopt;
+      }
     }
   }
 
@@ -234,15 +215,10 @@ RasterTileCache::GroundIntersection(const SignedRasterLocation origin,
     // origin is outside overall bounds
     return {-1, -1};
 
-  // line algorithm parameters
-  const int dx = abs(destination.x - origin.x);
-  const int dy = abs(destination.y - origin.y);
-  int err = dx-dy;
-  const int sx = origin.x < destination.x ? 1 : -1;
-  const int sy = origin.y < destination.y ? 1 : -1;
+  RasterLineWalker line(origin, destination);
 
   // max number of steps to walk
-  const int max_steps = (dx+dy);
+  const int max_steps = line.GetMaxSteps();
   // calculate number of fine steps to produce a step on the overview field
 
   // step size at selected refinement level
@@ -253,11 +229,6 @@ RasterTileCache::GroundIntersection(const SignedRasterLocation origin,
   // number of steps for update to the overview map
   const int step_coarse = std::max(1 << RasterTraits::OVERVIEW_BITS, step_fine);
 
-  // counter for steps to reach next position to be checked on the field.
-  unsigned step_counter = 0;
-  // total counter of fine steps
-  int total_steps = 0;
-
 #ifdef DEBUG_TILE
   printf("# max steps %d\n", max_steps);
   printf("# step coarse %d\n", step_coarse);
@@ -268,9 +239,9 @@ RasterTileCache::GroundIntersection(const SignedRasterLocation origin,
   int last_clear_h = h_origin;
 
   while (true) {
+    location = line.GetLocation();
 
-    if (!step_counter) {
-
+    {
       if (!IsInside(location))
         break;
 
@@ -279,10 +250,10 @@ RasterTileCache::GroundIntersection(const SignedRasterLocation origin,
         break;
 
       const int h_terrain = field_direct.first.GetValueOr0();
-      step_counter = field_direct.second ? step_fine : step_coarse;
+      const int step_counter = field_direct.second ? step_fine : step_coarse;
 
       // calculate height of glide so far
-      const int dh = (total_steps * slope_fact) >> RASTER_SLOPE_FACT;
+      const int dh = (line.GetTotalSteps() * slope_fact) >> RASTER_SLOPE_FACT;
 
       // current aircraft height
       const int h_int = h_origin - dh;
@@ -301,25 +272,15 @@ RasterTileCache::GroundIntersection(const SignedRasterLocation origin,
 
       last_clear_location = location;
       last_clear_h = h_int;
-    }
 
-    if (total_steps > max_steps)
-      break;
+      if (line.GetTotalSteps() > max_steps)
+        break;
 
-    const int e2 = 2*err;
-    if (e2 > -dy) {
-      err -= dy;
-      location.x += sx;
-      if (step_counter>0)
-        step_counter--;
-      total_steps++;
-    }
-    if (e2 < dx) {
-      err += dx;
-      location.y += sy;
-      if (step_counter>0)
-        step_counter--;
-      total_steps++;
+      // skip to the next position to be checked, unless the end of
+      // the line is passed on the way
+      line.Advance(step_counter);
+      if (line.GetTotalSteps(line.GetIteration() - 1) > max_steps)
+        break;
     }
   }
 
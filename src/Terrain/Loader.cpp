@@ -4,6 +4,7 @@
 #include "Loader.hpp"
 #include "RasterTileCache.hpp"
 #include "RasterProjection.hpp"
+#include "TileStore.hpp"
 #include "ZzipStream.hpp"
 #include "WorldFile.hpp"
 #include "Operation/Operation.hpp"
@@ -147,9 +148,14 @@ TerrainLoader::SetSize(unsigned _width, unsigned _height,
                        uint_least16_t _tile_width, uint_least16_t _tile_height,
                        unsigned tile_columns, unsigned tile_rows)
 {
-  if (scan_overview)
+  if (scan_overview) {
     raster_tile_cache.SetSize({_width, _height}, {_tile_width, _tile_height},
                               {tile_columns, tile_rows});
+
+    if (store_writer != nullptr)
+      store_writer->Start({_tile_width, _tile_height},
+                          {tile_columns, tile_rows});
+  }
 }
 
 void
@@ -157,9 +163,13 @@ TerrainLoader::PutTileData(unsigned index,
                            RasterLocation start, RasterLocation end,
                            const struct jas_matrix &m)
 {
-  if (scan_overview)
+  if (scan_overview) {
     raster_tile_cache.PutOverviewTile(index, start, end, m);
 
+    if (store_writer != nullptr)
+      store_writer->PutTile(index, m);
+  }
+
   if (scan_tiles) {
     const std::lock_guard lock{mutex};
     raster_tile_cache.PutTileData(index, m);
@@ -280,12 +290,14 @@ LoadTerrainOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
-                    OperationEnvironment &env)
+                    OperationEnvironment &env,
+                    TerrainTileStoreWriter *store_writer)
 {
   /* fake a mutex - we don't need it for LoadTerrainOverview() */
   SharedMutex mutex;
 
-  TerrainLoader loader(mutex, raster_tile_cache, true, all, env);
+  TerrainLoader loader(mutex, raster_tile_cache, true, all, env,
+                       store_writer);
   loader.LoadOverview(dir, path, world_file);
 }
 
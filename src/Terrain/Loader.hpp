@@ -12,6 +12,7 @@ struct zzip_dir;
 struct GeoPoint;
 class RasterTileCache;
 class RasterProjection;
+class TerrainTileStoreWriter;
 class OperationEnvironment;
 
 class TerrainLoader {
@@ -23,6 +24,12 @@ class TerrainLoader {
 
   OperationEnvironment &env;
 
+  /**
+   * If set, then all decoded tiles are passed to this object while
+   * scanning the overview.
+   */
+  TerrainTileStoreWriter *const store_writer;
+
   /**
    * The number of remaining segments after the current one.
    */
@@ -31,11 +38,12 @@ class TerrainLoader {
 public:
   TerrainLoader(SharedMutex &_mutex, RasterTileCache &_rtc,
                 bool _scan_overview, bool _scan_all,
-                OperationEnvironment &_env)
+                OperationEnvironment &_env,
+                TerrainTileStoreWriter *_store_writer=nullptr)
     :mutex(_mutex), raster_tile_cache(_rtc),
      scan_overview(_scan_overview),
      scan_tiles(!_scan_overview || _scan_all),
-     env(_env) {}
+     env(_env), store_writer(_store_writer) {}
 
   /**
    * Throws on error.
@@ -81,13 +89,16 @@ private:
  * @param all load not only overview, but all tiles?  On large files,
  * this is a very expensive operation.  This option was designed for
  * small RASP files only.
+ * @param store_writer if not nullptr, then all decoded tiles are
+ * written to this #TerrainTileStore
  */
 void
 LoadTerrainOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
-                    OperationEnvironment &env);
+                    OperationEnvironment &env,
+                    TerrainTileStoreWriter *store_writer=nullptr);
 
 static inline void
 LoadTerrainOverview(struct zzip_dir *dir,
@@ -14,6 +14,8 @@ RasterBuffer::Resize(RasterLocation _size) noexcept
   assert(_size.y > 0);
 
   data.GrowDiscard(_size.x, _size.y);
+  view = data.begin();
+  size = _size;
 }
 
 TerrainHeight
@@ -243,7 +245,7 @@ TerrainHeight
 RasterBuffer::GetMaximum() const noexcept
 {
   return IsDefined()
-    ? *std::max_element(data.begin(), data.end(),
+    ? *std::max_element(view, view + size.Area(),
                         [](TerrainHeight a, TerrainHeight b) {
                           return a.GetValue() < b.GetValue();
                         })
@@ -9,47 +9,96 @@
 #include "util/AllocatedGrid.hxx"
 #include "util/Compiler.h"
 
+#include <cassert>
+
+/**
+ * A rectangular grid of terrain heights.  The heights are either
+ * owned by this object (allocated on the heap) or they are a
+ * read-only view of memory owned by somebody else, e.g. a
+ * #TerrainTileStore mapping.
+ */
 class RasterBuffer {
   AllocatedGrid<TerrainHeight> data;
 
+  /**
+   * Pointer to the first height value; either points into #data or
+   * into external memory (see SetView()).
+   */
+  const TerrainHeight *view = nullptr;
+
+  RasterLocation size{0, 0};
+
 public:
   RasterBuffer() noexcept = default;
   RasterBuffer(unsigned _width, unsigned _height) noexcept
-    :data(_width, _height) {}
+    :data(_width, _height), view(data.begin()), size(_width, _height) {}
 
   RasterBuffer(const RasterBuffer &) = delete;
   RasterBuffer &operator=(const RasterBuffer &) = delete;
 
   bool IsDefined() const noexcept {
+    return view != nullptr;
+  }
+
+  /**
+   * Does this object own its data, i.e. is it not a view?
+   */
+  bool IsOwned() const noexcept {
     return data.IsDefined();
   }
 
   RasterLocation GetSize() const noexcept {
-    return {data.GetWidth(), data.GetHeight()};
+    return size;
   }
 
   RasterLocation GetFineSize() const noexcept {
     return GetSize() << RasterTraits::SUBPIXEL_BITS;
   }
 
+  /**
+   * Obtain a writable pointer to the data.  This is only allowed if
+   * the buffer owns its data (i.e. after Resize()).
+   */
   TerrainHeight *GetData() noexcept {
+    assert(IsOwned());
+
     return data.begin();
   }
 
   const TerrainHeight *GetData() const noexcept {
-    return data.begin();
+    return view;
   }
 
   const TerrainHeight *GetDataAt(RasterLocation p) const noexcept {
-    return data.GetPointerAt(p.x, p.y);
+    return view + p.y * size.x + p.x;
   }
 
   void Reset() noexcept {
     data.Reset();
+    view = nullptr;
+    size = {0, 0};
   }
 
   void Resize(RasterLocation _size) noexcept;
 
+  /**
+   * Let this buffer refer to external (read-only) memory instead of
+   * allocating a copy.  The caller is responsible for keeping the
+   * memory valid until Reset() is called.
+   *
+   * @param _view pointer to the first row; rows are stored without
+   * padding, i.e. the pitch equals the width
+   */
+  void SetView(const TerrainHeight *_view, RasterLocation _size) noexcept {
+    assert(_view != nullptr);
+    assert(_size.x > 0);
+    assert(_size.y > 0);
+
+    data.Reset();
+    view = _view;
+    size = _size;
+  }
+
   [[gnu::pure]]
   TerrainHeight GetInterpolated(unsigned lx, unsigned ly,
                                 unsigned ix, unsigned iy) const noexcept;
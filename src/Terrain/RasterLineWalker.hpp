@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "RasterLocation.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * Walks along the pixels of a straight line in the same order as the
+ * classic Bresenham loop:
+ *
+ *   e2 = 2 * err;
+ *   if (e2 > -dy) { err -= dy; x += sx; }
+ *   if (e2 < dx) { err += dx; y += sy; }
+ *
+ * Each iteration of that loop moves along the major axis, and
+ * sometimes along the minor axis.  A "step" is a move along one
+ * axis; a diagonal iteration counts as two steps.  The line continues
+ * beyond the destination.
+ *
+ * The number of minor axis moves after a given number of iterations
+ * has a closed form, which allows skipping many pixels in constant
+ * time (see Advance()); the terrain intersection code samples only
+ * every n-th step.
+ */
+class RasterLineWalker {
+  SignedRasterLocation origin;
+
+  /**
+   * The absolute distance along the major and the minor axis.
+   */
+  int d_major, d_minor;
+
+  int sx, sy;
+
+  bool x_major;
+
+  /**
+   * The number of loop iterations so far.
+   */
+  int iteration = 0;
+
+public:
+  RasterLineWalker(SignedRasterLocation _origin,
+                   SignedRasterLocation destination) noexcept
+    :origin(_origin),
+     sx(origin.x < destination.x ? 1 : -1),
+     sy(origin.y < destination.y ? 1 : -1)
+  {
+    const int dx = std::abs(destination.x - origin.x);
+    const int dy = std::abs(destination.y - origin.y);
+    x_major = dx >= dy;
+    d_major = x_major ? dx : dy;
+    d_minor = x_major ? dy : dx;
+  }
+
+  /**
+   * The number of steps from the origin to the destination.
+   */
+  int GetMaxSteps() const noexcept {
+    return d_major + d_minor;
+  }
+
+  /**
+   * The iteration which reaches the destination.
+   */
+  int GetEndIteration() const noexcept {
+    return d_major;
+  }
+
+  int GetIteration() const noexcept {
+    return iteration;
+  }
+
+  /**
+   * The number of steps made after the given number of iterations.
+   */
+  [[gnu::pure]]
+  int GetTotalSteps(int i) const noexcept {
+    return i + MinorMoves(i);
+  }
+
+  int GetTotalSteps() const noexcept {
+    return GetTotalSteps(iteration);
+  }
+
+  [[gnu::pure]]
+  SignedRasterLocation GetLocation() const noexcept {
+    if (d_major == 0)
+      return origin;
+
+    const int minor = MinorMoves(iteration);
+    return x_major
+      ? SignedRasterLocation(origin.x + sx * iteration, origin.y + sy * minor)
+      : SignedRasterLocation(origin.x + sx * minor, origin.y + sy * iteration);
+  }
+
+  /**
+   * Perform loop iterations until at least the given number of steps
+   * has been made.  This is equivalent to decrementing a (saturating)
+   * counter for each step and stopping at the first iteration where
+   * it has reached zero.
+   *
+   * On a zero-length line, this only increments the iteration
+   * counter, so callers checking GetTotalSteps() against
+   * GetMaxSteps() terminate.
+   */
+  void Advance(unsigned n) noexcept {
+    if (d_major == 0) {
+      ++iteration;
+      return;
+    }
+
+    const int64_t target = int64_t(GetTotalSteps()) + n;
+
+    /* estimate the iteration from the slope, then correct rounding
+       errors */
+    int i = iteration + int(int64_t(n) * d_major / (d_major + d_minor));
+    if (i <= iteration)
+      i = iteration + 1;
+
+    while (GetTotalSteps(i) < target)
+      ++i;
+
+    while (i - 1 > iteration && GetTotalSteps(i - 1) >= target)
+      --i;
+
+    iteration = i;
+  }
+
+private:
+  /**
+   * The number of minor axis moves after the given number of
+   * iterations, i.e. the number of k>=0 with
+   * (2k+1)*d_major < 2*i*d_minor.
+   */
+  [[gnu::pure]]
+  int MinorMoves(int i) const noexcept {
+    const int64_t a = 2 * int64_t(i) * d_minor - d_major;
+    if (a <= 0)
+      return 0;
+
+    const int64_t b = 2 * int64_t(d_major);
+    return int((a + b - 1) / b);
+  }
+};
@@ -141,13 +141,12 @@ RasterMap::FirstIntersection(const GeoPoint &origin, const int h_origin,
   return {projection.UnprojectCoarse(intersection->location), intersection->height};
 }
 
-GeoPoint
-RasterMap::GroundIntersection(const GeoPoint &origin,
+inline GeoPoint
+RasterMap::GroundIntersection(const SignedRasterLocation c_origin,
                               const int h_origin, const int h_glide,
                               const GeoPoint &destination,
                               const int height_floor) const noexcept
 {
-  const auto c_origin = projection.ProjectCoarseRound(origin);
   const auto c_destination = projection.ProjectCoarseRound(destination);
   const int c_diff = ManhattanDistance(c_origin, c_destination);
   if (c_diff == 0)
@@ -163,3 +162,29 @@ RasterMap::GroundIntersection(const GeoPoint &origin,
 
   return projection.UnprojectCoarse(c_int);
 }
+
+GeoPoint
+RasterMap::GroundIntersection(const GeoPoint &origin,
+                              const int h_origin, const int h_glide,
+                              const GeoPoint &destination,
+                              const int height_floor) const noexcept
+{
+  return GroundIntersection(projection.ProjectCoarseRound(origin),
+                            h_origin, h_glide, destination, height_floor);
+}
+
+void
+RasterMap::GroundIntersections(const GeoPoint &origin,
+                               const int h_origin, const int h_glide,
+                               std::span<const GeoPoint> destinations,
+                               const int height_floor,
+                               std::span<GeoPoint> results) const noexcept
+{
+  assert(results.size() >= destinations.size());
+
+  const auto c_origin = projection.ProjectCoarseRound(origin);
+
+  for (std::size_t i = 0; i < destinations.size(); ++i)
+    results[i] = GroundIntersection(c_origin, h_origin, h_glide,
+                                    destinations[i], height_floor);
+}
@@ -7,6 +7,8 @@
 #include "RasterTileCache.hpp"
 #include "Geo/GeoPoint.hpp"
 
+#include <span>
+
 class OperationEnvironment;
 
 class RasterMap {
@@ -141,4 +143,27 @@ public:
                               int h_origin, int h_glide,
                               const GeoPoint &destination,
                               const int height_floor) const noexcept;
+
+  /**
+   * Like GroundIntersection(), but for a fan of rays sharing one
+   * origin, e.g. the reach polygon.  The origin is projected only
+   * once, and the rays are walked in the given order; if the
+   * destinations are sorted by direction, consecutive rays sample
+   * mostly the same tiles, which are then still in the CPU cache.
+   *
+   * @param results receives one result per destination; this
+   * must be at least as large as #destinations
+   */
+  void GroundIntersections(const GeoPoint &origin,
+                           int h_origin, int h_glide,
+                           std::span<const GeoPoint> destinations,
+                           int height_floor,
+                           std::span<GeoPoint> results) const noexcept;
+
+private:
+  [[gnu::pure]]
+  GeoPoint GroundIntersection(SignedRasterLocation c_origin,
+                              int h_origin, int h_glide,
+                              const GeoPoint &destination,
+                              int height_floor) const noexcept;
 };
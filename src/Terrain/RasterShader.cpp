@@ -0,0 +1,583 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Terrain/RasterShader.hpp"
+#include "Math/Angle.hpp"
+#include "ui/canvas/Ramp.hpp"
+#include "ui/canvas/RawBitmap.hpp"
+#include "ui/dim/Rect.hpp"
+#include "thread/StandbyThread.hpp"
+
+#include <algorithm> // for std::clamp()
+#include <cassert>
+#include <cmath> // for sqrt()
+#include <thread> // for std::thread::hardware_concurrency()
+
+/**
+ * Interpolate between x and y with i/128, i.e. i/(1 << 7).
+ *
+ * i must be below or equal to 128.
+ */
+static constexpr unsigned
+MIX(unsigned x, unsigned y, unsigned i) noexcept
+{
+  return (x * i + y * ((1 << 7) - i)) >> 7;
+}
+
+/**
+ * Shade the given color according to the illumination value.
+ *
+ * illum = 64: Contour, mixed with 50% brown
+ * illum < 0:  Shadow, mixed with up to 50% dark blue
+ * illum > 0:  Highlight, mixed with up to 25% yellow
+ * illum = 0:  No shading
+ */
+static constexpr RawColor
+TerrainShading(const int illum, RGB8Color color) noexcept
+{
+  if (illum == -64) {
+    // brown color mixed in for contours
+    return RawColor(MIX(100, color.Red(), 64),
+                    MIX(70, color.Green(), 64),
+                    MIX(26, color.Blue(), 64));
+  } else if (illum < 0) {
+    // shadow to blue
+    int x = std::min(63, -illum);
+    return RawColor(MIX(0, color.Red(), x),
+                    MIX(0, color.Green(), x),
+                    MIX(64, color.Blue(), x));
+  } else if (illum > 0) {
+    // highlight to yellow
+    int x = std::min(32, illum / 2);
+    return RawColor(MIX(255, color.Red(), x),
+                    MIX(255, color.Green(), x),
+                    MIX(16, color.Blue(), x));
+  } else
+    return RawColor(color.Red(), color.Green(), color.Blue());
+}
+
+static constexpr unsigned
+ContourInterval(unsigned h, unsigned contour_height_scale) noexcept
+{
+  return std::min(254u, h >> contour_height_scale);
+}
+
+[[gnu::const]]
+static unsigned
+ContourInterval(const TerrainHeight h, const unsigned contour_height_scale)
+{
+  if (h.IsSpecial()) [[unlikely]]
+    return 0;
+
+  if (h.GetValue() <= 0)
+    return 0;
+
+  return ContourInterval(h.GetValue(), contour_height_scale);
+}
+
+RasterShader::RasterShader(unsigned _max_bands) noexcept
+  :max_bands(std::clamp(_max_bands > 0
+                        ? _max_bands
+                        : std::thread::hardware_concurrency(),
+                        1u, MAX_BANDS)) {}
+
+RasterShader::~RasterShader() noexcept
+{
+  delete[] color_table;
+  delete[] contour_column_base;
+}
+
+struct RasterShader::ShadingParameters {
+  unsigned height_scale;
+  unsigned contour_height_scale;
+
+  bool do_shading;
+
+  /* the following are only used with slope shading */
+  int contrast;
+  int sx, sy, sz;
+  unsigned height_slope_factor;
+};
+
+/**
+ * A thread which generates one band of the image.
+ */
+class RasterShader::ShadingThread final : StandbyThread {
+  const RasterShader &shader;
+
+  const ShadingParameters *parameters;
+  unsigned y_begin, y_end;
+  unsigned char *contour_columns;
+
+public:
+  explicit ShadingThread(const RasterShader &_shader) noexcept
+    :StandbyThread("RasterShader"), shader(_shader) {}
+
+  ~ShadingThread() noexcept {
+    LockStop();
+  }
+
+  /**
+   * Throws on error.
+   */
+  void Start(const ShadingParameters &_parameters,
+             unsigned _y_begin, unsigned _y_end,
+             unsigned char *_contour_columns) {
+    const std::lock_guard lock{mutex};
+    parameters = &_parameters;
+    y_begin = _y_begin;
+    y_end = _y_end;
+    contour_columns = _contour_columns;
+    Trigger();
+  }
+
+  using StandbyThread::LockWaitDone;
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() noexcept override {
+    const ScopeUnlock unlock(mutex);
+    shader.GenerateRows(*parameters, y_begin, y_end, contour_columns);
+  }
+};
+
+/**
+ * How many bands shall the image with the given number of rows be
+ * split into?
+ */
+static constexpr unsigned
+GetBandCount(unsigned height, unsigned max_bands) noexcept
+{
+  /* bands smaller than this are not worth the thread overhead */
+  constexpr unsigned MIN_BAND_HEIGHT = 64;
+
+  return std::clamp(height / MIN_BAND_HEIGHT, 1u, max_bands);
+}
+
+void
+RasterShader::Generate(const TerrainHeight *_heights, UnsignedPoint2D _size,
+                       unsigned _quantisation_effective, double pixel_size,
+                       RawColor *_top_row, std::ptrdiff_t _pitch,
+                       bool do_shading,
+                       unsigned height_scale,
+                       int contrast, int brightness,
+                       const Angle sunazimuth,
+                       bool do_contour) noexcept
+{
+  assert(color_table != nullptr);
+
+  heights = _heights;
+  size = _size;
+  quantisation_effective = _quantisation_effective;
+  top_row = _top_row;
+  pitch = _pitch;
+
+  if (size.x > contour_column_width) {
+    delete[] contour_column_base;
+    contour_column_base = new unsigned char[size.x * MAX_BANDS];
+    contour_column_width = size.x;
+  }
+
+  if (quantisation_effective == 0) {
+    do_shading = false;
+    do_contour = false;
+  }
+
+  ShadingParameters parameters;
+  parameters.height_scale = height_scale;
+  parameters.contour_height_scale = do_contour? height_scale * 2 : 16;
+  parameters.do_shading = do_shading;
+
+  if (do_shading) {
+    const Angle fudgeelevation = Angle::Degrees(10) +
+      Angle::Degrees(80.0 / 255.0) * brightness;
+
+    parameters.contrast = contrast;
+    parameters.sx = (int)(255 * fudgeelevation.fastcosine() * -sunazimuth.fastsine());
+    parameters.sy = (int)(255 * fudgeelevation.fastcosine() * -sunazimuth.fastcosine());
+    parameters.sz = (int)(255 * fudgeelevation.fastsine());
+
+    parameters.height_slope_factor =
+      std::clamp((unsigned)pixel_size, 1u,
+                 /* this upper limit avoids integer overflows in the
+                    "mag" formula; it effectively limits "dd2" so
+                    calculating its square will not overflow */
+                 8192u / (quantisation_effective * quantisation_effective));
+  }
+
+  ContourStart(parameters.contour_height_scale);
+
+  /* split the image into horizontal bands; the contour state at the
+     start of each band is calculated in advance, so the bands can be
+     generated independently and the result is exactly the same as
+     generating all rows in one pass */
+
+  const unsigned width = size.x;
+  const unsigned height = size.y;
+  const unsigned n_bands = GetBandCount(height, max_bands);
+
+  std::array<unsigned, MAX_BANDS + 1> bands;
+  for (unsigned i = 0; i <= n_bands; ++i)
+    bands[i] = height * i / n_bands;
+
+  for (unsigned i = 1; i < n_bands; ++i)
+    ContourSeed(parameters, bands[i - 1], bands[i],
+                contour_column_base + (i - 1) * width,
+                contour_column_base + i * width);
+
+  std::array<bool, MAX_BANDS> started{};
+
+  for (unsigned i = 1; i < n_bands; ++i) {
+    auto &thread = threads[i - 1];
+
+    try {
+      if (!thread)
+        thread = std::make_unique<ShadingThread>(*this);
+
+      thread->Start(parameters, bands[i], bands[i + 1],
+                    contour_column_base + i * width);
+      started[i] = true;
+    } catch (...) {
+      /* fall back to generating this band in the calling thread */
+    }
+  }
+
+  GenerateRows(parameters, bands[0], bands[1], contour_column_base);
+
+  for (unsigned i = 1; i < n_bands; ++i) {
+    if (started[i])
+      threads[i - 1]->LockWaitDone();
+    else
+      GenerateRows(parameters, bands[i], bands[i + 1],
+                   contour_column_base + i * width);
+  }
+}
+
+void
+RasterShader::GenerateRows(const ShadingParameters &parameters,
+                           unsigned y_begin, unsigned y_end,
+                           unsigned char *contour_columns) const noexcept
+{
+  if (parameters.do_shading)
+    GenerateSlopeRows(parameters, y_begin, y_end, contour_columns);
+  else
+    GenerateUnshadedRows(parameters, y_begin, y_end, contour_columns);
+}
+
+void
+RasterShader::GenerateUnshadedRows(const ShadingParameters &parameters,
+                                   unsigned y_begin, unsigned y_end,
+                                   unsigned char *contour_columns) const noexcept
+{
+  const unsigned height_scale = parameters.height_scale;
+  const unsigned contour_height_scale = parameters.contour_height_scale;
+
+  const auto *src = GetRow(y_begin);
+  const RawColor *oColorBuf = color_table + 64 * 256;
+  RawColor *dest = top_row + (std::ptrdiff_t)y_begin * pitch;
+
+  for (unsigned y = y_end - y_begin; y > 0; --y) {
+    RawColor *p = dest;
+    dest = dest + pitch;
+
+    unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
+    unsigned char *contour_this_column_base = contour_columns;
+
+    for (unsigned x = size.x; x > 0; --x) {
+      const auto e = *src++;
+      if (!e.IsSpecial()) [[likely]] {
+        unsigned h = std::max(0, (int)e.GetValue());
+
+        const unsigned contour_interval =
+          ContourInterval(h, contour_height_scale);
+
+        h = std::min(254u, h >> height_scale);
+        if (contour_interval != contour_row_base ||
+            contour_interval != *contour_this_column_base) [[unlikely]] {
+          *p++ = oColorBuf[(int)h - 64 * 256];
+          *contour_this_column_base = contour_row_base = contour_interval;
+        } else {
+          *p++ = oColorBuf[h];
+        }
+      } else if (e.IsWater()) {
+        // we're in the water, so look up the color for water
+        *p++ = oColorBuf[255];
+      } else {
+        /* outside the terrain file bounds: white background */
+        *p++ = RawColor(0xff, 0xff, 0xff);
+      }
+      contour_this_column_base++;
+
+    }
+  }
+}
+
+/**
+ * Clip the difference between two adjacent terrain height values to
+ * sane bounds.  This works around integer overflows in the
+ * GenerateSlopeRows() formula when the map file is broken, avoiding
+ * the sqrt() call with a negative argument.
+ */
+static constexpr int
+ClipHeightDelta(int d) noexcept
+{
+  return std::clamp(d, -512, 512);
+}
+
+static constexpr int
+ClipHeightDelta(TerrainHeight a, TerrainHeight b) noexcept
+{
+  return ClipHeightDelta(a.GetValue() - b.GetValue());
+}
+
+/**
+ * The distance to the neighbour used for the slope calculation in
+ * negative direction, clipped at the edge of the height matrix.
+ */
+static constexpr unsigned
+SlopeMinusIndex(unsigned i, unsigned quantisation_effective) noexcept
+{
+  return i >= quantisation_effective ? quantisation_effective : i;
+}
+
+/**
+ * The distance to the neighbour used for the slope calculation in
+ * positive direction, clipped at the edge of the height matrix.
+ *
+ * @param border the end of the unclipped area
+ */
+static constexpr unsigned
+SlopePlusIndex(unsigned i, unsigned size, int border,
+               unsigned quantisation_effective) noexcept
+{
+  return i < (unsigned)border ? quantisation_effective : size - 1 - i;
+}
+
+// JMW: if zoomed right in (e.g. one unit is larger than terrain
+// grid), then increase the step size to be equal to the terrain
+// grid for purposes of calculating slope, to avoid shading problems
+// (gridding of display) This is why quantisation_effective is used instead of 1
+// previously.  for large zoom levels, quantisation_effective=1
+void
+RasterShader::GenerateSlopeRows(const ShadingParameters &parameters,
+                                unsigned y_begin, unsigned y_end,
+                                unsigned char *contour_columns) const noexcept
+{
+  assert(quantisation_effective > 0);
+
+  const unsigned height_scale = parameters.height_scale;
+  const unsigned contour_height_scale = parameters.contour_height_scale;
+  const int contrast = parameters.contrast;
+  const int sx = parameters.sx, sy = parameters.sy, sz = parameters.sz;
+  const unsigned height_slope_factor = parameters.height_slope_factor;
+
+  const auto border = PixelRect{PixelSize{size}}
+    .WithPadding(quantisation_effective);
+
+  const auto *src = GetRow(y_begin);
+  const RawColor *oColorBuf = color_table + 64 * 256;
+
+  RawColor *dest = top_row + (std::ptrdiff_t)y_begin * pitch;
+
+  for (unsigned y = y_begin; y < y_end; ++y) {
+    const unsigned row_plus_index =
+      SlopePlusIndex(y, size.y, border.bottom,
+                     quantisation_effective);
+    const unsigned row_plus_offset = size.x * row_plus_index;
+
+    const unsigned row_minus_index =
+      SlopeMinusIndex(y, quantisation_effective);
+    const unsigned row_minus_offset = size.x * row_minus_index;
+
+    const unsigned p31 = row_plus_index + row_minus_index;
+
+    RawColor *p = dest;
+    dest = dest + pitch;
+
+    unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
+    unsigned char *contour_this_column_base = contour_columns;
+
+    for (unsigned x = 0; x < size.x; ++x, ++src) {
+      const auto e = *src;
+      if (!e.IsSpecial()) [[likely]] {
+        unsigned h = std::max(0, (int)e.GetValue());
+
+        const unsigned contour_interval =
+          ContourInterval(h, contour_height_scale);
+
+        h = std::min(254u, h >> height_scale);
+
+        // no need to calculate slope if undefined height or sea level
+
+        // Y direction
+        assert(src - row_minus_offset >= heights);
+        assert(src + row_plus_offset >= heights);
+        assert(src - row_minus_offset < GetRow(size.y));
+        assert(src + row_plus_offset < GetRow(size.y));
+
+        // X direction
+
+        const unsigned column_plus_index =
+          SlopePlusIndex(x, size.x, border.right,
+                         quantisation_effective);
+        const unsigned column_minus_index =
+          SlopeMinusIndex(x, quantisation_effective);
+
+        assert(src - column_minus_index >= heights);
+        assert(src + column_plus_index >= heights);
+        assert(src - column_minus_index < GetRow(size.y));
+        assert(src + column_plus_index < GetRow(size.y));
+
+        const auto h_above = src[-(int)row_minus_offset];
+        const auto h_below = src[row_plus_offset];
+        const auto h_left = src[-(int)column_minus_index];
+        const auto h_right = src[column_plus_index];
+
+        if (h_above.IsSpecial() || h_below.IsSpecial() ||
+            h_left.IsSpecial() || h_right.IsSpecial()) [[unlikely]] {
+          /* some "special" terrain value surrounding us (water or
+             invalid), skip slope calculation */
+          *p++ = oColorBuf[h];
+          contour_this_column_base++;
+          continue;
+        }
+
+        if (contour_interval != contour_row_base ||
+            contour_interval != *contour_this_column_base) [[unlikely]] {
+
+          *contour_this_column_base++ = contour_row_base = contour_interval;
+          *p++ = oColorBuf[int(h) - 64 * 256];
+          continue;
+        }
+
+        const int p32 = ClipHeightDelta(h_above, h_below);
+        const int p22 = ClipHeightDelta(h_right, h_left);
+
+        const unsigned p20 = column_plus_index + column_minus_index;
+
+        const int dd0 = p22 * int(p31);
+        const int dd1 = int(p20) * p32;
+        const unsigned dd2 = p20 * p31 * height_slope_factor;
+        const int num = (int(dd2) * sz + dd0 * sx + dd1 * sy);
+        const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
+        const unsigned mag = (unsigned)sqrt(square_mag);
+        /* this is a workaround for a SIGFPE (division by zero)
+           observed by our users on some Android devices (e.g. Nexus
+           7), even though we did our best to make sure that the
+           integer arithmetics above can't overflow */
+        /* TODO: debug this problem and replace this workaround */
+        const int sval = num / int(mag|1);
+        const int sindex = (sval - sz) * contrast / 128;
+        *p++ = oColorBuf[int(h) + 256 * std::clamp(sindex, -63, 63)];
+      } else if (e.IsWater()) {
+        // we're in the water, so look up the color for water
+        *p++ = oColorBuf[255];
+      } else {
+        /* outside the terrain file bounds: white background */
+        *p++ = RawColor(0xff, 0xff, 0xff);
+      }
+      contour_this_column_base++;
+
+    }
+  }
+}
+
+void
+RasterShader::PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
+                                unsigned height_scale, int interp_levels) noexcept
+{
+  if (color_table == nullptr)
+    color_table = new RawColor[256 * 128];
+
+  for (int i = 0; i < 256; i++) {
+    for (int mag = -64; mag < 64; mag++) {
+      RawColor color;
+
+      if (i == 255) {
+        if (do_water) {
+          // water colours
+          color = RawColor(85, 160, 255);
+        } else {
+          color = RawColor(255, 255, 255);
+
+          // ColorRampLookup(0, r, g, b,
+          // Color_ramp, NUM_COLOR_RAMP_LEVELS, interp_levels);
+        }
+      } else {
+        const RGB8Color color2 =
+          ColorRampLookup(i << height_scale, color_ramp,
+                          NUM_COLOR_RAMP_LEVELS, interp_levels);
+
+        color = TerrainShading(mag, color2);
+      }
+
+      color_table[i + (mag + 64) * 256] = color;
+    }
+  }
+}
+
+void
+RasterShader::ContourStart(const unsigned contour_height_scale) noexcept
+{
+  // initialise column to first row
+  const auto *src = heights;
+  unsigned char *col_base = contour_column_base;
+  for (unsigned x = size.x; x > 0; --x)
+    *col_base++ = ContourInterval(*src++, contour_height_scale);
+}
+
+void
+RasterShader::ContourSeed(const ShadingParameters &parameters,
+                          unsigned y_previous, unsigned y_begin,
+                          const unsigned char *previous,
+                          unsigned char *contour_columns) const noexcept
+{
+  /* each pixel which is not skipped by GenerateRows() leaves its
+     contour interval in the column state (it was either equal
+     already, or a contour line was drawn), so the state at the start
+     of a band is the interval of the last such pixel in each column,
+     or the state at the start of the previous band if there is
+     none */
+
+  const unsigned width = size.x;
+  const unsigned height = size.y;
+  const auto border = PixelRect{PixelSize{size}}
+    .WithPadding(quantisation_effective);
+
+  for (unsigned x = 0; x < width; ++x) {
+    unsigned char value = previous[x];
+
+    for (unsigned y = y_begin; y > y_previous;) {
+      --y;
+
+      const auto *src = heights + y * width + x;
+      const auto e = *src;
+      if (e.IsSpecial())
+        continue;
+
+      if (parameters.do_shading) {
+        const unsigned row_plus_offset = width *
+          SlopePlusIndex(y, height, border.bottom, quantisation_effective);
+        const unsigned row_minus_offset = width *
+          SlopeMinusIndex(y, quantisation_effective);
+        const unsigned column_plus_index =
+          SlopePlusIndex(x, width, border.right, quantisation_effective);
+        const unsigned column_minus_index =
+          SlopeMinusIndex(x, quantisation_effective);
+
+        if (src[-(int)row_minus_offset].IsSpecial() ||
+            src[row_plus_offset].IsSpecial() ||
+            src[-(int)column_minus_index].IsSpecial() ||
+            src[column_plus_index].IsSpecial())
+          continue;
+      }
+
+      value = ContourInterval(std::max(0, (int)e.GetValue()),
+                              parameters.contour_height_scale);
+      break;
+    }
+
+    contour_columns[x] = value;
+  }
+}
+
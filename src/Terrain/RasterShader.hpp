@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Terrain/Height.hpp"
+#include "Math/Point2D.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+static constexpr unsigned NUM_COLOR_RAMP_LEVELS = 13;
+
+class Angle;
+struct RawColor;
+struct ColorRamp;
+
+/**
+ * Converts a matrix of terrain heights into an image, with optional
+ * slope shading and contour lines.  This class does not know about
+ * the map or the screen; see #RasterRenderer.
+ */
+class RasterShader {
+public:
+  /**
+   * The image is generated in up to this many horizontal bands, each
+   * in its own thread.
+   */
+  static constexpr unsigned MAX_BANDS = 4;
+
+private:
+  class ShadingThread;
+  struct ShadingParameters;
+
+  /**
+   * The maximum number of bands.
+   */
+  const unsigned max_bands;
+
+  RawColor *color_table = nullptr;
+
+  /**
+   * The contour state of each column, one array per band.
+   */
+  unsigned char *contour_column_base = nullptr;
+
+  /**
+   * The number of columns #contour_column_base was allocated for.
+   */
+  unsigned contour_column_width = 0;
+
+  /**
+   * Helper threads which generate all bands but the first one;
+   * created on demand by Generate().
+   */
+  std::array<std::unique_ptr<ShadingThread>, MAX_BANDS - 1> threads;
+
+  /* the following attributes are set by Generate() */
+
+  const TerrainHeight *heights;
+  UnsignedPoint2D size;
+
+  /**
+   * Step size used for slope calculations.  Slope shading is disabled
+   * when this attribute is 0.
+   */
+  unsigned quantisation_effective;
+
+  RawColor *top_row;
+
+  /**
+   * The distance between two image rows (negative if the bottom-most
+   * row comes first).
+   */
+  std::ptrdiff_t pitch;
+
+public:
+  /**
+   * @param _max_bands the maximum number of bands; 0 means one per
+   * CPU
+   */
+  explicit RasterShader(unsigned _max_bands=0) noexcept;
+  ~RasterShader() noexcept;
+
+  RasterShader(const RasterShader &) = delete;
+  RasterShader &operator=(const RasterShader &) = delete;
+
+  /**
+   * Fills the color_table array with precomputed colors for 256 height and
+   * 64 illumination levels. This is used to speed up the rendering by
+   * preventing the same color calculations over and over again.
+   */
+  void PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
+                         unsigned height_scale, int interp_levels) noexcept;
+
+  /**
+   * Convert the height matrix into the image.  PrepareColorTable()
+   * must have been called before.
+   *
+   * @param _heights the height matrix, row by row
+   * @param _quantisation_effective the step size used for slope
+   * calculations; 0 disables slope shading and contour lines
+   * @param pixel_size the edge length of one pixel in meters
+   * @param _top_row the top-most row of the image
+   * @param _pitch the distance between two image rows
+   */
+  void Generate(const TerrainHeight *_heights, UnsignedPoint2D _size,
+                unsigned _quantisation_effective, double pixel_size,
+                RawColor *_top_row, std::ptrdiff_t _pitch,
+                bool do_shading,
+                unsigned height_scale, int contrast, int brightness,
+                const Angle sunazimuth,
+                bool do_contour) noexcept;
+
+private:
+  const TerrainHeight *GetRow(unsigned y) const noexcept {
+    return heights + y * size.x;
+  }
+
+  /**
+   * Convert the given rows of the height matrix into the image.
+   *
+   * @param contour_columns the contour state of each column after
+   * the row above #y_begin; it is updated
+   */
+  void GenerateRows(const ShadingParameters &parameters,
+                    unsigned y_begin, unsigned y_end,
+                    unsigned char *contour_columns) const noexcept;
+
+  /**
+   * Convert the given rows of the height matrix into the image,
+   * without shading.
+   */
+  void GenerateUnshadedRows(const ShadingParameters &parameters,
+                            unsigned y_begin, unsigned y_end,
+                            unsigned char *contour_columns) const noexcept;
+
+  /**
+   * Convert the given rows of the height matrix into the image, with
+   * slope shading.
+   */
+  void GenerateSlopeRows(const ShadingParameters &parameters,
+                         unsigned y_begin, unsigned y_end,
+                         unsigned char *contour_columns) const noexcept;
+
+  void ContourStart(unsigned contour_height_scale) noexcept;
+
+  /**
+   * Calculate the contour state at the start of a band from the
+   * state at the start of the previous band, without generating the
+   * rows in between.
+   */
+  void ContourSeed(const ShadingParameters &parameters,
+                   unsigned y_previous, unsigned y_begin,
+                   const unsigned char *previous,
+                   unsigned char *contour_columns) const noexcept;
+};
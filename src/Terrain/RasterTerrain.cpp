@@ -3,10 +3,12 @@
 
 #include "RasterTerrain.hpp"
 #include "Loader.hpp"
+#include "TileStore.hpp"
 #include "Profile/Profile.hpp"
 #include "io/ZipArchive.hpp"
 #include "io/FileCache.hpp"
 #include "io/FileOutputStream.hxx"
+#include "io/FileMapping.hpp"
 #include "io/BufferedOutputStream.hxx"
 #include "io/Reader.hxx"
 #include "io/BufferedReader.hxx"
@@ -15,7 +17,10 @@
 #include "util/ConvertString.hpp"
 #include "LogFile.hpp"
 
+#include <optional>
+
 static const TCHAR *const terrain_cache_name = _T("terrain");
+static const TCHAR *const terrain_tiles_cache_name = _T("terrain-tiles");
 
 inline bool
 RasterTerrain::LoadCache(FileCache &cache, Path path)
@@ -45,18 +50,52 @@ RasterTerrain::SaveCache(FileCache &cache, Path path) const
   os->Commit();
 }
 
+inline void
+RasterTerrain::LoadTileStore(FileCache &cache, Path path)
+{
+  auto mapping = cache.Map(terrain_tiles_cache_name, path);
+  if (!mapping)
+    return;
+
+  auto &tile_cache = map.GetTileCache();
+  tile_cache.SetTileStore(std::make_unique<TerrainTileStore>(std::move(mapping),
+                                                             tile_cache.GetTileSize(),
+                                                             tile_cache.GetTileCount()));
+}
+
 inline void
 RasterTerrain::Load(Path path, FileCache *cache,
                     OperationEnvironment &operation)
 {
   try {
-    if (LoadCache(cache, path))
+    if (LoadCache(cache, path)) {
+      try {
+        LoadTileStore(*cache, path);
+      } catch (...) {
+        LogError(std::current_exception(), "Failed to load terrain tile store");
+      }
+
       return;
+    }
   } catch (...) {
     LogError(std::current_exception(), "Failed to load terrain cache");
   }
 
-  LoadTerrainOverview(archive.get(), map.GetTileCache(), operation);
+  /* while scanning the overview, the JPEG2000 decoder sees all
+     tiles; write them to the tile store so we never need to decode
+     them again */
+  std::optional<TerrainTileStoreWriter> store_writer;
+  if (cache != nullptr) {
+    try {
+      store_writer.emplace(cache->Save(terrain_tiles_cache_name, path));
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to create terrain tile store");
+    }
+  }
+
+  LoadTerrainOverview(archive.get(), "terrain.jp2", "terrain.j2w",
+                      map.GetTileCache(), false, operation,
+                      store_writer ? &*store_writer : nullptr);
 
   map.UpdateProjection();
 
@@ -66,6 +105,16 @@ RasterTerrain::Load(Path path, FileCache *cache,
     } catch (...) {
       LogError(std::current_exception(), "Failed to save terrain cache");
     }
+
+    if (store_writer) {
+      try {
+        store_writer->Commit();
+        store_writer.reset();
+        LoadTileStore(*cache, path);
+      } catch (...) {
+        LogError(std::current_exception(), "Failed to save terrain tile store");
+      }
+    }
   }
 }
 
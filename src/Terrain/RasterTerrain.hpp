@@ -84,6 +84,14 @@ private:
    */
   void SaveCache(FileCache &cache, Path path) const;
 
+  /**
+   * Map the #TerrainTileStore from the cache (if one exists).  Must
+   * be called after the overview has been loaded.
+   *
+   * Throws on error.
+   */
+  void LoadTileStore(FileCache &cache, Path path);
+
   /**
    * Throws on error.
    */
@@ -7,6 +7,8 @@
 #include "RasterLocation.hpp"
 #include "RasterBuffer.hpp"
 
+#include <cassert>
+
 struct jas_matrix;
 class BufferedOutputStream;
 class BufferedReader;
@@ -87,6 +89,19 @@ public:
 
   void CopyFrom(const struct jas_matrix &m) noexcept;
 
+  /**
+   * Use pre-decoded heights (e.g. from a #TerrainTileStore mapping)
+   * instead of a heap copy.
+   *
+   * @param data a row-major array of #size heights which must remain
+   * valid until Unload() is called
+   */
+  void SetView(const TerrainHeight *data) noexcept {
+    assert(IsDefined());
+
+    buffer.SetView(data, size);
+  }
+
   /**
    * Determine the non-interpolated height at the specified pixel
    * location.
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "RasterTileCache.hpp"
+#include "TileStore.hpp"
 #include "Math/Angle.hpp"
 #include "io/BufferedOutputStream.hxx"
 #include "io/BufferedReader.hxx"
@@ -16,6 +17,26 @@ extern "C" {
 #include <string.h>
 #include <algorithm>
 
+RasterTileCache::RasterTileCache() noexcept
+{
+  Reset();
+}
+
+RasterTileCache::~RasterTileCache() noexcept = default;
+
+void
+RasterTileCache::SetTileStore(std::unique_ptr<TerrainTileStore> &&_store) noexcept
+{
+  assert(_store != nullptr);
+  assert(_store->GetTileCount() == tiles.GetSize());
+
+  /* discard tiles which were decoded before */
+  for (auto &i : tiles)
+    i.Unload();
+
+  tile_store = std::move(_store);
+}
+
 static void
 CopyOverviewRow(TerrainHeight *gcc_restrict dest, const jas_seqent_t *gcc_restrict src,
                 unsigned width, unsigned skip) noexcept
@@ -82,6 +103,32 @@ struct RTDistanceSort {
   }
 };
 
+inline void
+RasterTileCache::PollMappedTiles(SignedRasterLocation p,
+                                 unsigned radius) noexcept
+{
+  assert(tile_store != nullptr);
+
+  /* mapping a tile costs nothing but address space; the kernel
+     pages the data in when it is accessed, and may discard it under
+     memory pressure, so there is no need to limit the number of
+     active tiles or to unload distant ones */
+
+  bool modified = false;
+  for (unsigned i = 0; i < tiles.GetSize(); ++i) {
+    RasterTile &tile = tiles.GetLinear(i);
+    if (tile.VisibilityChanged(p, radius) && !tile.IsLoaded()) {
+      tile.SetView(tile_store->GetTile(i));
+      modified = true;
+    }
+  }
+
+  dirty = false;
+
+  if (modified)
+    ++serial;
+}
+
 bool
 RasterTileCache::PollTiles(SignedRasterLocation p, unsigned radius) noexcept
 {
@@ -91,6 +138,11 @@ RasterTileCache::PollTiles(SignedRasterLocation p, unsigned radius) noexcept
      the screen will be loaded in advance */
   radius += 256;
 
+  if (tile_store != nullptr) {
+    PollMappedTiles(p, radius);
+    return false;
+  }
+
   /**
    * Maximum number of tiles loaded at a time, to reduce system load
    * peaks.
@@ -219,6 +271,10 @@ RasterTileCache::Reset() noexcept
 
   for (auto &i : tiles)
     i.Unload();
+
+  /* the tiles have been unloaded, so there are no more references
+     into the store */
+  tile_store.reset();
 }
 
 const RasterTileCache::MarkerSegmentInfo *
@@ -12,12 +12,14 @@
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <optional>
 
 static constexpr unsigned  RASTER_SLOPE_FACT = 12;
 
 struct jas_matrix;
 struct GridLocation;
+class TerrainTileStore;
 class BufferedOutputStream;
 class BufferedReader;
 
@@ -26,7 +28,9 @@ class RasterTileCache {
 
   /**
    * The maximum number of tiles which are loaded at a time.  This
-   * must be limited because the amount of memory is finite.
+   * must be limited because the amount of memory is finite.  It does
+   * not apply to tiles obtained from a #TerrainTileStore, because
+   * those do not occupy heap memory.
    */
 #if defined(ANDROID)
   static constexpr unsigned MAX_ACTIVE_TILES = 128;
@@ -76,7 +80,7 @@ protected:
   };
 
   struct CacheHeader {
-    static constexpr unsigned VERSION = 0xb;
+    static constexpr unsigned VERSION = 0xc;
 
     unsigned version;
     UnsignedPoint2D size;
@@ -103,6 +107,12 @@ protected:
 
   GeoBounds bounds;
 
+  /**
+   * If set, then tiles are mapped from this store instead of being
+   * decoded from the JPEG2000 file.
+   */
+  std::unique_ptr<TerrainTileStore> tile_store;
+
   StaticArray<MarkerSegmentInfo, 8192> segments;
 
   /**
@@ -113,9 +123,8 @@ protected:
   StaticArray<uint16_t, MAX_RTC_TILES> request_tiles;
 
 public:
-  RasterTileCache() noexcept {
-    Reset();
-  }
+  RasterTileCache() noexcept;
+  ~RasterTileCache() noexcept;
 
   RasterTileCache(const RasterTileCache &) = delete;
   RasterTileCache &operator=(const RasterTileCache &) = delete;
@@ -126,6 +135,24 @@ public:
     bounds = _bounds;
   }
 
+  /**
+   * Obtain tile data from the specified store from now on.  The
+   * store must have been created with this object's tile geometry.
+   */
+  void SetTileStore(std::unique_ptr<TerrainTileStore> &&_store) noexcept;
+
+  bool HasTileStore() const noexcept {
+    return tile_store != nullptr;
+  }
+
+  Point2D<uint_least16_t> GetTileSize() const noexcept {
+    return tile_size;
+  }
+
+  UnsignedPoint2D GetTileCount() const noexcept {
+    return {tiles.GetWidth(), tiles.GetHeight()};
+  }
+
 protected:
   void ScanTileLine(GridLocation start, GridLocation end,
                     TerrainHeight *buffer, unsigned size,
@@ -258,6 +285,13 @@ public:
                        RasterLocation start, RasterLocation end,
                        const struct jas_matrix &m) noexcept;
 
+  /**
+   * Determine which tiles shall be loaded.  If a #TerrainTileStore
+   * is present, tiles are mapped right away and this method always
+   * returns false.
+   *
+   * @return true if tiles need to be decoded from the JPEG2000 file
+   */
   bool PollTiles(SignedRasterLocation p, unsigned radius) noexcept;
 
   void PutTileData(unsigned index, const struct jas_matrix &m) noexcept;
@@ -285,6 +319,8 @@ public:
   }
 
 private:
+  void PollMappedTiles(SignedRasterLocation p, unsigned radius) noexcept;
+
   RasterLocation GetFineTileSize() const noexcept {
     return {
       unsigned(tile_size.x) << RasterTraits::SUBPIXEL_BITS,
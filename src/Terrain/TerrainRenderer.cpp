@@ -312,20 +312,26 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
       !IsLargeSizeDifference(old_bounds, new_bounds) &&
       terrain_serial == terrain.GetSerial() &&
       sunazimuth.CompareRoughly(last_sun_azimuth) &&
-      !raster_renderer.UpdateQuantisation())
+      !raster_renderer.UpdateQuantisation()) {
     /* no change since previous frame */
+    cache_counter.Count(true);
     return true;
+  }
 
 #else
   if (compare_projection.Compare(map_projection) &&
       terrain_serial == terrain.GetSerial() &&
-      sunazimuth.CompareRoughly(last_sun_azimuth))
+      sunazimuth.CompareRoughly(last_sun_azimuth)) {
     /* no change since previous frame */
+    cache_counter.Count(true);
     return true;
+  }
 
   compare_projection = CompareProjection(map_projection);
 #endif
 
+  cache_counter.Count(false);
+
   terrain_serial = terrain.GetSerial();
 
   last_sun_azimuth = sunazimuth;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "RasterRenderer.hpp"
+#include "Renderer/CacheCounter.hpp"
 #include "util/Serial.hpp"
 #include "Terrain/TerrainSettings.hpp"
 
@@ -34,6 +35,11 @@ protected:
 
   RasterRenderer raster_renderer;
 
+  /**
+   * Counts the Generate() calls which reused the previous image.
+   */
+  CacheCounter cache_counter;
+
 public:
   TerrainRenderer(const RasterTerrain &_terrain);
   ~TerrainRenderer() {}
@@ -61,6 +67,10 @@ public:
     settings = _settings;
   }
 
+  CacheCounter TakeCacheCounter() noexcept {
+    return cache_counter.Exchange();
+  }
+
   /**
    * @return true if an image has been renderered and Draw() may be
    * called
@@ -12,7 +12,8 @@ TerrainThread::TerrainThread(RasterTerrain &_terrain,
    callback(std::move(_callback)) {}
 
 void
-TerrainThread::Trigger(const WindowProjection &projection)
+TerrainThread::Trigger(const WindowProjection &projection,
+                       const GeoPoint &prefetch_center)
 {
   assert(projection.IsValid());
 
@@ -20,10 +21,32 @@ TerrainThread::Trigger(const WindowProjection &projection)
 
   GeoPoint center = projection.GetGeoScreenCenter();
   auto radius = projection.GetScreenWidthMeters() / 2;
+
+  /* was the visible area loaded already? */
+  const bool covered = last_center.IsValid() &&
+    last_center.DistanceS(center) + radius <= last_radius;
+
+  if (prefetch_center.IsValid()) {
+    /* load the circle which encloses both the visible and the
+       predicted area; if there are too many tiles, the tile cache
+       discards those farthest from the center first, i.e. the ones
+       behind the aircraft */
+    const auto distance = center.DistanceS(prefetch_center);
+    if (distance <= radius) {
+      center = center.Middle(prefetch_center);
+      radius += distance / 2;
+    }
+  }
+
   if (last_center.IsValid() && last_radius >= radius &&
       last_center.DistanceS(center) < 1000)
     return;
 
+  if (covered)
+    ++statistics.hits;
+  else
+    ++statistics.misses;
+
   next_center = center;
   next_radius = radius;
   StandbyThread::Trigger();
@@ -15,6 +15,17 @@ class WindowProjection;
  * A thread that loads topography files asynchronously.
  */
 class TerrainThread final : private StandbyThread {
+public:
+  /**
+   * Counts how often the visible area was already loaded when the
+   * thread was asked to update the tiles ("hit"), and how often it
+   * was not ("miss").
+   */
+  struct Statistics {
+    unsigned hits = 0, misses = 0;
+  };
+
+private:
   RasterTerrain &terrain;
 
   const std::function<void()> callback;
@@ -25,12 +36,29 @@ class TerrainThread final : private StandbyThread {
   GeoPoint next_center;
   double next_radius;
 
+  Statistics statistics;
+
 public:
   TerrainThread(RasterTerrain &_terrain, std::function<void()> &&_callback);
 
   using StandbyThread::LockStop;
 
-  void Trigger(const WindowProjection &projection);
+  /**
+   * @param prefetch_center the predicted screen center in the near
+   * future (or GeoPoint::Invalid()); the area around it is loaded
+   * together with the visible area, within the tile cache's limit
+   * of active tiles.  It is ignored if it is more than half a screen
+   * width away.
+   */
+  void Trigger(const WindowProjection &projection,
+               const GeoPoint &prefetch_center=GeoPoint::Invalid());
+
+  /**
+   * Must be called from the thread which calls Trigger().
+   */
+  const Statistics &GetStatistics() const noexcept {
+    return statistics;
+  }
 
 private:
   /* virtual methods from class StandbyThread*/
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TileStore.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "util/SpanCast.hxx"
+
+extern "C" {
+#include "jasper/jas_seq.h"
+}
+
+#include <array>
+#include <cassert>
+#include <stdexcept>
+
+#include <string.h>
+
+TerrainTileStore::TerrainTileStore(std::unique_ptr<FileMapping> &&_mapping,
+                                   Point2D<uint_least16_t> tile_size,
+                                   UnsignedPoint2D _n_tiles)
+  :mapping(std::move(_mapping))
+{
+  const std::span<const std::byte> raw = *mapping;
+  if (raw.size() < GetDataOffset(FileCache::HEADER_SIZE))
+    throw std::runtime_error("Terrain tile store too small");
+
+  Header header;
+  memcpy(&header, raw.data() + FileCache::HEADER_SIZE, sizeof(header));
+
+  if (header.version != Header::VERSION ||
+      header.tile_size != tile_size ||
+      header.n_tiles != _n_tiles)
+    throw std::runtime_error("Terrain tile store mismatch");
+
+  slot_size = GetSlotSize(tile_size);
+  n_tiles = _n_tiles.Area();
+
+  const std::size_t offset = GetDataOffset(FileCache::HEADER_SIZE);
+  if (raw.size() < offset + slot_size * n_tiles)
+    throw std::runtime_error("Terrain tile store truncated");
+
+  data = reinterpret_cast<const TerrainHeight *>(raw.data() + offset);
+}
+
+TerrainTileStore::~TerrainTileStore() noexcept = default;
+
+TerrainTileStoreWriter::TerrainTileStoreWriter(std::unique_ptr<FileOutputStream> &&_file) noexcept
+  :file(std::move(_file)),
+   os(std::make_unique<BufferedOutputStream>(*file)) {}
+
+TerrainTileStoreWriter::~TerrainTileStoreWriter() noexcept = default;
+
+inline void
+TerrainTileStoreWriter::Fail(std::exception_ptr e) noexcept
+{
+  if (!error)
+    error = std::move(e);
+}
+
+/**
+ * Write the given number of zero bytes.
+ */
+static void
+WriteZeroes(BufferedOutputStream &os, std::size_t n)
+{
+  static constexpr std::array<std::byte, 1024> zero{};
+
+  while (n > 0) {
+    const std::size_t chunk = std::min(n, zero.size());
+    os.Write(std::span{zero}.first(chunk));
+    n -= chunk;
+  }
+}
+
+void
+TerrainTileStoreWriter::Start(Point2D<uint_least16_t> tile_size,
+                              UnsignedPoint2D _n_tiles) noexcept
+try {
+  if (error)
+    return;
+
+  if (slot_size > 0)
+    throw std::runtime_error("Duplicate terrain size");
+
+  slot_size = TerrainTileStore::GetSlotSize(tile_size);
+  n_tiles = _n_tiles.Area();
+
+  if (slot_size == 0 || n_tiles == 0 ||
+      slot_size * n_tiles > TerrainTileStore::MAX_SIZE)
+    throw std::runtime_error("Terrain too large for tile store");
+
+  TerrainTileStore::Header header;
+  memset(&header, 0, sizeof(header));
+  header.version = TerrainTileStore::Header::VERSION;
+  header.tile_size = tile_size;
+  header.n_tiles = _n_tiles;
+
+  os->Write(ReferenceAsBytes(header));
+
+  /* pad up to the first (page aligned) tile slot */
+  WriteZeroes(*os, TerrainTileStore::GetDataOffset(FileCache::HEADER_SIZE)
+              - FileCache::HEADER_SIZE - sizeof(header));
+} catch (...) {
+  Fail(std::current_exception());
+}
+
+void
+TerrainTileStoreWriter::SkipTo(unsigned index)
+{
+  assert(index >= next_tile);
+  assert(index <= n_tiles);
+
+  /* tiles which have no data are never defined in the
+     RasterTileCache and will therefore never be read; just fill
+     their slots with zeroes */
+  WriteZeroes(*os, (index - next_tile) * slot_size);
+  next_tile = index;
+}
+
+void
+TerrainTileStoreWriter::PutTile(unsigned index,
+                                const struct jas_matrix &m) noexcept
+try {
+  if (error)
+    return;
+
+  if (slot_size == 0)
+    throw std::runtime_error("Terrain size unknown");
+
+  if (index < next_tile || index >= n_tiles)
+    throw std::runtime_error("Terrain tiles out of order");
+
+  const unsigned width = m.numcols_, height = m.numrows_;
+  if (std::size_t(width) * height * sizeof(TerrainHeight) > slot_size)
+    throw std::runtime_error("Terrain tile too large");
+
+  SkipTo(index);
+
+  std::array<TerrainHeight, 1024> row;
+
+  for (unsigned y = 0; y != height; ++y) {
+    const jas_seqent_t *src = m.rows_[y];
+
+    for (unsigned x = 0; x < width;) {
+      const unsigned n = std::min<unsigned>(width - x, row.size());
+      for (unsigned i = 0; i < n; ++i)
+        row[i] = TerrainHeight(src[x + i]);
+
+      os->Write(std::as_bytes(std::span{row}.first(n)));
+      x += n;
+    }
+  }
+
+  /* pad the rest of the slot (for tiles at the right or bottom
+     edge, which are smaller than the nominal tile size) */
+  WriteZeroes(*os, slot_size - std::size_t(width) * height * sizeof(TerrainHeight));
+  ++next_tile;
+} catch (...) {
+  Fail(std::current_exception());
+}
+
+void
+TerrainTileStoreWriter::Commit()
+{
+  if (error)
+    std::rethrow_exception(error);
+
+  if (slot_size == 0)
+    throw std::runtime_error("No terrain tiles");
+
+  SkipTo(n_tiles);
+  os->Flush();
+  file->Commit();
+}
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Height.hpp"
+#include "RasterLocation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <span>
+
+struct jas_matrix;
+class FileMapping;
+class FileOutputStream;
+class BufferedOutputStream;
+
+/**
+ * A flat file containing the decoded heights of all terrain tiles.
+ * It is written once while the JPEG2000 file is being scanned for
+ * the overview (see #TerrainTileStoreWriter); after that, "loading"
+ * a tile means pointing its #RasterBuffer into the memory mapping,
+ * without running the JPEG2000 decoder.
+ *
+ * File layout (after the #FileCache header): a #Header, padding up
+ * to #DATA_ALIGNMENT, then one fixed-size slot per tile (in tile
+ * index order), each containing the tile's heights in row-major
+ * order without padding between rows.
+ */
+class TerrainTileStore {
+public:
+  struct Header {
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t version;
+    Point2D<uint_least16_t> tile_size;
+    UnsignedPoint2D n_tiles;
+  };
+
+  /**
+   * The offset of the first tile slot within the cache payload.
+   * This is a multiple of the page size, which means each slot
+   * begins at a page boundary when the tile size is a power of two.
+   */
+  static constexpr std::size_t DATA_ALIGNMENT = 4096;
+
+  /**
+   * Refuse to write stores larger than this; #FileMapping would not
+   * be able to map them anyway.
+   */
+  static constexpr std::size_t MAX_SIZE = 1024 * 1024 * 1024;
+
+  [[gnu::const]]
+  static constexpr std::size_t GetDataOffset(std::size_t header_offset) noexcept {
+    return (header_offset + sizeof(Header) + DATA_ALIGNMENT - 1)
+      / DATA_ALIGNMENT * DATA_ALIGNMENT;
+  }
+
+  [[gnu::const]]
+  static constexpr std::size_t GetSlotSize(Point2D<uint_least16_t> tile_size) noexcept {
+    return std::size_t(tile_size.x) * tile_size.y * sizeof(TerrainHeight);
+  }
+
+private:
+  std::unique_ptr<FileMapping> mapping;
+
+  /**
+   * The first tile slot.
+   */
+  const TerrainHeight *data;
+
+  std::size_t slot_size;
+
+  unsigned n_tiles;
+
+public:
+  /**
+   * Throws if the file is malformed or does not match the given
+   * geometry.
+   *
+   * @param _mapping a #FileCache mapping (see FileCache::Map())
+   */
+  TerrainTileStore(std::unique_ptr<FileMapping> &&_mapping,
+                   Point2D<uint_least16_t> tile_size,
+                   UnsignedPoint2D n_tiles);
+
+  ~TerrainTileStore() noexcept;
+
+  TerrainTileStore(const TerrainTileStore &) = delete;
+  TerrainTileStore &operator=(const TerrainTileStore &) = delete;
+
+  /**
+   * Returns a pointer to the first height of the specified tile.
+   */
+  [[gnu::pure]]
+  const TerrainHeight *GetTile(unsigned index) const noexcept {
+    return data + index * (slot_size / sizeof(TerrainHeight));
+  }
+
+  unsigned GetTileCount() const noexcept {
+    return n_tiles;
+  }
+};
+
+/**
+ * Writes a #TerrainTileStore file.  Tiles are expected to arrive in
+ * ascending index order (which is the order in the JPEG2000 files
+ * generated for XCSoar); if they do not, the store is abandoned.
+ *
+ * All methods except for Commit() are called from inside the
+ * JPEG2000 decoder and therefore do not throw; errors are remembered
+ * and rethrown by Commit().
+ */
+class TerrainTileStoreWriter {
+  std::unique_ptr<FileOutputStream> file;
+  std::unique_ptr<BufferedOutputStream> os;
+
+  std::exception_ptr error;
+
+  std::size_t slot_size = 0;
+
+  /**
+   * The index of the next tile slot to be written.
+   */
+  unsigned next_tile = 0;
+
+  unsigned n_tiles = 0;
+
+public:
+  /**
+   * @param _file a file obtained from FileCache::Save()
+   */
+  explicit TerrainTileStoreWriter(std::unique_ptr<FileOutputStream> &&_file) noexcept;
+  ~TerrainTileStoreWriter() noexcept;
+
+  TerrainTileStoreWriter(const TerrainTileStoreWriter &) = delete;
+  TerrainTileStoreWriter &operator=(const TerrainTileStoreWriter &) = delete;
+
+  /**
+   * Write the header.  Must be called before the first PutTile().
+   */
+  void Start(Point2D<uint_least16_t> tile_size,
+             UnsignedPoint2D _n_tiles) noexcept;
+
+  void PutTile(unsigned index, const struct jas_matrix &m) noexcept;
+
+  /**
+   * Finish the file and make it visible.
+   *
+   * Throws on error.
+   */
+  void Commit();
+
+private:
+  void Fail(std::exception_ptr e) noexcept;
+
+  /**
+   * Fill the remaining slots up to (but not including) the given
+   * one.
+   */
+  void SkipTo(unsigned index);
+};
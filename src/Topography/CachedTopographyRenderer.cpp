@@ -10,8 +10,11 @@ void
 CachedTopographyRenderer::Draw(Canvas &canvas,
                                const WindowProjection &projection) noexcept
 {
-  if (renderer.GetStore().GetSerial() != last_serial ||
-      !cache.Check(projection)) {
+  const bool hit = renderer.GetStore().GetSerial() == last_serial &&
+    cache.Check(projection);
+  cache_counter.Count(hit);
+
+  if (!hit) {
     last_serial = renderer.GetStore().GetSerial();
 
     Canvas &buffer_canvas = cache.Begin(canvas, projection);
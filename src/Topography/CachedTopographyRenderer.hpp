@@ -5,6 +5,7 @@
 
 #include "TopographyRenderer.hpp"
 #include "Renderer/TransparentRendererCache.hpp"
+#include "Renderer/CacheCounter.hpp"
 
 /**
  * Class used to manage and render vector topography layers
@@ -16,6 +17,8 @@ class CachedTopographyRenderer {
   TransparentRendererCache cache;
 
   unsigned last_serial = 0;
+
+  CacheCounter cache_counter;
 #endif
 
 public:
@@ -38,6 +41,18 @@ public:
   void Draw(Canvas &canvas, const WindowProjection &projection) noexcept;
 #endif
 
+  /**
+   * Return (and reset) the statistics of the bitmap cache.  Always
+   * empty on OpenGL, which draws the shapes directly.
+   */
+  CacheCounter TakeCacheCounter() noexcept {
+#ifndef ENABLE_OPENGL
+    return cache_counter.Exchange();
+#else
+    return {};
+#endif
+  }
+
   void DrawLabels(Canvas &canvas, const WindowProjection &projection,
                   LabelBlock &label_block) noexcept {
     renderer.DrawLabels(canvas, projection, label_block);
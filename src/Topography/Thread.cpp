@@ -9,19 +9,37 @@ TopographyThread::TopographyThread(TopographyStore &_store,
   :StandbyThread("Topography"),
    store(_store),
    callback(std::move(_callback)),
-   last_bounds(GeoBounds::Invalid()) {}
+   next_prefetch_bounds(GeoBounds::Invalid()),
+   last_bounds(GeoBounds::Invalid()),
+   cache_bounds(GeoBounds::Invalid()) {}
 
 TopographyThread::~TopographyThread()
 {
 }
 
 void
-TopographyThread::Trigger(const WindowProjection &_projection)
+TopographyThread::Trigger(const WindowProjection &_projection,
+                          const GeoPoint &prefetch_center)
 {
   assert(_projection.IsValid());
 
   const GeoBounds new_bounds = _projection.GetScreenBounds();
-  if (last_bounds.IsValid() && last_bounds.IsInside(new_bounds)) {
+
+  GeoBounds prefetch_bounds = GeoBounds::Invalid(), required = new_bounds;
+  if (prefetch_center.IsValid()) {
+    const GeoPoint center = _projection.GetGeoScreenCenter();
+    if (center.DistanceS(prefetch_center) <=
+        _projection.GetScreenWidthMeters() / 2) {
+      /* the visible area, moved to the predicted center */
+      const GeoPoint delta = prefetch_center - center;
+      prefetch_bounds = GeoBounds(new_bounds.GetNorthWest() + delta,
+                                  new_bounds.GetSouthEast() + delta);
+      required.Extend(prefetch_bounds.GetNorthWest());
+      required.Extend(prefetch_bounds.GetSouthEast());
+    }
+  }
+
+  if (last_bounds.IsValid() && last_bounds.IsInside(required)) {
     /* still inside cache bounds - now check if we crossed a scale
        threshold for at least one file, which would mean we have to
        update a file which was not updated for the current cache
@@ -32,12 +50,19 @@ TopographyThread::Trigger(const WindowProjection &_projection)
       return;
   }
 
-  last_bounds = new_bounds.Scale(1.1);
+  if (cache_bounds.IsValid() && cache_bounds.IsInside(new_bounds))
+    ++statistics.hits;
+  else
+    ++statistics.misses;
+
+  last_bounds = required.Scale(1.1);
+  cache_bounds = TopographyFile::GetCacheBounds(new_bounds, prefetch_bounds);
   scale_threshold = store.GetNextScaleThreshold(_projection.GetMapScale());
 
   {
     const std::lock_guard lock{mutex};
     next_projection = _projection;
+    next_prefetch_bounds = prefetch_bounds;
     StandbyThread::Trigger();
   }
 }
@@ -51,9 +76,10 @@ TopographyThread::Tick() noexcept
   bool again = true;
   while (next_projection.IsValid() && again && !IsStopped()) {
     const WindowProjection projection = next_projection;
+    const GeoBounds prefetch_bounds = next_prefetch_bounds;
 
     const ScopeUnlock unlock(mutex);
-    again = store.ScanVisibility(projection, 1) > 0;
+    again = store.ScanVisibility(projection, 1, prefetch_bounds) > 0;
   }
 
   /* notify the client that we have updated the topography cache */
@@ -15,22 +15,56 @@ class TopographyStore;
  * A thread that loads topography files asynchronously.
  */
 class TopographyThread final : private StandbyThread {
+public:
+  /**
+   * Counts how often the visible area was already loaded when the
+   * thread was asked to update the topography ("hit"), and how often
+   * it was not ("miss").
+   */
+  struct Statistics {
+    unsigned hits = 0, misses = 0;
+  };
+
+private:
   TopographyStore &store;
 
   const std::function<void()> callback;
 
   WindowProjection next_projection;
+  GeoBounds next_prefetch_bounds;
 
   GeoBounds last_bounds;
   double scale_threshold;
 
+  /**
+   * The area loaded by the last update, see
+   * TopographyFile::GetCacheBounds().
+   */
+  GeoBounds cache_bounds;
+
+  Statistics statistics;
+
 public:
   TopographyThread(TopographyStore &_store, std::function<void()> &&_callback);
   ~TopographyThread();
 
   using StandbyThread::LockStop;
 
-  void Trigger(const WindowProjection &_projection);
+  /**
+   * @param prefetch_center the predicted screen center in the near
+   * future (or GeoPoint::Invalid()); shapes around it are loaded
+   * together with the visible ones.  It is ignored if it is more
+   * than half a screen width away.
+   */
+  void Trigger(const WindowProjection &_projection,
+               const GeoPoint &prefetch_center=GeoPoint::Invalid());
+
+  /**
+   * Must be called from the thread which calls Trigger().
+   */
+  const Statistics &GetStatistics() const noexcept {
+    return statistics;
+  }
 
 private:
   /* virtual methods from class StandbyThread*/
@@ -3,13 +3,20 @@
 
 #include "Topography/TopographyFile.hpp"
 #include "Topography/XShape.hpp"
+#include "Topography/TopographyPack.hpp"
 #include "Convert.hpp"
 #include "Projection/WindowProjection.hpp"
+#include "io/FileMapping.hpp"
 #include "util/ScopeExit.hxx"
 
+#ifdef ENABLE_OPENGL
+#include "Geo/FAISphere.hpp"
+#endif
+
 #include <zzip/lib.h>
 
 #include <algorithm>
+#include <array>
 #include <stdexcept>
 
 TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
@@ -22,7 +29,7 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
                                ResourceId _ultra_icon,
                                unsigned _pen_width)
   :dir(_dir),
-   file(dir, filename),
+   file(std::in_place, dir, filename),
    label_field(_label_field),
    icon(_icon), big_icon(_big_icon), ultra_icon(_ultra_icon),
    pen_width(_pen_width),
@@ -30,7 +37,7 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
    label_threshold(_label_threshold),
    important_label_threshold(_important_label_threshold)
 {
-  const std::size_t n_shapes = file.size();
+  const std::size_t n_shapes = file->size();
   constexpr std::size_t MAX_SHAPES = 16 * 1024 * 1024;
   if (n_shapes == 0)
     throw std::runtime_error{"Empty shapefile"};
@@ -38,7 +45,7 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
   if (n_shapes > MAX_SHAPES)
     throw std::runtime_error{"Too many shapes in shapefile"};
 
-  const auto file_bounds = ImportRect(file.GetBounds());
+  const auto file_bounds = ImportRect(file->GetBounds());
   if (!file_bounds.Check())
     throw std::runtime_error{"Malformed shapefile bounds"};
 
@@ -70,7 +77,7 @@ TopographyFile::ClearCache() noexcept
 }
 
 static std::unique_ptr<XShape>
-LoadShape(ShapeFile &file, GeoPoint &center, std::size_t i, int label_field)
+ReadShape(ShapeFile &file, GeoPoint &center, std::size_t i, int label_field)
 {
   shapeObj shape;
   msInitShape(&shape);
@@ -84,8 +91,39 @@ LoadShape(ShapeFile &file, GeoPoint &center, std::size_t i, int label_field)
   return std::make_unique<XShape>(shape, center, label);
 }
 
+inline std::unique_ptr<const XShape>
+TopographyFile::LoadShape(std::size_t i)
+{
+  if (pack != nullptr)
+    return pack->LoadShape(i);
+
+  return ReadShape(*file, center, i, label_field);
+}
+
+static GeoBounds
+Union(GeoBounds a, const GeoBounds &b) noexcept
+{
+  a.Extend(b.GetNorthWest());
+  a.Extend(b.GetSouthEast());
+  return a;
+}
+
+GeoBounds
+TopographyFile::GetCacheBounds(const GeoBounds &screen,
+                               const GeoBounds &prefetch_bounds) noexcept
+{
+  if (!prefetch_bounds.IsValid())
+    return screen.Scale(2);
+
+  /* the union is already larger than the screen, so a smaller
+     margin is enough; this keeps the memory usage close to the
+     non-prefetching case */
+  return Union(screen, prefetch_bounds).Scale(1.5);
+}
+
 bool
-TopographyFile::Update(const WindowProjection &map_projection)
+TopographyFile::Update(const WindowProjection &map_projection,
+                       const GeoBounds &prefetch_bounds)
 {
   if (map_projection.GetMapScale() > scale_threshold)
     /* not visible, don't update cache now */
@@ -93,35 +131,48 @@ TopographyFile::Update(const WindowProjection &map_projection)
 
   const GeoBounds screenRect =
     map_projection.GetScreenBounds();
-  if (cache_bounds.IsValid() && cache_bounds.IsInside(screenRect))
+  const GeoBounds required = prefetch_bounds.IsValid()
+    ? Union(screenRect, prefetch_bounds)
+    : screenRect;
+  if (cache_bounds.IsValid() && cache_bounds.IsInside(required))
     /* the cache is still fresh */
     return false;
 
-  cache_bounds = screenRect.Scale(2);
-
-  // Test which shapes are inside the given bounds and save the
-  // status to file.status
-  switch (file.WhichShapes(dir, ConvertRect(cache_bounds))) {
-  case MS_FAILURE:
-    ClearCache();
-    throw std::runtime_error{"Failed to update shapefile"};
-
-  case MS_DONE:
-    /* screen is outside of map bounds */
-    return false;
+  cache_bounds = GetCacheBounds(screenRect, prefetch_bounds);
+
+  ms_const_bitarray status = nullptr;
+  if (pack != nullptr) {
+    if (!pack->Select(cache_bounds))
+      /* screen is outside of map bounds */
+      return false;
+  } else {
+    // Test which shapes are inside the given bounds and save the
+    // status to file.status
+    switch (file->WhichShapes(dir, ConvertRect(cache_bounds))) {
+    case MS_FAILURE:
+      ClearCache();
+      throw std::runtime_error{"Failed to update shapefile"};
+
+    case MS_DONE:
+      /* screen is outside of map bounds */
+      return false;
+
+    case MS_SUCCESS:
+      break;
+    }
 
-  case MS_SUCCESS:
-    break;
+    status = file->GetStatus();
+    assert(status != nullptr);
   }
 
-  const auto status = file.GetStatus();
-  assert(status != nullptr);
-
   // Iterate through the shapefile entries
   auto prev = list.before_begin();
   auto it = shapes.begin();
-  for (std::size_t i = 0; i < file.size(); ++i, ++it) {
-    if (!msGetBit(status, i)) {
+  for (std::size_t i = 0; i < shapes.size(); ++i, ++it) {
+    const bool visible = status != nullptr
+      ? msGetBit(status, i)
+      : pack->IsSelected(i);
+    if (!visible) {
       // If the shape is outside the bounds
       // delete the shape from the cache
       if (it->shape != nullptr) {
@@ -144,7 +195,7 @@ TopographyFile::Update(const WindowProjection &map_projection)
         assert(&*std::next(prev) != &*it);
 
         // shape isn't cached yet -> cache the shape
-        it->shape = LoadShape(file, center, i, label_field);
+        it->shape = LoadShape(i);
 
         /* insert into linked list (protected) */
         {
@@ -170,11 +221,11 @@ TopographyFile::LoadAll()
   // Iterate through the shapefile entries
   auto prev = list.before_begin();
   auto it = shapes.begin();
-  for (std::size_t i = 0; i < file.size(); ++i, ++it) {
+  for (std::size_t i = 0; i < shapes.size(); ++i, ++it) {
     if (it->shape == nullptr) {
       assert(&*std::next(prev) != &*it);
       // shape isn't cached yet -> cache the shape
-      it->shape = LoadShape(file, center, i, label_field);
+      it->shape = LoadShape(i);
       // update list pointer
       prev = list.insert_after(prev, *it);
     } else {
@@ -188,6 +239,60 @@ TopographyFile::LoadAll()
   ++serial;
 }
 
+/**
+ * The #TopographyPack::Key for the given #TopographyFile settings.
+ */
+static constexpr TopographyPack::Key
+MakePackKey(double scale_threshold, int label_field,
+            [[maybe_unused]] unsigned layout_scale) noexcept
+{
+  return {
+    scale_threshold,
+    label_field,
+#ifdef ENABLE_OPENGL
+    layout_scale,
+#else
+    /* no thinning without OpenGL */
+    0,
+#endif
+  };
+}
+
+void
+TopographyFile::SavePack(BufferedOutputStream &os, unsigned layout_scale)
+{
+  assert(file);
+
+  std::array<float, TopographyPack::THINNING_LEVELS> min_distances{};
+#ifdef ENABLE_OPENGL
+  for (unsigned level = 0; level < min_distances.size(); ++level)
+    min_distances[level] = GetMinimumShapeDistance(level, layout_scale);
+#endif
+
+  TopographyPackWriter writer(os);
+  for (std::size_t i = 0; i < shapes.size(); ++i)
+    writer.Add(*ReadShape(*file, center, i, label_field), min_distances);
+
+  writer.Finish(MakePackKey(scale_threshold, label_field, layout_scale));
+}
+
+bool
+TopographyFile::LoadPack(std::unique_ptr<FileMapping> &&mapping,
+                         unsigned layout_scale)
+{
+  assert(list.empty());
+
+  auto new_pack = std::make_unique<TopographyPack>(std::move(mapping));
+  if (new_pack->GetShapeCount() != shapes.size() ||
+      new_pack->GetKey() != MakePackKey(scale_threshold, label_field,
+                                        layout_scale))
+    return false;
+
+  pack = std::move(new_pack);
+  file.reset();
+  return true;
+}
+
 unsigned
 TopographyFile::GetSkipSteps(double map_scale) const noexcept
 {
@@ -229,4 +334,12 @@ TopographyFile::GetMinimumPointDistance(unsigned level) const noexcept
   return 1;
 }
 
+ShapeScalar
+TopographyFile::GetMinimumShapeDistance(unsigned level,
+                                        unsigned layout_scale) const noexcept
+{
+  return ShapeScalar(GetMinimumPointDistance(level))
+    / (layout_scale * FAISphere::REARTH);
+}
+
 #endif
@@ -18,9 +18,13 @@
 
 #include <cassert>
 #include <memory>
+#include <optional>
 
 class WindowProjection;
 class XShape;
+class TopographyPack;
+class FileMapping;
+class BufferedOutputStream;
 struct zzip_dir;
 
 class TopographyFile {
@@ -35,13 +39,23 @@ class TopographyFile {
 
   zzip_dir *const dir;
 
-  ShapeFile file;
+  /**
+   * The shapefile; it is closed after LoadPack() has succeeded.
+   */
+  std::optional<ShapeFile> file;
 
   /**
    * The center of shapefileObj::bounds.
    */
   GeoPoint center;
 
+  /**
+   * If set, shapes are loaded from this precompiled copy instead of
+   * the shapefile.  This must be declared before #shapes because the
+   * #XShape objects point into it.
+   */
+  std::unique_ptr<TopographyPack> pack;
+
   AllocatedArray<ShapeEnvelope> shapes;
 
   using ShapeList = IntrusiveForwardList<ShapeEnvelope>;
@@ -242,14 +256,63 @@ public:
    */
   [[gnu::pure]]
   unsigned GetMinimumPointDistance(unsigned level) const noexcept;
+
+  /**
+   * Convert GetMinimumPointDistance() to the #ShapeScalar value
+   * passed to XShape::GetIndices().
+   *
+   * @param layout_scale the value of Layout::Scale(1)
+   */
+  [[gnu::pure]]
+  ShapeScalar GetMinimumShapeDistance(unsigned level,
+                                      unsigned layout_scale) const noexcept;
 #endif
 
+  /**
+   * Compile the whole shapefile to a #TopographyPack.  Must be called
+   * before LoadPack().
+   *
+   * Throws on error.
+   *
+   * @param layout_scale the value of Layout::Scale(1), see
+   * TopographyPack::Key
+   */
+  void SavePack(BufferedOutputStream &os, unsigned layout_scale);
+
+  /**
+   * Load all shapes from the given #TopographyPack from now on, and
+   * close the shapefile.  Must be called before the first Update().
+   *
+   * Throws if the pack is malformed.
+   *
+   * @param mapping a #FileCache mapping of a file written by
+   * SavePack()
+   * @return false if the pack does not match this file and its
+   * settings (it needs to be compiled again)
+   */
+  bool LoadPack(std::unique_ptr<FileMapping> &&mapping,
+                unsigned layout_scale);
+
+  /**
+   * Calculate the area which is loaded by Update().
+   *
+   * @param screen the visible area
+   * @param prefetch_bounds the area which will probably be visible
+   * soon, or GeoBounds::Invalid()
+   */
+  [[gnu::pure]]
+  static GeoBounds GetCacheBounds(const GeoBounds &screen,
+                                  const GeoBounds &prefetch_bounds) noexcept;
+
   /**
    * Throws on error.
    *
+   * @param prefetch_bounds the area which will probably be visible
+   * soon; shapes in this area are loaded in advance
    * @return true if new data from the topography file has been loaded
    */
-  bool Update(const WindowProjection &map_projection);
+  bool Update(const WindowProjection &map_projection,
+              const GeoBounds &prefetch_bounds=GeoBounds::Invalid());
 
   /**
    * Throws on error.
@@ -260,4 +323,10 @@ public:
 
 protected:
   void ClearCache() noexcept;
+
+private:
+  /**
+   * Throws on error.
+   */
+  std::unique_ptr<const XShape> LoadShape(std::size_t i);
 };
@@ -14,7 +14,6 @@
 #include "util/AllocatedArray.hxx"
 #include "util/tstring.hpp"
 #include "Geo/GeoClip.hpp"
-#include "Geo/FAISphere.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "ui/canvas/opengl/VertexPointer.hpp"
@@ -139,8 +138,14 @@ TopographyFileRenderer::PaintPoints(Canvas &canvas,
 }
 
 void
+#ifdef USE_MEMORY_CANVAS
+TopographyFileRenderer::Paint(Canvas &canvas,
+                              const WindowProjection &projection,
+                              TiledRasteriser &tiled_rasteriser) noexcept
+#else
 TopographyFileRenderer::Paint(Canvas &canvas,
                               const WindowProjection &projection) noexcept
+#endif
 {
   const std::lock_guard lock{file.mutex};
 
@@ -169,6 +174,12 @@ TopographyFileRenderer::Paint(Canvas &canvas,
   }
 #else
   shape_renderer.Configure(&pen, &brush);
+
+#ifdef USE_MEMORY_CANVAS
+  /* the loop below draws only polygons and polylines, which are
+     recorded and then rasterised in parallel bands */
+  canvas.BeginTiled(tiled_rasteriser);
+#endif
 #endif
 
   // get drawing info
@@ -176,8 +187,7 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 #ifdef ENABLE_OPENGL
   const unsigned level = file.GetThinningLevel(map_scale);
   const ShapeScalar min_distance =
-    ShapeScalar(file.GetMinimumPointDistance(level))
-    / (Layout::Scale(1) * FAISphere::REARTH);
+    file.GetMinimumShapeDistance(level, Layout::Scale(1U));
 
   glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
                      glm::value_ptr(ToGLM(projection, file.GetCenter())));
@@ -340,6 +350,10 @@ TopographyFileRenderer::Paint(Canvas &canvas,
   array_buffer->Unbind();
 #else
   shape_renderer.Commit();
+
+#ifdef USE_MEMORY_CANVAS
+  canvas.EndTiled();
+#endif
 #endif
 }
 
@@ -19,6 +19,7 @@
 
 class TopographyFile;
 class Canvas;
+class TiledRasteriser;
 class GLArrayBuffer;
 class WindowProjection;
 class LabelBlock;
@@ -72,8 +73,14 @@ public:
    * @param canvas The canvas to paint on
    * @param bitmap_canvas Temporary canvas for the icon
    * @param projection
+   * @param tiled_rasteriser draws the shapes on several CPU cores
    */
+#ifdef USE_MEMORY_CANVAS
+  void Paint(Canvas &canvas, const WindowProjection &projection,
+             TiledRasteriser &tiled_rasteriser) noexcept;
+#else
   void Paint(Canvas &canvas, const WindowProjection &projection) noexcept;
+#endif
 
   /**
    * Paints a topography label if the space is available in the LabelBlock
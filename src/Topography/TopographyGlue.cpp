@@ -3,27 +3,36 @@
 
 #include "Topography/TopographyGlue.hpp"
 #include "Topography/TopographyStore.hpp"
+#include "Topography/TopographyPack.hpp"
 #include "Language/Language.hpp"
 #include "Profile/Profile.hpp"
+#include "Screen/Layout.hpp"
 #include "LogFile.hpp"
-#include "io/MapFile.hpp"
 #include "io/ZipArchive.hpp"
 #include "io/ZipLineReader.hpp"
 #include "system/Path.hpp"
 
+#include <optional>
+
 /**
  * Load topography from the map file (ZIP), load the other files from
  * the same ZIP file.
  */
 static bool
-LoadConfiguredTopographyZip(TopographyStore &store)
+LoadConfiguredTopographyZip(TopographyStore &store, FileCache *cache)
 try {
-  auto archive = OpenMapFile();
-  if (!archive)
+  const auto path = Profile::GetPath(ProfileKeys::MapFile);
+  if (path == nullptr)
     return false;
 
-  ZipLineReaderA reader(archive->get(), "topology.tpl");
-  store.Load(reader, nullptr, archive->get());
+  ZipArchive archive{path};
+
+  std::optional<TopographyPackContext> packs;
+  if (cache != nullptr)
+    packs.emplace(*cache, path, Layout::Scale(1U));
+
+  ZipLineReaderA reader(archive.get(), "topology.tpl");
+  store.Load(reader, nullptr, archive.get(), packs ? &*packs : nullptr);
   return true;
 } catch (...) {
   LogError(std::current_exception(), "No topography in map file");
@@ -31,7 +40,7 @@ try {
 }
 
 bool
-LoadConfiguredTopography(TopographyStore &store)
+LoadConfiguredTopography(TopographyStore &store, FileCache *cache)
 {
-  return LoadConfiguredTopographyZip(store);
+  return LoadConfiguredTopographyZip(store, cache);
 }
@@ -0,0 +1,461 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TopographyPack.hpp"
+#include "XShape.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "util/SpanCast.hxx"
+#include "util/StringAPI.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include <string.h>
+#include <tchar.h>
+
+#ifdef ENABLE_OPENGL
+static_assert(TopographyPack::THINNING_LEVELS == XShape::THINNING_LEVELS);
+#endif
+
+static_assert(std::is_trivially_copyable_v<TopographyPack::ShapeRecord>);
+static_assert(std::is_trivially_copyable_v<TopographyPack::Footer>);
+
+/**
+ * The maximum number of grid cells in each direction.
+ */
+static constexpr unsigned MAX_GRID_SIZE = 256;
+
+/* limit to reject corrupt files */
+static constexpr uint32_t MAX_LABEL_SIZE = 4096;
+
+static constexpr std::size_t
+AlignOffset(std::size_t offset, std::size_t alignment) noexcept
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+namespace {
+
+/**
+ * The offsets of a shape's data, calculated from its
+ * #TopographyPack::ShapeRecord.
+ */
+struct ShapeLayout {
+  uint64_t points, indices, label, end;
+
+  explicit ShapeLayout(const TopographyPack::ShapeRecord &r) noexcept {
+    points = AlignOffset(r.offset + r.num_lines * sizeof(uint16_t),
+                         alignof(XShape::Point));
+    indices = points + uint64_t(r.n_points) * sizeof(XShape::Point);
+
+    uint64_t n_indices = 0;
+    for (const auto i : r.n_indices)
+      n_indices += i;
+
+    label = AlignOffset(indices + n_indices * sizeof(uint16_t),
+                        alignof(TCHAR));
+    end = label + uint64_t(r.label_size) * sizeof(TCHAR);
+  }
+};
+
+/**
+ * Maps coordinates to grid cells.
+ */
+struct Grid {
+  double west, south, cell_width, cell_height;
+  unsigned width, height;
+
+  Grid(const GeoBounds &bounds, unsigned _width, unsigned _height) noexcept
+    :west(bounds.GetWest().Native()), south(bounds.GetSouth().Native()),
+     cell_width((bounds.GetEast().Native() - west) / _width),
+     cell_height((bounds.GetNorth().Native() - south) / _height),
+     width(_width), height(_height) {}
+
+  [[gnu::pure]]
+  static unsigned ToCell(double value, double origin, double cell_size,
+                         unsigned n) noexcept {
+    if (!(cell_size > 0))
+      return 0;
+
+    const double cell = std::floor((value - origin) / cell_size);
+    return cell <= 0 ? 0 : std::min(unsigned(cell), n - 1);
+  }
+
+  [[gnu::pure]]
+  unsigned ToColumn(Angle longitude) const noexcept {
+    return ToCell(longitude.Native(), west, cell_width, width);
+  }
+
+  [[gnu::pure]]
+  unsigned ToRow(Angle latitude) const noexcept {
+    return ToCell(latitude.Native(), south, cell_height, height);
+  }
+
+  /**
+   * Call the given function for each cell overlapping the given
+   * bounds.
+   */
+  template<typename F>
+  void ForEachCell(const GeoBounds &bounds, F &&f) const noexcept {
+    unsigned x0 = ToColumn(bounds.GetWest()), x1 = ToColumn(bounds.GetEast());
+    if (bounds.GetWest().Native() > bounds.GetEast().Native()) {
+      /* crosses the date line; don't bother and pick all columns */
+      x0 = 0;
+      x1 = width - 1;
+    }
+
+    const unsigned y0 = ToRow(bounds.GetSouth()), y1 = ToRow(bounds.GetNorth());
+
+    for (unsigned y = y0; y <= y1; ++y)
+      for (unsigned x = x0; x <= x1; ++x)
+        f(y * width + x);
+  }
+};
+
+} // anonymous namespace
+
+TopographyPack::TopographyPack(std::unique_ptr<FileMapping> &&_mapping)
+  :mapping(std::move(_mapping))
+{
+  const std::span<const std::byte> raw = *mapping;
+  base = raw.data();
+  size = raw.size();
+
+  constexpr std::size_t data_offset =
+    FileCache::HEADER_SIZE + sizeof(Header);
+  if (size < data_offset + sizeof(Footer))
+    throw std::runtime_error("Topography pack too small");
+
+  Header header;
+  memcpy(&header, base + FileCache::HEADER_SIZE, sizeof(header));
+  if (header.version != VERSION || header.flags != FLAGS)
+    throw std::runtime_error("Topography pack mismatch");
+
+  const std::size_t footer_offset = size - sizeof(Footer);
+  memcpy(&footer, base + footer_offset, sizeof(footer));
+  if (footer.version != VERSION)
+    throw std::runtime_error("Topography pack mismatch");
+
+  const uint64_t n_cells = uint64_t(footer.grid_width) * footer.grid_height;
+  if (n_cells == 0 ||
+      footer.grid_width > MAX_GRID_SIZE ||
+      footer.grid_height > MAX_GRID_SIZE ||
+      footer.records_offset % alignof(ShapeRecord) != 0 ||
+      footer.cells_offset % alignof(uint32_t) != 0 ||
+      footer.records_offset < data_offset ||
+      footer.records_offset + uint64_t(footer.n_shapes) * sizeof(ShapeRecord) > footer.cells_offset ||
+      footer.cells_offset + (n_cells + 1) * sizeof(uint32_t) > footer_offset)
+    throw std::runtime_error("Malformed topography pack");
+
+  records = reinterpret_cast<const ShapeRecord *>(base + footer.records_offset);
+  cells = reinterpret_cast<const uint32_t *>(base + footer.cells_offset);
+  cell_shapes = cells + n_cells + 1;
+
+  /* verify the grid index */
+
+  if (cells[0] != 0 ||
+      footer.cells_offset + (n_cells + 1 + uint64_t(cells[n_cells])) * sizeof(uint32_t) > footer_offset)
+    throw std::runtime_error("Malformed topography pack");
+
+  for (uint64_t i = 0; i < n_cells; ++i)
+    if (cells[i] > cells[i + 1])
+      throw std::runtime_error("Malformed topography pack");
+
+  for (uint32_t i = 0; i < cells[n_cells]; ++i)
+    if (cell_shapes[i] >= footer.n_shapes)
+      throw std::runtime_error("Malformed topography pack");
+
+  /* verify all shapes now, so a corrupt pack is rejected (and
+     compiled again) instead of failing later in LoadShape() */
+
+  for (uint32_t i = 0; i < footer.n_shapes; ++i)
+    CheckShape(records[i]);
+
+  selected.resize(footer.n_shapes);
+}
+
+TopographyPack::~TopographyPack() noexcept = default;
+
+bool
+TopographyPack::Select(const GeoBounds &bounds) noexcept
+{
+  if (!bounds.Overlaps(footer.bounds))
+    return false;
+
+  std::fill(selected.begin(), selected.end(), false);
+
+  const Grid grid(footer.bounds, footer.grid_width, footer.grid_height);
+  grid.ForEachCell(bounds, [this, &bounds](unsigned cell){
+    for (uint32_t j = cells[cell]; j != cells[cell + 1]; ++j) {
+      const uint32_t i = cell_shapes[j];
+      if (!selected[i] && records[i].bounds.Overlaps(bounds))
+        selected[i] = true;
+    }
+  });
+
+  return true;
+}
+
+void
+TopographyPack::CheckShape(const ShapeRecord &r) const
+{
+  constexpr std::size_t data_offset =
+    FileCache::HEADER_SIZE + sizeof(Header);
+
+  /* check the offset first, or ShapeLayout could overflow */
+  if (r.offset < data_offset ||
+      r.offset >= footer.records_offset ||
+      r.num_lines > XShape::MAX_LINES ||
+      r.label_size > MAX_LABEL_SIZE)
+    throw std::runtime_error("Malformed topography pack");
+
+  const ShapeLayout layout{r};
+  if (layout.end > footer.records_offset)
+    throw std::runtime_error("Malformed topography pack");
+
+  std::array<uint16_t, XShape::MAX_LINES> lines;
+  memcpy(lines.data(), base + r.offset, r.num_lines * sizeof(uint16_t));
+  if (std::accumulate(lines.begin(), std::next(lines.begin(), r.num_lines),
+                      uint64_t{}) != r.n_points)
+    throw std::runtime_error("Malformed topography pack");
+
+#ifdef ENABLE_OPENGL
+  const uint16_t *p = reinterpret_cast<const uint16_t *>(base + layout.indices);
+#endif
+
+  for (std::size_t level = 0; level < THINNING_LEVELS; ++level) {
+    const uint32_t n = r.n_indices[level];
+    if (n == 0)
+      continue;
+
+#ifdef ENABLE_OPENGL
+    /* the counts, followed by the indices (see XShape::BuildIndices()) */
+    uint64_t n_expected;
+    std::size_t n_counts;
+    if (r.type == MS_SHAPE_LINE) {
+      n_counts = r.num_lines;
+      if (n < n_counts)
+        throw std::runtime_error("Malformed topography pack");
+
+      n_expected = std::accumulate(p, p + n_counts, uint64_t{n_counts});
+    } else if (r.type == MS_SHAPE_POLYGON) {
+      n_counts = 1;
+      n_expected = 1 + uint64_t{*p};
+    } else
+      throw std::runtime_error("Malformed topography pack");
+
+    if (n != n_expected ||
+        std::any_of(p + n_counts, p + n, [&r](uint16_t index){
+          return index >= r.n_points;
+        }))
+      throw std::runtime_error("Malformed topography pack");
+
+    p += n;
+#else
+    /* packs compiled without OpenGL have no indices */
+    throw std::runtime_error("Malformed topography pack");
+#endif
+  }
+
+  if (r.label_size > 0) {
+    const TCHAR *label = reinterpret_cast<const TCHAR *>(base + layout.label);
+    if (label[r.label_size - 1] != 0)
+      throw std::runtime_error("Malformed topography pack");
+  }
+}
+
+std::unique_ptr<XShape>
+TopographyPack::LoadShape(std::size_t i) const
+{
+  if (i >= footer.n_shapes)
+    throw std::runtime_error("Malformed topography pack");
+
+  const ShapeRecord &r = records[i];
+  CheckShape(r);
+
+  const ShapeLayout layout{r};
+
+  /* XShape's default constructor is private */
+  std::unique_ptr<XShape> shape{new XShape()};
+  shape->bounds = r.bounds;
+  shape->type = r.type;
+  shape->num_lines = r.num_lines;
+
+  memcpy(shape->lines.data(), base + r.offset,
+         r.num_lines * sizeof(uint16_t));
+
+  shape->points = reinterpret_cast<const XShape::Point *>(base + layout.points);
+
+#ifdef ENABLE_OPENGL
+  const uint16_t *p = reinterpret_cast<const uint16_t *>(base + layout.indices);
+  for (std::size_t level = 0; level < THINNING_LEVELS; ++level) {
+    const uint32_t n = r.n_indices[level];
+    if (n == 0)
+      continue;
+
+    const std::size_t n_counts = r.type == MS_SHAPE_LINE ? r.num_lines : 1;
+    shape->index_count[level] = p;
+    shape->indices[level] = p + n_counts;
+    p += n;
+  }
+#endif
+
+  if (r.label_size > 0)
+    shape->label = BasicAllocatedString<TCHAR>{
+      reinterpret_cast<const TCHAR *>(base + layout.label),
+    };
+
+  return shape;
+}
+
+TopographyPackWriter::TopographyPackWriter(BufferedOutputStream &_os)
+  :os(_os), position(FileCache::HEADER_SIZE)
+{
+  TopographyPack::Header header;
+  header.version = TopographyPack::VERSION;
+  header.flags = TopographyPack::FLAGS;
+  Write(ReferenceAsBytes(header));
+}
+
+void
+TopographyPackWriter::Write(std::span<const std::byte> src)
+{
+  os.Write(src);
+  position += src.size();
+}
+
+void
+TopographyPackWriter::Align(std::size_t alignment)
+{
+  static constexpr std::array<std::byte, 16> zero{};
+
+  const std::size_t n = AlignOffset(position, alignment) - position;
+  assert(n < zero.size());
+  Write(std::span{zero}.first(n));
+}
+
+void
+TopographyPackWriter::Add(const XShape &shape,
+                          [[maybe_unused]] std::span<const float> min_distances)
+{
+  TopographyPack::ShapeRecord r;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(static_cast<void *>(&r), 0, sizeof(r));
+
+  const auto lines = shape.GetLines();
+  const TCHAR *label = shape.GetLabel();
+
+  Align(alignof(XShape::Point));
+  r.offset = position;
+  r.bounds = shape.get_bounds();
+  r.type = shape.get_type();
+  r.num_lines = lines.size();
+  r.n_points = std::accumulate(lines.begin(), lines.end(), uint32_t{});
+  r.label_size = label != nullptr ? StringLength(label) + 1 : 0;
+
+#ifdef ENABLE_OPENGL
+  std::array<XShape::Indices, TopographyPack::THINNING_LEVELS> indices{};
+  if (!lines.empty() &&
+      (r.type == MS_SHAPE_LINE || r.type == MS_SHAPE_POLYGON)) {
+    for (std::size_t level = 0; level < indices.size(); ++level) {
+      indices[level] = shape.GetIndices(level, min_distances[level]);
+      if (indices[level].count == nullptr)
+        continue;
+
+      /* the counts, followed by the indices (see
+         XShape::BuildIndices()) */
+      if (r.type == MS_SHAPE_LINE)
+        r.n_indices[level] = lines.size() +
+          std::accumulate(indices[level].count,
+                          indices[level].count + lines.size(), uint32_t{});
+      else
+        r.n_indices[level] = 1 + *indices[level].count;
+    }
+  }
+#endif
+
+  Write(std::as_bytes(lines));
+  Align(alignof(XShape::Point));
+  Write(std::as_bytes(std::span{shape.GetPoints(), r.n_points}));
+
+#ifdef ENABLE_OPENGL
+  for (std::size_t level = 0; level < indices.size(); ++level)
+    if (r.n_indices[level] > 0)
+      Write(std::as_bytes(std::span{indices[level].count,
+                                    r.n_indices[level]}));
+#endif
+
+  if (label != nullptr) {
+    Align(alignof(TCHAR));
+    Write(std::as_bytes(std::span{label, r.label_size}));
+  }
+
+  assert(position == ShapeLayout{r}.end);
+
+  records.push_back(r);
+}
+
+void
+TopographyPackWriter::Finish(const TopographyPack::Key &key)
+{
+  TopographyPack::Footer footer;
+  memset(static_cast<void *>(&footer), 0, sizeof(footer));
+  footer.version = TopographyPack::VERSION;
+  footer.n_shapes = records.size();
+  footer.key = key;
+
+  /* the grid covers the union of all shape bounds */
+
+  bool first = true;
+  for (const auto &r : records) {
+    if (first) {
+      footer.bounds = r.bounds;
+      first = false;
+    } else {
+      footer.bounds.Extend(r.bounds.GetNorthWest());
+      footer.bounds.Extend(r.bounds.GetSouthEast());
+    }
+  }
+
+  /* about 8 shapes per cell */
+  const unsigned grid_size =
+    std::clamp(unsigned(std::sqrt(records.size() / 8.)), 1U, MAX_GRID_SIZE);
+  footer.grid_width = footer.grid_height = grid_size;
+
+  Align(alignof(TopographyPack::ShapeRecord));
+  footer.records_offset = position;
+  Write(std::as_bytes(std::span{records}));
+
+  /* build the grid index: count the shapes in each cell, convert the
+     counts to start indices, then fill the lists */
+
+  const Grid grid(footer.bounds, grid_size, grid_size);
+  std::vector<uint32_t> cells(grid_size * grid_size + 1);
+  for (const auto &r : records)
+    grid.ForEachCell(r.bounds, [&cells](unsigned cell){
+      ++cells[cell + 1];
+    });
+
+  std::partial_sum(cells.begin(), cells.end(), cells.begin());
+
+  std::vector<uint32_t> cell_shapes(cells.back());
+  std::vector<uint32_t> fill(cells.begin(), std::prev(cells.end()));
+  for (uint32_t i = 0; i < records.size(); ++i)
+    grid.ForEachCell(records[i].bounds, [&](unsigned cell){
+      cell_shapes[fill[cell]++] = i;
+    });
+
+  Align(alignof(uint32_t));
+  footer.cells_offset = position;
+  Write(std::as_bytes(std::span{cells}));
+  Write(std::as_bytes(std::span{cell_shapes}));
+
+  Write(ReferenceAsBytes(footer));
+}
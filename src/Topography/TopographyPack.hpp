@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Geo/GeoBounds.hpp"
+#include "system/Path.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+class FileCache;
+class FileMapping;
+class BufferedOutputStream;
+class XShape;
+
+/**
+ * A precompiled copy of one #TopographyFile.  It is compiled once
+ * from the shapefile (see #TopographyPackWriter) and stored in the
+ * #FileCache; after that, the file is memory-mapped and shapes are
+ * created from it without running shapelib: the points are already
+ * converted (to #ShapePoint on OpenGL), the triangulation and
+ * thinning indices for all levels are precomputed, and a grid index
+ * replaces msShapefileWhichShapes().  The #XShape objects point into
+ * the mapping instead of copying points and indices.
+ *
+ * File layout (after the #FileCache header): a #Header, the data of
+ * each shape (lines, points, indices, label), the #ShapeRecord
+ * table, the grid index (#Footer::cells_offset) and finally the
+ * #Footer.  All offsets are relative to the beginning of the cache
+ * file, which is page-aligned when mapped.
+ */
+class TopographyPack {
+public:
+  static constexpr uint32_t VERSION = 1;
+
+  static constexpr uint32_t FLAG_OPENGL = 0x1;
+  static constexpr uint32_t FLAG_UNICODE = 0x2;
+
+  /**
+   * The flags describing this build; a pack can only be used by a
+   * build with the same flags.
+   */
+  static constexpr uint32_t FLAGS =
+#ifdef ENABLE_OPENGL
+    FLAG_OPENGL |
+#endif
+#ifdef _UNICODE
+    FLAG_UNICODE |
+#endif
+    0;
+
+  static constexpr std::size_t THINNING_LEVELS = 4;
+
+  /**
+   * The settings which affect the contents of a pack.  If they
+   * change, the pack needs to be compiled again.
+   */
+  struct Key {
+    double scale_threshold;
+
+    int32_t label_field;
+
+    /**
+     * Layout::Scale(1) at compile time; it determines how far
+     * shapes are thinned out.
+     */
+    uint32_t layout_scale;
+
+    constexpr bool operator==(const Key &) const noexcept = default;
+  };
+
+  struct Header {
+    uint32_t version;
+    uint32_t flags;
+  };
+
+  struct ShapeRecord {
+    GeoBounds bounds;
+
+    /**
+     * The offset of this shape's data: #num_lines line sizes
+     * (uint16_t), the points (aligned), the indices for each
+     * thinning level and the label (TCHAR, null-terminated).
+     */
+    uint64_t offset;
+
+    uint32_t n_points;
+
+    /**
+     * The number of characters of the label, including the null
+     * terminator; 0 if there is no label.
+     */
+    uint32_t label_size;
+
+    /**
+     * The number of uint16_t values for each thinning level: the
+     * counts (one per line, or one for a polygon), followed by the
+     * indices.  0 means there are no indices for this level.
+     */
+    uint32_t n_indices[THINNING_LEVELS];
+
+    uint8_t type;
+    uint8_t num_lines;
+  };
+
+  struct Footer {
+    uint32_t version;
+    uint32_t n_shapes;
+
+    Key key;
+
+    /**
+     * The area covered by the grid index.
+     */
+    GeoBounds bounds;
+
+    uint32_t grid_width, grid_height;
+
+    uint64_t records_offset;
+
+    /**
+     * An array of (grid_width*grid_height+1) uint32_t values, each
+     * the index of the cell's first entry in the shape list which
+     * follows.  The shape list contains the indices of all shapes
+     * whose bounds overlap the cell.
+     */
+    uint64_t cells_offset;
+  };
+
+private:
+  std::unique_ptr<FileMapping> mapping;
+
+  const std::byte *base;
+  std::size_t size;
+
+  Footer footer;
+
+  const ShapeRecord *records;
+  const uint32_t *cells;
+  const uint32_t *cell_shapes;
+
+  /**
+   * The result of the last Select() call.
+   */
+  std::vector<bool> selected;
+
+public:
+  /**
+   * Throws if the file is malformed.
+   *
+   * @param _mapping a #FileCache mapping (see FileCache::Map())
+   */
+  explicit TopographyPack(std::unique_ptr<FileMapping> &&_mapping);
+
+  ~TopographyPack() noexcept;
+
+  TopographyPack(const TopographyPack &) = delete;
+  TopographyPack &operator=(const TopographyPack &) = delete;
+
+  std::size_t GetShapeCount() const noexcept {
+    return footer.n_shapes;
+  }
+
+  const Key &GetKey() const noexcept {
+    return footer.key;
+  }
+
+  /**
+   * Select all shapes whose bounds overlap the given rectangle.
+   *
+   * @return false if the rectangle is outside of the area covered by
+   * this pack (the selection is unchanged then)
+   */
+  bool Select(const GeoBounds &bounds) noexcept;
+
+  [[gnu::pure]]
+  bool IsSelected(std::size_t i) const noexcept {
+    return selected[i];
+  }
+
+  /**
+   * Create an #XShape which refers to the points and indices in the
+   * memory mapping; it must not outlive this object.
+   *
+   * Throws on error.
+   */
+  std::unique_ptr<XShape> LoadShape(std::size_t i) const;
+
+private:
+  /**
+   * Verify that the data of the given shape lies within the mapping
+   * and is consistent: the line sizes add up to the number of points,
+   * the index counts match and all indices refer to existing points,
+   * and the label is terminated.
+   *
+   * Throws if the shape is malformed.
+   */
+  void CheckShape(const ShapeRecord &r) const;
+};
+
+/**
+ * Writes a #TopographyPack file.  Shapes must be added in the order
+ * of the shapefile.
+ */
+class TopographyPackWriter {
+  BufferedOutputStream &os;
+
+  /**
+   * The offset of the next byte within the cache file.
+   */
+  std::size_t position;
+
+  std::vector<TopographyPack::ShapeRecord> records;
+
+public:
+  /**
+   * Write the header.
+   *
+   * @param _os a stream obtained from FileCache::Save()
+   */
+  explicit TopographyPackWriter(BufferedOutputStream &_os);
+
+  TopographyPackWriter(const TopographyPackWriter &) = delete;
+  TopographyPackWriter &operator=(const TopographyPackWriter &) = delete;
+
+  /**
+   * Throws on error.
+   *
+   * @param min_distances the minimum distance between points for
+   * each thinning level (see XShape::GetIndices()); ignored without
+   * OpenGL
+   */
+  void Add(const XShape &shape, std::span<const float> min_distances);
+
+  /**
+   * Write the shape table, the grid index and the footer.  The
+   * caller is responsible for flushing the stream.
+   *
+   * Throws on error.
+   */
+  void Finish(const TopographyPack::Key &key);
+
+private:
+  void Write(std::span<const std::byte> src);
+  void Align(std::size_t alignment);
+};
+
+/**
+ * Where to find (and store) #TopographyPack files while loading a
+ * #TopographyStore.
+ */
+struct TopographyPackContext {
+  FileCache &cache;
+
+  /**
+   * The map file which contains the topography; it is used to
+   * validate the cache.
+   */
+  Path source;
+
+  /**
+   * Layout::Scale(1), see TopographyPack::Key::layout_scale.
+   */
+  unsigned layout_scale;
+};
@@ -22,7 +22,11 @@ TopographyRenderer::Draw(Canvas &canvas,
                          const WindowProjection &projection) noexcept
 {
   for (auto &i : files)
+#ifdef USE_MEMORY_CANVAS
+    i.Paint(canvas, projection, tiled_rasteriser);
+#else
     i.Paint(canvas, projection);
+#endif
 }
 
 void
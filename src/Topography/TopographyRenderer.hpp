@@ -5,6 +5,10 @@
 
 #include "util/NonCopyable.hpp"
 
+#ifdef USE_MEMORY_CANVAS
+#include "ui/canvas/memory/TiledRasteriser.hpp"
+#endif
+
 #include <forward_list>
 
 class Canvas;
@@ -22,6 +26,10 @@ class TopographyRenderer : private NonCopyable {
 
   std::forward_list<TopographyFileRenderer> files;
 
+#ifdef USE_MEMORY_CANVAS
+  TiledRasteriser tiled_rasteriser;
+#endif
+
 public:
   TopographyRenderer(const TopographyStore &store,
                      const TopographyLook &look) noexcept;
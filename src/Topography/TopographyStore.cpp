@@ -2,10 +2,15 @@
 // Copyright The XCSoar Project
 
 #include "Topography/TopographyStore.hpp"
+#include "Topography/TopographyPack.hpp"
 #include "Index.hpp"
 #include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
 #include "io/LineReader.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "system/ConvertPathName.hpp"
 #include "system/Path.hpp"
 #include "Operation/Operation.hpp"
@@ -13,6 +18,7 @@
 #include "LogFile.hpp"
 
 #include <cstdint>
+#include <string>
 
 #include <windef.h> // for MAX_PATH
 
@@ -34,7 +40,8 @@ TopographyStore::GetNextScaleThreshold(double map_scale) const noexcept
 
 unsigned
 TopographyStore::ScanVisibility(const WindowProjection &m_projection,
-                                unsigned max_update) noexcept
+                                unsigned max_update,
+                                const GeoBounds &prefetch_bounds) noexcept
 {
   // check if any needs to have cache updates because wasnt
   // visible previously when bounds moved
@@ -44,7 +51,7 @@ TopographyStore::ScanVisibility(const WindowProjection &m_projection,
   unsigned num_updated = 0;
   for (auto &file : files) {
     try {
-      if (file.Update(m_projection)) {
+      if (file.Update(m_projection, prefetch_bounds)) {
         ++num_updated;
         if (num_updated >= max_update)
           break;
@@ -65,9 +72,58 @@ TopographyStore::LoadAll() noexcept
     i.LoadAll();
 }
 
+/**
+ * Returns the #FileCache name of the #TopographyPack for the given
+ * shapefile name (from topology.tpl).
+ */
+static std::basic_string<TCHAR>
+MakePackCacheName(std::string_view name)
+{
+  std::basic_string<TCHAR> result{_T("topography-")};
+  /* shapefile names are ASCII */
+  result.append(name.begin(), name.end());
+  return result;
+}
+
+/**
+ * Attempt to load a #TopographyPack for the given file from the
+ * #FileCache; if there is none (or it is stale), compile a new one.
+ * Errors are logged, and the file keeps using shapelib then.
+ */
+static void
+LoadTopographyPack(TopographyFile &file, std::string_view name,
+                   const TopographyPackContext &packs) noexcept
+{
+  const auto cache_name = MakePackCacheName(name);
+
+  try {
+    if (auto mapping = packs.cache.Map(cache_name.c_str(), packs.source);
+        mapping && file.LoadPack(std::move(mapping), packs.layout_scale))
+      return;
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to load topography pack");
+  }
+
+  try {
+    {
+      auto os = packs.cache.Save(cache_name.c_str(), packs.source);
+      BufferedOutputStream bos(*os);
+      file.SavePack(bos, packs.layout_scale);
+      bos.Flush();
+      os->Commit();
+    }
+
+    if (auto mapping = packs.cache.Map(cache_name.c_str(), packs.source))
+      file.LoadPack(std::move(mapping), packs.layout_scale);
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to compile topography pack");
+  }
+}
+
 void
 TopographyStore::Load(NLineReader &reader,
-                      Path directory, struct zzip_dir *zdir) noexcept
+                      Path directory, struct zzip_dir *zdir,
+                      const TopographyPackContext *packs) noexcept
 {
   Reset();
 
@@ -111,7 +167,11 @@ TopographyStore::Load(NLineReader &reader,
                               entry->pen_width);
     } catch (...) {
       LogError(std::current_exception());
+      continue;
     }
+
+    if (packs != nullptr)
+      LoadTopographyPack(*i, entry->name, *packs);
   }
 }
 
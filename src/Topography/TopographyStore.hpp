@@ -11,6 +11,7 @@
 class Path;
 class WindowProjection;
 class NLineReader;
+struct TopographyPackContext;
 struct zzip_dir;
 
 /**
@@ -53,10 +54,13 @@ public:
   /**
    * @param max_update the maximum number of files updated in this
    * call
+   * @param prefetch_bounds see TopographyFile::Update()
    * @return the number of files which were updated
    */
   unsigned ScanVisibility(const WindowProjection &m_projection,
-                          unsigned max_update=1024) noexcept;
+                          unsigned max_update=1024,
+                          const GeoBounds &prefetch_bounds=
+                          GeoBounds::Invalid()) noexcept;
 
   /**
    * Load all shapes of all files into memory.  For debugging
@@ -64,7 +68,12 @@ public:
    */
   void LoadAll() noexcept;
 
+  /**
+   * @param packs if not nullptr, then precompiled #TopographyPack
+   * files are loaded from (and saved to) the given #FileCache
+   */
   void Load(NLineReader &reader,
-            Path directory, struct zzip_dir *zdir = nullptr) noexcept;
+            Path directory, struct zzip_dir *zdir = nullptr,
+            const TopographyPackContext *packs = nullptr) noexcept;
   void Reset() noexcept;
 };
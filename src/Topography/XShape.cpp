@@ -129,8 +129,9 @@ XShape::XShape(const shapeObj &shape, const GeoPoint &file_center,
     ++num_lines;
   }
 
-  points = std::make_unique<Point[]>(num_points);
-  auto *p = points.get();
+  allocated_points = std::make_unique<Point[]>(num_points);
+  points = allocated_points.get();
+  auto *p = allocated_points.get();
   for (std::size_t l = 0; l < num_lines; ++l) {
     const pointObj *src = shape.line[l].point;
     p = std::transform(src, src + lines[l], p,
@@ -158,12 +159,13 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance) noexcept
   if (type == MS_SHAPE_LINE) {
     if (num_points <= 2)
       return false;  // line cannot be simplified, so don't create indices
-    index_count[thinning_level] = std::make_unique<GLushort[]>(num_lines + num_points);
-    idx_count = index_count[thinning_level].get();
+    allocated_indices[thinning_level] = std::make_unique<GLushort[]>(num_lines + num_points);
+    idx_count = allocated_indices[thinning_level].get();
+    index_count[thinning_level] = idx_count;
     indices[thinning_level] = idx = idx_count + num_lines;
 
     const auto end_l = std::next(lines.begin(), num_lines);
-    const ShapePoint *p = points.get();
+    const ShapePoint *p = points;
     unsigned i = 0;
     for (auto l = lines.begin(); l != end_l; ++l) {
       assert(*l >= 2);
@@ -188,17 +190,18 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance) noexcept
     // TODO: free memory saved by thinning (use malloc/realloc or some class?)
     return true;
   } else if (type == MS_SHAPE_POLYGON) {
-    index_count[thinning_level] = std::make_unique<GLushort[]>(1 + 3 * (num_points - 2) + 2 * (num_lines - 1));
-    idx_count = index_count[thinning_level].get();
+    allocated_indices[thinning_level] = std::make_unique<GLushort[]>(1 + 3 * (num_points - 2) + 2 * (num_lines - 1));
+    idx_count = allocated_indices[thinning_level].get();
+    index_count[thinning_level] = idx_count;
     indices[thinning_level] = idx = idx_count + 1;
 
     *idx_count = 0;
-    const ShapePoint *pt = points.get();
+    const ShapePoint *pt = points;
     for (std::size_t i=0; i < num_lines; i++) {
       std::size_t count = PolygonToTriangles(pt, lines[i], idx + *idx_count,
                                              min_distance);
       if (i > 0) {
-        const GLushort offset = pt - points.get();
+        const GLushort offset = pt - points;
         const std::size_t max_idx_count = *idx_count + count;
         for (std::size_t j = *idx_count; j < max_idx_count; j++)
           idx[j] += offset;
@@ -223,7 +226,7 @@ XShape::GetIndices(int thinning_level, ShapeScalar min_distance) const noexcept
       return {};
   }
 
-  return {indices[thinning_level], index_count[thinning_level].get()};
+  return {indices[thinning_level], index_count[thinning_level]};
 }
 
 #endif // ENABLE_OPENGL
@@ -22,11 +22,20 @@
 struct GeoPoint;
 
 class XShape {
+  friend class TopographyPack;
+
   static constexpr std::size_t MAX_LINES = 32;
+
+public:
 #ifdef ENABLE_OPENGL
   static constexpr std::size_t THINNING_LEVELS = 4;
+
+  using Point = ShapePoint;
+#else
+  using Point = GeoPoint;
 #endif
 
+private:
   GeoBounds bounds;
 
   uint8_t type;
@@ -43,22 +52,19 @@ class XShape {
    */
   std::array<uint16_t, MAX_LINES> lines;
 
-#ifdef ENABLE_OPENGL
-  using Point = ShapePoint;
-#else
-  using Point = GeoPoint;
-#endif
-
   /**
-   * All points of all lines.
+   * All points of all lines.  They are either owned by this object
+   * (#allocated_points) or live in a #TopographyPack.
    */
-  std::unique_ptr<Point[]> points;
+  const Point *points = nullptr;
+
+  std::unique_ptr<Point[]> allocated_points;
 
 #ifdef ENABLE_OPENGL
   /**
    * Indices of polygon triangles or lines with reduced number of vertices.
    */
-  std::array<uint16_t *, THINNING_LEVELS> indices{};
+  std::array<const uint16_t *, THINNING_LEVELS> indices{};
 
   /**
    * For polygons this will contain the total number of triangle vertices
@@ -66,7 +72,14 @@ class XShape {
    * For lines there will be an array of size num_lines for each thinning
    * level, which contains the number of points for each line.
    */
-  std::array<std::unique_ptr<uint16_t[]>, THINNING_LEVELS> index_count;
+  std::array<const uint16_t *, THINNING_LEVELS> index_count{};
+
+  /**
+   * The memory allocated by BuildIndices(); both #index_count and
+   * #indices point into it.  This is empty for shapes loaded from a
+   * #TopographyPack.
+   */
+  std::array<std::unique_ptr<uint16_t[]>, THINNING_LEVELS> allocated_indices;
 
   /**
    * The start offset in the #GLArrayBuffer (vertex buffer object).
@@ -77,6 +90,11 @@ class XShape {
 
   BasicAllocatedString<TCHAR> label;
 
+  /**
+   * Used by #TopographyPack, which initializes all attributes.
+   */
+  XShape() noexcept = default;
+
 public:
   /**
    * Throws on error.
@@ -126,7 +144,7 @@ public:
   }
 
   const Point *GetPoints() const noexcept {
-    return points.get();
+    return points;
   }
 
   const TCHAR *GetLabel() const noexcept {
@@ -10,13 +10,24 @@
 #include "net/UniqueSocketDescriptor.hxx"
 #include "util/CRC16CCITT.hpp"
 
+#include <stdexcept>
+
 static UniqueSocketDescriptor
-CreateBindUDP(SocketAddress address)
+CreateBindUDP(SocketAddress address, bool reuse_port)
 {
   UniqueSocketDescriptor s;
   if (!s.Create(address.GetFamily(), SOCK_DGRAM, 0))
     throw MakeSocketError("Failed to create socket");
 
+  if (reuse_port) {
+#ifdef __linux__
+    if (!s.SetReusePort())
+      throw MakeSocketError("Failed to set SO_REUSEPORT");
+#else
+    throw std::runtime_error("SO_REUSEPORT not supported");
+#endif
+  }
+
   if (!s.Bind(address))
     throw MakeSocketError("Failed to connect socket");
 
@@ -26,9 +37,10 @@ CreateBindUDP(SocketAddress address)
 namespace SkyLinesTracking {
 
 Server::Server(EventLoop &event_loop,
-               SocketAddress server_address)
+               SocketAddress server_address,
+               bool reuse_port)
   :socket(event_loop, BIND_THIS_METHOD(OnSocketReady),
-          CreateBindUDP(server_address).Release())
+          CreateBindUDP(server_address, reuse_port).Release())
 {
   socket.ScheduleRead();
 }
@@ -43,7 +55,7 @@ Server::SendBuffer(SocketAddress address,
                    std::span<const std::byte> buffer) noexcept
 {
   try {
-    ssize_t nbytes = socket.GetSocket().WriteNoWait(buffer);
+    ssize_t nbytes = socket.GetSocket().WriteNoWait(buffer, address);
     if (nbytes < 0)
       throw MakeSocketError("Failed to send");
   } catch (...) {
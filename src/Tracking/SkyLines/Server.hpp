@@ -32,7 +32,15 @@ public:
   };
 
 public:
-  Server(EventLoop &event_loop, SocketAddress server_address);
+  /**
+   * Throws on error.
+   *
+   * @param reuse_port set SO_REUSEPORT, to allow several instances
+   * (e.g. one per thread) to share the port; the kernel then
+   * distributes incoming datagrams by source address
+   */
+  Server(EventLoop &event_loop, SocketAddress server_address,
+         bool reuse_port=false);
 
   ~Server();
 
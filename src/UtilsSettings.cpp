@@ -109,7 +109,7 @@ SettingsLeave(const UISettings &old_ui_settings)
   if (WaypointFileChanged || AirfieldFileChanged) {
     // re-load waypoints
     WaypointGlue::LoadWaypoints(way_points, data_components->terrain.get(),
-                                operation);
+                                file_cache, operation);
 
     try {
       WaypointDetails::ReadFileFromProfile(way_points, operation);
@@ -143,7 +143,7 @@ SettingsLeave(const UISettings &old_ui_settings)
 
     auto &topography = *data_components->topography;
     topography.Reset();
-    LoadConfiguredTopography(topography);
+    LoadConfiguredTopography(topography, file_cache);
     main_window.SetTopography(&topography);
   }
 
@@ -157,7 +157,7 @@ SettingsLeave(const UISettings &old_ui_settings)
     airspace_database.Clear();
     ReadAirspace(airspace_database,
                  CommonInterface::GetComputerSettings().pressure,
-                 operation);
+                 file_cache, operation);
 
     if (data_components->terrain)
       SetAirspaceGroundLevels(airspace_database, *data_components->terrain);
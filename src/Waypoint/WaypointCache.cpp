@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "WaypointCache.hpp"
+#include "Factory.hpp"
+#include "Waypoint/Waypoints.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "system/Path.hpp"
+#include "util/SpanCast.hxx"
+#include "util/StringAPI.hxx"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct CacheHeader {
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  /**
+   * The length of the source path (in characters) which follows
+   * this header.
+   */
+  uint32_t source_length;
+
+  uint32_t n_waypoints;
+};
+
+/**
+ * Describes one waypoint.  It is followed by its strings: short
+ * name, name, comment, details and the file names, each preceded by
+ * its length (uint32_t, in characters).
+ */
+struct CacheWaypoint {
+  GeoPoint location;
+  double elevation;
+
+  uint32_t original_id;
+
+  uint16_t n_files_embed, n_files_external;
+
+  Runway runway;
+  RadioFrequency radio_frequency;
+
+  Waypoint::Type type;
+  WaypointOrigin origin;
+
+  /**
+   * A bit field of #FLAG_TURN_POINT etc.
+   */
+  uint8_t flags;
+
+  bool has_elevation;
+};
+
+static_assert(std::is_trivially_copyable_v<CacheWaypoint>);
+
+static constexpr uint8_t FLAG_TURN_POINT = 0x1;
+static constexpr uint8_t FLAG_HOME = 0x2;
+static constexpr uint8_t FLAG_START_POINT = 0x4;
+static constexpr uint8_t FLAG_FINISH_POINT = 0x8;
+
+/* limits to reject corrupt files before allocating memory */
+static constexpr uint32_t MAX_STRING_LENGTH = 1024 * 1024;
+
+/**
+ * Reads values from a memory buffer, throwing if it ends too early.
+ */
+class CacheReader {
+  std::span<const std::byte> src;
+
+public:
+  explicit CacheReader(std::span<const std::byte> _src) noexcept
+    :src(_src) {}
+
+  std::span<const std::byte> Read(std::size_t size) {
+    if (size > src.size())
+      throw std::runtime_error("Truncated waypoint cache");
+
+    auto result = src.first(size);
+    src = src.subspan(size);
+    return result;
+  }
+
+  template<typename T>
+  T ReadT() {
+    T value;
+    memcpy(static_cast<void *>(&value), Read(sizeof(value)).data(),
+           sizeof(value));
+    return value;
+  }
+
+  tstring ReadString(std::size_t length) {
+    if (length > MAX_STRING_LENGTH)
+      throw std::runtime_error("Malformed waypoint cache");
+
+    tstring s(length, TCHAR{});
+    memcpy(s.data(), Read(length * sizeof(TCHAR)).data(),
+           length * sizeof(TCHAR));
+    return s;
+  }
+
+  tstring ReadString() {
+    return ReadString(ReadT<uint32_t>());
+  }
+};
+
+} // anonymous namespace
+
+static void
+WriteString(BufferedOutputStream &os, tstring_view s)
+{
+  os.WriteT<uint32_t>(s.size());
+  os.Write(std::as_bytes(std::span{s}));
+}
+
+template<typename L>
+[[gnu::pure]]
+static uint16_t
+CountFiles(const L &list) noexcept
+{
+  return std::min<std::size_t>(std::distance(list.begin(), list.end()),
+                               UINT16_MAX);
+}
+
+template<typename L>
+static void
+WriteFiles(BufferedOutputStream &os, const L &list, uint16_t n)
+{
+  for (const auto &i : list) {
+    if (n-- == 0)
+      break;
+
+    WriteString(os, i);
+  }
+}
+
+static void
+SaveWaypoint(BufferedOutputStream &os, const Waypoint &waypoint)
+{
+  CacheWaypoint header;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(static_cast<void *>(&header), 0, sizeof(header));
+
+  header.location = waypoint.location;
+  header.elevation = waypoint.elevation;
+  header.original_id = waypoint.original_id;
+  header.n_files_embed = CountFiles(waypoint.files_embed);
+#ifdef HAVE_RUN_FILE
+  header.n_files_external = CountFiles(waypoint.files_external);
+#else
+  header.n_files_external = 0;
+#endif
+  header.runway = waypoint.runway;
+  header.radio_frequency = waypoint.radio_frequency;
+  header.type = waypoint.type;
+  header.origin = waypoint.origin;
+  header.flags = (waypoint.flags.turn_point ? FLAG_TURN_POINT : 0) |
+    (waypoint.flags.home ? FLAG_HOME : 0) |
+    (waypoint.flags.start_point ? FLAG_START_POINT : 0) |
+    (waypoint.flags.finish_point ? FLAG_FINISH_POINT : 0);
+  header.has_elevation = waypoint.has_elevation;
+
+  os.Write(ReferenceAsBytes(header));
+  WriteString(os, waypoint.shortname);
+  WriteString(os, waypoint.name);
+  WriteString(os, waypoint.comment);
+  WriteString(os, waypoint.details);
+  WriteFiles(os, waypoint.files_embed, header.n_files_embed);
+#ifdef HAVE_RUN_FILE
+  WriteFiles(os, waypoint.files_external, header.n_files_external);
+#endif
+}
+
+/**
+ * Read a list of file names, preserving their order.
+ */
+static std::forward_list<tstring>
+ReadFiles(CacheReader &r, unsigned n)
+{
+  std::forward_list<tstring> list;
+  auto i = list.before_begin();
+  while (n-- > 0)
+    i = list.insert_after(i, r.ReadString());
+  return list;
+}
+
+static Waypoint
+LoadWaypoint(CacheReader &r)
+{
+  const auto header = r.ReadT<CacheWaypoint>();
+  if (!header.location.Check() ||
+      unsigned(header.type) > unsigned(Waypoint::Type::PGLANDING) ||
+      unsigned(header.origin) > unsigned(WaypointOrigin::MAP))
+    throw std::runtime_error("Malformed waypoint cache");
+
+  Waypoint waypoint(header.location);
+  waypoint.elevation = header.elevation;
+  waypoint.has_elevation = header.has_elevation;
+  waypoint.original_id = header.original_id;
+  waypoint.runway = header.runway;
+  waypoint.radio_frequency = header.radio_frequency;
+  waypoint.type = header.type;
+  waypoint.origin = header.origin;
+  waypoint.flags.turn_point = header.flags & FLAG_TURN_POINT;
+  waypoint.flags.home = header.flags & FLAG_HOME;
+  waypoint.flags.start_point = header.flags & FLAG_START_POINT;
+  waypoint.flags.finish_point = header.flags & FLAG_FINISH_POINT;
+
+  waypoint.shortname = r.ReadString();
+  waypoint.name = r.ReadString();
+  waypoint.comment = r.ReadString();
+  waypoint.details = r.ReadString();
+  waypoint.files_embed = ReadFiles(r, header.n_files_embed);
+
+#ifdef HAVE_RUN_FILE
+  waypoint.files_external = ReadFiles(r, header.n_files_external);
+#else
+  /* skip them */
+  ReadFiles(r, header.n_files_external);
+#endif
+
+  return waypoint;
+}
+
+void
+SaveWaypointCache(BufferedOutputStream &os, Path source,
+                  const Waypoints &waypoints)
+{
+  /* the Waypoints container is ordered by location; sort by id to
+     restore the order of the file */
+  std::vector<const Waypoint *> sorted;
+  sorted.reserve(waypoints.size());
+  for (const auto &i : waypoints)
+    sorted.push_back(i.get());
+
+  std::sort(sorted.begin(), sorted.end(), [](const auto *a, const auto *b){
+    return a->id < b->id;
+  });
+
+  CacheHeader header;
+  header.version = CacheHeader::VERSION;
+  header.source_length = StringLength(source.c_str());
+  header.n_waypoints = sorted.size();
+
+  os.Write(ReferenceAsBytes(header));
+  os.Write(std::as_bytes(std::span{source.c_str(), header.source_length}));
+
+  for (const auto *i : sorted)
+    SaveWaypoint(os, *i);
+}
+
+bool
+LoadWaypointCache(std::span<const std::byte> src, Path source,
+                  Waypoints &waypoints, const WaypointFactory &factory)
+{
+  CacheReader r{src};
+
+  const auto header = r.ReadT<CacheHeader>();
+  if (header.version != CacheHeader::VERSION)
+    throw std::runtime_error("Malformed waypoint cache header");
+
+  if (r.ReadString(header.source_length) != source.c_str())
+    return false;
+
+  /* decode everything before appending, because a failure in the
+     middle would leave a partial set */
+  std::vector<Waypoint> loaded;
+  loaded.reserve(std::min<std::size_t>(header.n_waypoints,
+                                       src.size() / sizeof(CacheWaypoint)));
+  for (uint32_t i = 0; i < header.n_waypoints; ++i)
+    loaded.push_back(LoadWaypoint(r));
+
+  for (auto &i : loaded) {
+    if (!i.has_elevation)
+      factory.FallbackElevation(i);
+
+    waypoints.Append(std::move(i));
+  }
+
+  return true;
+}
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+class Path;
+class Waypoints;
+class WaypointFactory;
+class BufferedOutputStream;
+
+/**
+ * Write a snapshot of all waypoints in the #Waypoints object, in the
+ * order they were added.  The snapshot contains the parsed
+ * attributes, so loading it does not need to run the file parser.
+ *
+ * Throws on error.
+ *
+ * @param source the path of the file these waypoints were parsed
+ * from; it is stored to detect configuration changes
+ */
+void
+SaveWaypointCache(BufferedOutputStream &os, Path source,
+                  const Waypoints &waypoints);
+
+/**
+ * Load a snapshot written by SaveWaypointCache() and append its
+ * waypoints to the given #Waypoints object.  Nothing is appended if
+ * the snapshot is malformed.
+ *
+ * Throws on error.
+ *
+ * @param src the snapshot (e.g. a memory-mapped #FileCache file
+ * after its header)
+ * @param factory provides the fallback elevation for waypoints which
+ * have none
+ * @return false if the snapshot was created from a different file
+ */
+bool
+LoadWaypointCache(std::span<const std::byte> src, Path source,
+                  Waypoints &waypoints, const WaypointFactory &factory);
@@ -8,15 +8,109 @@
 #include "LogFile.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "WaypointReader.hpp"
+#include "WaypointCache.hpp"
 #include "Language/Language.hpp"
 #include "LocalPath.hpp"
 #include "Operation/Operation.hpp"
 #include "system/Path.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "io/MapFile.hpp"
 #include "io/ZipArchive.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace WaypointGlue {
 
+static bool
+LoadWaypointCache(FileCache &cache, const TCHAR *cache_name, Path path,
+                  Waypoints &waypoints,
+                  const WaypointFactory &factory) noexcept
+try {
+  const auto mapping = cache.Map(cache_name, path);
+  if (!mapping)
+    return false;
+
+  const std::span<const std::byte> raw = *mapping;
+  if (raw.size() < FileCache::HEADER_SIZE)
+    return false;
+
+  return LoadWaypointCache(raw.subspan(FileCache::HEADER_SIZE),
+                           path, waypoints, factory);
+} catch (...) {
+  LogError(std::current_exception(), "Failed to load waypoint cache");
+  return false;
+}
+
+static void
+SaveWaypointCache(FileCache &cache, const TCHAR *cache_name, Path path,
+                  const Waypoints &waypoints) noexcept
+try {
+  auto os = cache.Save(cache_name, path);
+  BufferedOutputStream bos(*os);
+  SaveWaypointCache(bos, path, waypoints);
+  bos.Flush();
+  os->Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save waypoint cache");
+}
+
+/**
+ * Invoke the parser (with a #WaypointFactory), unless there is a
+ * cached copy which is not older than #path.
+ *
+ * The cache does not depend on the terrain: the parser runs without
+ * it, and the fallback elevation is applied while copying the
+ * waypoints to the destination.
+ *
+ * @param cache the #FileCache or nullptr to disable caching
+ * @param path the path of the file (or the map file containing it)
+ * to validate the cache
+ */
+template<typename F>
+static void
+ParseCachedWaypointFile(Waypoints &waypoints,
+                        FileCache *cache, const TCHAR *cache_name, Path path,
+                        WaypointOrigin origin, const RasterTerrain *terrain,
+                        F &&parse)
+{
+  const WaypointFactory factory(origin, terrain);
+
+  if (cache == nullptr) {
+    parse(waypoints, factory);
+    return;
+  }
+
+  if (LoadWaypointCache(*cache, cache_name, path, waypoints, factory))
+    return;
+
+  Waypoints parsed;
+  parse(parsed, WaypointFactory(origin));
+
+  SaveWaypointCache(*cache, cache_name, path, parsed);
+
+  std::vector<const Waypoint *> sorted;
+  sorted.reserve(parsed.size());
+  for (const auto &i : parsed)
+    sorted.push_back(i.get());
+
+  /* preserve the order of the file */
+  std::sort(sorted.begin(), sorted.end(), [](const auto *a, const auto *b){
+    return a->id < b->id;
+  });
+
+  for (const auto *i : sorted) {
+    Waypoint w = *i;
+    if (!w.has_elevation)
+      factory.FallbackElevation(w);
+
+    waypoints.Append(std::move(w));
+  }
+}
+
 static bool
 LoadWaypointFile(Waypoints &waypoints, Path path,
                  WaypointFileType file_type,
@@ -36,13 +130,16 @@ try {
 
 static bool
 LoadWaypointFile(Waypoints &waypoints, Path path,
+                 FileCache *cache, const TCHAR *cache_name,
                  WaypointOrigin origin,
                  const RasterTerrain *terrain,
                  ProgressListener &progress) noexcept
 try {
-  ReadWaypointFile(path, waypoints,
-                   WaypointFactory(origin, terrain),
-                   progress);
+  ParseCachedWaypointFile(waypoints, cache, cache_name, path,
+                          origin, terrain,
+                          [&](Waypoints &dest, const WaypointFactory &factory){
+    ReadWaypointFile(path, dest, factory, progress);
+  });
   return true;
 } catch (...) {
   LogFormat(_T("Failed to read waypoint file: %s"), path.c_str());
@@ -53,13 +150,16 @@ try {
 static bool
 LoadWaypointFile(Waypoints &waypoints, struct zzip_dir *dir, const char *path,
                  WaypointFileType file_type,
+                 Path archive_path, FileCache *cache, const TCHAR *cache_name,
                  WaypointOrigin origin,
                  const RasterTerrain *terrain,
                  ProgressListener &progressg) noexcept
 try {
-  ReadWaypointFile(dir, path, file_type, waypoints,
-                   WaypointFactory(origin, terrain),
-                   progressg);
+  ParseCachedWaypointFile(waypoints, cache, cache_name, archive_path,
+                          origin, terrain,
+                          [&](Waypoints &dest, const WaypointFactory &factory){
+    ReadWaypointFile(dir, path, file_type, dest, factory, progressg);
+  });
   return true;
 } catch (...) {
   LogFormat(_T("Failed to read waypoint file: %s"), path);
@@ -69,7 +169,7 @@ try {
 
 bool
 LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
-              ProgressListener &progress)
+              FileCache *cache, ProgressListener &progress)
 {
   bool found = false;
 
@@ -79,20 +179,20 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   // ### FIRST FILE ###
   auto path = Profile::GetPath(ProfileKeys::WaypointFile);
   if (path != nullptr)
-    found |= LoadWaypointFile(way_points, path, WaypointOrigin::PRIMARY,
-                              terrain, progress);
+    found |= LoadWaypointFile(way_points, path, cache, _T("waypoints"),
+                              WaypointOrigin::PRIMARY, terrain, progress);
 
   // ### SECOND FILE ###
   path = Profile::GetPath(ProfileKeys::AdditionalWaypointFile);
   if (path != nullptr)
-    found |= LoadWaypointFile(way_points, path, WaypointOrigin::ADDITIONAL,
-                              terrain, progress);
+    found |= LoadWaypointFile(way_points, path, cache, _T("waypoints-additional"),
+                              WaypointOrigin::ADDITIONAL, terrain, progress);
 
   // ### WATCHED WAYPOINT/THIRD FILE ###
   path = Profile::GetPath(ProfileKeys::WatchedWaypointFile);
   if (path != nullptr)
-    found |= LoadWaypointFile(way_points, path, WaypointOrigin::WATCHED,
-                              terrain, progress);
+    found |= LoadWaypointFile(way_points, path, cache, _T("waypoints-watched"),
+                              WaypointOrigin::WATCHED, terrain, progress);
 
   // ### MAP/FOURTH FILE ###
 
@@ -100,13 +200,17 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   if (!found) {
     try {
       if (auto archive = OpenMapFile()) {
+        const auto map_path = Profile::GetPath(ProfileKeys::MapFile);
+
         found |= LoadWaypointFile(way_points, archive->get(), "waypoints.xcw",
                                   WaypointFileType::WINPILOT,
+                                  map_path, cache, _T("waypoints-map-xcw"),
                                   WaypointOrigin::MAP,
                                   terrain, progress);
 
         found |= LoadWaypointFile(way_points, archive->get(), "waypoints.cup",
                                   WaypointFileType::SEEYOU,
+                                  map_path, cache, _T("waypoints-map-cup"),
                                   WaypointOrigin::MAP,
                                   terrain, progress);
       }
@@ -12,6 +12,7 @@ struct PlacesOfInterestSettings;
 struct TeamCodeSettings;
 class DeviceBlackboard;
 class ProfileMap;
+class FileCache;
 
 /**
  * This class is used to parse different waypoint files
@@ -86,10 +87,13 @@ SaveHome(ProfileMap &profile,
  * specified waypoint list
  * @param way_points The waypoint list to fill
  * @param terrain RasterTerrain (for automatic waypoint height)
+ * @param cache a #FileCache for parsed waypoint files; nullptr
+ * disables caching
  */
 bool
 LoadWaypoints(Waypoints &way_points,
               const RasterTerrain *terrain,
+              FileCache *cache,
               ProgressListener &progress);
 
 /**
@@ -5,17 +5,25 @@
 
 #include "system/Path.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <stdio.h>
 #include <tchar.h>
 
 class Reader;
 class FileOutputStream;
+class FileMapping;
 
 class FileCache {
   AllocatedPath cache_path;
 
 public:
+  /**
+   * The size of the header which precedes the payload in each cache
+   * file.
+   */
+  static constexpr std::size_t HEADER_SIZE = 4 + 8 + 8;
+
   FileCache(AllocatedPath &&_cache_path);
 
 protected:
@@ -32,6 +40,15 @@ public:
    */
   std::unique_ptr<Reader> Load(const TCHAR *name, Path original_path) noexcept;
 
+  /**
+   * Like Load(), but map the whole cache file into memory.  The
+   * payload begins at #HEADER_SIZE.
+   *
+   * Returns nullptr on error.
+   */
+  std::unique_ptr<FileMapping> Map(const TCHAR *name,
+                                   Path original_path) noexcept;
+
   /**
    * Throws on error.
    */
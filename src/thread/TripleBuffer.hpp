@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Passes the most recent version of an object from one producer
+ * thread to one consumer thread without locking.  The producer fills
+ * the "back" slot and publishes it; the consumer picks up the latest
+ * published slot.  Intermediate versions which were not picked up
+ * are overwritten.
+ *
+ * There must be only one producer and one consumer at a time; the
+ * caller is responsible for serializing them.
+ */
+template<typename T>
+class TripleBuffer {
+  static constexpr uint_least8_t INDEX_MASK = 0x3;
+
+  /**
+   * This flag is set in #middle when the producer has published a
+   * slot which was not yet picked up by the consumer.
+   */
+  static constexpr uint_least8_t FRESH = 0x4;
+
+  std::array<T, 3> slots;
+
+  /**
+   * The index of the slot which is exchanged between producer and
+   * consumer, plus the #FRESH flag.
+   */
+  std::atomic<uint_least8_t> middle{1};
+
+  /**
+   * The index of the slot owned by the producer.
+   */
+  uint_least8_t back = 0;
+
+  /**
+   * The index of the slot owned by the consumer.
+   */
+  uint_least8_t front = 2;
+
+public:
+  /**
+   * Returns the slot the producer may write to.
+   */
+  T &GetBack() noexcept {
+    return slots[back];
+  }
+
+  /**
+   * Publish the back slot.  After this call, GetBack() returns a
+   * different slot with undefined (old) contents.
+   */
+  void Publish() noexcept {
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel)
+      & INDEX_MASK;
+  }
+
+  /**
+   * Pick up the slot published most recently, if there is a new
+   * one.
+   *
+   * @return true if GetFront() returns a new version
+   */
+  bool Consume() noexcept {
+    if ((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+      return false;
+
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+
+  /**
+   * Returns the slot picked up by the last successful Consume() call.
+   */
+  const T &GetFront() const noexcept {
+    return slots[front];
+  }
+};
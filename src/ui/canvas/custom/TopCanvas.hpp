@@ -34,6 +34,10 @@
 
 #include <cstdint>
 
+#if defined(USE_FB) || defined(USE_VFB)
+#include <chrono>
+#endif
+
 #ifdef SOFTWARE_ROTATE_DISPLAY
 enum class DisplayOrientation : uint8_t;
 #endif
@@ -43,6 +47,7 @@ struct SDL_Renderer;
 struct SDL_Texture;
 class Canvas;
 struct PixelSize;
+struct PixelRect;
 namespace UI { class Display; }
 
 #if defined(USE_FB) && !defined(KOBO)
@@ -102,6 +107,58 @@ class TopCanvas
 #endif
 #endif /* USE_MEMORY_CANVAS */
 
+#if defined(USE_FB) || defined(USE_VFB)
+public:
+  /**
+   * Counters describing the work done by Flip().
+   */
+  struct FlipStatistics {
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+    uint_least64_t flips = 0;
+
+    /**
+     * The number of Flip() calls which updated only parts of the
+     * screen.
+     */
+    uint_least64_t partial = 0;
+
+    /**
+     * The number of Flip() calls which found no change.
+     */
+    uint_least64_t unchanged = 0;
+
+    /**
+     * The number of bytes of #buffer which were converted to the
+     * frame buffer.
+     */
+    uint_least64_t converted_bytes = 0;
+
+    /**
+     * The number of bytes which would have been converted by full
+     * screen updates.
+     */
+    uint_least64_t total_bytes = 0;
+  };
+
+private:
+  /**
+   * A copy of #buffer as it was during the last Flip().  Comparing
+   * with it finds the regions which have changed; only those are
+   * converted and sent to the display.
+   */
+  decltype(buffer) previous = decltype(buffer)::Empty();
+
+  /**
+   * Does #previous contain the last frame?  If not, the next Flip()
+   * updates the whole screen.
+   */
+  bool previous_valid = false;
+
+  FlipStatistics flip_statistics;
+#endif
+
 #ifdef USE_FB
   int fd = -1;
 
@@ -228,6 +285,12 @@ public:
 
   void Flip();
 
+#if defined(USE_FB) || defined(USE_VFB)
+  const FlipStatistics &GetFlipStatistics() const noexcept {
+    return flip_statistics;
+  }
+#endif
+
 #ifdef KOBO
   /**
    * Wait until the screen update is complete.
@@ -236,6 +299,9 @@ public:
 
   void SetEnableDither(bool _enable_dither) noexcept {
     enable_dither = _enable_dither;
+
+    /* the whole screen needs to be converted again */
+    previous_valid = false;
   }
 #endif
 
@@ -251,4 +317,21 @@ private:
 #ifdef USE_EGL
   void CreateSurface(EGLNativeWindowType native_window);
 #endif
+
+#ifdef USE_FB
+  /**
+   * Is #buffer converted to the frame buffer with error diffusion
+   * dithering?
+   */
+  bool IsDithering() const noexcept;
+
+  /**
+   * Convert a portion of #buffer to the frame buffer.
+   */
+  void Export(const PixelRect &rc) noexcept;
+#endif
+
+#ifdef KOBO
+  void SendUpdate(const PixelRect &rc, bool full) noexcept;
+#endif
 };
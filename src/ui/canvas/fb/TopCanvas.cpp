@@ -3,7 +3,9 @@
 
 #include "ui/canvas/custom/TopCanvas.hpp"
 #include "ui/canvas/Canvas.hpp"
+#include "ui/canvas/memory/Damage.hpp"
 #include "lib/fmt/SystemError.hxx"
+#include "LogFile.hpp"
 
 #ifdef USE_FB
 #include "ui/canvas/memory/Export.hpp"
@@ -65,7 +67,21 @@ GetSize(const struct fb_var_screeninfo &vinfo) noexcept
 
 TopCanvas::~TopCanvas() noexcept
 {
+  const auto &stats = flip_statistics;
+  const std::chrono::duration<double> duration =
+    std::chrono::steady_clock::now() - stats.start;
+  if (stats.flips > 0 && duration.count() > 0)
+    LogFormat("Flip: %llu frames (%llu partial, %llu unchanged), "
+              "converted %llu of %llu kB, %.0f kB/s",
+              (unsigned long long)stats.flips,
+              (unsigned long long)stats.partial,
+              (unsigned long long)stats.unchanged,
+              (unsigned long long)(stats.converted_bytes / 1024),
+              (unsigned long long)(stats.total_bytes / 1024),
+              stats.converted_bytes / 1024. / duration.count());
+
   buffer.Free();
+  previous.Free();
 
 #ifdef USE_FB
   if (fd >= 0) {
@@ -175,6 +191,7 @@ TopCanvas::TopCanvas(UI::Display &_display)
                            vinfo.width, vinfo.height);
 
   buffer.Allocate(new_size);
+  previous.Allocate(new_size);
 }
 
 inline PixelSize
@@ -197,6 +214,7 @@ TopCanvas::TopCanvas(UI::Display &_display, PixelSize new_size)
   :display(_display)
 {
   buffer.Allocate(new_size);
+  previous.Allocate(new_size);
 
   // suppress -Wunused
   (void)display;
@@ -225,6 +243,9 @@ TopCanvas::CheckResize(const PixelSize new_native_size) noexcept
 
   buffer.Free();
   buffer.Allocate(new_size);
+  previous.Free();
+  previous.Allocate(new_size);
+  previous_valid = false;
   return true;
 }
 
@@ -239,36 +260,57 @@ TopCanvas::Unlock() noexcept
 {
 }
 
-void
-TopCanvas::Flip()
-{
 #ifdef USE_FB
 
+inline bool
+TopCanvas::IsDithering() const noexcept
+{
+#if defined(KOBO) && defined(DITHER)
+  return enable_dither;
+#elif defined(DITHER)
+  return true;
+#else
+  return false;
+#endif
+}
+
+inline void
+TopCanvas::Export(const PixelRect &rc) noexcept
+{
+  auto *dest = (uint8_t *)map + rc.top * map_pitch + rc.left * map_bpp;
+  const decltype(ConstImageBuffer{buffer}) src{
+    buffer.At(rc.left, rc.top), buffer.pitch, rc.GetSize(),
+  };
+
 #ifdef GREYSCALE
   CopyFromGreyscale(
 #ifdef DITHER
-                    dither,
+                    dither, unsigned(rc.top),
 #endif
 #ifdef KOBO
                     enable_dither,
 #endif
-                    map, map_pitch, map_bpp,
-                    buffer);
+                    dest, map_pitch, map_bpp,
+                    src);
 #else
-  CopyFromBGRA(map, map_pitch, map_bpp, buffer);
+  CopyFromBGRA(dest, map_pitch, map_bpp, src);
 #endif
+}
 
+#endif
 
 #ifdef KOBO
-  if (frame_sync)
-    Wait();
 
+inline void
+TopCanvas::SendUpdate(const PixelRect &rc, bool full) noexcept
+{
   epd_update_marker++;
 
   KoboModel kobo_model = DetectKoboModel();
   struct mxcfb_update_data epd_update_data = {
     {
-      0, 0, buffer.size.width, buffer.size.height
+      uint32_t(rc.top), uint32_t(rc.left),
+      rc.GetWidth(), rc.GetHeight(),
     },
 
     uint32_t(enable_dither &&
@@ -282,16 +324,94 @@ TopCanvas::Flip()
               kobo_model == KoboModel::CLARA_2E)
              ? WAVEFORM_MODE_A2
              : WAVEFORM_MODE_AUTO),
-    UPDATE_MODE_FULL, // PARTIAL
+    uint32_t(full ? UPDATE_MODE_FULL : UPDATE_MODE_PARTIAL),
     epd_update_marker,
     TEMP_USE_AMBIENT,
     enable_dither ? EPDC_FLAG_FORCE_MONOCHROME : 0,
   };
 
   ioctl(fd, MXCFB_SEND_UPDATE, &epd_update_data);
+}
+
+#endif
+
+void
+TopCanvas::Flip()
+{
+  const PixelRect screen_rect{buffer.size};
+  const std::size_t screen_area =
+    std::size_t(buffer.size.width) * buffer.size.height;
+  constexpr std::size_t pixel_size = sizeof(*buffer.data);
+
+  ++flip_statistics.flips;
+  flip_statistics.total_bytes += screen_area * pixel_size;
+
+  bool full = !previous_valid;
+
+#ifdef USE_FB
+  const bool dithering = IsDithering();
+#else
+  constexpr bool dithering = false;
+#endif
+
+#if defined(USE_FB) && defined(GREYSCALE) && defined(DITHER) && !defined(KOBO)
+  /* CopyFromGreyscale() expands dithered pixels to 32 bit in-place,
+     which works only for the whole screen */
+  if (map_bpp != 1)
+    full = true;
 #endif
 
-#endif /* USE_FB */
+  DamageList damage;
+  if (!full) {
+    FindDamage(damage, ConstImageBuffer{buffer}, ConstImageBuffer{previous});
+    if (damage.empty()) {
+      ++flip_statistics.unchanged;
+      return;
+    }
+
+    /* with a lot of changes, one full update is cheaper than
+       several partial ones, and it cleans up e-ink ghosting */
+    if (GetArea(damage) * 2 >= screen_area)
+      full = true;
+  }
+
+  if (full) {
+    damage.clear();
+    damage.push_back(screen_rect);
+  } else {
+    ++flip_statistics.partial;
+
+    if (dithering)
+      ExtendDamageForDither(damage, buffer.size);
+  }
+
+  for (const auto &rc : damage) {
+    PixelRect export_rc = rc;
+#ifdef DITHER
+    /* error diffusion dithering resumes at the last checkpoint above
+       the damage to give the same result as a full conversion; the
+       rows in between get the same values again */
+    if (dithering)
+      export_rc.top = dither.GetResumeRow(buffer.size.width, rc.top);
+#endif
+
+#ifdef USE_FB
+    Export(export_rc);
+#endif
+    CopyDamage(previous, ConstImageBuffer{buffer}, rc);
+    flip_statistics.converted_bytes +=
+      std::size_t(export_rc.GetWidth()) * export_rc.GetHeight() * pixel_size;
+  }
+
+  previous_valid = true;
+
+#ifdef KOBO
+  if (frame_sync)
+    Wait();
+
+  for (const auto &rc : damage)
+    SendUpdate(rc, full);
+#endif
 }
 
 #ifdef KOBO
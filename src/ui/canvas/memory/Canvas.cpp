@@ -6,6 +6,7 @@
 #include "ui/canvas/Util.hpp"
 #include "Optimised.hpp"
 #include "RasterCanvas.hpp"
+#include "TiledRasteriser.hpp"
 #include "ui/canvas/custom/Cache.hpp"
 #include "Math/Angle.hpp"
 
@@ -23,6 +24,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <utility> // for std::exchange()
 #include <string.h>
 
 class SDLRasterCanvas : public RasterCanvas<ActivePixelTraits> {
@@ -83,6 +85,13 @@ DrawPolyline(Canvas &canvas, [[maybe_unused]] PixelOperations operations, const
 void
 Canvas::DrawPolyline(const BulkPixelPoint *p, unsigned cPoints)
 {
+  if (tiled != nullptr) {
+    tiled->DrawPolyline(p, cPoints, false,
+                        SDLRasterCanvas::Import(pen.GetColor()),
+                        pen.GetWidth(), pen.GetMask());
+    return;
+  }
+
   SDLRasterCanvas canvas(buffer);
   ::DrawPolyline(canvas, ActivePixelTraits(), pen,
                  p, cPoints, false);
@@ -94,6 +103,19 @@ Canvas::DrawPolygon(const BulkPixelPoint *lppt, unsigned cPoints)
   if (brush.IsHollow() && !pen.IsDefined())
     return;
 
+  if (tiled != nullptr) {
+    if (!brush.IsHollow())
+      tiled->FillPolygon(lppt, cPoints,
+                         SDLRasterCanvas::Import(brush.GetColor()),
+                         brush.GetColor().Alpha());
+
+    if (IsPenOverBrush())
+      tiled->DrawPolyline(lppt, cPoints, true,
+                          SDLRasterCanvas::Import(pen.GetColor()),
+                          pen.GetWidth(), pen.GetMask());
+    return;
+  }
+
   SDLRasterCanvas canvas(buffer);
 
   if (!brush.IsHollow()) {
@@ -110,6 +132,23 @@ Canvas::DrawPolygon(const BulkPixelPoint *lppt, unsigned cPoints)
                    lppt, cPoints, true);
 }
 
+void
+Canvas::BeginTiled(TiledRasteriser &_tiled) noexcept
+{
+  assert(tiled == nullptr);
+
+  tiled = &_tiled;
+  tiled->Begin(buffer);
+}
+
+void
+Canvas::EndTiled() noexcept
+{
+  assert(tiled != nullptr);
+
+  std::exchange(tiled, nullptr)->Flush();
+}
+
 void
 Canvas::DrawHLine(int x1, int x2, int y, Color color)
 {
@@ -25,6 +25,7 @@
 
 class Angle;
 class Bitmap;
+class TiledRasteriser;
 
 /**
  * Base drawable canvas class
@@ -46,6 +47,12 @@ protected:
     OPAQUE, TRANSPARENT
   } background_mode = OPAQUE;
 
+  /**
+   * If set, then DrawPolygon() and DrawPolyline() are recorded here
+   * instead of being drawn immediately; see BeginTiled().
+   */
+  TiledRasteriser *tiled = nullptr;
+
 public:
   Canvas()
     :buffer(WritableImageBuffer<ActivePixelTraits>::Empty()) {}
@@ -201,6 +208,23 @@ public:
   void DrawPolyline(const BulkPixelPoint *points, unsigned num_points);
   void DrawPolygon(const BulkPixelPoint *points, unsigned num_points);
 
+  /**
+   * Record all following DrawPolygon() and DrawPolyline() calls in
+   * the given #TiledRasteriser, which draws them on several CPU
+   * cores in EndTiled().  The result is the same as drawing them
+   * immediately.
+   *
+   * Until EndTiled(), no other drawing method may be called on this
+   * object (or on a #SubCanvas of it), because it would bypass the
+   * recorded commands.
+   */
+  void BeginTiled(TiledRasteriser &_tiled) noexcept;
+
+  /**
+   * Draw all commands recorded since BeginTiled().
+   */
+  void EndTiled() noexcept;
+
   void DrawTriangleFan(const BulkPixelPoint *points, unsigned num_points) {
     DrawPolygon(points, num_points);
   }
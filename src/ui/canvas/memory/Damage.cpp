@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Damage.hpp"
+
+#include <string.h>
+
+/**
+ * Unchanged gaps of up to this number of rows between two damaged
+ * bands are included in one rectangle, because each rectangle means
+ * one more display update.
+ */
+static constexpr unsigned MERGE_ROWS = 8;
+
+/**
+ * Find the first and the last differing byte of two rows.
+ *
+ * @return false if the rows are equal
+ */
+static bool
+FindRowDamage(const std::byte *a, const std::byte *b, std::size_t length,
+              std::size_t &first, std::size_t &last) noexcept
+{
+  if (memcmp(a, b, length) == 0)
+    return false;
+
+  first = 0;
+  while (a[first] == b[first])
+    ++first;
+
+  last = length - 1;
+  while (a[last] == b[last])
+    --last;
+
+  return true;
+}
+
+void
+FindDamage(DamageList &damage,
+           const std::byte *current, std::size_t current_pitch,
+           const std::byte *previous, std::size_t previous_pitch,
+           PixelSize size, std::size_t bytes_per_pixel) noexcept
+{
+  assert(damage.empty());
+
+  const std::size_t length = size.width * bytes_per_pixel;
+
+  for (unsigned y = 0; y < size.height;
+       ++y, current += current_pitch, previous += previous_pitch) {
+    std::size_t first, last;
+    if (!FindRowDamage(current, previous, length, first, last))
+      continue;
+
+    const int left = first / bytes_per_pixel;
+    const int right = last / bytes_per_pixel + 1;
+
+    if (!damage.empty() &&
+        (damage.back().bottom + int(MERGE_ROWS) >= int(y) ||
+         damage.full())) {
+      /* extend the current band */
+      PixelRect &rc = damage.back();
+      rc.left = std::min(rc.left, left);
+      rc.right = std::max(rc.right, right);
+      rc.bottom = y + 1;
+    } else
+      damage.push_back({left, int(y), right, int(y) + 1});
+  }
+}
+
+void
+ExtendDamageForDither(DamageList &damage, PixelSize size) noexcept
+{
+  assert(!damage.empty());
+
+  const int top = damage.front().top;
+  damage.clear();
+  damage.push_back({0, top, int(size.width), int(size.height)});
+}
+
+std::size_t
+GetArea(const DamageList &damage) noexcept
+{
+  std::size_t area = 0;
+  for (const auto &rc : damage)
+    area += std::size_t(rc.GetWidth()) * rc.GetHeight();
+  return area;
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Buffer.hpp"
+#include "ui/dim/Rect.hpp"
+#include "util/StaticArray.hxx"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * The regions of a frame which differ from the previous frame.
+ * #TopCanvas uses this to convert and refresh only those parts of the
+ * screen.
+ */
+using DamageList = StaticArray<PixelRect, 8>;
+
+/**
+ * Compare two buffers of the same size and pixel format row by row,
+ * and collect the differing areas as horizontal bands.  Bands which
+ * are separated by only a few unchanged rows are merged; if there are
+ * more bands than #DamageList can hold, the last one is extended.
+ *
+ * @param damage the list which receives the rectangles (must be
+ * empty)
+ * @param bytes_per_pixel the size of one pixel in both buffers
+ */
+void
+FindDamage(DamageList &damage,
+           const std::byte *current, std::size_t current_pitch,
+           const std::byte *previous, std::size_t previous_pitch,
+           PixelSize size, std::size_t bytes_per_pixel) noexcept;
+
+template<AnyPixelTraits PixelTraits>
+static inline void
+FindDamage(DamageList &damage,
+           ConstImageBuffer<PixelTraits> current,
+           ConstImageBuffer<PixelTraits> previous) noexcept
+{
+  assert(current.size == previous.size);
+
+  FindDamage(damage,
+             reinterpret_cast<const std::byte *>(current.data),
+             current.pitch,
+             reinterpret_cast<const std::byte *>(previous.data),
+             previous.pitch,
+             current.size, sizeof(typename PixelTraits::color_type));
+}
+
+/**
+ * Copy a rectangle from one buffer to the same position in another
+ * buffer of the same size.
+ */
+template<AnyPixelTraits PixelTraits>
+static inline void
+CopyDamage(WritableImageBuffer<PixelTraits> dest,
+           ConstImageBuffer<PixelTraits> src, const PixelRect &rc) noexcept
+{
+  assert(dest.size == src.size);
+
+  const std::size_t width = rc.GetWidth();
+  for (int y = rc.top; y < rc.bottom; ++y)
+    std::copy_n(src.At(rc.left, y), width, dest.At(rc.left, y));
+}
+
+/**
+ * Adjust the damage for error diffusion dithering (#Dither), which
+ * carries the error of each pixel into the pixels right of and below
+ * it.  Every row from the first damaged one to the bottom may change,
+ * but the rows above it do not; the list is replaced with one
+ * full-width band covering these rows.
+ *
+ * To get the same result as converting the whole screen, dithering
+ * must start at Dither::GetResumeRow().
+ *
+ * @param damage the result of FindDamage() (must not be empty)
+ */
+void
+ExtendDamageForDither(DamageList &damage, PixelSize size) noexcept;
+
+[[gnu::pure]]
+std::size_t
+GetArea(const DamageList &damage) noexcept;
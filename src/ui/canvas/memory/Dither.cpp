@@ -4,6 +4,16 @@
 #include "Dither.hpp"
 
 #include <algorithm>
+#include <cassert>
+
+unsigned
+Dither::GetResumeRow(unsigned width, unsigned y) const noexcept
+{
+  if (width != checkpoint_width)
+    return 0;
+
+  return std::min(y / CHECKPOINT_ROWS, n_checkpoints) * CHECKPOINT_ROWS;
+}
 
 // Code adapted from imx.60 linux kernel EPD driver by Daiyu Ko <dko@freescale.com>
 //
@@ -13,18 +23,51 @@ Dither::DitherGreyscale(const uint8_t *gcc_restrict src,
                         unsigned src_pitch,
                         uint8_t *gcc_restrict dest,
                         unsigned dest_pitch,
-                        unsigned width, unsigned height) noexcept
+                        unsigned width, unsigned height,
+                        unsigned y) noexcept
 {
+  assert(y == GetResumeRow(width, y));
+
   const unsigned width_2 = width + 2;
-  allocated_error_dist_buffer.GrowDiscard(width_2 * 2u);
+  const std::size_t buffer_size = width_2 * 2u;
+  allocated_error_dist_buffer.GrowDiscard(buffer_size);
   ErrorDistType *const error_dist_buffer = allocated_error_dist_buffer.data();
-  std::fill(error_dist_buffer, error_dist_buffer + width_2 * 2u, 0);
 
-  for (; height; --height) {
+  if (width != checkpoint_width) {
+    checkpoint_width = width;
+    n_checkpoints = 0;
+  }
+
+  const unsigned y_begin = y, y_end = y + height;
+
+  /* the old checkpoints below the first converted row may depend on
+     rows which have changed */
+  n_checkpoints = std::min(n_checkpoints, y_begin / CHECKPOINT_ROWS);
+
+  const unsigned max_checkpoints = y_end > 0
+    ? (y_end - 1) / CHECKPOINT_ROWS
+    : 0;
+  checkpoints.GrowPreserve(max_checkpoints * buffer_size,
+                           n_checkpoints * buffer_size);
+
+  if (y_begin > 0)
+    std::copy_n(checkpoints.data() +
+                (y_begin / CHECKPOINT_ROWS - 1) * buffer_size,
+                buffer_size, error_dist_buffer);
+  else
+    std::fill_n(error_dist_buffer, buffer_size, 0);
+
+  for (; y < y_end; ++y) {
+    if (y % CHECKPOINT_ROWS == 0 && y > y_begin) {
+      std::copy_n(error_dist_buffer, buffer_size,
+                  checkpoints.data() + n_checkpoints * buffer_size);
+      ++n_checkpoints;
+    }
+
     ErrorDistType *gcc_restrict err_dist_l0 =
-      error_dist_buffer + ((height & 1) ? width_2 : 0) + 1;
+      error_dist_buffer + ((y & 1) ? width_2 : 0) + 1;
     ErrorDistType *gcc_restrict err_dist_l1 =
-      error_dist_buffer + ((height & 1) ? 0 : width_2);
+      error_dist_buffer + ((y & 1) ? 0 : width_2);
 
     int e0 = *err_dist_l0++;
     int e1 = *err_dist_l1;
@@ -13,10 +13,51 @@ class Dither {
 
   AllocatedArray<ErrorDistType> allocated_error_dist_buffer;
 
+  /**
+   * Copies of the error distribution buffer at the start of every
+   * #CHECKPOINT_ROWS-th row, saved by DitherGreyscale().  They allow
+   * resuming the conversion in the middle of the image.
+   */
+  AllocatedArray<ErrorDistType> checkpoints;
+
+  /**
+   * The image width of the #checkpoints.
+   */
+  unsigned checkpoint_width = 0;
+
+  /**
+   * The number of valid #checkpoints.
+   */
+  unsigned n_checkpoints = 0;
+
 public:
+  /**
+   * The distance between two checkpoints.  This must be even,
+   * because the two halves of the error distribution buffer swap
+   * roles after each row.
+   */
+  static constexpr unsigned CHECKPOINT_ROWS = 32;
+
+  /**
+   * Determine the row where DitherGreyscale() has to start to
+   * convert all rows from @p y on: the last checkpoint at or above
+   * it, or 0 if there is none.  The rows above the returned one must
+   * not have changed since they were converted.
+   */
+  [[gnu::pure]]
+  unsigned GetResumeRow(unsigned width, unsigned y) const noexcept;
+
+  /**
+   * @param src the source row at image row @p y
+   * @param dest the destination row at image row @p y
+   * @param height the number of rows to be converted
+   * @param y the first row to be converted; must be 0 or a value
+   * returned by GetResumeRow()
+   */
   void DitherGreyscale(const uint8_t *gcc_restrict src,
                        unsigned src_pitch,
                        uint8_t *gcc_restrict dest,
                        unsigned dest_pitch,
-                       unsigned width, unsigned height) noexcept;
+                       unsigned width, unsigned height,
+                       unsigned y=0) noexcept;
 };
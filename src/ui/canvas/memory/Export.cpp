@@ -29,7 +29,7 @@ CopyGreyscale(uint8_t *dest_pixels, unsigned dest_pitch,
 void
 CopyFromGreyscale(
 #ifdef DITHER
-                  Dither &dither,
+                  Dither &dither, unsigned dither_y,
 #endif
 #ifdef KOBO
                   bool enable_dither,
@@ -53,12 +53,13 @@ CopyFromGreyscale(
   dither.DitherGreyscale(src_pixels, src.pitch,
                          (uint8_t *)dest_pixels,
                          dest_pitch,
-                         src.size.width, src.size.height);
+                         src.size.width, src.size.height,
+                         dither_y);
 
 #ifndef KOBO
   if (dest_bpp == 4) {
     const unsigned n_pixels = (dest_pitch / dest_bpp)
-      * src.height;
+      * src.size.height;
     int32_t *d = (int32_t *)dest_pixels + n_pixels;
     const int8_t *end = (int8_t *)dest_pixels;
     const int8_t *s = end + n_pixels;
@@ -67,7 +67,7 @@ BGRAToRGB565(RGB565Color *dest, const BGRA8Color *src, unsigned n)
 void
 CopyFromGreyscale(
 #ifdef DITHER
-                  Dither &dither,
+                  Dither &dither, unsigned dither_y,
 #endif
 #ifdef KOBO
                   bool enable_dither,
@@ -10,6 +10,7 @@
 #include "ui/dim/Point.hpp"
 #include "util/AllocatedArray.hxx"
 
+#include <algorithm>
 #include <cassert>
 
 /*
@@ -44,15 +45,43 @@ public:
 private:
   WritableImageBuffer<PixelTraits> buffer;
 
+  /**
+   * Only rows in this range are written by the pixel, line,
+   * rectangle, polygon and circle primitives; see SetRowClip().
+   */
+  unsigned clip_top = 0, clip_bottom;
+
   AllocatedArray<int> polygon_buffer;
   AllocatedArray<BresenhamIterator> edge_buffer;
 
 public:
   RasterCanvas(WritableImageBuffer<PixelTraits> _buffer,
                PixelTraits _traits=PixelTraits()) noexcept
-    :PixelTraits(_traits), buffer(_buffer) {}
+    :PixelTraits(_traits), buffer(_buffer),
+     clip_bottom(_buffer.size.height) {}
+
+  /**
+   * Restrict the pixel, line, rectangle, polygon and circle
+   * primitives to the rows [top, bottom).  Unlike drawing into a smaller buffer, all
+   * coordinates (and line clipping) are still calculated against the
+   * whole buffer, so each pixel inside the range gets exactly the
+   * value it would get without the restriction.  This allows
+   * splitting one drawing into horizontal bands which are rendered
+   * independently.
+   */
+  void SetRowClip(unsigned top, unsigned bottom) noexcept {
+    assert(top <= bottom);
+    assert(bottom <= buffer.size.height);
+
+    clip_top = top;
+    clip_bottom = bottom;
+  }
 
 protected:
+  constexpr bool IsRowVisible(int y) const noexcept {
+    return unsigned(y - int(clip_top)) < clip_bottom - clip_top;
+  }
+
   PixelTraits &GetPixelTraits() noexcept {
     return *this;
   }
@@ -235,7 +264,7 @@ public:
   template<AnyWritePixelOperation PixelOperations>
   void DrawPixel(int x, int y, color_type c,
                  [[maybe_unused]] PixelOperations operations) noexcept {
-    if (Check(x, y))
+    if (Check(x, y) && IsRowVisible(y))
       PixelTraits::WritePixel(At(x, y), c);
   }
 
@@ -249,14 +278,14 @@ public:
     if (x1 < 0)
       x1 = 0;
 
-    if (y1 < 0)
-      y1 = 0;
+    if (y1 < int(clip_top))
+      y1 = clip_top;
 
     if (x2 > int(buffer.size.width))
       x2 = buffer.size.width;
 
-    if (y2 > int(buffer.size.height))
-      y2 = buffer.size.height;
+    if (y2 > int(clip_bottom))
+      y2 = clip_bottom;
 
     if (x1 >= x2 || y1 >= y2)
       return;
@@ -276,7 +305,7 @@ public:
   template<AnyFillPixelOperation PixelOperations>
   void DrawHLine(int x1, int x2, int y, color_type c,
                  PixelOperations operations) noexcept {
-    if (y < 0 || unsigned(y) >= buffer.size.height)
+    if (!IsRowVisible(y))
       return;
 
     if (x1 < 0)
@@ -303,11 +332,11 @@ public:
     if (x < 0 || unsigned(x) >= buffer.size.width)
       return;
 
-    if (y1 < 0)
-      y1 = 0;
+    if (y1 < int(clip_top))
+      y1 = clip_top;
 
-    if (y2 > int(buffer.size.height))
-      y2 = buffer.size.height;
+    if (y2 > int(clip_bottom))
+      y2 = clip_bottom;
 
     if (y1 >= y2)
       return;
@@ -350,21 +379,31 @@ public:
     std::ptrdiff_t pixx = PixelTraits::CalcIncrement(sx) * sizeof(*p);
     std::ptrdiff_t pixy = sy * static_cast<std::ptrdiff_t>(buffer.pitch);
 
+    /* the row increments for "pixx" and "pixy", to check the row
+       clip if the line crosses it */
+    int rowx = 0, rowy = sy;
+
     if (dx < dy) {
       std::swap(dx, dy);
       std::swap(pixx, pixy);
+      std::swap(rowx, rowy);
     }
 
+    const bool row_clipped = !IsRowVisible(y1) || !IsRowVisible(y2);
+
     unsigned lmp = line_mask_position;
 
-    for (int x = 0, y = 0; x < dx; x++, p = PixelTraits::NextByte(p, pixx)) {
-      if ((lmp++ | line_mask) == unsigned(-1))
+    for (int x = 0, y = 0, row = y1; x < dx;
+         x++, p = PixelTraits::NextByte(p, pixx), row += rowx) {
+      if ((lmp++ | line_mask) == unsigned(-1) &&
+          (!row_clipped || IsRowVisible(row)))
         PixelTraits::WritePixel(p, c);
 
       y += dy;
       if (y >= dx) {
         y -= dx;
         p = PixelTraits::NextByte(p, pixy);
+        row += rowy;
       }
     }
 
@@ -491,7 +530,7 @@ public:
       p_1++;
     }
 
-    if (n_edges < 2)
+    if (n_edges < 2 || maxy < int(clip_top) || miny >= int(clip_bottom))
       return;
 
     auto edge_start = edge_buffer.begin();
@@ -502,6 +541,10 @@ public:
 
     // perform scans
 
+    /* the edges must be advanced from the top, even above the row
+       clip, but there is nothing to do below it */
+    maxy = std::min(maxy, int(clip_bottom) - 1);
+
     for (int y = miny; y <= maxy; y++) {
 
       bool changed = false;
@@ -577,8 +620,9 @@ public:
         maxy = points[i].y;
     }
 
-    // Draw, scanning y
-    for (int y = miny; y <= maxy; y++) {
+    // Draw, scanning y (each row is independent of the others)
+    const int y_end = std::min(maxy, int(clip_bottom) - 1);
+    for (int y = std::max(miny, int(clip_top)); y <= y_end; y++) {
       unsigned n_ints = 0;
       for (unsigned i = 0; i < n; i++) {
         unsigned ind1, ind2;
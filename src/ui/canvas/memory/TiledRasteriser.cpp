@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TiledRasteriser.hpp"
+#include "RasterCanvas.hpp"
+#include "Optimised.hpp"
+#include "thread/StandbyThread.hpp"
+
+#include <algorithm> // for std::clamp()
+#include <cassert>
+#include <thread> // for std::thread::hardware_concurrency()
+
+/**
+ * Below this number of recorded points, the thread overhead is
+ * bigger than the gain, and all commands are drawn in the calling
+ * thread.
+ */
+static constexpr std::size_t MIN_PARALLEL_POINTS = 256;
+
+/**
+ * A thread which rasterises one band.
+ */
+class TiledRasteriser::BandThread final : StandbyThread {
+  const TiledRasteriser &rasteriser;
+
+  unsigned top, bottom;
+  const std::vector<unsigned> *bin;
+
+public:
+  explicit BandThread(const TiledRasteriser &_rasteriser) noexcept
+    :StandbyThread("TiledRasteriser"), rasteriser(_rasteriser) {}
+
+  ~BandThread() noexcept {
+    LockStop();
+  }
+
+  /**
+   * Throws on error.
+   */
+  void Start(unsigned _top, unsigned _bottom,
+             const std::vector<unsigned> &_bin) {
+    const std::lock_guard lock{mutex};
+    top = _top;
+    bottom = _bottom;
+    bin = &_bin;
+    Trigger();
+  }
+
+  using StandbyThread::LockWaitDone;
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() noexcept override {
+    const ScopeUnlock unlock(mutex);
+    rasteriser.RenderBand(top, bottom, *bin);
+  }
+};
+
+TiledRasteriser::TiledRasteriser(unsigned _max_bands) noexcept
+  :buffer(WritableImageBuffer<ActivePixelTraits>::Empty()),
+   max_bands(std::clamp(_max_bands > 0
+                        ? _max_bands
+                        : std::thread::hardware_concurrency(),
+                        1u, MAX_BANDS)) {}
+
+TiledRasteriser::~TiledRasteriser() noexcept = default;
+
+void
+TiledRasteriser::Add(const Command &command, const BulkPixelPoint *p)
+{
+  points.insert(points.end(), p, p + command.n);
+  commands.push_back(command);
+}
+
+/**
+ * Determine the rows covered by the given points.
+ */
+static void
+GetVerticalRange(const BulkPixelPoint *p, unsigned n,
+                 int &top, int &bottom) noexcept
+{
+  assert(n > 0);
+
+  int min = p[0].y, max = p[0].y;
+  for (unsigned i = 1; i < n; ++i) {
+    min = std::min(min, int(p[i].y));
+    max = std::max(max, int(p[i].y));
+  }
+
+  top = min;
+  bottom = max + 1;
+}
+
+void
+TiledRasteriser::FillPolygon(const BulkPixelPoint *p, unsigned n,
+                             color_type color, uint8_t alpha)
+{
+  if (n < 3)
+    return;
+
+  Command command{};
+  command.offset = points.size();
+  command.n = n;
+  command.color = color;
+  command.type = Command::Type::FILL;
+  command.alpha = alpha;
+  GetVerticalRange(p, n, command.top, command.bottom);
+
+  Add(command, p);
+}
+
+void
+TiledRasteriser::DrawPolyline(const BulkPixelPoint *p, unsigned n, bool loop,
+                              color_type color,
+                              unsigned thickness, unsigned line_mask)
+{
+  if (n == 0)
+    return;
+
+  Command command{};
+  command.offset = points.size();
+  command.n = n;
+  command.color = color;
+  command.type = Command::Type::POLYLINE;
+  command.loop = loop;
+  command.thickness = thickness;
+  command.line_mask = line_mask;
+  GetVerticalRange(p, n, command.top, command.bottom);
+
+  if (thickness > 1) {
+    /* thick lines and their end caps extend beyond the points; this
+       margin is generous, it only needs to cover all modified rows */
+    command.top -= thickness;
+    command.bottom += thickness;
+  }
+
+  Add(command, p);
+}
+
+void
+TiledRasteriser::RenderBand(unsigned top, unsigned bottom,
+                            const std::vector<unsigned> &bin) const noexcept
+{
+  RasterCanvas<ActivePixelTraits> canvas(buffer);
+  canvas.SetRowClip(top, bottom);
+
+  for (const unsigned i : bin) {
+    const Command &command = commands[i];
+    const BulkPixelPoint *p = points.data() + command.offset;
+
+    switch (command.type) {
+    case Command::Type::FILL:
+      if (command.alpha == 0xff)
+        canvas.FillPolygon(p, command.n, command.color);
+      else
+        canvas.FillPolygon(p, command.n, command.color,
+                           AlphaPixelOperations<ActivePixelTraits>(command.alpha));
+      break;
+
+    case Command::Type::POLYLINE:
+      canvas.DrawPolyline(p, command.n, command.loop, command.color,
+                          command.thickness, command.line_mask);
+      break;
+    }
+  }
+}
+
+/**
+ * How many bands shall the buffer with the given number of rows be
+ * split into?
+ */
+static constexpr unsigned
+GetBandCount(unsigned height, unsigned max_bands) noexcept
+{
+  /* bands smaller than this are not worth the thread overhead */
+  constexpr unsigned MIN_BAND_HEIGHT = 64;
+
+  return std::clamp(height / MIN_BAND_HEIGHT, 1u, max_bands);
+}
+
+void
+TiledRasteriser::Flush() noexcept
+{
+  if (commands.empty())
+    return;
+
+  const unsigned height = buffer.size.height;
+  const unsigned n_bands = points.size() >= MIN_PARALLEL_POINTS
+    ? GetBandCount(height, max_bands)
+    : 1;
+
+  std::array<unsigned, MAX_BANDS + 1> bands;
+  for (unsigned i = 0; i <= n_bands; ++i)
+    bands[i] = height * i / n_bands;
+
+  /* assign each command to the bands it touches, keeping the
+     recorded order */
+
+  for (auto &bin : bins)
+    bin.clear();
+
+  for (unsigned c = 0; c < commands.size(); ++c) {
+    const Command &command = commands[c];
+    for (unsigned i = 0; i < n_bands; ++i)
+      if (command.top < int(bands[i + 1]) && command.bottom > int(bands[i]))
+        bins[i].push_back(c);
+  }
+
+  std::array<bool, MAX_BANDS> started{};
+
+  for (unsigned i = 1; i < n_bands; ++i) {
+    if (bins[i].empty())
+      continue;
+
+    auto &thread = threads[i - 1];
+
+    try {
+      if (!thread)
+        thread = std::make_unique<BandThread>(*this);
+
+      thread->Start(bands[i], bands[i + 1], bins[i]);
+      started[i] = true;
+    } catch (...) {
+      /* fall back to rendering this band in the calling thread */
+    }
+  }
+
+  RenderBand(bands[0], bands[1], bins[0]);
+
+  for (unsigned i = 1; i < n_bands; ++i) {
+    if (started[i])
+      threads[i - 1]->LockWaitDone();
+    else
+      RenderBand(bands[i], bands[i + 1], bins[i]);
+  }
+
+  points.clear();
+  commands.clear();
+}
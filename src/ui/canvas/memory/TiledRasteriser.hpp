@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Buffer.hpp"
+#include "ActivePixelTraits.hpp"
+#include "ui/dim/BulkPoint.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Records polygon and polyline draw calls instead of executing them
+ * immediately.  Flush() splits the buffer into horizontal bands,
+ * assigns each recorded command to the bands it touches and
+ * rasterises the bands in parallel.
+ *
+ * Each band is drawn by a #RasterCanvas restricted to its rows with
+ * RasterCanvas::SetRowClip(), which calculates all geometry against
+ * the whole buffer.  Bands do not overlap, and each one executes its
+ * commands in the recorded order, so the result is exactly the same
+ * as drawing the commands one after another.
+ *
+ * Use it with Canvas::BeginTiled().
+ */
+class TiledRasteriser {
+public:
+  using color_type = ActivePixelTraits::color_type;
+
+  static constexpr unsigned MAX_BANDS = 4;
+
+private:
+  struct Command {
+    /**
+     * Index of the first point in #points.
+     */
+    std::size_t offset;
+
+    unsigned n;
+
+    color_type color;
+
+    /**
+     * The rows which may be modified by this command; used for
+     * assigning it to bands.
+     */
+    int top, bottom;
+
+    enum class Type : uint8_t {
+      FILL, POLYLINE,
+    } type;
+
+    /**
+     * The opacity of a #Type::FILL command; 0xff is opaque.
+     */
+    uint8_t alpha;
+
+    /**
+     * Is the #Type::POLYLINE command a closed outline?
+     */
+    bool loop;
+
+    unsigned thickness, line_mask;
+  };
+
+  class BandThread;
+
+  WritableImageBuffer<ActivePixelTraits> buffer;
+
+  std::vector<BulkPixelPoint> points;
+  std::vector<Command> commands;
+
+  /**
+   * The command indices for each band, filled by Flush().
+   */
+  std::array<std::vector<unsigned>, MAX_BANDS> bins;
+
+  std::array<std::unique_ptr<BandThread>, MAX_BANDS - 1> threads;
+
+  const unsigned max_bands;
+
+public:
+  /**
+   * @param _max_bands the maximum number of bands; 0 means one per
+   * CPU (limited to #MAX_BANDS)
+   */
+  explicit TiledRasteriser(unsigned _max_bands=0) noexcept;
+  ~TiledRasteriser() noexcept;
+
+  TiledRasteriser(const TiledRasteriser &) = delete;
+  TiledRasteriser &operator=(const TiledRasteriser &) = delete;
+
+  void Begin(WritableImageBuffer<ActivePixelTraits> _buffer) noexcept {
+    assert(commands.empty());
+
+    buffer = _buffer;
+  }
+
+  /**
+   * Record RasterCanvas::FillPolygon() (or FillPolygon() with
+   * #AlphaPixelOperations if #alpha is not 0xff).
+   */
+  void FillPolygon(const BulkPixelPoint *p, unsigned n,
+                   color_type color, uint8_t alpha);
+
+  /**
+   * Record RasterCanvas::DrawPolyline().
+   */
+  void DrawPolyline(const BulkPixelPoint *p, unsigned n, bool loop,
+                    color_type color,
+                    unsigned thickness, unsigned line_mask);
+
+  /**
+   * Draw all recorded commands into the buffer and clear the list.
+   */
+  void Flush() noexcept;
+
+private:
+  void Add(const Command &command, const BulkPixelPoint *p);
+
+  void RenderBand(unsigned top, unsigned bottom,
+                  const std::vector<unsigned> &bin) const noexcept;
+};
@@ -3,9 +3,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <utility>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include <cassert>
 
@@ -1372,6 +1374,129 @@ public:
 		return FindNearest(GetPosition(value), range);
 	}
 
+	/**
+	 * Find the nearest values (up to #max_results) within the
+	 * specified range which match the predicate, and pass them to
+	 * the visitor, nearest first.
+	 *
+	 * This is a best-first search: buckets are visited in the order
+	 * of their distance to the location, and once #max_results values
+	 * have been found, buckets which are farther away than the worst
+	 * of them are skipped.  Unlike VisitWithinRange(), the cost
+	 * depends on #max_results, not on the range.
+	 *
+	 * @param visitor a function which is called with the value and
+	 * its square distance
+	 * @return the number of values passed to the visitor
+	 */
+	template<class P, class V>
+	std::size_t VisitNearestIf(const Point location, distance_type range,
+				   std::size_t max_results,
+				   const P &predicate, V &&visitor) const {
+		if (max_results == 0 || root.IsEmpty())
+			return 0;
+
+		struct SearchBucket {
+			distance_type square_distance;
+			const Bucket *bucket;
+			Rectangle bounds;
+
+			/* std::push_heap() builds a max-heap; invert the
+			   order to get the nearest bucket first */
+			constexpr bool operator<(const SearchBucket &other) const noexcept {
+				return square_distance > other.square_distance;
+			}
+		};
+
+		struct Result {
+			distance_type square_distance;
+			const Leaf *leaf;
+
+			constexpr bool operator<(const Result &other) const noexcept {
+				return square_distance < other.square_distance;
+			}
+		};
+
+		/* the worst square distance a new result may have */
+		distance_type limit = Square(range);
+
+		std::vector<SearchBucket> queue;
+		queue.push_back({0, &root, bounds});
+
+		/* a max-heap, the worst result on top */
+		std::vector<Result> results;
+
+		while (!queue.empty()) {
+			std::pop_heap(queue.begin(), queue.end());
+			const SearchBucket current = queue.back();
+			queue.pop_back();
+
+			if (current.square_distance > limit)
+				/* all remaining buckets are even farther away */
+				break;
+
+			if (current.bucket->IsSplitted()) {
+				const auto &children = *current.bucket->children;
+				const Point middle = current.bounds.GetMiddle();
+				const Rectangle child_bounds[QuadBucket::N] = {
+					QuadBucket::GetTopLeft(current.bounds, middle),
+					QuadBucket::GetTopRight(current.bounds, middle),
+					QuadBucket::GetBottomLeft(current.bounds, middle),
+					QuadBucket::GetBottomRight(current.bounds, middle),
+				};
+
+				for (unsigned i = 0; i < QuadBucket::N; ++i) {
+					const Bucket &child = children.buckets[i];
+					if (child.IsEmpty())
+						continue;
+
+					const distance_type d =
+						child_bounds[i].SquareDistanceTo(location);
+					if (d > limit)
+						continue;
+
+					queue.push_back({d, &child, child_bounds[i]});
+					std::push_heap(queue.begin(), queue.end());
+				}
+
+				continue;
+			}
+
+			for (const Leaf *leaf = current.bucket->leaves.head;
+			     leaf != nullptr; leaf = leaf->next) {
+				const distance_type d = leaf->SquareDistanceTo(location);
+				if (d > limit || !predicate(leaf->value))
+					continue;
+
+				if (results.size() == max_results) {
+					std::pop_heap(results.begin(), results.end());
+					results.pop_back();
+				}
+
+				results.push_back({d, leaf});
+				std::push_heap(results.begin(), results.end());
+
+				if (results.size() == max_results)
+					limit = results.front().square_distance;
+			}
+		}
+
+		std::sort_heap(results.begin(), results.end());
+
+		for (const auto &i : results)
+			visitor((const T &)i.leaf->value, i.square_distance);
+
+		return results.size();
+	}
+
+	template<class P, class V>
+	std::size_t VisitNearestIf(const T &value, distance_type range,
+				   std::size_t max_results,
+				   const P &predicate, V &&visitor) const {
+		return VisitNearestIf(GetPosition(value), range, max_results,
+				      predicate, std::forward<V>(visitor));
+	}
+
 	template<class V>
 	void VisitWithinRange(const Point location, distance_type range,
 			      V &visitor) const {
@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays IGC files through the #GlideComputer and measures the time
+ * spent in each subsystem.  For each subsystem, the percentiles and a
+ * histogram of the call durations are printed, as a table or (with
+ * "--json") in a machine-readable format which can be compared
+ * between releases.
+ */
+
+#include "DebugReplayIGC.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/Profiler.hpp"
+#include "Computer/Settings.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceGlue.hpp"
+#include "Terrain/RasterTerrain.hpp"
+#include "Operation/Operation.hpp"
+#include "io/FileReader.hxx"
+#include "io/BufferedReader.hxx"
+#include "system/Args.hpp"
+#include "util/PrintException.hxx"
+#include "util/StringCompare.hxx"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <memory>
+#include <vector>
+
+#include <stdio.h>
+
+/* fake symbols: */
+
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+
+void
+ConditionMonitors::Update([[maybe_unused]] const NMEAInfo &basic,
+                          [[maybe_unused]] const DerivedInfo &calculated,
+                          [[maybe_unused]] const ComputerSettings &settings) noexcept
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogPoint([[maybe_unused]] const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+static constexpr std::array<const char *,
+                            unsigned(ComputerSubsystem::COUNT)> subsystem_names{
+  "trace",
+  "task",
+  "route",
+  "reach",
+  "wind",
+  "contest",
+  "airspace",
+  "gps",
+  "idle",
+};
+
+/**
+ * Collects all samples, to calculate exact percentiles at the end.
+ */
+class BenchmarkProfiler final : public ComputerProfiler {
+  std::array<std::vector<Duration>, unsigned(ComputerSubsystem::COUNT)> samples;
+
+public:
+  void Add(ComputerSubsystem subsystem, Duration duration) noexcept override {
+    samples[unsigned(subsystem)].push_back(duration);
+  }
+
+  void Finish() noexcept {
+    for (auto &i : samples)
+      std::sort(i.begin(), i.end());
+  }
+
+  const std::vector<Duration> &operator[](unsigned i) const noexcept {
+    return samples[i];
+  }
+};
+
+/**
+ * @param samples a sorted list
+ * @param p the percentile (0..100)
+ */
+static long
+Percentile(const std::vector<ComputerProfiler::Duration> &samples,
+           double p) noexcept
+{
+  if (samples.empty())
+    return 0;
+
+  const std::size_t i = std::min(std::size_t(samples.size() * p / 100),
+                                 samples.size() - 1);
+  return duration_cast<microseconds>(samples[i]).count();
+}
+
+static long
+Total(const std::vector<ComputerProfiler::Duration> &samples) noexcept
+{
+  ComputerProfiler::Duration total{};
+  for (const auto &i : samples)
+    total += i;
+  return duration_cast<microseconds>(total).count();
+}
+
+/**
+ * Count the samples in power-of-two buckets; bucket #i contains
+ * samples below 2^i microseconds (and not in a previous bucket).
+ */
+static std::vector<unsigned>
+Histogram(const std::vector<ComputerProfiler::Duration> &samples) noexcept
+{
+  std::vector<unsigned> histogram;
+  for (const auto &i : samples) {
+    const unsigned long us = duration_cast<microseconds>(i).count();
+    const std::size_t bucket = std::bit_width(us);
+    if (bucket >= histogram.size())
+      histogram.resize(bucket + 1);
+    ++histogram[bucket];
+  }
+
+  return histogram;
+}
+
+static void
+PrintTable(const BenchmarkProfiler &profiler, unsigned n_files,
+           unsigned long n_fixes)
+{
+  printf("files=%u fixes=%lu\n", n_files, n_fixes);
+  printf("%-10s %8s %10s %8s %8s %8s %8s %8s\n",
+         "subsystem", "calls", "total[ms]",
+         "p50[us]", "p90[us]", "p99[us]", "p99.9", "max[us]");
+
+  for (unsigned i = 0; i < subsystem_names.size(); ++i) {
+    const auto &samples = profiler[i];
+    printf("%-10s %8zu %10ld %8ld %8ld %8ld %8ld %8ld\n",
+           subsystem_names[i], samples.size(), Total(samples) / 1000,
+           Percentile(samples, 50), Percentile(samples, 90),
+           Percentile(samples, 99), Percentile(samples, 99.9),
+           Percentile(samples, 100));
+  }
+}
+
+static void
+PrintJSON(const BenchmarkProfiler &profiler, unsigned n_files,
+          unsigned long n_fixes)
+{
+  printf("{\"files\":%u,\"fixes\":%lu,\"subsystems\":{", n_files, n_fixes);
+
+  for (unsigned i = 0; i < subsystem_names.size(); ++i) {
+    const auto &samples = profiler[i];
+    printf("%s\"%s\":{\"calls\":%zu,\"total_us\":%ld,"
+           "\"p50_us\":%ld,\"p90_us\":%ld,\"p99_us\":%ld,"
+           "\"p999_us\":%ld,\"max_us\":%ld,\"histogram\":[",
+           i > 0 ? "," : "", subsystem_names[i], samples.size(),
+           Total(samples),
+           Percentile(samples, 50), Percentile(samples, 90),
+           Percentile(samples, 99), Percentile(samples, 99.9),
+           Percentile(samples, 100));
+
+    const auto histogram = Histogram(samples);
+    for (std::size_t j = 0; j < histogram.size(); ++j)
+      printf("%s%u", j > 0 ? "," : "", histogram[j]);
+
+    printf("]}");
+  }
+
+  printf("}}\n");
+}
+
+/**
+ * Replay one file through a new #GlideComputer, just like
+ * #CalculationThread does in flight (with one idle call per fix).
+ *
+ * @return the number of fixes
+ */
+static unsigned long
+Replay(Path path, Airspaces &airspaces,
+       RasterTerrain *terrain, ComputerProfiler &profiler)
+{
+  std::unique_ptr<DebugReplay> replay(DebugReplayIGC::Create(path));
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+
+  const Waypoints way_points;
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TaskManager task_manager(task_behaviour, way_points);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  GlideComputer glide_computer(settings, way_points, airspaces,
+                               protected_task_manager, task_events);
+  glide_computer.SetTerrain(terrain);
+  glide_computer.SetProfiler(&profiler);
+  glide_computer.Initialise();
+
+  unsigned long n_fixes = 0;
+  while (replay->Next()) {
+    const MoreData &basic = replay->Basic();
+
+    /* load the terrain tiles around the aircraft outside of the
+       measurement, like TerrainThread does */
+    if (terrain != nullptr && basic.location_available)
+      while (terrain->UpdateTiles(basic.location, 50000)) {}
+
+    glide_computer.ReadBlackboard(basic);
+    glide_computer.ProcessGPS();
+    glide_computer.ProcessIdle();
+    ++n_fixes;
+  }
+
+  glide_computer.SetProfiler(nullptr);
+  return n_fixes;
+}
+
+static void
+LoadAirspaceFile(Airspaces &airspaces, Path path)
+{
+  FileReader file_reader{path};
+  BufferedReader buffered_reader{file_reader};
+  ParseAirspaceFile(airspaces, buffered_reader);
+  airspaces.Optimise();
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv,
+            "[--json] [--airspace=FILE] [--terrain=FILE.xcm] FILE.igc ...");
+
+  bool json = false;
+  Airspaces airspaces;
+  std::unique_ptr<RasterTerrain> terrain;
+
+  while (!args.IsEmpty() && StringStartsWith(args.PeekNext(), "--")) {
+    const char *option = args.GetNext();
+    const char *value;
+
+    if (StringIsEqual(option, "--json"))
+      json = true;
+    else if ((value = StringAfterPrefix(option, "--airspace=")) != nullptr)
+      LoadAirspaceFile(airspaces, Path(value));
+    else if ((value = StringAfterPrefix(option, "--terrain=")) != nullptr) {
+      NullOperationEnvironment operation;
+      terrain = RasterTerrain::OpenTerrain(nullptr, Path(value), operation);
+    } else
+      args.UsageError();
+  }
+
+  if (args.IsEmpty())
+    args.UsageError();
+
+  BenchmarkProfiler profiler;
+  unsigned n_files = 0;
+  unsigned long n_fixes = 0;
+
+  while (!args.IsEmpty()) {
+    n_fixes += Replay(args.ExpectNextPath(), airspaces, terrain.get(),
+                      profiler);
+    ++n_files;
+  }
+
+  profiler.Finish();
+
+  if (json)
+    PrintJSON(profiler, n_files, n_fixes);
+  else
+    PrintTable(profiler, n_files, n_fixes);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -3,6 +3,8 @@
 
 #include "Terrain/RasterTerrain.hpp"
 
+#include <algorithm>
+
 TerrainHeight
 RasterMap::GetHeight([[maybe_unused]] const GeoPoint &location) const noexcept
 {
@@ -30,3 +32,14 @@ RasterMap::FirstIntersection([[maybe_unused]] const GeoPoint &origin,
 {
   return Intersection::Invalid();
 }
+
+void
+RasterMap::GroundIntersections([[maybe_unused]] const GeoPoint &origin,
+                               [[maybe_unused]] const int h_origin,
+                               [[maybe_unused]] const int h_glide,
+                               std::span<const GeoPoint> destinations,
+                               [[maybe_unused]] const int height_floor,
+                               std::span<GeoPoint> results) const noexcept
+{
+  std::fill_n(results.begin(), destinations.size(), GeoPoint::Invalid());
+}
@@ -3,18 +3,23 @@
 
 #include "Audio/PCMPlayer.hpp"
 #include "Audio/PCMPlayerFactory.hpp"
+#include "Audio/PCMMixerDataSource.hpp"
 #include "Audio/VarioSynthesiser.hpp"
 #include "ui/window/Init.hpp"
 #include "system/Args.hpp"
 #include "event/Loop.hxx"
 #include "event/FineTimerEvent.hxx"
+#include "util/StringAPI.hxx"
 #include "DebugReplay.hpp"
 
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <chrono>
 #include <memory>
 
+static constexpr unsigned sample_rate = 44100;
+
 class ReplayTimer {
   FineTimerEvent timer;
   DebugReplay &replay;
@@ -54,10 +59,65 @@ private:
   }
 };
 
+/**
+ * Measure the CPU cost of synthesising and mixing 1 to 4 voices
+ * without playing them; each voice is a #VarioSynthesiser with a
+ * different tone, standing in for the vario and the sounds mixed by
+ * #PCMMixerDataSource.
+ */
+static void
+RunBenchmark()
+{
+  /* a typical ALSA period */
+  static constexpr std::size_t BLOCK_SIZE = 1024;
+
+  /* one minute of audio */
+  static constexpr std::size_t N_BLOCKS = 60 * sample_rate / BLOCK_SIZE;
+
+  static constexpr double varios[] = { -2, 1.5, -4.5, 3 };
+
+  printf("voices  ns/sample  realtime\n");
+
+  for (unsigned n_voices = 1; n_voices <= std::size(varios); ++n_voices) {
+    VarioSynthesiser voices[std::size(varios)]{
+      VarioSynthesiser{sample_rate}, VarioSynthesiser{sample_rate},
+      VarioSynthesiser{sample_rate}, VarioSynthesiser{sample_rate},
+    };
+
+    PCMMixerDataSource mixer(sample_rate);
+    for (unsigned i = 0; i < n_voices; ++i) {
+      voices[i].SetVario(varios[i]);
+      mixer.AddSource(voices[i]);
+    }
+
+    int16_t buffer[BLOCK_SIZE];
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < N_BLOCKS; ++i)
+      mixer.GetData(buffer, BLOCK_SIZE);
+    const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    const double n_samples = double(N_BLOCKS * BLOCK_SIZE);
+    printf("%6u  %9.2f  %7.0fx\n", n_voices,
+           elapsed.count() * 1e9 / n_samples,
+           n_samples / sample_rate / elapsed.count());
+  }
+}
+
 int
 main(int argc, char **argv)
 {
-  Args args(argc, argv, "DRIVER FILE");
+  Args args(argc, argv, "DRIVER FILE | --benchmark");
+
+  const char *a = args.PeekNext();
+  if (a != nullptr && StringIsEqual(a, "--benchmark")) {
+    args.Skip();
+    args.ExpectEnd();
+    RunBenchmark();
+    return EXIT_SUCCESS;
+  }
+
   DebugReplay *replay = CreateDebugReplay(args);
   if (replay == NULL)
     return EXIT_FAILURE;
@@ -71,8 +131,6 @@ main(int argc, char **argv)
   std::unique_ptr<PCMPlayer> player(
       PCMPlayerFactory::CreateInstanceForDirectAccess(event_loop));
 
-  const unsigned sample_rate = 44100;
-
   VarioSynthesiser synthesiser(sample_rate);
 
   if (!player->Start(synthesiser)) {
@@ -91,7 +91,7 @@ LoadFiles(Airspaces &airspace_database)
   terrain = RasterTerrain::OpenTerrain(nullptr, operation).release();
 
   const AtmosphericPressure pressure = AtmosphericPressure::Standard();
-  ReadAirspace(airspace_database, pressure, operation);
+  ReadAirspace(airspace_database, pressure, nullptr, operation);
 
   if (terrain != nullptr)
     SetAirspaceGroundLevels(airspace_database, *terrain);
@@ -117,7 +117,7 @@ LoadReplay(DebugReplay *replay, GlideComputer &glide_computer,
   glide_computer.ProcessExhaustive();
 
   blackboard.ReadBlackboardBasic(glide_computer.Basic());
-  blackboard.ReadBlackboardCalculated(glide_computer.Calculated());
+  blackboard.ReadBlackboardCalculated(std::make_shared<const DerivedInfo>(glide_computer.Calculated()));
 }
 
 static DebugReplay *replay;
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * A load generator for xcsoar-cloud-server.  It simulates many
+ * SkyLines tracking clients flying in several areas around the world;
+ * each of them sends a fix and a traffic request as soon as its
+ * previous request has been answered.  At the end, the number of
+ * responses received per second is printed.
+ *
+ * Compare the output with the server running with one thread and
+ * with several ("xcsoar-cloud-server DBPATH THREADS").  The server
+ * prints the lock statistics of its range queries on exit (and on
+ * SIGUSR1).
+ */
+
+#include "Tracking/SkyLines/Server.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "Tracking/SkyLines/Assemble.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "net/Resolver.hxx"
+#include "net/AddressInfo.hxx"
+#include "net/SocketError.hxx"
+#include "net/UniqueSocketDescriptor.hxx"
+#include "event/Loop.hxx"
+#include "event/SocketEvent.hxx"
+#include "event/CoarseTimerEvent.hxx"
+#include "system/Args.hpp"
+#include "util/ByteOrder.hxx"
+#include "util/PrintException.hxx"
+
+#include <forward_list>
+#include <random>
+
+#include <stdio.h>
+
+using std::chrono::steady_clock;
+
+/**
+ * The clients are distributed among this many areas, which are far
+ * enough apart to be handled by different shards.
+ */
+static constexpr unsigned N_AREAS = 16;
+
+/**
+ * The radius of each area [degrees].
+ */
+static constexpr double AREA_RADIUS = 0.3;
+
+static constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(1);
+
+struct LoadStatistics {
+  unsigned long requests = 0, responses = 0, timeouts = 0;
+};
+
+class LoadClient {
+  LoadStatistics &statistics;
+
+  SocketEvent socket;
+
+  const uint64_t key;
+
+  GeoPoint location;
+
+  steady_clock::time_point sent;
+
+  bool pending = false;
+
+public:
+  LoadClient(EventLoop &event_loop, LoadStatistics &_statistics,
+             SocketAddress server_address,
+             uint64_t _key, GeoPoint _location)
+    :statistics(_statistics),
+     socket(event_loop, BIND_THIS_METHOD(OnSocketReady)),
+     key(_key), location(_location)
+  {
+    UniqueSocketDescriptor s;
+    if (!s.Create(server_address.GetFamily(), SOCK_DGRAM, 0))
+      throw MakeSocketError("Failed to create socket");
+
+    if (!s.Connect(server_address))
+      throw MakeSocketError("Failed to connect socket");
+
+    socket.Open(s.Release());
+    socket.ScheduleRead();
+  }
+
+  ~LoadClient() noexcept {
+    socket.Close();
+  }
+
+  /**
+   * Fly a bit and send a fix followed by a traffic request.
+   */
+  void Send() noexcept {
+    location.latitude += Angle::Degrees(0.0001);
+
+    const unsigned flags = SkyLinesTracking::FixPacket::FLAG_LOCATION|
+      SkyLinesTracking::FixPacket::FLAG_ALTITUDE;
+    SendPacket(SkyLinesTracking::MakeFix(key, flags, 0, location,
+                                         Angle::Zero(), 0, 0,
+                                         1000, 0, 0));
+    SendPacket(SkyLinesTracking::MakeTrafficRequest(key, false, false, true));
+
+    sent = steady_clock::now();
+    pending = true;
+    ++statistics.requests;
+  }
+
+  void CheckTimeout(steady_clock::time_point now) noexcept {
+    if (pending && now - sent > REQUEST_TIMEOUT) {
+      ++statistics.timeouts;
+      Send();
+    }
+  }
+
+private:
+  template<typename P>
+  void SendPacket(const P &packet) noexcept {
+    (void)socket.GetSocket().Write(ReferenceAsBytes(packet));
+  }
+
+  void OnSocketReady(unsigned) noexcept {
+    std::byte buffer[4096];
+    if (socket.GetSocket().ReadNoWait(buffer) <= 0)
+      return;
+
+    if (pending) {
+      pending = false;
+      ++statistics.responses;
+    }
+
+    Send();
+  }
+};
+
+class LoadGenerator {
+  EventLoop &event_loop;
+
+  std::forward_list<LoadClient> clients;
+
+  CoarseTimerEvent timeout_timer{event_loop, BIND_THIS_METHOD(OnTimeoutTimer)};
+  CoarseTimerEvent stop_timer{event_loop, BIND_THIS_METHOD(OnStopTimer)};
+
+public:
+  LoadStatistics statistics;
+
+  LoadGenerator(EventLoop &_event_loop, SocketAddress server_address,
+                unsigned n_clients)
+    :event_loop(_event_loop)
+  {
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> offset(-AREA_RADIUS, AREA_RADIUS);
+
+    for (unsigned i = 0; i < n_clients; ++i) {
+      const int area = i % N_AREAS;
+      const GeoPoint location(Angle::Degrees(-120 + 15 * area + offset(rng)),
+                              Angle::Degrees(40 + offset(rng)));
+      clients.emplace_front(event_loop, statistics, server_address,
+                            0x10000 + i, location);
+    }
+  }
+
+  void Start(std::chrono::seconds duration) noexcept {
+    /* the first round of requests is not answered, because nobody
+       has submitted a position yet; the timeout check takes care of
+       that */
+    for (auto &client : clients)
+      client.Send();
+
+    timeout_timer.Schedule(REQUEST_TIMEOUT);
+    stop_timer.Schedule(duration);
+  }
+
+private:
+  void OnTimeoutTimer() noexcept {
+    const auto now = steady_clock::now();
+    for (auto &client : clients)
+      client.CheckTimeout(now);
+
+    timeout_timer.Schedule(REQUEST_TIMEOUT);
+  }
+
+  void OnStopTimer() noexcept {
+    event_loop.Break();
+  }
+};
+
+int
+main(int argc, char *argv[])
+try {
+  Args args(argc, argv, "HOST [CLIENTS] [SECONDS]");
+  const char *host = args.ExpectNext();
+  const unsigned n_clients = args.IsEmpty() ? 200 : args.ExpectNextInt();
+  const unsigned duration = args.IsEmpty() ? 10 : args.ExpectNextInt();
+  args.ExpectEnd();
+
+  const auto address_list =
+    Resolve(host, SkyLinesTracking::Server::GetDefaultPort(),
+            0, SOCK_DGRAM);
+
+  EventLoop event_loop;
+
+  LoadGenerator generator(event_loop, address_list.GetBest(), n_clients);
+
+  const auto start = steady_clock::now();
+  generator.Start(std::chrono::seconds(duration));
+  event_loop.Run();
+
+  const double seconds =
+    std::chrono::duration<double>(steady_clock::now() - start).count();
+  const auto &statistics = generator.statistics;
+
+  printf("clients=%u requests=%lu responses=%lu timeouts=%lu\n",
+         n_clients, statistics.requests, statistics.responses,
+         statistics.timeouts);
+  printf("%.0f responses/s\n", statistics.responses / seconds);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -7,6 +7,8 @@
 #define ENABLE_MAIN_WINDOW
 #define ENABLE_CLOSE_BUTTON
 #define ENABLE_LOOK
+#define ENABLE_CMDLINE
+#define USAGE "[-WxH] [--benchmark]"
 #include "Main.hpp"
 #include "MapWindow/MapWindow.hpp"
 #include "Terrain/RasterTerrain.hpp"
@@ -26,8 +28,11 @@
 #include "io/ConfiguredFile.hpp"
 #include "io/FileReader.hxx"
 #include "io/BufferedReader.hxx"
+#include "io/StdioOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "Operation/ConsoleOperationEnvironment.hpp"
 #include "thread/Debug.hpp"
+#include "util/StringAPI.hxx"
 
 void
 DeviceBlackboard::SetStartupLocation([[maybe_unused]] const GeoPoint &loc,
@@ -45,6 +50,18 @@ InDrawThread()
 
 #endif
 
+static bool benchmark = false;
+
+static void
+ParseCommandLine(Args &args)
+{
+  const char *a = args.PeekNext();
+  if (a != nullptr && StringIsEqual(a, "--benchmark")) {
+    args.Skip();
+    benchmark = true;
+  }
+}
+
 static Waypoints way_points;
 
 static Airspaces airspace_database;
@@ -65,6 +82,21 @@ public:
     map.UpdateAll();
   }
 #endif
+
+  /**
+   * Load the data for the current projection and render one frame
+   * synchronously.
+   */
+  static void DrawFrame(MapWindow &map,
+                        [[maybe_unused]] UI::TopWindow &top_window) {
+    map.UpdateAll();
+#ifndef ENABLE_OPENGL
+    map.Repaint();
+#else
+    map.Invalidate();
+    top_window.Refresh();
+#endif
+  }
 };
 
 class TestMapWindow final : public MapWindow {
@@ -104,7 +136,7 @@ LoadFiles(PlacesOfInterestSettings &poi_settings,
 
   terrain = RasterTerrain::OpenTerrain(nullptr, operation).release();
 
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+  WaypointGlue::LoadWaypoints(way_points, terrain, nullptr, operation);
   WaypointGlue::SetHome(way_points, terrain, poi_settings, team_code_settings,
                         NULL, false);
 
@@ -149,12 +181,55 @@ GenerateBlackboard(MapWindow &map, const ComputerSettings &settings_computer,
   if (terrain != nullptr)
     while (terrain->UpdateTiles(nmea_info.location, 50000)) {}
 
-  map.ReadBlackboard(nmea_info, derived_info, settings_computer,
+  map.ReadBlackboard(nmea_info, std::make_shared<const DerivedInfo>(derived_info),
+                     settings_computer,
                      settings_map);
   map.SetLocation(nmea_info.location);
   map.UpdateScreenBounds();
 }
 
+/**
+ * Render a scripted sequence of zoom and pan steps and print the
+ * frame time percentiles.
+ */
+static void
+RunBenchmark(MapWindow &map, UI::TopWindow &top_window)
+{
+  static constexpr double scales[] = { 1000, 5000, 20000, 50000 };
+  static constexpr unsigned PAN_STEPS = 8;
+
+  const GeoPoint center = map.VisibleProjection().GetGeoLocation();
+
+  map.GetRenderStats().Clear();
+
+  for (const double scale : scales) {
+    map.SetLocation(center);
+    map.SetMapScale(scale);
+    map.UpdateScreenBounds();
+    DrawThread::DrawFrame(map, top_window);
+
+    /* pan east by a quarter of the screen width per step, and back */
+    const auto &projection = map.VisibleProjection();
+    const GeoPoint delta =
+      projection.ScreenToGeo(projection.GetScreenOrigin() +
+                             PixelSize{projection.GetScreenSize().width / 4, 0})
+      - center;
+
+    GeoPoint location = center;
+    for (unsigned i = 0; i < 2 * PAN_STEPS; ++i) {
+      location = i < PAN_STEPS ? location + delta : location - delta;
+      map.SetLocation(location);
+      map.UpdateScreenBounds();
+      DrawThread::DrawFrame(map, top_window);
+    }
+  }
+
+  StdioOutputStream sos(stdout);
+  BufferedOutputStream bos(sos);
+  map.GetRenderStats().Dump(bos);
+  bos.Flush();
+}
+
 void
 Main(TestMainWindow &main_window)
 {
@@ -186,7 +261,10 @@ Main(TestMainWindow &main_window)
   map.initialised = true;
 #endif
 
-  main_window.RunEventLoop();
+  if (benchmark)
+    RunBenchmark(map, main_window);
+  else
+    main_window.RunEventLoop();
 
   delete terrain;
   delete topography;
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/AbstractAirspace.hpp"
 #include "Engine/Airspace/AirspaceCircle.hpp"
 #include "Engine/Airspace/AirspacePolygon.hpp"
@@ -11,6 +12,12 @@
 #include "util/StringAPI.hxx"
 #include "util/PrintException.hxx"
 #include "io/FileLineReader.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/StringOutputStream.hxx"
+#include "io/MemoryReader.hxx"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "system/FileUtil.hpp"
 #include "Operation/Operation.hpp"
 #include "TestUtil.hpp"
 
@@ -288,13 +295,157 @@ TestOpenAirExtended()
   }
 }
 
+[[gnu::pure]]
+static bool
+operator==(const AirspaceAltitude &a, const AirspaceAltitude &b) noexcept
+{
+  return a.reference == b.reference && a.altitude == b.altitude &&
+    a.flight_level == b.flight_level &&
+    a.altitude_above_terrain == b.altitude_above_terrain;
+}
+
+[[gnu::pure]]
+static bool
+IsEqual(const AbstractAirspace &a, const AbstractAirspace &b) noexcept
+{
+  if (a.GetShape() != b.GetShape() ||
+      !StringIsEqual(a.GetName(), b.GetName()) ||
+      a.GetClass() != b.GetClass() || a.GetType() != b.GetType() ||
+      !(a.GetBase() == b.GetBase()) || !(a.GetTop() == b.GetTop()) ||
+      a.GetRadioFrequency() != b.GetRadioFrequency() ||
+      !a.GetDays().equals(b.GetDays()) ||
+      a.GetPoints().size() != b.GetPoints().size())
+    return false;
+
+  if (a.GetShape() == AbstractAirspace::Shape::CIRCLE &&
+      (static_cast<const AirspaceCircle &>(a).GetRadius() !=
+       static_cast<const AirspaceCircle &>(b).GetRadius() ||
+       a.GetReferenceLocation() != b.GetReferenceLocation()))
+    return false;
+
+  for (std::size_t i = 0; i < a.GetPoints().size(); ++i)
+    if (a.GetPoints()[i].GetLocation() != b.GetPoints()[i].GetLocation())
+      return false;
+
+  return true;
+}
+
+static void
+TestCache()
+{
+  const Path path(_T("test/data/airspace/openair.txt"));
+
+  Airspaces parsed;
+  FileReader file_reader{path};
+  BufferedReader buffered_reader{file_reader};
+  ParseAirspaceFile(parsed, buffered_reader);
+
+  StringOutputStream sos;
+  BufferedOutputStream bos(sos);
+  SaveAirspaceCache(bos, path, parsed);
+  bos.Flush();
+
+  const auto &data = sos.GetValue();
+  MemoryReader memory_reader{std::as_bytes(std::span{data})};
+  BufferedReader cache_reader{memory_reader};
+
+  Airspaces loaded;
+  ok1(LoadAirspaceCache(cache_reader, path, loaded));
+
+  const auto &a = parsed.GetPending(), &b = loaded.GetPending();
+  ok1(a.size() == b.size());
+  ok1(std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                 [](const AirspacePtr &x, const AirspacePtr &y){
+                   return IsEqual(*x, *y);
+                 }));
+
+  /* a cache written for another file is rejected */
+  MemoryReader memory_reader2{std::as_bytes(std::span{data})};
+  BufferedReader cache_reader2{memory_reader2};
+  Airspaces other;
+  ok1(!LoadAirspaceCache(cache_reader2,
+                         Path(_T("test/data/airspace/tnp.sua")), other));
+}
+
+/**
+ * Parse a file with a syntax error in its third airspace.
+ *
+ * @return the number of airspaces which were kept
+ */
+static std::size_t
+ParseBrokenFile(FileCache *cache, Path path)
+{
+  Airspaces airspaces;
+
+  try {
+    ParseCachedAirspaceFile(airspaces, cache, _T("airspace-broken"), path,
+                            [path](Airspaces &dest){
+      FileReader file_reader{path};
+      BufferedReader buffered_reader{file_reader};
+      ParseAirspaceFile(dest, buffered_reader);
+    });
+    ok1(false);
+  } catch (...) {
+    ok1(true);
+  }
+
+  return airspaces.GetPending().size();
+}
+
+static void
+TestCacheBrokenFile()
+{
+  const Path path(_T("output/test/broken_airspace.txt"));
+
+  {
+    static constexpr std::string_view text =
+      "AC C\n"
+      "AN One\n"
+      "AL 1000 ft\n"
+      "AH 2000 ft\n"
+      "V X=01:05.5 N 000:05.5 E\n"
+      "DC 5\n"
+      "AC C\n"
+      "AN Two\n"
+      "AL 1000 ft\n"
+      "AH 2000 ft\n"
+      "V X=01:15.5 N 000:05.5 E\n"
+      "DC 5\n"
+      "AC C\n"
+      "AN Broken\n"
+      "AL 1000 ft\n"
+      "AH 2000 ft\n"
+      "V X=01:25.5 Q 000:05.5 E\n"
+      "DC 5\n";
+
+    FileOutputStream file(path);
+    file.Write(std::as_bytes(std::span{text}));
+    file.Commit();
+  }
+
+  FileCache cache{AllocatedPath{_T("output/test")}};
+  cache.Flush(_T("airspace-broken"));
+
+  /* the airspaces before the error are kept, with or without a
+     cache */
+  ok1(ParseBrokenFile(nullptr, path) == 2);
+  ok1(ParseBrokenFile(&cache, path) == 2);
+
+  /* but the incomplete result is not cached */
+  ok1(cache.Load(_T("airspace-broken"), path) == nullptr);
+
+  File::Delete(path);
+}
+
 int main()
 try {
-  plan_tests(113);
+  plan_tests(122);
 
   TestOpenAir();
   TestTNP();
   TestOpenAirExtended();
+  TestCache();
+  TestCacheBrokenFile();
 
   return exit_status();
 } catch (const std::runtime_error &e) {
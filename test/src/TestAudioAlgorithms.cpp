@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Audio/AudioAlgorithms.hpp"
+#include "Audio/PCMMixerDataSource.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <array>
+
+/**
+ * A #PCMDataSource which delivers a constant sample value.
+ */
+class ConstantDataSource final : public PCMDataSource {
+  const int16_t value;
+
+public:
+  explicit constexpr ConstantDataSource(int16_t _value) noexcept
+    :value(_value) {}
+
+  bool IsBigEndian() const override {
+    return ::IsBigEndian();
+  }
+
+  unsigned GetSampleRate() const override {
+    return 44100;
+  }
+
+  size_t GetData(int16_t *buffer, size_t n) override {
+    std::fill_n(buffer, n, value);
+    return n;
+  }
+};
+
+/* more than one NEON block, plus a remainder for the scalar loop */
+using Buffer = std::array<int16_t, 37>;
+
+static bool
+AllEqual(const Buffer &buffer, int16_t value) noexcept
+{
+  return std::all_of(buffer.begin(), buffer.end(),
+                     [value](int16_t i){ return i == value; });
+}
+
+static void
+TestLowerVolume()
+{
+  Buffer buffer;
+
+  buffer.fill(20000);
+  LowerVolume(buffer.data(), buffer.size(), 100);
+  ok1(AllEqual(buffer, 20000));
+
+  LowerVolume(buffer.data(), buffer.size(), 50);
+  ok1(AllEqual(buffer, 10000));
+
+  buffer.fill(-20000);
+  LowerVolume(buffer.data(), buffer.size(), 25);
+  ok1(AllEqual(buffer, -5000));
+
+  LowerVolume(buffer.data(), buffer.size(), 0);
+  ok1(AllEqual(buffer, 0));
+
+  /* big endian -20000 */
+  buffer.fill(ByteSwapSample(-20000));
+  ByteSwapAndLowerVolume(buffer.data(), buffer.size(), 50);
+  ok1(AllEqual(buffer, -10000));
+
+  /* full volume only swaps */
+  buffer.fill(ByteSwapSample(-20001));
+  ByteSwapAndLowerVolume(buffer.data(), buffer.size(), 100);
+  ok1(AllEqual(buffer, -20001));
+}
+
+static void
+TestMix()
+{
+  Buffer dest, src;
+
+  dest.fill(1000);
+  src.fill(-3000);
+  MixPCM(dest.data(), src.data(), dest.size(), 50);
+  ok1(AllEqual(dest, -500));
+
+  /* saturation instead of wrapping around */
+  dest.fill(30000);
+  src.fill(30000);
+  MixPCM(dest.data(), src.data(), dest.size(), 50);
+  ok1(AllEqual(dest, 32767));
+
+  dest.fill(-30000);
+  src.fill(ByteSwapSample(-30000));
+  ByteSwapAndMixPCM(dest.data(), src.data(), dest.size(), 50);
+  ok1(AllEqual(dest, -32768));
+
+  /* a muted source does not affect the others */
+  dest.fill(1234);
+  MixPCM(dest.data(), src.data(), dest.size(), 0);
+  ok1(AllEqual(dest, 1234));
+
+  /* full volume adds the source samples unchanged */
+  src.fill(-3001);
+  MixPCM(dest.data(), src.data(), dest.size(), 100);
+  ok1(AllEqual(dest, 1234 - 3001));
+
+  dest.fill(1234);
+  src.fill(ByteSwapSample(-3001));
+  ByteSwapAndMixPCM(dest.data(), src.data(), dest.size(), 100);
+  ok1(AllEqual(dest, 1234 - 3001));
+}
+
+static void
+TestMixer()
+{
+  ConstantDataSource a(8000), b(-2000), c(4000), d(16000), e(1);
+
+  PCMMixerDataSource mixer(44100);
+  mixer.SetVolume(50);
+  ok1(mixer.AddSource(a));
+  ok1(mixer.AddSource(b));
+  ok1(mixer.AddSource(c));
+
+  Buffer buffer;
+  ok1(mixer.GetData(buffer.data(), buffer.size()) == buffer.size());
+  ok1(AllEqual(buffer, 5000));
+
+  ok1(mixer.AddSource(d));
+  ok1(!mixer.AddSource(e));
+
+  /* full volume leaves all samples unchanged */
+  mixer.SetVolume(100);
+  mixer.GetData(buffer.data(), buffer.size());
+  ok1(AllEqual(buffer, 8000 - 2000 + 4000 + 16000));
+}
+
+int main()
+{
+  plan_tests(20);
+
+  TestLowerVolume();
+  TestMix();
+  TestMixer();
+
+  return exit_status();
+}
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Check that running the independent solvers of a contest in
+ * separate threads finds the same solutions as running them
+ * serially.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "Contest/ContestManager.hpp"
+#include "DebugReplayIGC.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <memory>
+
+using namespace std::chrono;
+
+static Trace full_trace({}, Trace::null_time, 512);
+static Trace triangle_trace({}, Trace::null_time, 1024);
+static Trace sprint_trace({}, minutes{150}, 128);
+
+static bool
+Replay(Path path)
+{
+  std::unique_ptr<DebugReplay> replay{DebugReplayIGC::Create(path)};
+  if (replay == nullptr)
+    return false;
+
+  bool released = false;
+  while (replay->Next()) {
+    const MoreData &basic = replay->Basic();
+    if (!basic.time_available || !basic.location_available ||
+        !basic.NavAltitudeAvailable())
+      continue;
+
+    const auto release_time = replay->Calculated().flight.release_time;
+    if (!released && release_time.IsDefined()) {
+      released = true;
+
+      triangle_trace.EraseEarlierThan(release_time);
+      full_trace.EraseEarlierThan(release_time);
+      sprint_trace.EraseEarlierThan(release_time);
+    }
+
+    const TracePoint point(basic);
+    triangle_trace.push_back(point);
+    full_trace.push_back(point);
+    sprint_trace.push_back(point);
+  }
+
+  return true;
+}
+
+static bool
+operator==(const ContestResult &a, const ContestResult &b) noexcept
+{
+  return a.score == b.score && a.distance == b.distance && a.time == b.time;
+}
+
+static bool
+operator==(const ContestTraceVector &a, const ContestTraceVector &b) noexcept
+{
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const ContestTracePoint &x, const ContestTracePoint &y){
+                      return x.GetTime() == y.GetTime() &&
+                        x.GetLocation() == y.GetLocation();
+                    });
+}
+
+static bool
+operator==(const ContestStatistics &a, const ContestStatistics &b) noexcept
+{
+  return a.result == b.result && a.solution == b.solution;
+}
+
+static void
+TestContest(Contest contest, unsigned max_threads)
+{
+  ContestManager serial(contest, full_trace, triangle_trace, sprint_trace);
+  serial.SetMaxThreads(1);
+  serial.SolveExhaustive();
+
+  ContestManager parallel(contest, full_trace, triangle_trace, sprint_trace);
+  parallel.SetMaxThreads(max_threads);
+  parallel.SolveExhaustive();
+
+  ok1(serial.GetStats().GetResult().IsDefined());
+  ok1(parallel.GetStats() == serial.GetStats());
+}
+
+int main()
+{
+  plan_tests(11);
+
+  ok1(Replay(Path(_T("test/data/01lz1hq1.igc"))));
+
+  TestContest(Contest::OLC_PLUS, 2);
+  TestContest(Contest::XCONTEST, 2);
+  TestContest(Contest::DHV_XC, 2);
+  TestContest(Contest::WEGLIDE_FREE, 3);
+
+  /* fewer threads than solvers */
+  TestContest(Contest::WEGLIDE_FREE, 2);
+
+  return exit_status();
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Protection.hpp"
+#include "TestUtil.hpp"
+
+bool global_simulator_flag = false;
+
+static unsigned n_merges;
+
+void
+TriggerMergeThread() noexcept
+{
+  ++n_merges;
+}
+
+static void
+Merge(DeviceBlackboard &blackboard) noexcept
+{
+  const std::lock_guard lock{blackboard.mutex};
+  blackboard.Merge();
+}
+
+/**
+ * Feed a device which has been silent for the given duration.
+ */
+static void
+SetDevice(DeviceBlackboard &blackboard, unsigned i,
+          std::chrono::steady_clock::duration silence) noexcept
+{
+  NMEAInfo info = blackboard.LockGetDeviceDataUpdateClock(i);
+  const auto last = info.clock - silence;
+  info.alive.Update(last);
+  info.time_available.Update(last);
+  info.time = TimeStamp{std::chrono::hours(12)};
+  info.gps.satellites_used_available.Update(last);
+  info.gps.satellites_used = 7;
+  info.flarm.status.available.Update(last);
+
+  blackboard.LockSetDeviceDataScheduleMerge(i, info);
+  Merge(blackboard);
+}
+
+static void
+TestExpireWallClock()
+{
+  DeviceBlackboard blackboard;
+
+  /* device 0 is alive, device 1 has been silent for too long, but
+     Merge() has not noticed yet */
+  SetDevice(blackboard, 0, std::chrono::seconds(1));
+  SetDevice(blackboard, 1, std::chrono::seconds(20));
+  ok1(blackboard.Basic().alive);
+  ok1(blackboard.RealState(1).alive);
+
+  n_merges = 0;
+  blackboard.ExpireWallClock();
+  ok1(n_merges == 1);
+
+  /* the staged data (which the NMEA parser continues with) is
+     cleared, not only the merged copy */
+  const NMEAInfo staged = blackboard.LockGetDeviceDataUpdateClock(1);
+  ok1(!staged.alive);
+  ok1(!staged.time_available);
+  ok1(!staged.gps.satellites_used_available);
+  ok1(!staged.flarm.IsDetected());
+
+  /* the next Merge() does not bring the old data back */
+  Merge(blackboard);
+  ok1(!blackboard.RealState(1).alive);
+  ok1(!blackboard.RealState(1).flarm.IsDetected());
+  ok1(blackboard.RealState(0).alive);
+  ok1(blackboard.RealState(0).flarm.IsDetected());
+
+  /* nothing has expired: no merge */
+  n_merges = 0;
+  blackboard.ExpireWallClock();
+  ok1(n_merges == 0);
+}
+
+int main()
+{
+  plan_tests(12);
+
+  TestExpireWallClock();
+
+  return exit_status();
+}
@@ -231,8 +231,21 @@ TestFLARM()
     ok1(traffic->climb_rate_received);
     ok1(traffic->type == FlarmTraffic::AircraftType::AIRSHIP);
     ok1(!traffic->stealth);
+    ok1(traffic->source == FlarmTraffic::SourceType::FLARM);
   } else {
-    skip(15, 0, "traffic == NULL");
+    skip(16, 0, "traffic == NULL");
+  }
+
+  ok1(parser.ParseLine("$PFLAA,0,-1234,1234,220,1,4B4D3A,225,,39,-1.5,9,,1,-70*28",
+                       nmea_info));
+
+  id = FlarmId::Parse("4B4D3A", NULL);
+  traffic = nmea_info.flarm.traffic.FindTraffic(id);
+  if (ok1(traffic != NULL)) {
+    ok1(traffic->type == FlarmTraffic::AircraftType::JET_AIRCRAFT);
+    ok1(traffic->source == FlarmTraffic::SourceType::ADSB);
+  } else {
+    skip(2, 0, "traffic == NULL");
   }
 }
 
@@ -1680,7 +1693,7 @@ TestFlightList(const struct DeviceRegister &driver)
 
 int main()
 {
-  plan_tests(877);
+  plan_tests(882);
 
   TestGeneric();
   TestTasman();
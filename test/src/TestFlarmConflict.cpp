@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FLARM/ConflictPredictor.hpp"
+#include "FLARM/Conflict.hpp"
+#include "FLARM/List.hpp"
+#include "NMEA/Info.hpp"
+#include "TestUtil.hpp"
+
+#include <stdio.h>
+
+static constexpr TimeStamp NOW{FloatDuration{100}};
+
+static FlarmId
+MakeId(unsigned value) noexcept
+{
+  char buffer[16];
+  sprintf(buffer, "%X", value);
+  return FlarmId::Parse(buffer, nullptr);
+}
+
+/**
+ * Create our own state: flying north at 30 m/s, level.
+ */
+static NMEAInfo
+MakeBasic() noexcept
+{
+  NMEAInfo basic;
+  basic.track = Angle::Zero();
+  basic.track_available.Update(NOW);
+  basic.ground_speed = 30;
+  basic.ground_speed_available.Update(NOW);
+  basic.noncomp_vario_available.Clear();
+  return basic;
+}
+
+static FlarmTraffic &
+AddTarget(TrafficList &traffic, unsigned id,
+          double north, double east, double altitude,
+          Angle track, double speed) noexcept
+{
+  FlarmTraffic &target = *traffic.AllocateTraffic(MakeId(id));
+  target.Clear();
+  target.valid.Update(NOW);
+  target.relative_north = north;
+  target.relative_east = east;
+  target.relative_altitude = altitude;
+  target.track = track;
+  target.speed = speed;
+  target.climb_rate = 0;
+  target.track_received = target.speed_received =
+    target.climb_rate_received = true;
+  target.alarm_level = FlarmTraffic::AlarmType::NONE;
+  target.source = FlarmTraffic::SourceType::ADSB;
+  return target;
+}
+
+static void
+TestHeadOn()
+{
+  const NMEAInfo basic = MakeBasic();
+  TrafficList traffic;
+  traffic.Clear();
+
+  /* head-on, 600 m ahead, closing at 60 m/s: conflict in 10 s */
+  AddTarget(traffic, 1, 600, 0, 0, Angle::HalfCircle(), 30);
+
+  FlarmConflictPredictor predictor;
+  FlarmConflictList conflicts;
+  predictor.Predict(traffic, basic, conflicts);
+
+  ok1(conflicts.list.size() == 1);
+  const auto *conflict = conflicts.GetMostUrgent();
+  ok1(conflict != nullptr && conflict->id == MakeId(1));
+  ok1(conflict != nullptr && equals(conflict->time, 10));
+  ok1(conflict != nullptr && conflict->horizontal_distance < 1);
+  ok1(conflict != nullptr &&
+      conflict->level == FlarmTraffic::AlarmType::IMPORTANT);
+
+  /* the same, but 200 m above */
+  traffic.Clear();
+  AddTarget(traffic, 1, 600, 0, 200, Angle::HalfCircle(), 30);
+  predictor.Predict(traffic, basic, conflicts);
+  ok1(conflicts.IsEmpty());
+
+  /* a FLARM alarm hides the prediction */
+  traffic.Clear();
+  AddTarget(traffic, 1, 600, 0, 0, Angle::HalfCircle(), 30).alarm_level =
+    FlarmTraffic::AlarmType::LOW;
+  predictor.Predict(traffic, basic, conflicts);
+  ok1(conflicts.IsEmpty());
+
+  /* FLARM targets are assessed by the FLARM, even without an alarm */
+  traffic.Clear();
+  AddTarget(traffic, 1, 600, 0, 0, Angle::HalfCircle(), 30).source =
+    FlarmTraffic::SourceType::FLARM;
+  predictor.Predict(traffic, basic, conflicts);
+  ok1(conflicts.IsEmpty());
+
+  /* without track, speed or climb rate, there is nothing to predict
+     (and the target must not be assumed to stand still) */
+  traffic.Clear();
+  AddTarget(traffic, 1, 600, 0, 0, Angle::Zero(), 0).track_received = false;
+  AddTarget(traffic, 2, 600, 0, 0, Angle::Zero(), 0).speed_received = false;
+  AddTarget(traffic, 3, 600, 0, 0, Angle::Zero(), 0).climb_rate_received = false;
+  predictor.Predict(traffic, basic, conflicts);
+  ok1(conflicts.IsEmpty());
+
+  /* ADS-R and TIS-B targets are predicted like ADS-B */
+  traffic.Clear();
+  AddTarget(traffic, 1, 600, 0, 0, Angle::HalfCircle(), 30).source =
+    FlarmTraffic::SourceType::ADSR;
+  AddTarget(traffic, 2, 300, 300, 0, Angle::Degrees(270), 30).source =
+    FlarmTraffic::SourceType::TISB;
+  predictor.Predict(traffic, basic, conflicts);
+  ok1(conflicts.list.size() == 2);
+}
+
+static void
+TestMiss()
+{
+  const NMEAInfo basic = MakeBasic();
+  TrafficList traffic;
+  traffic.Clear();
+
+  /* passing 500 m to the right */
+  AddTarget(traffic, 1, 600, 500, 0, Angle::HalfCircle(), 30);
+
+  /* flying away behind us */
+  AddTarget(traffic, 2, -100, 0, 0, Angle::HalfCircle(), 30);
+
+  /* formation flight, 100 m to the left */
+  AddTarget(traffic, 3, 0, -100, 0, Angle::Zero(), 30);
+
+  /* too far away to matter within the horizon */
+  AddTarget(traffic, 4, 3000, 0, 0, Angle::HalfCircle(), 30);
+
+  FlarmConflictPredictor predictor;
+  FlarmConflictList conflicts;
+  predictor.Predict(traffic, basic, conflicts);
+  ok1(conflicts.IsEmpty());
+
+  /* without our own velocity, nothing is predicted */
+  TrafficList traffic2;
+  traffic2.Clear();
+  AddTarget(traffic2, 1, 600, 0, 0, Angle::HalfCircle(), 30);
+  NMEAInfo basic2 = basic;
+  basic2.track_available.Clear();
+  predictor.Predict(traffic2, basic2, conflicts);
+  ok1(conflicts.IsEmpty());
+}
+
+static void
+TestRanking()
+{
+  const NMEAInfo basic = MakeBasic();
+  TrafficList traffic;
+  traffic.Clear();
+
+  /* many targets converging from the side, closest ones are most
+     urgent */
+  for (unsigned i = 0; i < 300; ++i)
+    AddTarget(traffic, i + 1, 30 * (3 + i % 15), 0, 0,
+              Angle::HalfCircle(), 0);
+
+  FlarmConflictPredictor predictor;
+  FlarmConflictList conflicts;
+  predictor.Predict(traffic, basic, conflicts);
+
+  ok1(conflicts.list.full());
+
+  bool sorted = true;
+  for (unsigned i = 1; i < conflicts.list.size(); ++i)
+    if (conflicts.list[i].IsMoreUrgentThan(conflicts.list[i - 1]))
+      sorted = false;
+  ok1(sorted);
+
+  ok1(equals(conflicts.GetMostUrgent()->time, 3));
+  ok1(conflicts.GetAlarmLevel() == FlarmTraffic::AlarmType::URGENT);
+}
+
+int main()
+{
+  plan_tests(16);
+
+  TestHeadOn();
+  TestMiss();
+  TestRanking();
+
+  return exit_status();
+}
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Logger/FlightLogbook.hpp"
+#include "io/FileOutputStream.hxx"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <string_view>
+
+static const Path log_path(_T("output/test/flights.log"));
+static const Path index_path(_T("output/test/flights.idx"));
+
+static void
+Append(std::string_view text, bool create=false)
+{
+  FileOutputStream file(log_path, create
+                        ? FileOutputStream::Mode::CREATE
+                        : FileOutputStream::Mode::APPEND_EXISTING);
+  file.Write(std::as_bytes(std::span{text}));
+  file.Commit();
+}
+
+static FlightLogbook
+Update()
+{
+  FlightLogbook logbook(log_path);
+  logbook.Update();
+  return logbook;
+}
+
+static bool
+Equals(const FlightInfo &flight, unsigned year, unsigned month,
+       unsigned day, unsigned start_hour, int end_hour) noexcept
+{
+  return flight.date == BrokenDate(year, month, day) &&
+    flight.start_time.hour == start_hour &&
+    (end_hour < 0
+     ? !flight.end_time.IsPlausible()
+     : flight.end_time.hour == unsigned(end_hour));
+}
+
+static void
+TestMigrate()
+{
+  File::Delete(index_path);
+  Append("2022-05-01T10:00:00 start\n"
+         "2022-05-01T12:30:00 landing\n"
+         "garbage\n"
+         "2023-07-02T09:00:00 start\n"
+         "2023-07-02T10:00:00 landing\n"
+         "2023-07-03T11:00:00 start\n"
+         "2023-07-03T11:45:00 landing\n", true);
+
+  const auto logbook = Update();
+  ok1(File::Exists(index_path));
+  ok1(logbook.GetFlightCount() == 3);
+
+  const auto &years = logbook.GetYears();
+  ok1(years.size() == 2);
+  ok1(years[0].year == 2022 && years[0].n_flights == 1 &&
+      years[0].duration == std::chrono::minutes(150));
+  ok1(years[1].year == 2023 && years[1].n_flights == 2 &&
+      years[1].duration == std::chrono::minutes(105));
+
+  const auto &recent = logbook.GetRecentFlights();
+  ok1(recent.size() == 3);
+  ok1(Equals(recent.front(), 2022, 5, 1, 10, 12));
+  ok1(Equals(recent.back(), 2023, 7, 3, 11, 11));
+}
+
+static void
+TestIncremental()
+{
+  /* a start without landing is shown, but not indexed */
+  Append("2024-04-20T13:00:00 start\n");
+
+  {
+    const auto logbook = Update();
+    ok1(logbook.GetFlightCount() == 4);
+    ok1(logbook.GetYears().size() == 2);
+    ok1(Equals(logbook.GetRecentFlights().back(), 2024, 4, 20, 13, -1));
+  }
+
+  /* the landing completes it */
+  Append("2024-04-20T15:00:00 landing\n");
+
+  {
+    const auto logbook = Update();
+    ok1(logbook.GetFlightCount() == 4);
+    ok1(logbook.GetYears().size() == 3);
+    ok1(logbook.GetYears().back().duration == std::chrono::hours(2));
+    ok1(Equals(logbook.GetRecentFlights().back(), 2024, 4, 20, 13, 15));
+  }
+
+  /* a start followed by another start is a flight without landing;
+     an incomplete line at the end is ignored */
+  Append("2024-04-21T08:00:00 start\n"
+         "2024-04-21T09:00:00 start\n"
+         "2024-04-21T10:00:00 landing\n"
+         "2024-04-21T11:00");
+
+  const auto logbook = Update();
+  ok1(logbook.GetFlightCount() == 6);
+  ok1(logbook.GetYears().back().n_flights == 3);
+  ok1(logbook.GetYears().back().duration == std::chrono::hours(3));
+
+  const auto &recent = logbook.GetRecentFlights();
+  ok1(Equals(recent[recent.size() - 2], 2024, 4, 21, 8, -1));
+  ok1(Equals(recent.back(), 2024, 4, 21, 9, 10));
+}
+
+static void
+TestReplaced()
+{
+  /* a different log with more bytes than the old one: the index must
+     be rebuilt */
+  Append("2021-01-02T10:00:00 start\n"
+         "2021-01-02T11:00:00 landing\n"
+         "2021-01-03T10:00:00 start\n"
+         "2021-01-03T11:00:00 landing\n"
+         "2021-01-04T10:00:00 start\n"
+         "2021-01-04T11:00:00 landing\n"
+         "2021-01-05T10:00:00 start\n"
+         "2021-01-05T11:00:00 landing\n"
+         "2021-01-06T10:00:00 start\n"
+         "2021-01-06T11:00:00 landing\n"
+         "2021-01-07T10:00:00 start\n"
+         "2021-01-07T11:00:00 landing\n"
+         "2021-01-08T10:00:00 start\n"
+         "2021-01-08T11:00:00 landing\n", true);
+
+  const auto logbook = Update();
+  ok1(logbook.GetFlightCount() == 7);
+  ok1(logbook.GetYears().size() == 1);
+  ok1(logbook.GetYears().front().duration == std::chrono::hours(7));
+}
+
+static void
+TestRecent()
+{
+  static constexpr std::string_view flight =
+    "2020-06-01T10:00:00 start\n"
+    "2020-06-01T10:30:00 landing\n";
+
+  Append("", true);
+  for (unsigned i = 0; i < FlightLogbook::MAX_RECENT + 10; ++i)
+    Append(flight);
+
+  const auto logbook = Update();
+  ok1(logbook.GetFlightCount() == FlightLogbook::MAX_RECENT + 10);
+  ok1(logbook.GetRecentFlights().size() == FlightLogbook::MAX_RECENT);
+
+  /* loaded from the index only */
+  const auto logbook2 = Update();
+  ok1(logbook2.GetFlightCount() == FlightLogbook::MAX_RECENT + 10);
+  ok1(logbook2.GetRecentFlights().size() == FlightLogbook::MAX_RECENT);
+  ok1(logbook2.GetYears().front().duration ==
+      std::chrono::minutes(30) * (FlightLogbook::MAX_RECENT + 10));
+
+  /* the indexed part of the log is not parsed again: breaking its
+     first flight (but not the tail which is compared) changes
+     nothing */
+  Append("2020-06-01T10:00:00 xxxxx\n"
+         "2020-06-01T10:30:00 xxxxxxx\n", true);
+  for (unsigned i = 1; i < FlightLogbook::MAX_RECENT + 10; ++i)
+    Append(flight);
+
+  ok1(Update().GetFlightCount() == FlightLogbook::MAX_RECENT + 10);
+}
+
+int main()
+{
+  plan_tests(29);
+
+  TestMigrate();
+  TestIncremental();
+  TestReplaced();
+  TestRecent();
+
+  File::Delete(log_path);
+  File::Delete(index_path);
+
+  return exit_status();
+}
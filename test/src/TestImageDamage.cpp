@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ui/canvas/memory/Damage.hpp"
+#include "ui/canvas/memory/Dither.hpp"
+#include "TestUtil.hpp"
+
+#include <array>
+#include <cstdint>
+
+#include <string.h>
+
+static constexpr PixelSize size{64, 128};
+static constexpr std::size_t BPP = 4;
+static constexpr std::size_t PITCH = size.width * BPP;
+
+using Image = std::array<std::byte, PITCH * size.height>;
+
+static void
+Set(Image &image, unsigned x, unsigned y) noexcept
+{
+  image[y * PITCH + x * BPP + 1] = std::byte{0xff};
+}
+
+static DamageList
+Compare(const Image &a, const Image &b) noexcept
+{
+  DamageList damage;
+  FindDamage(damage, a.data(), PITCH, b.data(), PITCH, size, BPP);
+  return damage;
+}
+
+static bool
+operator==(const PixelRect &a, const PixelRect &b) noexcept
+{
+  return a.left == b.left && a.top == b.top &&
+    a.right == b.right && a.bottom == b.bottom;
+}
+
+using GreyImage = std::array<uint8_t, size.width * size.height>;
+
+static void
+DitherFull(GreyImage &dest, const GreyImage &src) noexcept
+{
+  Dither dither;
+  dither.DitherGreyscale(src.data(), size.width, dest.data(), size.width,
+                         size.width, size.height);
+}
+
+/**
+ * Convert only the damaged parts of a frame, the way TopCanvas::Flip()
+ * does it with dithering, and compare with a full conversion.
+ */
+static void
+TestDither()
+{
+  GreyImage previous, current;
+  for (unsigned y = 0; y < size.height; ++y)
+    for (unsigned x = 0; x < size.width; ++x)
+      previous[y * size.width + x] = (x * 3 + y * 5) % 256;
+
+  current = previous;
+  for (unsigned y = 40; y < 50; ++y)
+    for (unsigned x = 20; x < 30; ++x)
+      current[y * size.width + x] = 0x80;
+
+  GreyImage previous_output, expected;
+  DitherFull(previous_output, previous);
+  DitherFull(expected, current);
+
+  DamageList damage;
+  FindDamage(damage,
+             reinterpret_cast<const std::byte *>(current.data()), size.width,
+             reinterpret_cast<const std::byte *>(previous.data()), size.width,
+             size, 1);
+  ok1(damage.size() == 1);
+  ok1(damage.front() == PixelRect(20, 40, 30, 50));
+
+  /* dithering only the damaged rectangle gives a different result,
+     because the error diffusion starts from scratch there and does
+     not reach the rows below */
+  const PixelRect &rc = damage.front();
+  GreyImage output = previous_output;
+  Dither dither;
+  dither.DitherGreyscale(current.data() + rc.top * size.width + rc.left,
+                         size.width,
+                         output.data() + rc.top * size.width + rc.left,
+                         size.width, rc.GetWidth(), rc.GetHeight());
+  ok1(output != expected);
+
+  ExtendDamageForDither(damage, size);
+  ok1(damage.size() == 1);
+  ok1(damage.front() == PixelRect(0, 40, size.width, size.height));
+
+  /* the rows above the damage do not change */
+  ok1(memcmp(previous_output.data(), expected.data(),
+             40 * size.width) == 0);
+
+  /* resuming at the last checkpoint above the damage gives the same
+     result as a full conversion */
+  Dither resumed;
+  output = {};
+  resumed.DitherGreyscale(previous.data(), size.width,
+                          output.data(), size.width,
+                          size.width, size.height);
+  ok1(output == previous_output);
+
+  unsigned y = resumed.GetResumeRow(size.width, damage.front().top);
+  ok1(y == 32);
+  resumed.DitherGreyscale(current.data() + y * size.width, size.width,
+                          output.data() + y * size.width, size.width,
+                          size.width, size.height - y, y);
+  ok1(output == expected);
+
+  /* the checkpoints below the damage were updated by the previous
+     conversion */
+  for (unsigned x = 0; x < size.width; ++x)
+    current[100 * size.width + x] = 0xff;
+  DitherFull(expected, current);
+
+  y = resumed.GetResumeRow(size.width, 100);
+  ok1(y == 96);
+  resumed.DitherGreyscale(current.data() + y * size.width, size.width,
+                          output.data() + y * size.width, size.width,
+                          size.width, size.height - y, y);
+  ok1(output == expected);
+
+  /* the checkpoints are useless for a different width */
+  ok1(resumed.GetResumeRow(size.width / 2, 100) == 0);
+}
+
+int main()
+{
+  plan_tests(22);
+
+  const Image previous{};
+
+  /* no change */
+  ok1(Compare(previous, previous).empty());
+
+  /* one pixel */
+  Image current = previous;
+  Set(current, 10, 20);
+  auto damage = Compare(current, previous);
+  ok1(damage.size() == 1);
+  ok1(damage.front() == PixelRect(10, 20, 11, 21));
+
+  /* rows close to each other are merged */
+  Set(current, 30, 25);
+  damage = Compare(current, previous);
+  ok1(damage.size() == 1);
+  ok1(damage.front() == PixelRect(10, 20, 31, 26));
+  ok1(GetArea(damage) == 21 * 6);
+
+  /* distant rows make a new band */
+  Set(current, 0, 47);
+  damage = Compare(current, previous);
+  ok1(damage.size() == 2);
+  ok1(damage.back() == PixelRect(0, 47, 1, 48));
+
+  /* the number of bands is limited; the last one absorbs the rest */
+  current = previous;
+  for (unsigned y = 0; y < size.height; y += 10)
+    Set(current, y / 2, y);
+  damage = Compare(current, previous);
+  ok1(damage.full());
+  ok1(damage.back() == PixelRect(35, 70, 61, 121));
+
+  TestDither();
+
+  return exit_status();
+}
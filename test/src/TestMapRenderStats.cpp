@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "MapWindow/MapRenderStats.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/StringOutputStream.hxx"
+#include "TestUtil.hpp"
+
+using Layer = MapRenderStats::Layer;
+using Cache = MapRenderStats::Cache;
+using Duration = MapRenderStats::Duration;
+
+static MapRenderStats::Frame
+MakeFrame(unsigned terrain_us, unsigned waypoints_us) noexcept
+{
+  MapRenderStats::Frame frame;
+  frame.layers[std::size_t(Layer::TERRAIN)] = Duration{terrain_us};
+  frame.layers[std::size_t(Layer::WAYPOINTS)] = Duration{waypoints_us};
+  frame.total = Duration{terrain_us + waypoints_us};
+  frame.caches[std::size_t(Cache::TERRAIN)] = {terrain_us == 1, terrain_us != 1};
+  return frame;
+}
+
+static void
+TestEmpty()
+{
+  MapRenderStats stats;
+  const auto summary = stats.GetSummary();
+  ok1(summary.n_frames == 0);
+  ok1(summary.total.max == Duration{});
+}
+
+static void
+TestPercentiles()
+{
+  MapRenderStats stats;
+
+  /* 1..100 microseconds, shuffled */
+  for (unsigned i = 0; i < 100; ++i)
+    stats.Commit(MakeFrame((i * 37) % 100 + 1, 5));
+
+  const auto summary = stats.GetSummary();
+  ok1(summary.n_frames == 100);
+
+  const auto &terrain = summary.layers[std::size_t(Layer::TERRAIN)];
+  ok1(terrain.p50 == Duration{50});
+  ok1(terrain.p90 == Duration{90});
+  ok1(terrain.p99 == Duration{99});
+  ok1(terrain.max == Duration{100});
+
+  const auto &waypoints = summary.layers[std::size_t(Layer::WAYPOINTS)];
+  ok1(waypoints.p50 == Duration{5} && waypoints.max == Duration{5});
+
+  ok1(summary.layers[std::size_t(Layer::AIRSPACE)].max == Duration{});
+  ok1(summary.total.max == Duration{105});
+
+  const auto &cache = summary.caches[std::size_t(Cache::TERRAIN)];
+  ok1(cache.hits == 1 && cache.misses == 99);
+}
+
+static void
+TestRing()
+{
+  MapRenderStats stats;
+
+  /* the old frames are overwritten */
+  for (unsigned i = 0; i < MapRenderStats::HISTORY; ++i)
+    stats.Commit(MakeFrame(1000, 0));
+  for (unsigned i = 0; i < MapRenderStats::HISTORY; ++i)
+    stats.Commit(MakeFrame(10, 0));
+
+  auto summary = stats.GetSummary();
+  ok1(summary.n_frames == MapRenderStats::HISTORY);
+  ok1(summary.total.max == Duration{10});
+
+  stats.Clear();
+  summary = stats.GetSummary();
+  ok1(summary.n_frames == 0);
+}
+
+static void
+TestRecorder()
+{
+  MapRenderStats::Recorder recorder;
+
+  recorder.BeginFrame();
+  recorder.Mark(Layer::TERRAIN);
+  recorder.Mark(Layer::TASK);
+  recorder.Mark(Layer::TERRAIN);
+  recorder.SetCache(Cache::REACH, {3, 4});
+  const auto &frame = recorder.EndFrame();
+
+  Duration sum{};
+  for (const auto i : frame.layers)
+    sum += i;
+
+  ok1(sum <= frame.total);
+  ok1(frame.layers[std::size_t(Layer::AIRSPACE)] == Duration{});
+  ok1(frame.caches[std::size_t(Cache::REACH)].hits == 3);
+
+  /* a new frame starts from scratch */
+  recorder.BeginFrame();
+  ok1(recorder.EndFrame().caches[std::size_t(Cache::REACH)].misses == 0);
+}
+
+static void
+TestDump()
+{
+  MapRenderStats stats;
+  stats.Commit(MakeFrame(42, 7));
+
+  StringOutputStream sos;
+  BufferedOutputStream bos(sos);
+  stats.Dump(bos);
+  bos.Flush();
+
+  const auto &s = sos.GetValue();
+  ok1(s.starts_with("frames: 1\n"));
+  ok1(s.find("Waypoints                 7        7        7        7\n") != s.npos);
+  ok1(s.find("Reach                     0        0\n") != s.npos);
+}
+
+int main()
+{
+  plan_tests(2 + 9 + 3 + 4 + 3);
+
+  TestEmpty();
+  TestPercentiles();
+  TestRing();
+  TestRecorder();
+  TestDump();
+
+  return exit_status();
+}
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Terrain/RasterLineWalker.hpp"
+#include "TestUtil.hpp"
+
+#include <cstdlib>
+#include <iterator>
+
+/**
+ * Compare RasterLineWalker with the classic Bresenham loop, sampling
+ * every n-th step like RasterTileCache::GroundIntersection() did
+ * before.
+ */
+static bool
+TestLine(SignedRasterLocation origin, SignedRasterLocation destination,
+         unsigned n)
+{
+  const int dx = std::abs(destination.x - origin.x);
+  const int dy = std::abs(destination.y - origin.y);
+  int err = dx - dy;
+  const int sx = origin.x < destination.x ? 1 : -1;
+  const int sy = origin.y < destination.y ? 1 : -1;
+
+  RasterLineWalker line(origin, destination);
+  if (line.GetMaxSteps() != dx + dy)
+    return false;
+
+  SignedRasterLocation location = origin;
+  unsigned step_counter = 0;
+  int total_steps = 0;
+
+  /* walk twice the line length to cover the part beyond the
+     destination */
+  while (total_steps <= 2 * (dx + dy)) {
+    if (!step_counter) {
+      if (line.GetLocation() != location ||
+          line.GetTotalSteps() != total_steps)
+        return false;
+
+      step_counter = n;
+      line.Advance(n);
+    }
+
+    const int e2 = 2 * err;
+    if (e2 > -dy) {
+      err -= dy;
+      location.x += sx;
+      if (step_counter)
+        step_counter--;
+      total_steps++;
+    }
+    if (e2 < dx) {
+      err += dx;
+      location.y += sy;
+      if (step_counter)
+        step_counter--;
+      total_steps++;
+    }
+  }
+
+  return true;
+}
+
+int main()
+{
+  static constexpr SignedRasterLocation destinations[] = {
+    {100, 0},
+    {0, 100},
+    {100, 100},
+    {100, 37},
+    {-41, 100},
+    {-100, -99},
+    {3, -250},
+    {-1000, 999},
+  };
+
+  static constexpr unsigned steps[] = { 1, 2, 7, 16 };
+
+  plan_tests(std::size(destinations) * std::size(steps) + 2);
+
+  const SignedRasterLocation origin(12, 34);
+
+  for (const auto &d : destinations)
+    for (const unsigned n : steps)
+      ok1(TestLine(origin, {origin.x + d.x, origin.y + d.y}, n));
+
+  /* a zero-length line stays at its origin */
+  RasterLineWalker line(origin, origin);
+  line.Advance(5);
+  ok1(line.GetLocation() == origin);
+  ok1(line.GetTotalSteps() > line.GetMaxSteps());
+
+  return exit_status();
+}
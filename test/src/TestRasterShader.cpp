@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Terrain/RasterShader.hpp"
+#include "ui/canvas/RawBitmap.hpp"
+#include "ui/canvas/Ramp.hpp"
+#include "Math/Angle.hpp"
+#include "TestUtil.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <string.h>
+
+static constexpr ColorRamp terrain_colors[NUM_COLOR_RAMP_LEVELS] = {
+  {0, {0x70, 0xc0, 0xa7}},
+  {250, {0xca, 0xe7, 0xb9}},
+  {500, {0xf4, 0xea, 0xaf}},
+  {750, {0xdc, 0xb2, 0x82}},
+  {1000, {0xca, 0x8e, 0x72}},
+  {1250, {0xde, 0xc8, 0xbd}},
+  {1500, {0xe3, 0xe4, 0xe9}},
+  {1750, {0xdb, 0xd9, 0xef}},
+  {2000, {0xce, 0xcd, 0xf5}},
+  {2250, {0xc2, 0xc1, 0xfa}},
+  {2500, {0xb7, 0xb9, 0xff}},
+  {5000, {0xb7, 0xb9, 0xff}},
+  {6000, {0xb7, 0xb9, 0xff}},
+};
+
+/**
+ * A simple deterministic random number generator.
+ */
+class Random {
+  uint32_t state = 1;
+
+public:
+  int operator()(int min, int max) noexcept {
+    state = state * 1103515245 + 12345;
+    return min + int((state >> 8) % unsigned(max - min + 1));
+  }
+};
+
+/**
+ * Generate a synthetic height matrix with hills, noise, water and an
+ * area outside of the terrain file.
+ */
+static std::vector<TerrainHeight>
+MakeTerrain(UnsignedPoint2D size) noexcept
+{
+  Random random;
+  std::vector<TerrainHeight> heights;
+  heights.reserve(size.x * size.y);
+
+  for (unsigned y = 0; y < size.y; ++y) {
+    for (unsigned x = 0; x < size.x; ++x) {
+      int value = int(800 + 600 * sin(x * 0.05) * cos(y * 0.037)
+                      + 300 * sin((x + y) * 0.11)) + random(0, 39);
+
+      if ((x / 40 + y / 60) % 7 == 3 && x % 40 < 25)
+        /* lakes */
+        value = -31000;
+
+      if (x < 5 && y > 50)
+        /* a river along the left edge */
+        value = -31000;
+
+      if (y > 200 && y < 300 && x > 100 && x < 140)
+        /* outside of the terrain file */
+        value = TerrainHeight::Invalid().GetValue();
+
+      heights.emplace_back(int16_t(value));
+    }
+  }
+
+  return heights;
+}
+
+struct Parameters {
+  unsigned quantisation_effective;
+  bool do_shading, do_contour;
+};
+
+static void
+Generate(RasterShader &shader, const std::vector<TerrainHeight> &heights,
+         UnsignedPoint2D size, const Parameters &p,
+         RawColor *top_row, std::ptrdiff_t pitch) noexcept
+{
+  shader.PrepareColorTable(terrain_colors, true, 4, 5);
+  shader.Generate(heights.data(), size, p.quantisation_effective, 150,
+                  top_row, pitch,
+                  p.do_shading, 4, 64, 128, Angle::Degrees(-45),
+                  p.do_contour);
+}
+
+static std::vector<RawColor>
+Generate(unsigned max_bands, const std::vector<TerrainHeight> &heights,
+         UnsignedPoint2D size, const Parameters &p) noexcept
+{
+  std::vector<RawColor> image(size.x * size.y);
+  RasterShader shader(max_bands);
+  Generate(shader, heights, size, p, image.data(), size.x);
+  return image;
+}
+
+static bool
+Equals(const std::vector<RawColor> &a, const std::vector<RawColor> &b) noexcept
+{
+  return a.size() == b.size() &&
+    memcmp(a.data(), b.data(), a.size() * sizeof(a.front())) == 0;
+}
+
+static constexpr UnsignedPoint2D size{333, 517};
+
+static constexpr Parameters parameters[] = {
+  {0, false, false},
+  {1, false, false},
+  {1, false, true},
+  {1, true, false},
+  {1, true, true},
+  {3, true, true},
+  {7, false, true},
+  {7, true, true},
+  {25, true, true},
+};
+
+static void
+TestBands(const std::vector<TerrainHeight> &heights)
+{
+  for (const auto &p : parameters) {
+    /* the serial path is the reference */
+    const auto expected = Generate(1, heights, size, p);
+
+    for (unsigned n_bands = 2; n_bands <= RasterShader::MAX_BANDS;
+         ++n_bands)
+      ok1(Equals(Generate(n_bands, heights, size, p), expected));
+  }
+}
+
+/**
+ * Generate a smaller matrix into a wider image with the same object,
+ * like #RasterRenderer does when it reuses its #RawBitmap.
+ */
+static void
+TestReuse(const std::vector<TerrainHeight> &heights)
+{
+  static constexpr Parameters p{3, true, true};
+
+  static constexpr UnsignedPoint2D small_size{200, 300};
+  const auto small_heights = MakeTerrain(small_size);
+  const auto expected = Generate(1, small_heights, small_size, p);
+
+  RasterShader shader(RasterShader::MAX_BANDS);
+  std::vector<RawColor> image(size.x * size.y);
+  Generate(shader, heights, size, p, image.data(), size.x);
+  Generate(shader, small_heights, small_size, p, image.data(), size.x);
+
+  bool equals = true;
+  for (unsigned y = 0; y < small_size.y; ++y)
+    equals &= memcmp(image.data() + y * size.x,
+                     expected.data() + y * small_size.x,
+                     small_size.x * sizeof(RawColor)) == 0;
+  ok1(equals);
+
+  /* bottom-up image, like a WIN32 bitmap */
+  std::vector<RawColor> flipped(small_size.x * small_size.y);
+  Generate(shader, small_heights, small_size, p,
+           flipped.data() + (small_size.y - 1) * small_size.x,
+           -std::ptrdiff_t(small_size.x));
+
+  equals = true;
+  for (unsigned y = 0; y < small_size.y; ++y)
+    equals &= memcmp(flipped.data() + (small_size.y - 1 - y) * small_size.x,
+                     expected.data() + y * small_size.x,
+                     small_size.x * sizeof(RawColor)) == 0;
+  ok1(equals);
+}
+
+int main()
+{
+  plan_tests(std::size(parameters) * (RasterShader::MAX_BANDS - 1) + 2);
+
+  const auto heights = MakeTerrain(size);
+  TestBands(heights);
+  TestReuse(heights);
+
+  return exit_status();
+}
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ui/canvas/memory/TiledRasteriser.hpp"
+#include "ui/canvas/memory/RasterCanvas.hpp"
+#include "ui/canvas/memory/Optimised.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <string.h>
+
+using Buffer = WritableImageBuffer<ActivePixelTraits>;
+using color_type = ActivePixelTraits::color_type;
+
+static constexpr PixelSize size{160, 300};
+
+/**
+ * A simple deterministic random number generator.
+ */
+class Random {
+  uint32_t state = 1;
+
+public:
+  int operator()(int min, int max) noexcept {
+    state = state * 1103515245 + 12345;
+    return min + int((state >> 8) % unsigned(max - min + 1));
+  }
+};
+
+/**
+ * The recorded draw calls of one test scene.
+ */
+struct Shape {
+  std::vector<BulkPixelPoint> points;
+  color_type color;
+  uint8_t alpha;
+  bool fill, loop;
+  unsigned thickness, line_mask;
+};
+
+static std::vector<Shape>
+MakeScene(unsigned n_shapes) noexcept
+{
+  static constexpr unsigned masks[] = {
+    unsigned(-1), unsigned(-1 - 0b100), unsigned(-1 - 0b1100),
+  };
+
+  Random random;
+  std::vector<Shape> scene;
+
+  for (unsigned i = 0; i < n_shapes; ++i) {
+    Shape shape;
+
+    /* some points are outside of the buffer, to exercise clipping */
+    const unsigned n_points = random(2, 12);
+    for (unsigned j = 0; j < n_points; ++j)
+      shape.points.emplace_back(random(-40, size.width + 40),
+                                random(-40, size.height + 40));
+
+    shape.color = BGRA8Color(random(0, 255), random(0, 255),
+                             random(0, 255), 0xff);
+    shape.alpha = random(0, 1) ? 0xff : random(0, 0xfe);
+    shape.fill = random(0, 1);
+    shape.loop = random(0, 1);
+    shape.thickness = random(0, 2) == 0 ? random(2, 7) : 1;
+    shape.line_mask = masks[random(0, 2)];
+    scene.push_back(std::move(shape));
+  }
+
+  return scene;
+}
+
+static void
+DrawDirect(Buffer buffer, const std::vector<Shape> &scene) noexcept
+{
+  RasterCanvas<ActivePixelTraits> canvas(buffer);
+
+  for (const auto &shape : scene) {
+    if (shape.fill) {
+      if (shape.alpha == 0xff)
+        canvas.FillPolygon(shape.points.data(), shape.points.size(),
+                           shape.color);
+      else
+        canvas.FillPolygon(shape.points.data(), shape.points.size(),
+                           shape.color,
+                           AlphaPixelOperations<ActivePixelTraits>(shape.alpha));
+    } else
+      canvas.DrawPolyline(shape.points.data(), shape.points.size(),
+                          shape.loop, shape.color,
+                          shape.thickness, shape.line_mask);
+  }
+}
+
+static void
+Record(TiledRasteriser &tiled, const std::vector<Shape> &scene)
+{
+  for (const auto &shape : scene) {
+    if (shape.fill)
+      tiled.FillPolygon(shape.points.data(), shape.points.size(),
+                        shape.color, shape.alpha);
+    else
+      tiled.DrawPolyline(shape.points.data(), shape.points.size(),
+                         shape.loop, shape.color,
+                         shape.thickness, shape.line_mask);
+  }
+}
+
+static void
+Clear(Buffer buffer) noexcept
+{
+  std::fill_n(buffer.data, buffer.size.width * buffer.size.height,
+              BGRA8Color(0x40, 0x40, 0x40, 0xff));
+}
+
+static bool
+Equals(Buffer a, Buffer b) noexcept
+{
+  return memcmp(a.data, b.data, a.pitch * a.size.height) == 0;
+}
+
+static void
+TestScene(const std::vector<Shape> &scene)
+{
+  Buffer expected, actual;
+  expected.Allocate(size);
+  actual.Allocate(size);
+
+  Clear(expected);
+  DrawDirect(expected, scene);
+
+  for (unsigned n_bands = 1; n_bands <= TiledRasteriser::MAX_BANDS;
+       ++n_bands) {
+    TiledRasteriser tiled(n_bands);
+
+    Clear(actual);
+    tiled.Begin(actual);
+    Record(tiled, scene);
+    tiled.Flush();
+    ok1(Equals(actual, expected));
+  }
+
+  expected.Free();
+  actual.Free();
+}
+
+static void
+TestReuse()
+{
+  const auto scene = MakeScene(200);
+
+  Buffer expected, actual;
+  expected.Allocate(size);
+  actual.Allocate(size);
+
+  Clear(expected);
+  DrawDirect(expected, scene);
+  DrawDirect(expected, scene);
+
+  /* two frames with the same object: the commands of the first one
+     must be gone after Flush() */
+  TiledRasteriser tiled(TiledRasteriser::MAX_BANDS);
+  Clear(actual);
+  for (unsigned i = 0; i < 2; ++i) {
+    tiled.Begin(actual);
+    Record(tiled, scene);
+    tiled.Flush();
+  }
+
+  ok1(Equals(actual, expected));
+
+  expected.Free();
+  actual.Free();
+}
+
+int main()
+{
+  plan_tests(2 * TiledRasteriser::MAX_BANDS + 1);
+
+  /* enough points to be split into bands */
+  TestScene(MakeScene(200));
+
+  /* below the threshold, everything is drawn in one band */
+  TestScene(MakeScene(5));
+
+  TestReuse();
+
+  return exit_status();
+}
@@ -0,0 +1,364 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Topography/TopographyFile.hpp"
+#include "Topography/TopographyPack.hpp"
+#include "Topography/XShape.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/ZipArchive.hpp"
+#include "system/Path.hpp"
+#include "util/StringAPI.hxx"
+#include "util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <string.h>
+
+static bool
+IsEqual(const XShape &a, const XShape &b,
+        [[maybe_unused]] const TopographyFile &file) noexcept
+{
+  if (a.get_type() != b.get_type() ||
+      a.get_bounds().GetNorthWest() != b.get_bounds().GetNorthWest() ||
+      a.get_bounds().GetSouthEast() != b.get_bounds().GetSouthEast() ||
+      !std::equal(a.GetLines().begin(), a.GetLines().end(),
+                  b.GetLines().begin(), b.GetLines().end()))
+    return false;
+
+  if ((a.GetLabel() == nullptr) != (b.GetLabel() == nullptr) ||
+      (a.GetLabel() != nullptr && !StringIsEqual(a.GetLabel(), b.GetLabel())))
+    return false;
+
+  std::size_t n_points = 0;
+  for (const auto i : a.GetLines())
+    n_points += i;
+
+  if (!std::equal(a.GetPoints(), a.GetPoints() + n_points, b.GetPoints()))
+    return false;
+
+#ifdef ENABLE_OPENGL
+  if (a.get_type() != MS_SHAPE_LINE && a.get_type() != MS_SHAPE_POLYGON)
+    return true;
+
+  for (unsigned level = 0; level < XShape::THINNING_LEVELS; ++level) {
+    const auto min_distance = file.GetMinimumShapeDistance(level, 1);
+    const auto x = a.GetIndices(level, min_distance);
+    const auto y = b.GetIndices(level, min_distance);
+    if ((x.indices == nullptr) != (y.indices == nullptr))
+      return false;
+
+    if (x.indices == nullptr)
+      continue;
+
+    std::size_t n_counts = 1, n_indices = *x.count;
+    if (a.get_type() == MS_SHAPE_LINE) {
+      n_counts = a.GetLines().size();
+      n_indices = 0;
+      for (std::size_t i = 0; i < n_counts; ++i)
+        n_indices += x.count[i];
+    }
+
+    if (!std::equal(x.count, x.count + n_counts, y.count) ||
+        !std::equal(x.indices, x.indices + n_indices, y.indices))
+      return false;
+  }
+#endif
+
+  return true;
+}
+
+/**
+ * Compare the shapes currently loaded by two files.
+ */
+static bool
+IsEqual(const TopographyFile &a, const TopographyFile &b) noexcept
+{
+  const std::lock_guard lock_a{a.mutex}, lock_b{b.mutex};
+
+  auto x = a.begin(), y = b.begin();
+  for (; x != a.end() && y != b.end(); ++x, ++y)
+    if (!IsEqual(*x, *y, a))
+      return false;
+
+  return x == a.end() && y == b.end();
+}
+
+[[gnu::pure]]
+static std::size_t
+CountShapes(const TopographyFile &file) noexcept
+{
+  const std::lock_guard lock{file.mutex};
+
+  std::size_t n = 0;
+  for ([[maybe_unused]] const auto &shape : file)
+    ++n;
+
+  return n;
+}
+
+static void
+SavePack(TopographyFile &file, FileCache &cache, Path source)
+{
+  auto os = cache.Save(_T("topography-test"), source);
+  BufferedOutputStream bos(*os);
+  file.SavePack(bos, 1);
+  bos.Flush();
+  os->Commit();
+}
+
+static void
+TestFile(ZipArchive &archive, Path map_path, FileCache &cache,
+         const char *name, double threshold, int label_field)
+{
+  const BGRA8Color color(0, 0, 0);
+  TopographyFile plain(archive.get(), name, threshold, threshold, threshold,
+                       color, label_field);
+  TopographyFile packed(archive.get(), name, threshold, threshold, threshold,
+                        color, label_field);
+
+  SavePack(packed, cache, map_path);
+
+  /* a pack compiled with a different label field is rejected */
+  TopographyFile other(archive.get(), name, threshold, threshold, threshold,
+                       color, label_field + 1);
+  ok1(!other.LoadPack(cache.Map(_T("topography-test"), map_path), 1));
+
+  ok1(packed.LoadPack(cache.Map(_T("topography-test"), map_path), 1));
+
+  /* a part of the map */
+  WindowProjection projection;
+  projection.SetScreenSize({640, 480});
+  projection.SetScaleFromRadius(3000);
+  projection.SetGeoLocation(plain.GetCenter());
+  projection.SetScreenOrigin(320, 240);
+  projection.UpdateScreenBounds();
+
+  /* the pack's grid index selects the same shapes as shapelib */
+  ok1(plain.Update(projection));
+  ok1(packed.Update(projection));
+  ok1(CountShapes(plain) > 0 && IsEqual(plain, packed));
+
+  /* compare all shapes */
+  plain.LoadAll();
+  packed.LoadAll();
+  ok1(IsEqual(plain, packed));
+}
+
+/**
+ * Save a copy of the pack "topography-test", modified by the given
+ * function, as "topography-corrupt".
+ */
+template<typename F>
+static void
+SaveCorruptPack(FileCache &cache, Path source, F &&f)
+{
+  std::vector<std::byte> data;
+  {
+    const auto mapping = cache.Map(_T("topography-test"), source);
+    const std::span<const std::byte> raw = *mapping;
+    data.assign(raw.begin(), raw.end());
+  }
+
+  f(data);
+
+  auto os = cache.Save(_T("topography-corrupt"), source);
+  os->Write(std::span{data}.subspan(FileCache::HEADER_SIZE));
+  os->Commit();
+}
+
+/**
+ * Modify the first #TopographyPack::ShapeRecord for which the given
+ * function returns true.
+ *
+ * @return false if there is no such record
+ */
+template<typename F>
+static bool
+ModifyRecord(std::vector<std::byte> &data, F &&f)
+{
+  TopographyPack::Footer footer;
+  memcpy(&footer, data.data() + data.size() - sizeof(footer), sizeof(footer));
+
+  for (uint32_t i = 0; i < footer.n_shapes; ++i) {
+    std::byte *p = data.data() + footer.records_offset +
+      i * sizeof(TopographyPack::ShapeRecord);
+
+    TopographyPack::ShapeRecord r;
+    memcpy(&r, p, sizeof(r));
+    if (f(data, r)) {
+      memcpy(p, &r, sizeof(r));
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static constexpr std::size_t
+AlignOffset(std::size_t offset, std::size_t alignment) noexcept
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * The offset of the indices of a shape, see
+ * #TopographyPack::ShapeRecord.
+ */
+static std::size_t
+GetIndicesOffset(const TopographyPack::ShapeRecord &r) noexcept
+{
+  return AlignOffset(r.offset + r.num_lines * sizeof(uint16_t),
+                     alignof(XShape::Point)) +
+    r.n_points * sizeof(XShape::Point);
+}
+
+/**
+ * The offset of the label of a shape, see
+ * #TopographyPack::ShapeRecord.
+ */
+static std::size_t
+GetLabelOffset(const TopographyPack::ShapeRecord &r) noexcept
+{
+  std::size_t n_indices = 0;
+  for (const auto i : r.n_indices)
+    n_indices += i;
+
+  return AlignOffset(GetIndicesOffset(r) + n_indices * sizeof(uint16_t),
+                     alignof(TCHAR));
+}
+
+/**
+ * Does TopographyFile::LoadPack() reject the pack
+ * "topography-corrupt"?
+ */
+static bool
+IsRejected(ZipArchive &archive, Path map_path, FileCache &cache,
+           const char *name, double threshold, int label_field) noexcept
+{
+  TopographyFile file(archive.get(), name, threshold, threshold, threshold,
+                      BGRA8Color(0, 0, 0), label_field);
+
+  try {
+    return !file.LoadPack(cache.Map(_T("topography-corrupt"), map_path), 1);
+  } catch (...) {
+    return true;
+  }
+}
+
+/**
+ * Corrupt the pack saved by TestFile() in various ways; LoadPack()
+ * must reject all of them, so the pack is compiled again.
+ */
+static void
+TestCorrupt(ZipArchive &archive, Path map_path, FileCache &cache,
+            const char *name, double threshold, int label_field)
+{
+  /* truncated */
+  SaveCorruptPack(cache, map_path, [](auto &data){
+    data.resize(data.size() - 100);
+  });
+  ok1(IsRejected(archive, map_path, cache, name, threshold, label_field));
+
+  /* the line sizes don't add up to the number of points */
+  SaveCorruptPack(cache, map_path, [](auto &data){
+    ModifyRecord(data, [](auto &, auto &r){
+      ++r.n_points;
+      return true;
+    });
+  });
+  ok1(IsRejected(archive, map_path, cache, name, threshold, label_field));
+
+  /* an offset which would overflow the layout calculation */
+  SaveCorruptPack(cache, map_path, [](auto &data){
+    ModifyRecord(data, [](auto &, auto &r){
+      r.offset = ~uint64_t{} - 7;
+      return true;
+    });
+  });
+  ok1(IsRejected(archive, map_path, cache, name, threshold, label_field));
+
+  /* a label without the null terminator */
+  if (label_field >= 0) {
+    bool found = false;
+    SaveCorruptPack(cache, map_path, [&found](auto &data){
+      found = ModifyRecord(data, [](auto &d, auto &r){
+        if (r.label_size == 0)
+          return false;
+
+        const TCHAR x = _T('x');
+        memcpy(d.data() + GetLabelOffset(r) +
+               (r.label_size - 1) * sizeof(TCHAR),
+               &x, sizeof(x));
+        return true;
+      });
+    });
+    ok1(found &&
+        IsRejected(archive, map_path, cache, name, threshold, label_field));
+  }
+
+#ifdef ENABLE_OPENGL
+  /* an index which refers to a point that does not exist (if there
+     are indices at all) */
+  bool found = false;
+  SaveCorruptPack(cache, map_path, [&found](auto &data){
+    found = ModifyRecord(data, [](auto &d, auto &r){
+      if (r.n_indices[0] == 0)
+        return false;
+
+      const std::size_t n_counts =
+        r.type == MS_SHAPE_LINE ? r.num_lines : 1;
+      const uint16_t index = r.n_points;
+      memcpy(d.data() + GetIndicesOffset(r) + n_counts * sizeof(uint16_t),
+             &index, sizeof(index));
+      return true;
+    });
+  });
+  ok1(!found ||
+      IsRejected(archive, map_path, cache, name, threshold, label_field));
+#endif
+}
+
+#ifdef ENABLE_OPENGL
+static constexpr unsigned N_CORRUPT_TESTS = 4;
+#else
+static constexpr unsigned N_CORRUPT_TESTS = 3;
+#endif
+
+int main()
+try {
+  /* one more for the labels of the point file */
+  plan_tests(3 * (6 + N_CORRUPT_TESTS) + 1);
+
+  const Path map_path(_T("test/data/benalla9.xcm"));
+  ZipArchive archive(map_path);
+
+  FileCache cache(AllocatedPath(_T("output/test/topography-cache")));
+
+  static constexpr struct {
+    const char *name;
+    double threshold;
+    int label_field;
+  } files[] = {
+    { "watrcrslhydro_line.shp", 7000, -1 },
+    { "inwaterahydro_area.shp", 100000, -1 },
+    /* the first field, like "1" in topology.tpl */
+    { "mispopppop_point.shp", 5000, 0 },
+  };
+
+  for (const auto &i : files) {
+    TestFile(archive, map_path, cache, i.name, i.threshold, i.label_field);
+    TestCorrupt(archive, map_path, cache,
+                i.name, i.threshold, i.label_field);
+  }
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Trace/Vector.hpp"
+#include "time/Stamp.hpp"
+#include "TestUtil.hpp"
+
+#include <cmath>
+
+using namespace std::chrono;
+
+static constexpr TracePoint::Time
+GetTime(unsigned i) noexcept
+{
+  return TracePoint::Time{1000 + 4 * i};
+}
+
+/**
+ * Generate the i-th point of a circling climb drifting east.
+ */
+static TracePoint
+MakePoint(unsigned i) noexcept
+{
+  const GeoPoint location(Angle::Degrees(7 + 0.0002 * i +
+                                         0.002 * std::cos(i * 0.3)),
+                          Angle::Degrees(51 + 0.002 * std::sin(i * 0.3)));
+  return TracePoint(location, GetTime(i), 500. + i, 0., 0);
+}
+
+/**
+ * Verify that the columns mirror the chronological list.
+ */
+static bool
+CheckColumns(const Trace &trace) noexcept
+{
+  const auto points = trace.GetPointColumn();
+  const auto flat = trace.GetFlatColumn();
+  const auto times = trace.GetTimeColumn();
+
+  if (points.size() != trace.size() || flat.size() != trace.size() ||
+      times.size() != trace.size())
+    return false;
+
+  unsigned i = 0;
+  for (const TracePoint &p : trace) {
+    if (points[i] != &p ||
+        flat[i] != p.GetFlatLocation() ||
+        times[i] != p.GetTime())
+      return false;
+
+    ++i;
+  }
+
+  return i == trace.size();
+}
+
+/**
+ * Append points, verifying the columns after each one.
+ */
+static bool
+Append(Trace &trace, unsigned begin, unsigned end) noexcept
+{
+  bool result = true;
+  for (unsigned i = begin; i < end; ++i) {
+    trace.push_back(MakePoint(i));
+    result &= CheckColumns(trace);
+  }
+
+  return result;
+}
+
+static bool
+Equals(const TracePointVector &a, const TracePointVector &b) noexcept
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (unsigned i = 0; i < a.size(); ++i)
+    if (a[i].GetTime() != b[i].GetTime() ||
+        a[i].GetLocation() != b[i].GetLocation())
+      return false;
+
+  return true;
+}
+
+static void
+TestAppend()
+{
+  Trace trace({}, Trace::null_time, 64);
+  ok1(CheckColumns(trace));
+
+  ok1(Append(trace, 0, 50));
+  ok1(trace.size() == 50);
+  ok1(trace.FindTime(GetTime(10)) == 10);
+  ok1(trace.FindTime(GetTime(10) - TracePoint::Time{1}) == 10);
+  ok1(trace.FindTime(GetTime(50)) == 50);
+
+  trace.clear();
+  ok1(trace.GetPointColumn().empty());
+  ok1(Append(trace, 0, 10));
+}
+
+static void
+TestThin()
+{
+  Trace trace({}, Trace::null_time, 64);
+
+  /* each time the trace is full, Thin() removes points from the
+     middle */
+  ok1(Append(trace, 0, 500));
+  ok1(trace.size() < 64);
+  ok1(trace.front().GetTime() == GetTime(0));
+  ok1(trace.back().GetTime() == GetTime(499));
+}
+
+static void
+TestEvict()
+{
+  /* a five minute window */
+  Trace trace({}, minutes{5}, 1000);
+
+  /* old points are removed from the front */
+  ok1(Append(trace, 0, 200));
+  ok1(trace.front().GetTime() + minutes{5} >= trace.back().GetTime());
+  ok1(trace.front().GetTime() > GetTime(0));
+
+  trace.EraseEarlierThan(TimeStamp{GetTime(180)});
+  ok1(CheckColumns(trace));
+  ok1(trace.front().GetTime() == GetTime(180));
+
+  /* a slight time warp removes points from the back */
+  trace.push_back(MakePoint(195));
+  ok1(CheckColumns(trace));
+  ok1(trace.back().GetTime() == GetTime(195));
+
+  ok1(Append(trace, 196, 210));
+}
+
+static void
+TestGetPoints()
+{
+  Trace trace({}, Trace::null_time, 128);
+  Append(trace, 0, 100);
+
+  TracePointerVector pointers;
+  trace.GetPoints(pointers);
+  ok1(std::equal(pointers.begin(), pointers.end(),
+                 trace.GetPointColumn().begin(),
+                 trace.GetPointColumn().end()));
+
+  ok1(!trace.SyncPoints(pointers));
+  Append(trace, 100, 110);
+  ok1(trace.SyncPoints(pointers));
+  ok1(std::equal(pointers.begin(), pointers.end(),
+                 trace.GetPointColumn().begin(),
+                 trace.GetPointColumn().end()));
+
+  TracePointVector expected, points;
+  for (const auto &i : trace)
+    expected.push_back(i);
+  trace.GetPoints(points);
+  ok1(Equals(points, expected));
+
+  /* compare the filtered copy with a walk over the list */
+  const GeoPoint location = trace.back().GetLocation();
+  const TracePoint::Time min_time = GetTime(20);
+  const double resolution = 150;
+
+  expected.clear();
+  const unsigned range = trace.ProjectRange(location, resolution);
+  auto i = trace.begin();
+  const auto end = trace.end();
+  while (i->GetTime() < min_time)
+    ++i;
+  do {
+    expected.push_back(*i);
+    i.NextSquareRange(range * range, end);
+  } while (i != end);
+
+  points.clear();
+  trace.GetPoints(points, min_time, location, resolution);
+  ok1(expected.size() < trace.size() - 20);
+  ok1(Equals(points, expected));
+}
+
+int
+main()
+{
+  plan_tests(8 + 4 + 8 + 7);
+
+  TestAppend();
+  TestThin();
+  TestEvict();
+  TestGetPoints();
+
+  return exit_status();
+}
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FLARM/TrafficTable.hpp"
+#include "TestUtil.hpp"
+
+#include <stdio.h>
+
+static FlarmId
+MakeId(unsigned value) noexcept
+{
+  char buffer[16];
+  sprintf(buffer, "%X", value);
+  return FlarmId::Parse(buffer, nullptr);
+}
+
+static void
+Append(TrafficTable &table, unsigned value) noexcept
+{
+  FlarmTraffic &traffic = table.Append(MakeId(value));
+  traffic.Clear();
+  traffic.relative_north = value;
+}
+
+/**
+ * Check whether all items can be found at their position and carry
+ * the right payload.
+ */
+static bool
+CheckIndex(const TrafficTable &table) noexcept
+{
+  unsigned i = 0;
+  for (const auto &traffic : table) {
+    if (table.Find(traffic.id) != int(i) ||
+        MakeId(unsigned(traffic.relative_north)) != traffic.id)
+      return false;
+
+    ++i;
+  }
+
+  return i == table.size();
+}
+
+static void
+TestFill()
+{
+  TrafficTable table;
+  ok1(table.empty());
+  ok1(table.Find(MakeId(1)) == -1);
+
+  for (unsigned i = 1; i <= TrafficTable::MAX_SIZE; ++i)
+    Append(table, i * 7919);
+
+  ok1(table.full());
+  ok1(table.size() == TrafficTable::MAX_SIZE);
+  ok1(CheckIndex(table));
+  ok1(table.Find(MakeId(1)) == -1);
+
+  /* remove every third item */
+  for (unsigned i = 1; i <= TrafficTable::MAX_SIZE; i += 3)
+    table.QuickRemove(table.Find(MakeId(i * 7919)));
+
+  ok1(!table.full());
+  ok1(table.size() == TrafficTable::MAX_SIZE * 2 / 3);
+  ok1(CheckIndex(table));
+  ok1(table.Find(MakeId(7919)) == -1);
+  ok1(table.Find(MakeId(2 * 7919)) >= 0);
+}
+
+static void
+TestCollisions()
+{
+  /* these ids all have the same hash, forming one long probe
+     sequence */
+  static constexpr unsigned N = 40;
+  static constexpr unsigned STEP = 1024;
+
+  TrafficTable table;
+  for (unsigned i = 1; i <= N; ++i)
+    Append(table, i * STEP + 5);
+
+  ok1(CheckIndex(table));
+
+  /* remove from the middle of the probe sequence */
+  for (unsigned i = 1; i <= N; i += 2)
+    table.QuickRemove(table.Find(MakeId(i * STEP + 5)));
+
+  ok1(table.size() == N / 2);
+  ok1(CheckIndex(table));
+  ok1(table.Find(MakeId(STEP + 5)) == -1);
+}
+
+static void
+TestCopyOnWrite()
+{
+  TrafficTable a;
+  for (unsigned i = 1; i <= 100; ++i)
+    Append(a, i);
+
+  TrafficTable b = a;
+  ok1(&a[50] == &b[50]);
+
+  b.Edit(50).relative_east = 42;
+  ok1(&a[50] != &b[50]);
+  ok1(&a[0] == &b[0]);
+  ok1(b[50].relative_east == 42);
+
+  b.QuickRemove(0);
+  Append(b, 1000);
+  ok1(a.size() == 100);
+  ok1(b.size() == 100);
+  ok1(a.Find(MakeId(1)) == 0);
+  ok1(b.Find(MakeId(1)) == -1);
+  ok1(a.Find(MakeId(1000)) == -1);
+  ok1(CheckIndex(a));
+  ok1(CheckIndex(b));
+}
+
+static void
+TestReplaceSharedChunks()
+{
+  TrafficTable input;
+  for (unsigned i = 1; i <= 100; ++i)
+    Append(input, i);
+
+  /* the result of processing all items of "input" */
+  TrafficTable output = input;
+  for (unsigned i = 0; i < output.size(); ++i)
+    output.Edit(i).relative_east = 1;
+
+  /* the next input, with one item modified */
+  TrafficTable next = input;
+  next.Edit(50).climb_rate = 7;
+  ok1(next.IsChunkSharedWith(input, 0));
+  ok1(!next.IsChunkSharedWith(input, 50));
+  ok1(!next.IsChunkSharedWith(output, 0));
+
+  next.ReplaceSharedChunks(input, output);
+  ok1(next.IsChunkSharedWith(output, 0));
+  ok1(next.IsChunkSharedWith(output, 99));
+  ok1(!next.IsChunkSharedWith(output, 50));
+  ok1(&next[0] == &output[0]);
+  ok1(next[50].climb_rate == 7);
+  ok1(next[50].relative_east == 0);
+  ok1(next[47].relative_east == 1);
+  ok1(next[48].relative_east == 0);
+  ok1(input[0].relative_east == 0);
+  ok1(CheckIndex(next));
+
+  /* appended items are not shared with the shorter table */
+  Append(next, 1000);
+  ok1(!next.IsChunkSharedWith(output, 100));
+}
+
+int main()
+{
+  plan_tests(26 + 14);
+
+  TestFill();
+  TestCollisions();
+  TestCopyOnWrite();
+  TestReplaceSharedChunks();
+
+  return exit_status();
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "thread/TripleBuffer.hpp"
+#include "TestUtil.hpp"
+
+#include <thread>
+
+struct Sample {
+  unsigned a, b;
+};
+
+/**
+ * One thread publishes increasing values while the other one picks
+ * them up; the consumer must never see a torn or an older value.
+ */
+static bool
+TestThreads() noexcept
+{
+  static constexpr unsigned N = 200000;
+
+  TripleBuffer<Sample> buffer;
+  buffer.GetBack() = {0, ~0U};
+  buffer.Publish();
+
+  std::thread producer([&buffer](){
+    for (unsigned i = 1; i <= N; ++i) {
+      buffer.GetBack() = {i, ~i};
+      buffer.Publish();
+    }
+  });
+
+  bool success = true;
+  unsigned last = 0;
+  while (last < N) {
+    if (!buffer.Consume())
+      continue;
+
+    const Sample &sample = buffer.GetFront();
+    if (sample.b != ~sample.a || sample.a < last)
+      success = false;
+
+    last = sample.a;
+  }
+
+  producer.join();
+  return success;
+}
+
+int main()
+{
+  plan_tests(8);
+
+  TripleBuffer<unsigned> buffer;
+  ok1(!buffer.Consume());
+
+  buffer.GetBack() = 1;
+  buffer.Publish();
+  ok1(buffer.Consume());
+  ok1(buffer.GetFront() == 1);
+  ok1(!buffer.Consume());
+
+  /* only the latest version is picked up */
+  buffer.GetBack() = 2;
+  buffer.Publish();
+  buffer.GetBack() = 3;
+  buffer.Publish();
+  ok1(buffer.Consume());
+  ok1(buffer.GetFront() == 3);
+  ok1(!buffer.Consume());
+
+  ok1(TestThreads());
+
+  return exit_status();
+}
@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Audio/VarioSynthesiser.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+
+static constexpr unsigned sample_rate = 44100;
+
+using Buffer = std::array<int16_t, sample_rate>;
+
+/**
+ * Count the sign changes from negative to non-negative, i.e. the
+ * number of sine waves.
+ */
+static unsigned
+CountWaves(const Buffer &buffer) noexcept
+{
+  unsigned n = 0;
+  for (std::size_t i = 1; i < buffer.size(); ++i)
+    if (buffer[i - 1] < 0 && buffer[i] >= 0)
+      ++n;
+  return n;
+}
+
+/**
+ * Determine the longest sequence of zero samples.
+ */
+static std::size_t
+LongestSilence(const Buffer &buffer) noexcept
+{
+  std::size_t longest = 0, current = 0;
+  for (const auto i : buffer) {
+    current = i == 0 ? current + 1 : 0;
+    longest = std::max(longest, current);
+  }
+  return longest;
+}
+
+static bool
+IsSilent(const int16_t *p, std::size_t n) noexcept
+{
+  return std::all_of(p, p + n, [](int16_t i){ return i == 0; });
+}
+
+static void
+TestSinking()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  Buffer buffer;
+
+  /* -2 m/s is 380 Hz with the default settings, continuous tone */
+  synthesiser.SetVario(-2);
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+
+  const unsigned waves = CountWaves(buffer);
+  ok1(waves >= 370 && waves <= 385);
+  ok1(LongestSilence(buffer) < 10);
+}
+
+static void
+TestClimbing()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  Buffer buffer;
+
+  /* +2 m/s: a 420 ms period, one third of which is silent */
+  synthesiser.SetVario(2);
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+
+  const std::size_t silence = LongestSilence(buffer);
+  ok1(silence >= sample_rate * 140 / 1000 - 10);
+  ok1(silence <= sample_rate * 140 / 1000 + 10);
+}
+
+static void
+TestSilence()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  Buffer buffer;
+
+  synthesiser.SetVario(-2);
+  synthesiser.Synthesise(buffer.data(), 1000);
+
+  /* at most the current sine wave is finished, then it's silent */
+  synthesiser.SetSilence();
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  ok1(IsSilent(buffer.data() + 200, buffer.size() - 200));
+
+  /* the dead band is silent, too */
+  synthesiser.SetDeadBand(true);
+  synthesiser.SetVario(0);
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  ok1(IsSilent(buffer.data(), buffer.size()));
+}
+
+static void
+TestNextBuffer()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  Buffer buffer;
+
+  synthesiser.SetSilence();
+  synthesiser.Synthesise(buffer.data(), 256);
+  ok1(IsSilent(buffer.data(), 256));
+
+  /* a new value is played by the next buffer */
+  synthesiser.SetVario(-2);
+  synthesiser.Synthesise(buffer.data(), 256);
+  ok1(!IsSilent(buffer.data(), 256));
+
+  /* only the most recent value counts */
+  synthesiser.SetVario(-2);
+  synthesiser.SetSilence();
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  ok1(IsSilent(buffer.data() + 200, buffer.size() - 200));
+}
+
+static void
+TestLatency()
+{
+  using namespace std::chrono;
+
+  VarioSynthesiser synthesiser(sample_rate);
+  Buffer buffer;
+
+  ok1(synthesiser.GetLatencyStatistics().count == 0);
+
+  synthesiser.SetVario(-2, VarioSynthesiser::Clock::now() - milliseconds(50));
+  synthesiser.Synthesise(buffer.data(), 256);
+
+  const auto latency = synthesiser.GetLatencyStatistics();
+  ok1(latency.count == 1);
+  ok1(latency.last >= milliseconds(50));
+  ok1(latency.max == latency.last);
+  ok1(latency.GetAverage() == latency.last);
+
+  /* no new value: nothing is counted */
+  synthesiser.Synthesise(buffer.data(), 256);
+  ok1(synthesiser.GetLatencyStatistics().count == 1);
+}
+
+/**
+ * Feed values from another thread while the audio thread is
+ * running; the last one must be played.
+ */
+static void
+TestConcurrent()
+{
+  VarioSynthesiser synthesiser(sample_rate);
+  std::atomic<bool> done{false};
+
+  std::thread producer([&synthesiser, &done]{
+    for (unsigned i = 0; i < 20000; ++i)
+      synthesiser.SetVario((int(i % 7) - 3) * 0.5);
+    synthesiser.SetVario(-2);
+    done.store(true);
+  });
+
+  std::array<int16_t, 64> small;
+  while (!done.load())
+    synthesiser.Synthesise(small.data(), small.size());
+
+  producer.join();
+
+  Buffer buffer;
+  synthesiser.Synthesise(buffer.data(), buffer.size());
+  const unsigned waves = CountWaves(buffer);
+  ok1(waves >= 370 && waves <= 385);
+}
+
+int main()
+{
+  plan_tests(16);
+
+  TestSinking();
+  TestClimbing();
+  TestSilence();
+  TestNextBuffer();
+  TestLatency();
+  TestConcurrent();
+
+  return exit_status();
+}
@@ -4,6 +4,7 @@
 #include "Waypoint/WaypointReader.hpp"
 #include "Waypoint/WaypointReaderBase.hpp"
 #include "Waypoint/CupWriter.hpp"
+#include "Waypoint/WaypointCache.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "Units/System.hpp"
@@ -16,6 +17,8 @@
 #include "util/StringStrip.hxx"
 #include "Operation/Operation.hpp"
 
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 using std::string_view_literals::operator""sv;
@@ -318,6 +321,92 @@ TestCupWriter(const wp_vector &org_wp)
 )cup"sv);
 }
 
+[[gnu::pure]]
+static bool
+IsEqual(const Waypoint &a, const Waypoint &b) noexcept
+{
+  return a.location == b.location &&
+    a.elevation == b.elevation && a.has_elevation == b.has_elevation &&
+    a.original_id == b.original_id &&
+    a.type == b.type && a.origin == b.origin &&
+    a.flags.turn_point == b.flags.turn_point &&
+    a.flags.home == b.flags.home &&
+    a.flags.start_point == b.flags.start_point &&
+    a.flags.finish_point == b.flags.finish_point &&
+    a.runway.IsDirectionDefined() == b.runway.IsDirectionDefined() &&
+    (!a.runway.IsDirectionDefined() ||
+     a.runway.GetDirectionDegrees() == b.runway.GetDirectionDegrees()) &&
+    a.runway.IsLengthDefined() == b.runway.IsLengthDefined() &&
+    (!a.runway.IsLengthDefined() ||
+     a.runway.GetLength() == b.runway.GetLength()) &&
+    a.radio_frequency.IsDefined() == b.radio_frequency.IsDefined() &&
+    (!a.radio_frequency.IsDefined() ||
+     a.radio_frequency.GetKiloHertz() == b.radio_frequency.GetKiloHertz()) &&
+    a.shortname == b.shortname && a.name == b.name &&
+    a.comment == b.comment && a.details == b.details &&
+    a.files_embed == b.files_embed;
+}
+
+[[gnu::pure]]
+static std::vector<const Waypoint *>
+SortById(const Waypoints &waypoints) noexcept
+{
+  std::vector<const Waypoint *> v;
+  for (const auto &i : waypoints)
+    v.push_back(i.get());
+
+  std::sort(v.begin(), v.end(), [](const auto *a, const auto *b){
+    return a->id < b->id;
+  });
+  return v;
+}
+
+static void
+TestCache(const wp_vector &org_wp)
+{
+  const Path path(_T("test/data/waypoints3.cup"));
+
+  Waypoints parsed;
+  NullOperationEnvironment operation;
+  ReadWaypointFile(path, parsed, WaypointFactory(WaypointOrigin::PRIMARY),
+                   operation);
+
+  StringOutputStream sos;
+  BufferedOutputStream bos(sos);
+  SaveWaypointCache(bos, path, parsed);
+  bos.Flush();
+
+  const auto &data = sos.GetValue();
+  const auto src = std::as_bytes(std::span{data});
+
+  Waypoints loaded;
+  ok1(LoadWaypointCache(src, path, loaded,
+                        WaypointFactory(WaypointOrigin::PRIMARY)));
+  loaded.Optimise();
+  ok1(loaded.size() == org_wp.size());
+
+  /* same attributes, same order */
+  const auto a = SortById(parsed), b = SortById(loaded);
+  ok1(std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                 [](const Waypoint *x, const Waypoint *y){
+                   return IsEqual(*x, *y);
+                 }));
+
+  /* a cache written for another file is rejected */
+  Waypoints other;
+  ok1(!LoadWaypointCache(src, Path(_T("test/data/waypoints.cup")), other,
+                         WaypointFactory(WaypointOrigin::PRIMARY)));
+
+  /* a truncated cache is rejected without adding anything */
+  try {
+    LoadWaypointCache(src.first(src.size() - 1), path, other,
+                      WaypointFactory(WaypointOrigin::PRIMARY));
+    ok1(false);
+  } catch (const std::runtime_error &) {
+    ok1(other.IsEmpty());
+  }
+}
+
 static wp_vector
 CreateOriginalWaypoints()
 {
@@ -420,7 +509,7 @@ int main()
 {
   wp_vector org_wp = CreateOriginalWaypoints();
 
-  plan_tests(451);
+  plan_tests(456);
 
   TestWinPilot(org_wp);
   TestSeeYou(org_wp);
@@ -431,6 +520,7 @@ int main()
   TestCompeGPS(org_wp);
   TestCompeGPS_UTM(org_wp);
   TestCupWriter(org_wp);
+  TestCache(org_wp);
 
   return exit_status();
 }
@@ -6,6 +6,7 @@
 #include "test_debug.hpp"
 
 #include <functional>
+#include <vector>
 
 #include <stdio.h>
 #include <tchar.h>
@@ -218,6 +219,41 @@ TestGetNearest(const Waypoints &waypoints, const GeoPoint &center)
   ok1(waypoint->original_id == 6);
 }
 
+static std::vector<unsigned>
+VisitNearest(const Waypoints &waypoints, const GeoPoint &location,
+             double range, unsigned max_results,
+             const WaypointPredicate &predicate)
+{
+  std::vector<unsigned> ids;
+  unsigned n = waypoints.VisitNearestIf(location, range, max_results,
+                                        predicate, [&](const auto &wp){
+                                          ids.push_back(wp->original_id);
+                                        });
+  ok1(n == ids.size());
+  return ids;
+}
+
+static void
+TestNearestVisitor(const Waypoints &waypoints, const GeoPoint &center)
+{
+  const auto all = [](const Waypoint &){ return true; };
+
+  ok1(VisitNearest(waypoints, center, 1000000, 5, all) ==
+      std::vector<unsigned>({0, 1, 2, 3, 4}));
+  ok1(VisitNearest(waypoints, center, 2500, 10, all) ==
+      std::vector<unsigned>({0, 1, 2}));
+  ok1(VisitNearest(waypoints, center, 1000000, 0, all).empty());
+  ok1(VisitNearest(waypoints, center, 1000000, 3, OriginalIDAbove5) ==
+      std::vector<unsigned>({6, 7, 8}));
+  ok1(VisitNearest(waypoints, center, 1000000, 1000, all).size() == 151);
+
+  std::vector<unsigned> ids;
+  waypoints.VisitNearestLandable(center, 1000000, 4, [&](const auto &wp){
+    ids.push_back(wp->original_id);
+  });
+  ok1(ids == std::vector<unsigned>({0, 3, 6, 7}));
+}
+
 static void
 TestIterator(const Waypoints &waypoints)
 {
@@ -285,7 +321,7 @@ main(int argc, char** argv)
   if (!ParseArgs(argc, argv))
     return 0;
 
-  plan_tests(52);
+  plan_tests(63);
 
   Waypoints waypoints;
   GeoPoint center(Angle::Degrees(51.4), Angle::Degrees(7.85));
@@ -301,6 +337,7 @@ main(int argc, char** argv)
   TestNamePrefixVisitor(waypoints);
   TestRangeVisitor(waypoints, center);
   TestGetNearest(waypoints, center);
+  TestNearestVisitor(waypoints, center);
   TestIterator(waypoints);
 
   ok(TestCopy(waypoints), "waypoint copy", 0);